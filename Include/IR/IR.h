@@ -20,6 +20,9 @@ namespace IR
 		maxReturnValues     = (Uptr)16,
 	};
 
+	// The features and limits that a module may use. linkFeatureSpecs in Lib/IR/Link.cpp combines
+	// the feature specs of linked modules field by field, so it must be updated when a field is
+	// added here.
 	struct FeatureSpec
 	{
 		// A feature flag for the MVP, just so the MVP operators can reference it as the required
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "IR.h"
+
+#include <string>
+#include <vector>
+
+namespace IR
+{
+	struct Module;
+
+	// A module to statically link with linkModules, and the name that the modules linked after it
+	// use to import its exports.
+	struct LinkableModule
+	{
+		std::string name;
+		const Module* module;
+	};
+
+	struct LinkException
+	{
+		std::string message;
+		LinkException(std::string&& inMessage) : message(inMessage) {}
+	};
+
+	// Statically links a set of valid modules into a single module, so they can be compiled
+	// together, and calls between them may be inlined. The modules are linked in order, as if each
+	// was instantiated after the modules before it:
+	// - An import whose module name is the name of a module before it is resolved to that module's
+	//   export. References to the import are replaced with references to the exported object.
+	// - The other imports remain imports of the linked module. Identical imports from different
+	//   modules are merged into one.
+	// - The definitions, data segments, and table segments of all the modules are concatenated,
+	//   and the function, table, memory, global, exception type, and type indices are remapped.
+	// - The exports of the linked module are the exports of the last module.
+	// - The linked module's feature spec allows the features that any of the modules allow.
+	// - The start functions of the modules are called in order by the linked module's start
+	//   function. Unlike instantiating the modules one at a time, the segments of all the modules
+	//   are copied into their tables and memories before any start function is called.
+	// Since memory and table operators implicitly use the first memory or table, the linked module
+	// may only contain one of each. The name sections of the modules are merged, and the other user
+	// sections are discarded. Throws a LinkException if the modules can't be linked.
+	IR_API void linkModules(const std::vector<LinkableModule>& modules, Module& outModule);
+}
@@ -1,10 +1,17 @@
 #pragma once
 
 #include "IR.h"
+#include "Inline/Arena.h"
 #include "Inline/Assert.h"
 #include "Inline/BasicTypes.h"
+#include "Inline/Lock.h"
+#include "Inline/SharedBytes.h"
+#include "Platform/Platform.h"
 #include "Types.h"
 
+#include <string.h>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace IR
@@ -75,13 +82,62 @@ namespace IR
 		}
 	};
 
+	// Memory for a module's function code and branch tables, which is freed all at once when the
+	// module is destroyed. Copies of a module share its arena, since the arrays in it are
+	// immutable. Allocation is thread-safe, so function bodies may be decoded in parallel.
+	struct ModuleArena
+	{
+		template<typename Element>
+		ArenaArray<Element> copyArray(const Element* elements, Uptr numElements)
+		{
+			static_assert(std::is_trivially_copyable<Element>::value,
+						  "ModuleArena arrays must be trivially copyable");
+			if(!numElements) { return ArenaArray<Element>(); }
+
+			Element* arenaElements;
+			{
+				Lock<Platform::Mutex> arenaLock(mutex);
+				arenaElements = arena.allocate<Element>(numElements);
+			}
+			memcpy(arenaElements, elements, sizeof(Element) * numElements);
+			return ArenaArray<Element>(arenaElements, numElements);
+		}
+
+		template<typename Element>
+		ArenaArray<Element> copyArray(const std::vector<Element>& elements)
+		{
+			return copyArray(elements.data(), elements.size());
+		}
+
+	private:
+		Platform::Mutex mutex;
+		Arena arena;
+	};
+
+	// The offsets in a function's code of the first operator in a part of a control structure, and
+	// of the else, catch, catch_all, or end operator that ends the part. The parts are the function
+	// body, and the bodies of each block, loop, if, else, try, catch, and catch_all. endOpIndex is
+	// the number of operators before the end operator in the function, for reporting locations.
+	struct ControlPartOffsets
+	{
+		U32 firstOpOffset;
+		U32 endOpOffset;
+		U32 endOpIndex;
+	};
+
 	// A function definition
 	struct FunctionDef
 	{
 		IndexedFunctionType type;
 		std::vector<ValueType> nonParameterLocalTypes;
-		std::vector<U8> code;
-		std::vector<std::vector<U32>> branchTables;
+		ArenaArray<U8> code;
+		std::vector<ArenaArray<U32>> branchTables;
+
+		// The offsets of the function's control structure parts, sorted by firstOpOffset. This is
+		// computed by computeControlPartOffsets when the function is loaded, so consumers of the
+		// code can find the end of a part without decoding the operators in it. May be empty if
+		// the function was created without computing it.
+		ArenaArray<ControlPartOffsets> controlPartOffsets;
 	};
 
 	// A table definition
@@ -132,12 +188,12 @@ namespace IR
 	};
 
 	// A data segment: a literal sequence of bytes that is copied into a Runtime::Memory when
-	// instantiating a module
+	// instantiating a module. The bytes may reference the buffer the module was loaded from.
 	struct DataSegment
 	{
 		Uptr memoryIndex;
 		InitializerExpression baseOffset;
-		std::vector<U8> data;
+		SharedBytes data;
 	};
 
 	// A table segment: a literal sequence of function indices that is copied into a Runtime::Table
@@ -149,11 +205,12 @@ namespace IR
 		std::vector<Uptr> indices;
 	};
 
-	// A user-defined module section as an array of bytes
+	// A user-defined module section as an array of bytes. The bytes may reference the buffer the
+	// module was loaded from, and are only parsed on demand, e.g. by IR::getDisassemblyNames.
 	struct UserSection
 	{
 		std::string name;
-		std::vector<U8> data;
+		SharedBytes data;
 	};
 
 	// An index-space for imports and definitions of a specific kind.
@@ -193,10 +250,14 @@ namespace IR
 
 		Uptr startFunctionIndex;
 
-		Module() : startFunctionIndex(UINTPTR_MAX) {}
+		std::shared_ptr<ModuleArena> arena;
+
+		Module() : startFunctionIndex(UINTPTR_MAX), arena(std::make_shared<ModuleArena>()) {}
 
 		Module(const FeatureSpec& inFeatureSpec)
-		: featureSpec(inFeatureSpec), startFunctionIndex(UINTPTR_MAX)
+		: featureSpec(inFeatureSpec)
+		, startFunctionIndex(UINTPTR_MAX)
+		, arena(std::make_shared<ModuleArena>())
 		{
 		}
 	};
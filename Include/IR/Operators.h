@@ -1,9 +1,11 @@
 #pragma once
 
 #include "IR.h"
+#include "Inline/Arena.h"
 #include "Inline/Assert.h"
 #include "Inline/BasicTypes.h"
 #include "Inline/Serialization.h"
+#include "Module.h"
 #include "Types.h"
 
 #include "OperatorTable.h"
@@ -124,13 +126,25 @@ namespace IR
 	// Decodes an operator from an input stream and dispatches by opcode.
 	struct OperatorDecoderStream
 	{
-		OperatorDecoderStream(const std::vector<U8>& codeBytes)
-		: nextByte(codeBytes.data()), end(codeBytes.data() + codeBytes.size())
+		OperatorDecoderStream(const ArenaArray<U8>& codeBytes)
+		: start(codeBytes.data())
+		, nextByte(codeBytes.data())
+		, end(codeBytes.data() + codeBytes.size())
 		{
 		}
 
 		operator bool() const { return nextByte < end; }
 
+		// The offset in the code of the next operator to be decoded.
+		Uptr getOffset() const { return nextByte - start; }
+
+		// Moves the stream to the operator at the given offset in the code.
+		void seek(Uptr offset)
+		{
+			wavmAssert(offset <= Uptr(end - start));
+			nextByte = start + offset;
+		}
+
 		template<typename Visitor> typename Visitor::Result decodeOp(Visitor& visitor)
 		{
 			wavmAssert(nextByte + sizeof(Opcode) <= end);
@@ -162,6 +176,7 @@ namespace IR
 		}
 
 	private:
+		const U8* start;
 		const U8* nextByte;
 		const U8* end;
 	};
@@ -191,4 +206,14 @@ namespace IR
 	};
 
 	IR_API const char* getOpcodeName(Opcode opcode);
+
+	// Computes the offsets of the control structure parts in a function's code, and allocates them
+	// in the module's arena.
+	IR_API ArenaArray<ControlPartOffsets> computeControlPartOffsets(ModuleArena& arena,
+																	const ArenaArray<U8>& code);
+
+	// Finds the control structure part whose first operator is at firstOpOffset, or returns null if
+	// the function's control part offsets weren't computed.
+	IR_API const ControlPartOffsets* findControlPart(const FunctionDef& functionDef,
+													 Uptr firstOpOffset);
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "IR.h"
+
+namespace IR
+{
+	struct Module;
+
+	// Removes code and declarations that can't affect the behavior of a module, so it is cheaper to
+	// compile:
+	// - The bodies of function definitions that can't be reached from the module's exports, start
+	//   function, or table segments are replaced with a body that traps. The function index space
+	//   isn't changed, so references to the functions from the module and its instances are still
+	//   valid.
+	// - Mutable global definitions that aren't exported and aren't set by any reachable function
+	//   are made immutable.
+	// - Function types that aren't used by the module are removed, and references to the other
+	//   types are renumbered.
+	// The module must be valid, and remains valid. If any code is changed and the module shares its
+	// arena with other copies, its code is first copied to an arena of its own.
+	IR_API void optimizeModule(Module& module);
+}
@@ -28,7 +28,7 @@ namespace IR
 		UntaggedValue(F32 inF32) { f32 = inF32; }
 		UntaggedValue(F64 inF64) { f64 = inF64; }
 		UntaggedValue(V128 inV128) { v128 = inV128; }
-		UntaggedValue() { memset(this, 0, sizeof(*this)); }
+		UntaggedValue() { memset(bytes, 0, sizeof(bytes)); }
 	};
 
 	// A boxed value: may hold any value that can be passed to a function invoked through the
@@ -136,7 +136,6 @@ namespace IR
 			ValueType elems[1];
 
 			Impl(Uptr inNumElems, const ValueType* inElems);
-			Impl(const Impl& inCopy);
 
 			static Uptr calcNumBytes(Uptr numElems)
 			{
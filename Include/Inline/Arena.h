@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+
+#include <vector>
+
+// Allocates memory from large blocks, which are only freed when the arena is destroyed. This makes
+// allocating many small objects that share a lifetime cheap, and keeps them close together in
+// memory. Objects allocated in the arena are not destroyed by it.
+struct Arena
+{
+	Arena(Uptr inNumBytesPerBlock = 64 * 1024)
+	: numBytesPerBlock(inNumBytesPerBlock), nextByte(nullptr), numFreeBlockBytes(0)
+	{
+	}
+	~Arena()
+	{
+		for(U8* block : blocks) { delete[] block; }
+	}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	void* allocate(Uptr numBytes, Uptr alignment = sizeof(void*))
+	{
+		wavmAssert(alignment && !(alignment & (alignment - 1)));
+
+		// Allocations that would waste a large part of a block are given their own block.
+		if(numBytes + alignment > numBytesPerBlock / 4)
+		{ return alignUp(allocateBlock(numBytes + alignment - 1), alignment); }
+
+		Uptr numAlignmentBytes = (alignment - Uptr(nextByte)) & (alignment - 1);
+		if(numAlignmentBytes + numBytes > numFreeBlockBytes)
+		{
+			nextByte          = allocateBlock(numBytesPerBlock);
+			numFreeBlockBytes = numBytesPerBlock;
+			numAlignmentBytes = (alignment - Uptr(nextByte)) & (alignment - 1);
+		}
+
+		U8* result = nextByte + numAlignmentBytes;
+		nextByte += numAlignmentBytes + numBytes;
+		numFreeBlockBytes -= numAlignmentBytes + numBytes;
+		return result;
+	}
+
+	template<typename Object> Object* allocate(Uptr numObjects = 1)
+	{
+		return (Object*)allocate(sizeof(Object) * numObjects, alignof(Object));
+	}
+
+private:
+	const Uptr numBytesPerBlock;
+	std::vector<U8*> blocks;
+	U8* nextByte;
+	Uptr numFreeBlockBytes;
+
+	U8* allocateBlock(Uptr numBytes)
+	{
+		U8* block = new U8[numBytes];
+		blocks.push_back(block);
+		return block;
+	}
+
+	static void* alignUp(U8* address, Uptr alignment)
+	{
+		return address + ((alignment - Uptr(address)) & (alignment - 1));
+	}
+};
+
+// An immutable array whose elements are allocated in an Arena, and are valid until it is destroyed.
+template<typename Element> struct ArenaArray
+{
+	ArenaArray() : elements(nullptr), numElements(0) {}
+	ArenaArray(const Element* inElements, Uptr inNumElements)
+	: elements(inElements), numElements(inNumElements)
+	{
+	}
+
+	const Element* data() const { return elements; }
+	const Element* begin() const { return elements; }
+	const Element* end() const { return elements + numElements; }
+	Uptr size() const { return numElements; }
+
+	const Element& operator[](Uptr index) const
+	{
+		wavmAssert(index < numElements);
+		return elements[index];
+	}
+
+	friend bool operator==(const ArenaArray& left, const ArenaArray& right)
+	{
+		if(left.numElements != right.numElements) { return false; }
+		for(Uptr index = 0; index < left.numElements; ++index)
+		{
+			if(left.elements[index] != right.elements[index]) { return false; }
+		}
+		return true;
+	}
+	friend bool operator!=(const ArenaArray& left, const ArenaArray& right)
+	{
+		return !(left == right);
+	}
+
+private:
+	const Element* elements;
+	Uptr numElements;
+};
@@ -4,12 +4,14 @@
 #include "IR/Validate.h"
 #include "Inline/BasicTypes.h"
 #include "Inline/Floats.h"
+#include "Inline/SharedBytes.h"
 #include "Inline/Timing.h"
 #include "Platform/Platform.h"
 #include "Runtime/Runtime.h"
 #include "WASM/WASM.h"
 #include "WAST/WAST.h"
 
+#include <memory>
 #include <vector>
 
 inline bool loadFile(const char* filename, std::vector<U8>& outFileContents)
@@ -40,6 +42,31 @@ inline bool loadFile(const char* filename, std::vector<U8>& outFileContents)
 	return true;
 }
 
+// Maps a file into memory as read-only. The file stays mapped until the last SharedBytes that
+// references it is destroyed. Returns false if the file couldn't be mapped, e.g. because it is
+// empty or isn't a regular file.
+inline bool mapFile(const char* filename, SharedBytes& outFileBytes)
+{
+	Platform::File* file = Platform::openFile(
+		filename, Platform::FileAccessMode::readOnly, Platform::FileCreateMode::openExisting);
+	if(!file) { return false; }
+
+	U64 numFileBytes      = 0;
+	const U8* mappedBytes = nullptr;
+	if(Platform::seekFile(file, 0, Platform::FileSeekOrigin::end, &numFileBytes)
+	   && numFileBytes > 0 && numFileBytes <= UINTPTR_MAX)
+	{ mappedBytes = Platform::mapFile(file, Uptr(numFileBytes)); }
+	errorUnless(Platform::closeFile(file));
+	if(!mappedBytes) { return false; }
+
+	const Uptr numMappedBytes = Uptr(numFileBytes);
+	std::shared_ptr<const void> mapping(mappedBytes, [numMappedBytes](const void* bytes) {
+		Platform::unmapFile((const U8*)bytes, numMappedBytes);
+	});
+	outFileBytes = SharedBytes(mapping, mappedBytes, numMappedBytes);
+	return true;
+}
+
 inline bool saveFile(const char* filename, const void* fileBytes, Uptr numFileBytes)
 {
 	Platform::File* file = Platform::openFile(
@@ -91,20 +118,13 @@ inline bool loadTextModuleFromFile(const char* filename, IR::Module& outModule)
 	}
 }
 
-inline bool loadBinaryModule(const void* wasmBytes,
-							 Uptr numBytes,
-							 IR::Module& outModule,
-							 Log::Category errorCategory = Log::error)
+// Calls a function that decodes a binary module, and logs any errors it throws.
+template<typename DecodeFunction>
+bool catchBinaryModuleErrors(Log::Category errorCategory, DecodeFunction&& decode)
 {
-	// Load the module from a binary WebAssembly file.
 	try
 	{
-		Timing::Timer loadTimer;
-
-		Serialization::MemoryInputStream stream((const U8*)wasmBytes, numBytes);
-		WASM::serialize(stream, outModule);
-
-		Timing::logRatePerSecond("Loaded WASM", loadTimer, numBytes / 1024.0 / 1024.0, "MB");
+		decode();
 		return true;
 	}
 	catch(Serialization::FatalSerializationException exception)
@@ -121,18 +141,94 @@ inline bool loadBinaryModule(const void* wasmBytes,
 					exception.message.c_str());
 		return false;
 	}
-	catch(std::bad_alloc)
+	catch(const std::bad_alloc&)
 	{
 		Log::printf(errorCategory, "Memory allocation failed: input is likely malformed\n");
 		return false;
 	}
 }
 
+inline bool loadBinaryModule(const void* wasmBytes,
+							 Uptr numBytes,
+							 IR::Module& outModule,
+							 Log::Category errorCategory = Log::error)
+{
+	// Load the module from a binary WebAssembly file.
+	return catchBinaryModuleErrors(errorCategory, [&] {
+		Timing::Timer loadTimer;
+
+		Serialization::MemoryInputStream stream((const U8*)wasmBytes, numBytes);
+		WASM::serialize(stream, outModule);
+
+		Timing::logRatePerSecond("Loaded WASM", loadTimer, numBytes / 1024.0 / 1024.0, "MB");
+	});
+}
+
+// Loads a binary module from bytes with shared ownership: the module's data segments and user
+// sections will reference the bytes instead of copying them.
+inline bool loadBinaryModule(const SharedBytes& wasmBytes,
+							 IR::Module& outModule,
+							 Log::Category errorCategory = Log::error)
+{
+	return catchBinaryModuleErrors(errorCategory, [&] {
+		Timing::Timer loadTimer;
+
+		Serialization::MemoryInputStream stream(wasmBytes);
+		WASM::serialize(stream, outModule);
+
+		Timing::logRatePerSecond(
+			"Loaded WASM", loadTimer, wasmBytes.size() / 1024.0 / 1024.0, "MB");
+	});
+}
+
 inline bool loadBinaryModuleFromFile(const char* filename,
 									 IR::Module& outModule,
 									 Log::Category errorCategory = Log::error)
 {
-	std::vector<U8> wasmBytes;
-	if(!loadFile(filename, wasmBytes)) { return false; }
-	return loadBinaryModule(wasmBytes.data(), wasmBytes.size(), outModule);
+	// If possible, map the file into memory and decode it in place.
+	SharedBytes mappedBytes;
+	if(mapFile(filename, mappedBytes))
+	{ return loadBinaryModule(mappedBytes, outModule, errorCategory); }
+
+	// Otherwise, read the file in chunks, and decode each section of the module as soon as it has
+	// been read.
+	Platform::File* file = Platform::openFile(
+		filename, Platform::FileAccessMode::readOnly, Platform::FileCreateMode::openExisting);
+	if(!file)
+	{
+		Log::printf(Log::error, "Couldn't read %s: couldn't open file.\n", filename);
+		return false;
+	}
+
+	bool readFailed   = false;
+	const bool result = catchBinaryModuleErrors(errorCategory, [&] {
+		Timing::Timer loadTimer;
+
+		WASM::StreamingDecoder decoder(outModule);
+		std::vector<U8> chunk(1024 * 1024);
+		U64 numFileBytes = 0;
+		while(true)
+		{
+			Uptr numChunkBytes = 0;
+			if(!Platform::readFile(file, chunk.data(), chunk.size(), &numChunkBytes))
+			{
+				readFailed = true;
+				return;
+			}
+			if(!numChunkBytes) { break; }
+			decoder.addBytes(chunk.data(), numChunkBytes);
+			numFileBytes += numChunkBytes;
+		};
+		decoder.finish();
+
+		Timing::logRatePerSecond("Loaded WASM", loadTimer, numFileBytes / 1024.0 / 1024.0, "MB");
+	});
+
+	errorUnless(Platform::closeFile(file));
+	if(readFailed)
+	{
+		Log::printf(Log::error, "Couldn't read %s: error reading file.\n", filename);
+		return false;
+	}
+	return result;
 }
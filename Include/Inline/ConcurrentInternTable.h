@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Inline/Arena.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Lock.h"
+#include "Platform/Platform.h"
+
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+// A set of immutable values, each stored once so that its address may be used as its identity.
+// Lookups don't take any locks. Additions lock one of numStripes stripes, selected by the value's
+// hash, and allocate the value in that stripe's arena. Values are never removed, and are freed
+// without being destroyed when the table is destroyed.
+template<typename Value, Uptr numStripes = 16> struct ConcurrentInternTable
+{
+	static_assert(numStripes && !(numStripes & (numStripes - 1)),
+				  "numStripes must be a power of two");
+	static_assert(std::is_trivially_destructible<Value>::value,
+				  "ConcurrentInternTable values must be trivially destructible");
+
+	ConcurrentInternTable() {}
+	ConcurrentInternTable(const ConcurrentInternTable&) = delete;
+	ConcurrentInternTable& operator=(const ConcurrentInternTable&) = delete;
+
+	// Looks for a value with the given hash that isEqual(const Value*) returns true for. If there
+	// isn't one, calls create(Arena&) to allocate the value in an arena and adds it.
+	template<typename IsEqual, typename Create>
+	const Value* getOrAdd(Uptr hash, const IsEqual& isEqual, const Create& create)
+	{
+		Stripe& stripe = stripes[hash & (numStripes - 1)];
+		const Uptr bucketHash = hash / numStripes;
+
+		// Look for the value without locking the stripe.
+		const Value* value = stripe.find(bucketHash, isEqual);
+		if(value) { return value; }
+
+		// Lock the stripe, and check that no other thread added the value before adding it.
+		Lock<Platform::Mutex> stripeLock(stripe.mutex);
+		value = stripe.find(bucketHash, isEqual);
+		if(!value)
+		{
+			value = create(stripe.arena);
+			stripe.add(bucketHash, value);
+		}
+		return value;
+	}
+
+private:
+	struct Bucket
+	{
+		std::atomic<Uptr> hash{0};
+		std::atomic<const Value*> value{nullptr};
+	};
+
+	struct Table
+	{
+		Uptr hashMask;
+		Bucket* buckets;
+	};
+
+	struct alignas(Platform::numCacheLineBytes) Stripe
+	{
+		std::atomic<const Table*> table{nullptr};
+		Uptr numValues = 0;
+
+		Platform::Mutex mutex;
+		Arena arena;
+
+		// Tables that have been replaced by a larger table may still be read by a concurrent
+		// lookup, so they are kept until the stripe is destroyed.
+		std::vector<Table*> tables;
+
+		~Stripe()
+		{
+			for(Table* oldTable : tables)
+			{
+				delete[] oldTable->buckets;
+				delete oldTable;
+			}
+		}
+
+		template<typename IsEqual> const Value* find(Uptr hash, const IsEqual& isEqual) const
+		{
+			const Table* currentTable = table.load(std::memory_order_acquire);
+			if(!currentTable) { return nullptr; }
+
+			// Linearly probe from the hash's ideal bucket until the value or an empty bucket is
+			// found. The table is never full, so an empty bucket will always be found.
+			for(Uptr bucketIndex = hash;; ++bucketIndex)
+			{
+				const Bucket& bucket = currentTable->buckets[bucketIndex & currentTable->hashMask];
+				const Value* value   = bucket.value.load(std::memory_order_acquire);
+				if(!value) { return nullptr; }
+				if(bucket.hash.load(std::memory_order_relaxed) == hash && isEqual(value))
+				{ return value; }
+			}
+		}
+
+		// Adds a value that isn't in the table yet. The caller must have locked the stripe.
+		void add(Uptr hash, const Value* value)
+		{
+			// Keep the table at most half full.
+			const Table* currentTable = table.load(std::memory_order_relaxed);
+			if(!currentTable || (numValues + 1) * 2 > currentTable->hashMask + 1)
+			{
+				const Uptr numBuckets = currentTable ? (currentTable->hashMask + 1) * 2 : 16;
+				Table* newTable       = new Table;
+				newTable->hashMask    = numBuckets - 1;
+				newTable->buckets     = new Bucket[numBuckets];
+				tables.push_back(newTable);
+
+				if(currentTable)
+				{
+					for(Uptr bucketIndex = 0; bucketIndex <= currentTable->hashMask; ++bucketIndex)
+					{
+						const Bucket& bucket = currentTable->buckets[bucketIndex];
+						const Value* oldValue = bucket.value.load(std::memory_order_relaxed);
+						if(oldValue)
+						{ insert(newTable, bucket.hash.load(std::memory_order_relaxed), oldValue); }
+					}
+				}
+
+				// Publish the new table after its buckets have been written.
+				table.store(newTable, std::memory_order_release);
+				currentTable = newTable;
+			}
+
+			insert(currentTable, hash, value);
+			++numValues;
+		}
+
+		static void insert(const Table* targetTable, Uptr hash, const Value* value)
+		{
+			for(Uptr bucketIndex = hash;; ++bucketIndex)
+			{
+				Bucket& bucket = targetTable->buckets[bucketIndex & targetTable->hashMask];
+				if(!bucket.value.load(std::memory_order_relaxed))
+				{
+					// Write the hash before publishing the value that a lookup will check first.
+					bucket.hash.store(hash, std::memory_order_relaxed);
+					bucket.value.store(value, std::memory_order_release);
+					return;
+				}
+			}
+		}
+	};
+
+	Stripe stripes[numStripes];
+};
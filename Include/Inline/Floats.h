@@ -3,6 +3,7 @@
 #include "Inline/BasicTypes.h"
 #include "Inline/Errors.h"
 
+#include <math.h>
 #include <cstdio>
 #include <string>
 
@@ -119,4 +120,109 @@ namespace Floats
 			return buffer;
 		}
 	}
+
+	// Implementations of the WebAssembly float operators that don't map directly to the C library:
+	// they must return a quiet NaN if an operand is a NaN, and min/max must order -0.0 before +0.0.
+	template<typename Float> Float quietNaN(Float value)
+	{
+		FloatComponents<Float> components;
+		components.value = value;
+		components.bits.significand |= typename FloatComponents<Float>::Bits(1)
+									   << (FloatComponents<Float>::numSignificandBits - 1);
+		return components.value;
+	}
+
+	template<typename Float> Float floatMin(Float left, Float right)
+	{
+		// If either operand is a NaN, convert it to a quiet NaN and return it.
+		if(left != left) { return quietNaN(left); }
+		else if(right != right)
+		{
+			return quietNaN(right);
+		}
+		// If either operand is less than the other, return it.
+		else if(left < right)
+		{
+			return left;
+		}
+		else if(right < left)
+		{
+			return right;
+		}
+		else
+		{
+			// Finally, if the operands are apparently equal, compare their integer values to
+			// distinguish -0.0 from +0.0
+			FloatComponents<Float> leftComponents;
+			leftComponents.value = left;
+			FloatComponents<Float> rightComponents;
+			rightComponents.value = right;
+			return leftComponents.bitcastInt < rightComponents.bitcastInt ? right : left;
+		}
+	}
+
+	template<typename Float> Float floatMax(Float left, Float right)
+	{
+		// If either operand is a NaN, convert it to a quiet NaN and return it.
+		if(left != left) { return quietNaN(left); }
+		else if(right != right)
+		{
+			return quietNaN(right);
+		}
+		// If either operand is less than the other, return it.
+		else if(left > right)
+		{
+			return left;
+		}
+		else if(right > left)
+		{
+			return right;
+		}
+		else
+		{
+			// Finally, if the operands are apparently equal, compare their integer values to
+			// distinguish -0.0 from +0.0
+			FloatComponents<Float> leftComponents;
+			leftComponents.value = left;
+			FloatComponents<Float> rightComponents;
+			rightComponents.value = right;
+			return leftComponents.bitcastInt > rightComponents.bitcastInt ? right : left;
+		}
+	}
+
+	template<typename Float> Float floatCeil(Float value)
+	{
+		if(value != value) { return quietNaN(value); }
+		else
+		{
+			return ceil(value);
+		}
+	}
+
+	template<typename Float> Float floatFloor(Float value)
+	{
+		if(value != value) { return quietNaN(value); }
+		else
+		{
+			return floor(value);
+		}
+	}
+
+	template<typename Float> Float floatTrunc(Float value)
+	{
+		if(value != value) { return quietNaN(value); }
+		else
+		{
+			return trunc(value);
+		}
+	}
+
+	template<typename Float> Float floatNearest(Float value)
+	{
+		if(value != value) { return quietNaN(value); }
+		else
+		{
+			return nearbyint(value);
+		}
+	}
 }
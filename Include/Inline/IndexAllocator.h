@@ -1,6 +1,12 @@
 #pragma once
 
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
 #include "Inline/Errors.h"
+#include "Platform/Platform.h"
+
+#include <atomic>
+#include <vector>
 
 template<typename Index, Index maxIndex> struct IndexAllocator
 {
@@ -28,3 +34,97 @@ private:
 	std::vector<Index> freeIndices;
 	Index minUnallocatedIndex;
 };
+
+// An index allocator that may be used by multiple threads without a lock. The allocated indices
+// are tracked by a bitmap, and alloc returns the lowest free index it finds with a compare and
+// swap on the bitmap word that contains it. The bitmap is allocated in virtual pages, which are
+// zero until they are written, so only the part of the bitmap that has been used takes memory.
+template<Uptr maxIndex> struct ConcurrentIndexAllocator
+{
+	ConcurrentIndexAllocator() : minFreeWordIndex(0)
+	{
+		words = (std::atomic<U64>*)Platform::allocateVirtualPages(getNumWordPages());
+		errorUnless(words);
+		errorUnless(Platform::commitVirtualPages((U8*)words, getNumWordPages()));
+	}
+
+	~ConcurrentIndexAllocator() { Platform::freeVirtualPages((U8*)words, getNumWordPages()); }
+
+	// Don't allow copying or moving a ConcurrentIndexAllocator.
+	ConcurrentIndexAllocator(const ConcurrentIndexAllocator&) = delete;
+	ConcurrentIndexAllocator(ConcurrentIndexAllocator&&)      = delete;
+	void operator=(const ConcurrentIndexAllocator&) = delete;
+	void operator=(ConcurrentIndexAllocator&&) = delete;
+
+	// Allocates an index. Returns false if all indices are allocated.
+	bool alloc(Uptr& outIndex)
+	{
+		// The minimum free word index is just a hint: a race between alloc and free may leave it
+		// past a free index, so fall back to scanning the whole bitmap before failing.
+		return allocFromWord(minFreeWordIndex.load(std::memory_order_relaxed), outIndex)
+			   || allocFromWord(0, outIndex);
+	}
+
+	void free(Uptr index)
+	{
+		wavmAssert(index < maxIndex);
+		const Uptr wordIndex = index / 64;
+		const U64 bit        = U64(1) << (index % 64);
+		const U64 oldWord    = words[wordIndex].fetch_and(~bit, std::memory_order_release);
+		wavmAssert(oldWord & bit);
+		SUPPRESS_UNUSED(oldWord);
+
+		Uptr oldMinFreeWordIndex = minFreeWordIndex.load(std::memory_order_relaxed);
+		while(wordIndex < oldMinFreeWordIndex
+			  && !minFreeWordIndex.compare_exchange_weak(
+					 oldMinFreeWordIndex, wordIndex, std::memory_order_relaxed))
+		{
+		}
+	}
+
+private:
+	enum
+	{
+		numWords = (maxIndex + 63) / 64
+	};
+
+	std::atomic<U64>* words;
+	std::atomic<Uptr> minFreeWordIndex;
+
+	static Uptr getNumWordPages()
+	{
+		const Uptr pageSize = Uptr(1) << Platform::getPageSizeLog2();
+		return (numWords * sizeof(std::atomic<U64>) + pageSize - 1) / pageSize;
+	}
+
+	bool allocFromWord(Uptr firstWordIndex, Uptr& outIndex)
+	{
+		for(Uptr wordIndex = firstWordIndex; wordIndex < numWords; ++wordIndex)
+		{
+			U64 word = words[wordIndex].load(std::memory_order_relaxed);
+			while(word != ~U64(0))
+			{
+				const U64 bitIndex = Platform::countTrailingZeroes(~word);
+				const Uptr index   = wordIndex * 64 + Uptr(bitIndex);
+				if(index >= maxIndex) { return false; }
+
+				const U64 newWord = word | (U64(1) << bitIndex);
+				if(words[wordIndex].compare_exchange_weak(
+					   word, newWord, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					// If this filled the word, advance the hint past it.
+					if(newWord == ~U64(0))
+					{
+						Uptr expectedWordIndex = wordIndex;
+						minFreeWordIndex.compare_exchange_strong(
+							expectedWordIndex, wordIndex + 1, std::memory_order_relaxed);
+					}
+
+					outIndex = index;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
@@ -26,7 +26,7 @@ struct OptionalStorage
 
 	template<typename... Args> void construct(Args&&... args)
 	{
-		memset(&contents, 0, sizeof(Contents));
+		memset(static_cast<void*>(&contents), 0, sizeof(Contents));
 		new(&contents) Contents(std::forward<Args>(args)...);
 	}
 
@@ -50,7 +50,7 @@ template<typename Contents> struct OptionalStorage<Contents, true>
 
 	template<typename... Args> void construct(Args&&... args)
 	{
-		memset(&contents, 0, sizeof(Contents));
+		memset(static_cast<void*>(&contents), 0, sizeof(Contents));
 		new(&contents) Contents(std::forward<Args>(args)...);
 	}
 
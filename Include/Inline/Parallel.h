@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Lock.h"
+#include "Platform/Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <vector>
+
+namespace ParallelImpl
+{
+	// The items of a parallelForEach call, and the exception thrown by processing them.
+	struct Job
+	{
+		const std::function<void(Uptr)>& processItem;
+		const Uptr numItems;
+		std::atomic<Uptr> nextItemIndex{0};
+		std::atomic<bool> hasException{false};
+
+		Platform::Mutex exceptionMutex;
+		Uptr exceptionItemIndex = UINTPTR_MAX;
+		std::exception_ptr exception;
+
+		Job(const std::function<void(Uptr)>& inProcessItem, Uptr inNumItems)
+		: processItem(inProcessItem), numItems(inNumItems)
+		{
+		}
+
+		void processItems()
+		{
+			while(!hasException.load(std::memory_order_acquire))
+			{
+				const Uptr itemIndex = nextItemIndex++;
+				if(itemIndex >= numItems) { break; }
+
+				try
+				{
+					processItem(itemIndex);
+				}
+				catch(...)
+				{
+					// Since items are handed out in order, any item with a lower index has already
+					// been started, so the exception for the lowest failing item index is the same
+					// one that processing the items in sequence would have thrown.
+					Lock<Platform::Mutex> exceptionLock(exceptionMutex);
+					if(itemIndex < exceptionItemIndex)
+					{
+						exceptionItemIndex = itemIndex;
+						exception          = std::current_exception();
+					}
+					hasException.store(true, std::memory_order_release);
+				}
+			}
+		}
+	};
+
+	// A thread that waits for a job, helps process its items, and then waits for the next job.
+	// Workers are never destroyed, so their events may be used without synchronizing with the
+	// thread that signals them.
+	struct Worker
+	{
+		Platform::Event startEvent;
+		Platform::Event finishedEvent;
+		Job* job = nullptr;
+
+		static I64 threadEntry(void* workerVoid)
+		{
+			Worker* worker = (Worker*)workerVoid;
+			while(true)
+			{
+				worker->startEvent.wait(UINT64_MAX);
+				worker->job->processItems();
+				worker->finishedEvent.signal();
+			}
+		}
+	};
+
+	// The workers that aren't processing a job. The pool starts empty, and grows to the largest
+	// number of workers that have been used at once, so a process that never calls
+	// parallelForEach with more than one thread doesn't create any.
+	struct WorkerPool
+	{
+		Platform::Mutex mutex;
+		std::vector<Worker*> idleWorkers;
+
+		// The pool is never destroyed, since its workers may still be waiting for a job when the
+		// process exits.
+		static WorkerPool& get()
+		{
+			static WorkerPool* pool = new WorkerPool;
+			return *pool;
+		}
+
+		void acquireWorkers(Uptr numWorkers, std::vector<Worker*>& outWorkers)
+		{
+			{
+				Lock<Platform::Mutex> lock(mutex);
+				while(outWorkers.size() < numWorkers && idleWorkers.size())
+				{
+					outWorkers.push_back(idleWorkers.back());
+					idleWorkers.pop_back();
+				}
+			}
+
+			while(outWorkers.size() < numWorkers)
+			{
+				Worker* worker = new Worker;
+				Platform::detachThread(
+					Platform::createThread(8 * 1024 * 1024, &Worker::threadEntry, worker));
+				outWorkers.push_back(worker);
+			}
+		}
+
+		void releaseWorkers(const std::vector<Worker*>& workers)
+		{
+			Lock<Platform::Mutex> lock(mutex);
+			idleWorkers.insert(idleWorkers.end(), workers.begin(), workers.end());
+		}
+	};
+}
+
+// Calls processItem(itemIndex) for each itemIndex in [0,numItems), using up to maxThreads threads
+// (including the calling thread), and returns once all the items have been processed.
+// Items are handed out to the threads in ascending order. If processing an item throws an
+// exception, no further items are started, and the exception thrown by the lowest item index is
+// rethrown on the calling thread.
+// The threads other than the calling thread are taken from a pool of worker threads that is
+// shared by all calls, so they are only created the first time they are needed.
+inline void parallelForEach(Uptr numItems,
+							Uptr maxThreads,
+							const std::function<void(Uptr itemIndex)>& processItem)
+{
+	const Uptr numThreads
+		= std::min(std::min(maxThreads, Platform::getNumberOfHardwareThreads()), numItems);
+	if(numThreads <= 1)
+	{
+		for(Uptr itemIndex = 0; itemIndex < numItems; ++itemIndex) { processItem(itemIndex); }
+		return;
+	}
+
+	ParallelImpl::Job job(processItem, numItems);
+
+	ParallelImpl::WorkerPool& workerPool = ParallelImpl::WorkerPool::get();
+	std::vector<ParallelImpl::Worker*> workers;
+	workerPool.acquireWorkers(numThreads - 1, workers);
+	for(ParallelImpl::Worker* worker : workers)
+	{
+		worker->job = &job;
+		worker->startEvent.signal();
+	}
+
+	job.processItems();
+
+	for(ParallelImpl::Worker* worker : workers) { worker->finishedEvent.wait(UINT64_MAX); }
+	workerPool.releaseWorkers(workers);
+
+	if(job.exception) { std::rethrow_exception(job.exception); }
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Inline/Assert.h"
+#include "Inline/SharedBytes.h"
 #include "Platform/Platform.h"
 
 #include <string.h>
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -64,6 +66,12 @@ namespace Serialization
 			return std::move(bytes);
 		}
 
+		// Ensures that at least numBytes can be written without growing the output array.
+		void reserve(Uptr numBytes)
+		{
+			if(Uptr(end - next) < numBytes) { extendBuffer(numBytes); }
+		}
+
 	private:
 		std::vector<U8> bytes;
 
@@ -88,7 +96,12 @@ namespace Serialization
 			isInput = true
 		};
 
-		InputStream(const U8* inNext, const U8* inEnd) : next(inNext), end(inEnd) {}
+		InputStream(const U8* inNext,
+					const U8* inEnd,
+					const std::shared_ptr<const void>& inOwner = nullptr)
+		: next(inNext), end(inEnd), owner(inOwner)
+		{
+		}
 
 		virtual Uptr capacity() const = 0;
 
@@ -110,9 +123,41 @@ namespace Serialization
 			return next;
 		}
 
+		// Returns a pointer to the current stream cursor if the current buffer has at least
+		// numBytes following it, or null otherwise. Unlike peek, this never asks for more data.
+		inline const U8* tryPeek(Uptr numBytes) const
+		{
+			return Uptr(end - next) >= numBytes ? next : nullptr;
+		}
+
+		// Advances the stream cursor by numBytes, and returns the bytes that were skipped over. If
+		// the stream reads from memory with an owner, the bytes are referenced instead of copied.
+		inline SharedBytes advanceShared(Uptr numBytes)
+		{
+			const U8* data = advance(numBytes);
+			if(owner) { return SharedBytes(owner, data, numBytes); }
+			else if(!numBytes)
+			{
+				return SharedBytes();
+			}
+			else
+			{
+				// Copy the bytes directly into the shared vector instead of moving a temporary
+				// vector into it. GCC can't tell that the moved-from temporary no longer owns a
+				// buffer, and warns that its destructor frees a pointer into the stream.
+				auto copy = std::make_shared<const std::vector<U8>>(data, data + numBytes);
+				return SharedBytes(copy, copy->data(), copy->size());
+			}
+		}
+
+		// The owner of the memory the stream reads from, or null if the stream's memory isn't
+		// shared.
+		const std::shared_ptr<const void>& getOwner() const { return owner; }
+
 	protected:
 		const U8* next;
 		const U8* end;
+		std::shared_ptr<const void> owner;
 
 		// Called when there isn't enough space in the buffer to satisfy a read from the stream.
 		// Should update next and end to point to a new buffer, and ensure that the new
@@ -123,7 +168,16 @@ namespace Serialization
 	// An input stream that reads from a contiguous range of memory.
 	struct MemoryInputStream : InputStream
 	{
-		MemoryInputStream(const U8* begin, Uptr numBytes) : InputStream(begin, begin + numBytes) {}
+		MemoryInputStream(const U8* begin,
+						  Uptr numBytes,
+						  const std::shared_ptr<const void>& owner = nullptr)
+		: InputStream(begin, begin + numBytes, owner)
+		{
+		}
+		MemoryInputStream(const SharedBytes& bytes)
+		: InputStream(bytes.begin(), bytes.end(), bytes.getOwner())
+		{
+		}
 		virtual Uptr capacity() const { return end - next; }
 
 	private:
@@ -219,22 +273,64 @@ namespace Serialization
 									 Value minValue,
 									 Value maxValue)
 	{
-		// First, read the variable number of input bytes into a fixed size buffer.
 		enum
 		{
 			maxBytes = (maxBits + 6) / 7
 		};
-		U8 bytes[maxBytes] = {0};
-		Uptr numBytes      = 0;
-		I8 signExtendShift = (I8)sizeof(Value) * 8;
-		while(numBytes < maxBytes)
+		Uptr numBytes = 0;
+		U8 lastByte   = 0;
+		U64 bits      = 0;
+
+		// If there are at least 8 bytes left in the stream's buffer, load them as a little-endian
+		// word, and find the first byte without a continuation bit (the terminator) using bitwise
+		// operations instead of a loop. The 7 payload bits of each byte are then compacted into a
+		// contiguous integer in three steps, each of which merges pairs of adjacent bit groups.
+		const U8* peekedBytes = maxBytes > 1 ? stream.tryPeek(8) : nullptr;
+		U64 word              = 0;
+		if(peekedBytes) { memcpy(&word, peekedBytes, sizeof(word)); }
+		const U64 terminatorMask = ~word & 0x8080808080808080ull;
+		if(peekedBytes && terminatorMask)
+		{ numBytes = (Platform::countTrailingZeroes(terminatorMask) + 1) / 8; }
+		if(numBytes == 1)
 		{
-			U8 byte         = *stream.advance(1);
-			bytes[numBytes] = byte;
-			++numBytes;
-			signExtendShift -= 7;
-			if(!(byte & 0x80)) { break; }
-		};
+			// Most encodings are a single byte, which doesn't need its bits to be compacted.
+			stream.advance(1);
+			bits = word & 0x7f;
+		}
+		else if(numBytes && numBytes <= maxBytes)
+		{
+			stream.advance(numBytes);
+
+			// Only the final byte of a maximum length encoding has unused bits that need to be
+			// validated.
+			if(numBytes == maxBytes) { lastByte = U8(word >> ((numBytes - 1) * 8)); }
+
+			bits = word & 0x7f7f7f7f7f7f7f7full;
+			if(numBytes < 8) { bits &= (U64(1) << (numBytes * 8)) - 1; }
+			bits = ((bits & 0x7f007f007f007f00ull) >> 1) | (bits & 0x007f007f007f007full);
+			bits = ((bits & 0x3fff00003fff0000ull) >> 2) | (bits & 0x00003fff00003fffull);
+			bits = ((bits & 0x0fffffff00000000ull) >> 4) | (bits & 0x000000000fffffffull);
+		}
+		else
+		{
+			// Otherwise, read the variable number of input bytes into a fixed size buffer. This
+			// also handles encodings that are longer than maxBytes, and 64-bit encodings longer
+			// than 8 bytes.
+			U8 bytes[maxBytes] = {0};
+			numBytes           = 0;
+			while(numBytes < maxBytes)
+			{
+				U8 byte         = *stream.advance(1);
+				bytes[numBytes] = byte;
+				++numBytes;
+				if(!(byte & 0x80)) { break; }
+			};
+			lastByte = bytes[maxBytes - 1];
+
+			// Decode the buffer's bytes into an integer.
+			for(Uptr byteIndex = 0; byteIndex < maxBytes; ++byteIndex)
+			{ bits |= U64(bytes[byteIndex] & ~0x80) << (byteIndex * 7); }
+		}
 
 		// Ensure that the input does not encode more than maxBits of data.
 		enum
@@ -245,7 +341,6 @@ namespace Serialization
 			lastByteUsedMask      = U8(1 << numUsedBitsInLastByte) - U8(1),
 			lastByteSignedMask    = U8(~U8(lastByteUsedMask) & ~U8(0x80))
 		};
-		const U8 lastByte = bytes[maxBytes - 1];
 		if(!std::is_signed<Value>::value)
 		{
 			if((lastByte & ~lastByteUsedMask) != 0)
@@ -266,12 +361,9 @@ namespace Serialization
 			}
 		}
 
-		// Decode the buffer's bytes into the output integer.
-		value = 0;
-		for(Uptr byteIndex = 0; byteIndex < maxBytes; ++byteIndex)
-		{ value |= Value(Uptr(bytes[byteIndex] & ~0x80) << (byteIndex * 7)); }
-
 		// Sign extend the output integer to the full size of Value.
+		value                    = Value(bits);
+		const I8 signExtendShift = I8(sizeof(Value) * 8 - numBytes * 7);
 		if(std::is_signed<Value>::value && signExtendShift > 0)
 		{ value = Value(value << signExtendShift) >> signExtendShift; }
 
@@ -359,6 +451,20 @@ namespace Serialization
 		}
 	}
 
+	inline void serialize(InputStream& stream, SharedBytes& bytes)
+	{
+		Uptr numBytes = 0;
+		serializeVarUInt32(stream, numBytes);
+		bytes = stream.advanceShared(numBytes);
+	}
+
+	inline void serialize(OutputStream& stream, const SharedBytes& bytes)
+	{
+		Uptr numBytes = bytes.size();
+		serializeVarUInt32(stream, numBytes);
+		serializeBytes(stream, bytes.data(), numBytes);
+	}
+
 	template<typename Stream, typename Element, typename Allocator, typename SerializeElement>
 	void serializeArray(Stream& stream,
 						std::vector<Element, Allocator>& vector,
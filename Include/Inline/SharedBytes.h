@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+
+#include <string.h>
+#include <memory>
+#include <vector>
+
+// An immutable range of bytes that shares ownership of the memory containing it. This allows it to
+// reference part of a larger buffer, e.g. a memory-mapped file, without copying it, and to be
+// copied without copying the bytes.
+struct SharedBytes
+{
+	SharedBytes() : bytes(nullptr), numBytes(0) {}
+
+	// Takes ownership of a vector's bytes.
+	SharedBytes(std::vector<U8>&& inVector)
+	{
+		if(inVector.size())
+		{
+			auto vector = std::make_shared<std::vector<U8>>(std::move(inVector));
+			bytes       = vector->data();
+			numBytes    = vector->size();
+			owner       = std::move(vector);
+		}
+		else
+		{
+			bytes    = nullptr;
+			numBytes = 0;
+		}
+	}
+	SharedBytes(const std::vector<U8>& inVector) : SharedBytes(std::vector<U8>(inVector)) {}
+
+	// References bytes in memory that is kept alive by owner.
+	SharedBytes(const std::shared_ptr<const void>& inOwner, const U8* inBytes, Uptr inNumBytes)
+	: owner(inOwner), bytes(inBytes), numBytes(inNumBytes)
+	{
+	}
+
+	const U8* data() const { return bytes; }
+	const U8* begin() const { return bytes; }
+	const U8* end() const { return bytes + numBytes; }
+	Uptr size() const { return numBytes; }
+	bool empty() const { return numBytes == 0; }
+
+	U8 operator[](Uptr index) const
+	{
+		wavmAssert(index < numBytes);
+		return bytes[index];
+	}
+
+	const std::shared_ptr<const void>& getOwner() const { return owner; }
+
+	// Returns a subrange of the bytes that shares ownership of them.
+	SharedBytes getSubrange(Uptr offset, Uptr numSubrangeBytes) const
+	{
+		wavmAssert(offset <= numBytes && numSubrangeBytes <= numBytes - offset);
+		return SharedBytes(owner, bytes + offset, numSubrangeBytes);
+	}
+
+	friend bool operator==(const SharedBytes& left, const SharedBytes& right)
+	{
+		return left.numBytes == right.numBytes
+			   && (!left.numBytes || !memcmp(left.bytes, right.bytes, left.numBytes));
+	}
+	friend bool operator!=(const SharedBytes& left, const SharedBytes& right)
+	{
+		return !(left == right);
+	}
+
+private:
+	std::shared_ptr<const void> owner;
+	const U8* bytes;
+	Uptr numBytes;
+};
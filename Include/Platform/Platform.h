@@ -177,6 +177,23 @@ namespace Platform
 											  Uptr numPages,
 											  Uptr alignmentLog2);
 
+	// An immutable sequence of pages that can be mapped copy-on-write into virtual memory, so the
+	// physical pages are shared until they are written.
+	struct MappableImage;
+
+	// Creates a MappableImage containing a copy of the specified bytes, padded with zeroes to a
+	// whole number of pages. Returns nullptr if the platform doesn't support mappable images.
+	PLATFORM_API MappableImage* createMappableImage(const U8* bytes, Uptr numBytes);
+	PLATFORM_API void destroyMappableImage(MappableImage* image);
+
+	// Maps pages of a MappableImage copy-on-write to the specified virtual pages with read-write
+	// access, replacing any physical memory that was committed to them. baseVirtualAddress must be
+	// a multiple of the preferred page size. Returns true if successful.
+	PLATFORM_API bool mapImagePages(MappableImage* image,
+									Uptr imagePageIndex,
+									U8* baseVirtualAddress,
+									Uptr numPages);
+
 	//
 	// Error reporting
 	//
@@ -204,12 +221,31 @@ namespace Platform
 		std::vector<Frame> stackFrames;
 	};
 
-	// Captures the execution context of the caller.
-	PLATFORM_API CallStack captureCallStack(Uptr numOmittedFramesFromTop = 0);
+	// Captures the execution context of the caller, up to maxFrames frames.
+	PLATFORM_API CallStack captureCallStack(Uptr numOmittedFramesFromTop = 0,
+											Uptr maxFrames              = UINTPTR_MAX);
+
+	// Sets the maximum number of frames captured in the call stack passed to signal filters and
+	// platform exception handlers. 0 disables call stack capture, and UINTPTR_MAX (the default)
+	// captures the full call stack.
+	PLATFORM_API void setSignalCallStackMaxFrames(Uptr maxFrames);
 
 	// Describes an instruction pointer.
 	PLATFORM_API bool describeInstructionPointer(Uptr ip, std::string& outDescription);
 
+	// Starts interrupting the process every intervalMicroseconds of CPU time to record a sample of
+	// the interrupted thread's call stack. Only the calling thread and threads created by
+	// createThread while sampling is active are sampled. The call stacks are walked using frame
+	// pointers, so the callers of code that doesn't maintain a frame pointer may be omitted.
+	// Returns false if sampling isn't supported on this platform.
+	PLATFORM_API bool startSampling(Uptr intervalMicroseconds);
+	PLATFORM_API void stopSampling();
+
+	// Calls visitSample for each call stack sample recorded since the last call to readSamples.
+	// The first frame of a sample is the interrupted instruction, and the rest are return
+	// addresses. Samples are dropped if a thread records them faster than they are read.
+	PLATFORM_API void readSamples(const std::function<void(const CallStack&)>& visitSample);
+
 	PLATFORM_API void registerEHFrames(const U8* imageBase, const U8* ehFrames, Uptr numBytes);
 	PLATFORM_API void deregisterEHFrames(const U8* imageBase, const U8* ehFrames, Uptr numBytes);
 
@@ -277,6 +313,13 @@ namespace Platform
 
 	RETURNS_TWICE PLATFORM_API Thread* forkCurrentThread();
 
+	// Returns the number of threads the host can run concurrently.
+	PLATFORM_API Uptr getNumberOfHardwareThreads();
+
+	// Gives up the rest of the calling thread's time slice if another thread is ready to run, e.g.
+	// while spinning to wait for another thread.
+	PLATFORM_API void yieldToAnotherThread();
+
 	// Returns the current value of a clock that may be used as an absolute time for wait timeouts.
 	// The resolution is microseconds, and the origin is arbitrary.
 	PLATFORM_API U64 getMonotonicClock();
@@ -349,6 +392,7 @@ namespace Platform
 		{
 			Uptr data[6];
 		} pthreadCond;
+		bool isSignaled;
 #elif defined(__APPLE__)
 		struct PthreadMutex
 		{
@@ -358,11 +402,33 @@ namespace Platform
 		{
 			Uptr data[6];
 		} pthreadCond;
+		bool isSignaled;
 #else
 #error unsupported platform
 #endif
 	};
 
+	// The result of waiting directly on an address with waitOnAddress32.
+	enum class AddressWaitResult
+	{
+		woken,
+		notEqual,
+		timedOut,
+		unsupported,
+	};
+
+	// Blocks the calling thread on a 32-bit address using the OS's native address-keyed wait
+	// primitive (a futex on Linux). Returns notEqual immediately if the value at the address isn't
+	// expectedValue, with the comparison being atomic with respect to wakeAddress32. Returns
+	// unsupported without blocking if the OS doesn't provide such a primitive.
+	PLATFORM_API AddressWaitResult waitOnAddress32(const U32* address,
+												   U32 expectedValue,
+												   U64 untilClock);
+
+	// Wakes up to numToWake threads blocked in waitOnAddress32 on the address, and returns the
+	// number of threads that were woken. numToWake==UINT32_MAX wakes all waiting threads.
+	PLATFORM_API Uptr wakeAddress32(const U32* address, U32 numToWake);
+
 	//
 	// File I/O
 	//
@@ -416,5 +482,10 @@ namespace Platform
 								Uptr numBytes,
 								Uptr* outNumBytesWritten = nullptr);
 	PLATFORM_API bool flushFileWrites(File* file);
+
+	// Maps the first numBytes of a file into memory as read-only. The mapping remains valid after
+	// the file is closed, until it is unmapped. Returns nullptr if the file couldn't be mapped.
+	PLATFORM_API const U8* mapFile(File* file, Uptr numBytes);
+	PLATFORM_API void unmapFile(const U8* bytes, Uptr numBytes);
 	PLATFORM_API std::string getCurrentWorkingDirectory();
 }
@@ -33,13 +33,57 @@ namespace Intrinsics
 							 Runtime::CallingConvention inCallingConvention);
 		RUNTIME_API Runtime::FunctionInstance* instantiate(Runtime::Compartment* compartment);
 
+		const char* getName() const { return name; }
+		IR::FunctionType getType() const { return type; }
+		void* getNativeFunction() const { return nativeFunction; }
+		Runtime::CallingConvention getCallingConvention() const { return callingConvention; }
+
+		// An optional LLVM bitcode body for the function. The JIT links it into modules that call
+		// the function when the binding is known at compile time, so LLVM may inline it. The
+		// bitcode must define an external function with the same name as the intrinsic, and the
+		// LLVM signature of the native function. It may also be given as null-terminated LLVM
+		// assembly text, which is parsed by the same version of LLVM that compiles the module.
+		void setBitcode(const U8* inBitcode, Uptr inNumBitcodeBytes)
+		{
+			bitcode         = inBitcode;
+			numBitcodeBytes = inNumBitcodeBytes;
+		}
+		const U8* getBitcode() const { return bitcode; }
+		Uptr getNumBitcodeBytes() const { return numBitcodeBytes; }
+
 	private:
 		const char* name;
 		IR::FunctionType type;
 		void* nativeFunction;
 		Runtime::CallingConvention callingConvention;
+		const U8* bitcode;
+		Uptr numBitcodeBytes;
+	};
+
+	// Sets the bitcode body of an intrinsic function during static initialization.
+	struct FunctionBitcode
+	{
+		FunctionBitcode(Function& function, const U8* bitcode, Uptr numBitcodeBytes)
+		{
+			function.setBitcode(bitcode, numBitcodeBytes);
+		}
 	};
 
+	// Looks up an intrinsic function by name without instantiating it. Returns null if the module
+	// doesn't contain a function with the name.
+	RUNTIME_API const Function* getUninstantiatedFunction(const Intrinsics::Module& moduleRef,
+														  const std::string& name);
+
+	// Compiles a module, inlining the bitcode bodies of the intrinsic functions its function
+	// imports will be bound to. importModules maps the module names used by the imports to the
+	// intrinsic modules that they will be bound to. Only imports of intrinsic functions that have
+	// bitcode and use CallingConvention::intrinsic are inlined, and instantiateModule checks that
+	// each of those imports is bound to the intrinsic function it was compiled against. The module
+	// is compiled as written, without removing its unreachable code.
+	RUNTIME_API Runtime::CompiledModuleRef compileModule(
+		const IR::Module& module,
+		const HashMap<std::string, const Intrinsics::Module*>& importModules);
+
 	// The base class of Intrinsic globals.
 	struct Global
 	{
@@ -197,6 +241,13 @@ namespace Intrinsics
 	static Intrinsics::ResultInContextRuntimeData<Result>* cName(                                  \
 		Runtime::ContextRuntimeData* contextRuntimeData, ##__VA_ARGS__)
 
+// Attaches an LLVM bitcode body to an intrinsic function defined in the same translation unit.
+// bitcodeBytes must be an array, e.g. generated from the output of clang -emit-llvm, or a string of
+// LLVM assembly text.
+#define DEFINE_INTRINSIC_FUNCTION_BITCODE(cName, bitcodeBytes)                                     \
+	static Intrinsics::FunctionBitcode cName##Bitcode(                                             \
+		cName##Intrinsic, (const U8*)bitcodeBytes, sizeof(bitcodeBytes));
+
 // Macros for defining intrinsic globals, memories, and tables.
 #define DEFINE_INTRINSIC_GLOBAL(module, name, Value, cName, initializer)                           \
 	static Intrinsics::GenericGlobal<Value> cName(getIntrinsicModule_##module(), name, initializer);
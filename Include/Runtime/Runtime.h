@@ -6,6 +6,8 @@
 #include "Inline/BasicTypes.h"
 #include "Platform/Platform.h"
 
+#include <memory>
+
 #ifndef RUNTIME_API
 #define RUNTIME_API DLL_IMPORT
 #endif
@@ -146,6 +148,14 @@ namespace Runtime
 	// Frees objects that are unreachable from root object references.
 	RUNTIME_API void collectGarbage();
 
+	// Frees objects owned by the compartment that are unreachable from root object references. Only
+	// the compartment's objects are scanned, so the pause time is proportional to the number of
+	// objects in the compartment rather than the number of objects in the process. Objects outside
+	// the compartment are never freed by this, and objects in the compartment are assumed to only
+	// be referenced from outside the compartment through root references. The compartment itself
+	// is kept alive: use collectGarbage to free unreferenced compartments.
+	RUNTIME_API void collectCompartmentGarbage(Compartment* compartment);
+
 	//
 	// Exceptions
 	//
@@ -200,6 +210,13 @@ namespace Runtime
 	// Describes a call stack.
 	RUNTIME_API std::vector<std::string> describeCallStack(const Platform::CallStack& callStack);
 
+	// Sets the maximum number of frames captured in Exception::callStack when a runtime exception
+	// is thrown or a trap occurs. Capturing the call stack requires unwinding it, which dominates
+	// the cost of exceptions that are thrown and caught in a loop. 0 disables call stack capture,
+	// and UINTPTR_MAX (the default) captures the full call stack. The frames aren't symbolized
+	// until describeCallStack or describeException is called.
+	RUNTIME_API void setExceptionCallStackMaxFrames(Uptr maxFrames);
+
 	//
 	// Functions
 	//
@@ -230,9 +247,42 @@ namespace Runtime
 													 FunctionInstance* function,
 													 const std::vector<IR::Value>& arguments);
 
+	// Invokes a FunctionInstance numInvokes times, entering generated code once for the whole
+	// batch. arguments holds a tuple of the function's parameters for each invoke, and results
+	// receives a tuple of the function's results for each invoke, with each tuple packed as
+	// consecutive UntaggedValues. Returns the number of invokes that completed: if it's less than
+	// numInvokes, the invoke at that index threw a runtime exception, and the exception is written
+	// to outException if it's non-null.
+	RUNTIME_API Uptr invokeFunctionBatch(Context* context,
+										 FunctionInstance* function,
+										 const IR::UntaggedValue* arguments,
+										 IR::UntaggedValue* results,
+										 Uptr numInvokes,
+										 Exception* outException = nullptr);
+
 	// Returns the type of a FunctionInstance.
 	RUNTIME_API IR::FunctionType getFunctionType(FunctionInstance* function);
 
+	// An invoke thunk calls a function with arguments read from the start of contextRuntimeData,
+	// each in an 8-byte slot, and writes the function's results to the start of the
+	// ContextRuntimeData that it returns.
+	typedef struct ContextRuntimeData* (*InvokeThunkPointer)(
+		void* nativeFunction,
+		struct ContextRuntimeData* contextRuntimeData);
+
+	// Returns the invoke thunk for a FunctionInstance, and the native code pointer to pass to it.
+	// This is the low-level interface used by TypedFunction to avoid looking up the thunk on every
+	// call.
+	RUNTIME_API InvokeThunkPointer getFunctionInvokeThunk(FunctionInstance* function,
+														  void*& outNativeFunction);
+
+	// Calls an invoke thunk returned by getFunctionInvokeThunk with the arguments already stored in
+	// the context's ContextRuntimeData. Like invokeFunctionUnchecked, the invoke is counted by the
+	// context's compartment, and runtime exceptions it raises are attributed to the compartment.
+	RUNTIME_API struct ContextRuntimeData* callInvokeThunk(Context* context,
+														   InvokeThunkPointer invokeThunk,
+														   void* nativeFunction);
+
 	//
 	// Tables
 	//
@@ -300,6 +350,78 @@ namespace Runtime
 		return (Value*)getValidatedMemoryOffsetRange(memory, offset, numElements * sizeof(Value));
 	}
 
+	// A range of elements in a memory that was validated when it was created, so the elements
+	// may be accessed without further bounds checks.
+	template<typename Value> struct MemorySpan
+	{
+		MemorySpan() : data(nullptr), numElements(0) {}
+		MemorySpan(Value* inData, Uptr inNumElements) : data(inData), numElements(inNumElements) {}
+
+		Value* begin() const { return data; }
+		Value* end() const { return data + numElements; }
+		Uptr size() const { return numElements; }
+
+		Value& operator[](Uptr index) const
+		{
+			wavmAssert(index < numElements);
+			return data[index];
+		}
+
+	private:
+		Value* data;
+		Uptr numElements;
+	};
+
+	// Validates an access to multiple elements of memory at the given offset, and returns a span
+	// of them.
+	template<typename Value>
+	MemorySpan<Value> memorySpan(MemoryInstance* memory, Uptr offset, Uptr numElements)
+	{
+		if(numElements > UINTPTR_MAX / sizeof(Value))
+		{ throwException(Exception::accessViolationType); }
+		return MemorySpan<Value>(memoryArrayPtr<Value>(memory, offset, numElements), numElements);
+	}
+
+	// Validates a NUL-terminated string in memory at the given offset, and returns a span of its
+	// characters, not including the NUL. Throws accessViolation if there's no NUL between the
+	// offset and the end of the memory.
+	RUNTIME_API MemorySpan<const char> memoryStringSpan(MemoryInstance* memory, Uptr offset);
+
+	// Copies a NUL-terminated string out of memory.
+	inline std::string readMemoryString(MemoryInstance* memory, Uptr offset)
+	{
+		MemorySpan<const char> span = memoryStringSpan(memory, offset);
+		return std::string(span.begin(), span.size());
+	}
+
+	// The layout of an iovec in the memory of a 32-bit WebAssembly program.
+	struct GuestIoVec
+	{
+		U32 address;
+		U32 numBytes;
+	};
+
+	// A buffer in a memory, with the same layout as a POSIX struct iovec.
+	struct MemoryIoVec
+	{
+		void* base;
+		Uptr numBytes;
+	};
+
+	// The maximum number of iovecs in a single readv/writev call: the IOV_MAX of Linux. Callers of
+	// getMemoryIoVecs should reject larger counts before allocating the MemoryIoVec array.
+	static constexpr Uptr maxMemoryIoVecs = 1024;
+
+	// Reads an array of numIoVecs GuestIoVecs from memory at the given offset, validates the
+	// buffers they point to, and writes a MemoryIoVec for each to outIoVecs. The result may be
+	// passed to readv/writev/sendmsg as an array of struct iovec. Returns the total number of
+	// bytes in the buffers. Throws invalidArgument if numIoVecs is greater than maxMemoryIoVecs,
+	// and accessViolation if the array or any of the buffers isn't in the memory.
+	RUNTIME_API Uptr getMemoryIoVecs(MemoryInstance* memory,
+									 Uptr ioVecsOffset,
+									 Uptr numIoVecs,
+									 MemoryIoVec* outIoVecs);
+
 	//
 	// Globals
 	//
@@ -332,8 +454,63 @@ namespace Runtime
 		std::vector<ExceptionTypeInstance*> exceptionTypes;
 	};
 
-	// Instantiates a module, bindings its imports to the specified objects. May throw a runtime
-	// exception for bad segment offsets.
+	// A module that has been compiled to machine code that may be instantiated any number of
+	// times, in any compartment.
+	struct CompiledModule;
+	typedef std::shared_ptr<const CompiledModule> CompiledModuleRef;
+
+	// The ways the functions of a compiled module may be executed. The interpreter translates each
+	// function the first time it is called instead of compiling it to machine code, so the bodies
+	// of interpreted functions aren't compiled by LLVM, but they run much slower. Interpreted and
+	// compiled code may call each other, and share the same memories, tables, and globals, so
+	// compiling a module for the interpreter still uses LLVM: each interpreted function gets a
+	// small compiled stub that calls the interpreter, and calls between interpreted functions in
+	// different modules or through tables go through the JIT's invoke thunks. Functions that use
+	// operators the interpreter doesn't support are compiled to machine code.
+	enum class ExecutionBackend
+	{
+		jit,
+		interpreter
+	};
+
+	// Options that control how compileModule compiles a module.
+	struct CompileOptions
+	{
+		ExecutionBackend backend = ExecutionBackend::jit;
+
+		// Allows LLVM to inline calls between the module's function definitions. This makes
+		// compiling slower, so it is off by default. It is meant for modules created by
+		// IR::linkModules, where calls that crossed module boundaries before linking become calls
+		// between function definitions. An inlined function doesn't appear in call stacks.
+		bool inlineFunctionDefs = false;
+
+		// Removes unreachable code and unused declarations from the compiled copy of the module
+		// with IR::optimizeModule before compiling it. Functions that can't be reached from the
+		// module's exports, start function, or table segments then aren't compiled, and trap if
+		// they are called.
+		bool optimizeModule = true;
+	};
+
+	// Compiles a module with the given options. The module must be valid.
+	RUNTIME_API CompiledModuleRef compileModule(const IR::Module& module,
+												const CompileOptions& options);
+
+	// Compiles a module for the given execution backend, with the default options otherwise.
+	RUNTIME_API CompiledModuleRef compileModule(const IR::Module& module,
+												ExecutionBackend backend = ExecutionBackend::jit);
+
+	// Instantiates a compiled module, bindings its imports to the specified objects. May throw a
+	// runtime exception for bad segment offsets.
+	// This skips generating and optimizing the module's LLVM IR, but each instance still loads its
+	// own copy of the compiled object code with RuntimeDyld. Loading relocates and links the code
+	// to the instance's imports, memories, tables, and globals, and registers its unwind info.
+	RUNTIME_API ModuleInstance* instantiateModule(Compartment* compartment,
+												  CompiledModuleRef compiledModule,
+												  ImportBindings&& imports,
+												  std::string&& debugName);
+
+	// Compiles and instantiates a module, bindings its imports to the specified objects. May throw
+	// a runtime exception for bad segment offsets.
 	RUNTIME_API ModuleInstance* instantiateModule(Compartment* compartment,
 												  const IR::Module& module,
 												  ImportBindings&& imports,
@@ -357,16 +534,72 @@ namespace Runtime
 
 	RUNTIME_API Compartment* cloneCompartment(Compartment* compartment);
 
+	// Statistics about the resources used by a compartment, and the work done in it.
+	struct CompartmentStatistics
+	{
+		// The number of objects owned by the compartment, indexed by ObjectKind. This includes the
+		// FunctionInstances that have been created for the compartment's module instances.
+		Uptr numObjectsByKind[Uptr(ObjectKind::compartment) + 1];
+
+		// The number of WebAssembly pages committed by the compartment's memories, and the number
+		// of elements in the compartment's tables.
+		Uptr numMemoryPages;
+		Uptr numTableElements;
+
+		// The number of bytes allocated for the code and data of the compartment's module
+		// instances.
+		Uptr numJITCodeBytes;
+		Uptr numJITDataBytes;
+
+		// The number of functions invoked by invokeFunctionUnchecked, invokeFunctionChecked,
+		// invokeFunctionBatch, and TypedFunction.
+		U64 numInvokes;
+
+		// The number of runtime exceptions raised by invokes in the compartment, by exception type.
+		std::vector<std::pair<std::string, U64>> numTrapsByExceptionType;
+
+		// The number of times WebAssembly code in the compartment has executed grow_memory.
+		U64 numGrowMemoryCalls;
+
+		// The total time spent collecting garbage in the compartment, by both collectGarbage and
+		// collectCompartmentGarbage.
+		U64 gcPauseMicroseconds;
+	};
+
+	// Gets statistics about a compartment. The counters are updated without synchronization, so
+	// a snapshot may not be consistent with concurrent activity in the compartment.
+	RUNTIME_API CompartmentStatistics getStatistics(Compartment* compartment);
+
 	//
 	// Contexts
 	//
 
+	// Creates a context. Throws outOfMemory if the compartment has the maximum number of contexts.
 	RUNTIME_API Context* createContext(Compartment* compartment);
 	RUNTIME_API Compartment* getCompartmentFromContext(Context* context);
 
+	// Restores the values of a context's mutable globals to their initial values, without
+	// reallocating the context.
+	RUNTIME_API void resetContext(Context* context);
+
 	// Creates a new context, initializing its mutable global state from the given context.
 	RUNTIME_API Context* cloneContext(Context* context, Compartment* newCompartment);
 
+	// A pool of reset contexts for a compartment, for embedders that execute each request in a
+	// fresh context. The pool holds a GC root on the compartment and the contexts in it until it is
+	// destroyed. It may be used by multiple threads.
+	struct ContextPool;
+	RUNTIME_API ContextPool* createContextPool(Compartment* compartment, Uptr maxPooledContexts);
+	RUNTIME_API void destroyContextPool(ContextPool* pool);
+
+	// Takes a context from the pool, or creates a new context if the pool is empty. Like
+	// createContext, the returned context isn't rooted.
+	RUNTIME_API Context* acquireContext(ContextPool* pool);
+
+	// Resets a context and returns it to the pool. If the pool already has maxPooledContexts
+	// contexts, the context is left to the garbage collector.
+	RUNTIME_API void releaseContext(ContextPool* pool, Context* context);
+
 	RUNTIME_API Context* getContextFromRuntimeData(struct ContextRuntimeData* contextRuntimeData);
 	RUNTIME_API struct ContextRuntimeData* getContextRuntimeData(Context* context);
 	RUNTIME_API TableInstance* getTableFromRuntimeData(
@@ -375,4 +608,19 @@ namespace Runtime
 	RUNTIME_API MemoryInstance* getMemoryFromRuntimeData(
 		struct ContextRuntimeData* contextRuntimeData,
 		Uptr memoryId);
+
+	//
+	// Profiling
+	//
+
+	// Starts sampling the call stack of the calling thread, and of threads created by
+	// Platform::createThread while profiling, every intervalMicroseconds of CPU time. Returns false
+	// if profiling is already started, or isn't supported on this platform.
+	RUNTIME_API bool startProfiling(Uptr intervalMicroseconds = 1000);
+
+	// Stops profiling, and returns the samples in the folded stack format used by flame graph
+	// tools: a line for each distinct call stack, with its frames from outermost to innermost
+	// separated by semicolons, followed by a space and the number of samples of it. WebAssembly
+	// frames are described by their module, function, and operator index.
+	RUNTIME_API std::string stopProfiling();
 }
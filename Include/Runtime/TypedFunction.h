@@ -0,0 +1,83 @@
+#pragma once
+
+#include "IR/Types.h"
+#include "Inline/BasicTypes.h"
+#include "Runtime.h"
+
+#include <string.h>
+
+namespace Runtime
+{
+	// Stores an argument in the invoke thunk argument slots at the start of a ContextRuntimeData.
+	template<typename Arg>
+	inline void storeInvokeArgument(ContextRuntimeData* contextRuntimeData,
+									Uptr& argIndex,
+									Arg argument)
+	{
+		memcpy(reinterpret_cast<U8*>(contextRuntimeData) + argIndex++ * 8, &argument, sizeof(Arg));
+	}
+
+	// Loads the result of an invoke thunk from the start of a ContextRuntimeData.
+	template<typename Result>
+	inline Result loadInvokeResult(ContextRuntimeData* contextRuntimeData)
+	{
+		Result result;
+		memcpy(&result, contextRuntimeData, sizeof(Result));
+		return result;
+	}
+	template<> inline void loadInvokeResult<void>(ContextRuntimeData* contextRuntimeData) {}
+
+	// A FunctionInstance bound to a statically known signature, e.g. TypedFunction<I32(I32, F64)>.
+	// The signature is checked once when the TypedFunction is created, and the invoke thunk is
+	// cached, so calls don't allocate or check the argument types. Like invokeFunctionUnchecked,
+	// calls may throw runtime exceptions.
+	template<typename Signature> struct TypedFunction;
+
+	template<typename Result, typename... Args> struct TypedFunction<Result(Args...)>
+	{
+		// Arguments are passed in the 8-byte slots of ContextRuntimeData::thunkArgAndReturnData,
+		// which is 256 bytes.
+		static_assert(sizeof...(Args) <= 32, "TypedFunction supports at most 32 arguments");
+
+		TypedFunction() : function(nullptr), invokeThunk(nullptr), nativeFunction(nullptr) {}
+
+		// Binds the TypedFunction to a FunctionInstance. Throws invokeSignatureMismatch if the
+		// function's type doesn't match the signature.
+		TypedFunction(FunctionInstance* inFunction)
+		: function(inFunction), invokeThunk(nullptr), nativeFunction(nullptr)
+		{
+			if(getFunctionType(function) != getType())
+			{ throwException(Exception::invokeSignatureMismatchType); }
+			invokeThunk = getFunctionInvokeThunk(function, nativeFunction);
+		}
+
+		Result operator()(Context* context, Args... args) const
+		{
+			wavmAssert(function);
+
+			// Write the arguments directly into the context's invoke thunk argument slots.
+			ContextRuntimeData* contextRuntimeData = getContextRuntimeData(context);
+			Uptr argIndex                          = 0;
+			int dummy[] = {0, (storeInvokeArgument(contextRuntimeData, argIndex, args), 0)...};
+			(void)dummy;
+			(void)argIndex;
+
+			// Call the invoke thunk, and read the result from the ContextRuntimeData it returns.
+			contextRuntimeData = callInvokeThunk(context, invokeThunk, nativeFunction);
+			return loadInvokeResult<Result>(contextRuntimeData);
+		}
+
+		FunctionInstance* getFunction() const { return function; }
+
+		static IR::FunctionType getType()
+		{
+			return IR::FunctionType(IR::inferResultType<Result>(),
+									IR::TypeTuple({IR::inferValueType<Args>()...}));
+		}
+
+	private:
+		FunctionInstance* function;
+		InvokeThunkPointer invokeThunk;
+		void* nativeFunction;
+	};
+}
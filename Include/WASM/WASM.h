@@ -6,6 +6,8 @@
 
 #include "Inline/BasicTypes.h"
 
+#include <functional>
+
 namespace IR
 {
 	struct Module;
@@ -20,4 +22,33 @@ namespace WASM
 {
 	WASM_API void serialize(Serialization::InputStream& stream, IR::Module& module);
 	WASM_API void serialize(Serialization::OutputStream& stream, const IR::Module& module);
+
+	struct StreamingDecoderImpl;
+
+	// Decodes a binary module from bytes that are added incrementally, e.g. as they are read from
+	// a file or network. Each section is decoded and validated as soon as all of its bytes have
+	// been added, and the code section is decoded and validated a function body at a time.
+	// addBytes and finish throw the same exceptions as serialize.
+	struct StreamingDecoder
+	{
+		// onFunctionDefDecoded is called with the index of each function definition as soon as
+		// its body has been decoded and validated.
+		WASM_API StreamingDecoder(IR::Module& outModule,
+								  std::function<void(Uptr functionDefIndex)>&& onFunctionDefDecoded
+								  = nullptr);
+		WASM_API ~StreamingDecoder();
+
+		StreamingDecoder(const StreamingDecoder&) = delete;
+		StreamingDecoder& operator=(const StreamingDecoder&) = delete;
+
+		// Adds the next bytes of the module, and decodes any sections or function bodies that
+		// are complete.
+		WASM_API void addBytes(const U8* bytes, Uptr numBytes);
+
+		// Checks that the bytes added form a complete module.
+		WASM_API void finish();
+
+	private:
+		StreamingDecoderImpl* impl;
+	};
 }
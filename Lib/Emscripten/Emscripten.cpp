@@ -221,7 +221,7 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env, "___ctype_b_loc", I32, ___ctyp
 	if(vmAddress == 0)
 	{
 		vmAddress = coerce32bitAddress(dynamicAlloc(memory, sizeof(data)));
-		memcpy(memoryArrayPtr<U8>(memory, vmAddress, sizeof(data)), data, sizeof(data));
+		memcpy(memorySpan<U8>(memory, vmAddress, sizeof(data)).begin(), data, sizeof(data));
 	}
 	return vmAddress + sizeof(short) * 128;
 }
@@ -256,7 +256,7 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env, "___ctype_toupper_loc", I32, _
 	if(vmAddress == 0)
 	{
 		vmAddress = coerce32bitAddress(dynamicAlloc(memory, sizeof(data)));
-		memcpy(memoryArrayPtr<U8>(memory, vmAddress, sizeof(data)), data, sizeof(data));
+		memcpy(memorySpan<U8>(memory, vmAddress, sizeof(data)).begin(), data, sizeof(data));
 	}
 	return vmAddress + sizeof(I32) * 128;
 }
@@ -291,7 +291,7 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env, "___ctype_tolower_loc", I32, _
 	if(vmAddress == 0)
 	{
 		vmAddress = coerce32bitAddress(dynamicAlloc(memory, sizeof(data)));
-		memcpy(memoryArrayPtr<U8>(memory, vmAddress, sizeof(data)), data, sizeof(data));
+		memcpy(memorySpan<U8>(memory, vmAddress, sizeof(data)).begin(), data, sizeof(data));
 	}
 	return vmAddress + sizeof(I32) * 128;
 }
@@ -432,7 +432,9 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env,
 {
 	MemoryInstance* memory
 		= Runtime::getMemoryFromRuntimeData(contextRuntimeData, defaultMemoryId.id);
-	memcpy(memoryArrayPtr<U8>(memory, a, c), memoryArrayPtr<U8>(memory, b, c), U32(c));
+	MemorySpan<U8> destSpan         = memorySpan<U8>(memory, U32(a), U32(c));
+	MemorySpan<const U8> sourceSpan = memorySpan<const U8>(memory, U32(b), U32(c));
+	memcpy(destSpan.begin(), sourceSpan.begin(), sourceSpan.size());
 	return a;
 }
 
@@ -479,10 +481,8 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env,
 {
 	MemoryInstance* memory
 		= Runtime::getMemoryFromRuntimeData(contextRuntimeData, defaultMemoryId.id);
-	return (I32)fread(memoryArrayPtr<U8>(memory, pointer, U64(size) * U64(count)),
-					  U64(size),
-					  U64(count),
-					  vmFile(file));
+	MemorySpan<U8> buffer = memorySpan<U8>(memory, U32(pointer), U64(U32(size)) * U64(U32(count)));
+	return (I32)fread(buffer.begin(), U32(size), U32(count), vmFile(file));
 }
 DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env,
 											 "_fwrite",
@@ -495,10 +495,9 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env,
 {
 	MemoryInstance* memory
 		= Runtime::getMemoryFromRuntimeData(contextRuntimeData, defaultMemoryId.id);
-	return (I32)fwrite(memoryArrayPtr<U8>(memory, pointer, U64(size) * U64(count)),
-					   U64(size),
-					   U64(count),
-					   vmFile(file));
+	MemorySpan<const U8> buffer
+		= memorySpan<const U8>(memory, U32(pointer), U64(U32(size)) * U64(U32(count)));
+	return (I32)fwrite(buffer.begin(), U32(size), U32(count), vmFile(file));
 }
 DEFINE_INTRINSIC_FUNCTION(env, "_fputc", I32, _fputc, I32 character, I32 file)
 {
@@ -546,30 +545,28 @@ DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(env,
 		= Runtime::getMemoryFromRuntimeData(contextRuntimeData, defaultMemoryId.id);
 
 	// writev
-	U32* args  = memoryArrayPtr<U32>(memory, argsPtr, 3);
-	U32 iov    = args[1];
-	U32 iovcnt = args[2];
+	MemorySpan<const U32> args = memorySpan<const U32>(memory, U32(argsPtr), 3);
+	const U32 iov              = args[1];
+	const U32 iovcnt           = args[2];
+	if(iovcnt > maxMemoryIoVecs) { return -1; }
+
+	// Validate the iovecs and the buffers they point to, and translate them to native buffers.
+	std::vector<MemoryIoVec> ioVecs(iovcnt);
+	getMemoryIoVecs(memory, iov, iovcnt, ioVecs.data());
 #ifdef _WIN32
 	U32 count = 0;
 	for(U32 i = 0; i < iovcnt; i++)
 	{
-		U32 base = memoryRef<U32>(memory, iov + i * 8);
-		U32 len  = memoryRef<U32>(memory, iov + i * 8 + 4);
-		U32 size = (U32)fwrite(memoryArrayPtr<U8>(memory, base, len), 1, len, vmFile(file));
+		U32 size = (U32)fwrite(ioVecs[i].base, 1, ioVecs[i].numBytes, vmFile(file));
 		count += size;
-		if(size < len) break;
+		if(size < ioVecs[i].numBytes) break;
 	}
 #else
-	struct iovec* native_iovec = new(alloca(sizeof(iovec) * iovcnt)) struct iovec[iovcnt];
-	for(U32 i = 0; i < iovcnt; i++)
-	{
-		U32 base = memoryRef<U32>(memory, iov + i * 8);
-		U32 len  = memoryRef<U32>(memory, iov + i * 8 + 4);
-
-		native_iovec[i].iov_base = memoryArrayPtr<U8>(memory, base, len);
-		native_iovec[i].iov_len  = len;
-	}
-	Iptr count = writev(fileno(vmFile(file)), native_iovec, iovcnt);
+	static_assert(sizeof(MemoryIoVec) == sizeof(iovec)
+					  && offsetof(MemoryIoVec, base) == offsetof(iovec, iov_base)
+					  && offsetof(MemoryIoVec, numBytes) == offsetof(iovec, iov_len),
+				  "MemoryIoVec must have the same layout as struct iovec");
+	Iptr count = writev(fileno(vmFile(file)), (const iovec*)ioVecs.data(), iovcnt);
 #endif
 	return count;
 }
@@ -695,18 +692,18 @@ void Emscripten::injectCommandArgs(Emscripten::Instance* instance,
 								   const std::vector<const char*>& argStrings,
 								   std::vector<IR::Value>& outInvokeArgs)
 {
-	MemoryInstance* memory         = instance->emscriptenMemory;
-	U8* emscriptenMemoryBaseAdress = getMemoryBaseAddress(memory);
+	MemoryInstance* memory = instance->emscriptenMemory;
 
-	U32* argvOffsets = (U32*)(emscriptenMemoryBaseAdress
-							  + dynamicAlloc(memory, (U32)(sizeof(U32) * (argStrings.size() + 1))));
+	const U32 argvAddress = dynamicAlloc(memory, (U32)(sizeof(U32) * (argStrings.size() + 1)));
+	MemorySpan<U32> argvOffsets = memorySpan<U32>(memory, argvAddress, argStrings.size() + 1);
 	for(Uptr argIndex = 0; argIndex < argStrings.size(); ++argIndex)
 	{
-		auto stringSize   = strlen(argStrings[argIndex]) + 1;
-		auto stringMemory = emscriptenMemoryBaseAdress + dynamicAlloc(memory, (U32)stringSize);
-		memcpy(stringMemory, argStrings[argIndex], stringSize);
-		argvOffsets[argIndex] = (U32)(stringMemory - emscriptenMemoryBaseAdress);
+		const Uptr stringSize         = strlen(argStrings[argIndex]) + 1;
+		const U32 stringAddress       = dynamicAlloc(memory, (U32)stringSize);
+		MemorySpan<char> stringMemory = memorySpan<char>(memory, stringAddress, stringSize);
+		memcpy(stringMemory.begin(), argStrings[argIndex], stringSize);
+		argvOffsets[argIndex] = stringAddress;
 	}
 	argvOffsets[argStrings.size()] = 0;
-	outInvokeArgs = {(U32)argStrings.size(), (U32)((U8*)argvOffsets - emscriptenMemoryBaseAdress)};
+	outInvokeArgs                  = {(U32)argStrings.size(), argvAddress};
 }
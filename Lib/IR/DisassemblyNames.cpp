@@ -245,7 +245,7 @@ void IR::getDisassemblyNames(const Module& module, DisassemblyNames& outNames)
 				"FatalSerializationException while deserializing WASM user name section: %s\n",
 				exception.message.c_str());
 		}
-		catch(std::bad_alloc)
+		catch(const std::bad_alloc&)
 		{
 			Log::printf(
 				Log::debug,
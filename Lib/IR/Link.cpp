@@ -0,0 +1,608 @@
+#include "IR/Link.h"
+#include "IR/Module.h"
+#include "IR/Operators.h"
+#include "IR/Types.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/HashMap.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Serialization;
+
+// An object in the linked module: either one of its imports, or a definition from one of the
+// modules being linked. The index of a definition doesn't include the linked module's imports,
+// since the number of imports isn't known until the imports of all the modules are resolved.
+struct LinkedObject
+{
+	bool isDef;
+	Uptr index;
+};
+
+// Maps the index spaces of one of the modules being linked to the objects in the linked module.
+struct LinkedObjects
+{
+	std::vector<Uptr> types;
+	std::vector<LinkedObject> functions;
+	std::vector<LinkedObject> tables;
+	std::vector<LinkedObject> memories;
+	std::vector<LinkedObject> globals;
+	std::vector<LinkedObject> exceptionTypes;
+};
+
+// Maps the index spaces of one of the modules being linked to the linked module's index spaces.
+struct IndexMap
+{
+	std::vector<Uptr> types;
+	std::vector<Uptr> functions;
+	std::vector<Uptr> tables;
+	std::vector<Uptr> memories;
+	std::vector<Uptr> globals;
+	std::vector<Uptr> exceptionTypes;
+};
+
+struct LinkState
+{
+	const std::vector<LinkableModule>& modules;
+	Module& outModule;
+
+	HashMap<FunctionType, Uptr> typeIndexMap;
+	std::vector<LinkedObjects> linkedObjects;
+
+	LinkState(const std::vector<LinkableModule>& inModules, Module& inOutModule)
+	: modules(inModules), outModule(inOutModule), linkedObjects(inModules.size())
+	{
+	}
+};
+
+// Re-encodes a function's code, remapping the function, global, exception type, and type indices
+// used by its operators. The encoding of an operator doesn't depend on the values of its
+// immediates, so the offsets of the operators are unchanged.
+struct IndexRemappingVisitor
+{
+	typedef void Result;
+
+	IndexRemappingVisitor(OperatorEncoderStream& inEncoder, const IndexMap& inIndexMap)
+	: encoder(inEncoder), indexMap(inIndexMap)
+	{
+	}
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm imm) { encoder.name(remap(imm)); }
+	ENUM_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+	void unknown(Opcode) { Errors::unreachable(); }
+
+private:
+	OperatorEncoderStream& encoder;
+	const IndexMap& indexMap;
+
+	CallImm remap(CallImm imm)
+	{
+		imm.functionIndex = U32(indexMap.functions[imm.functionIndex]);
+		return imm;
+	}
+	CallIndirectImm remap(CallIndirectImm imm)
+	{
+		imm.type.index = indexMap.types[imm.type.index];
+		return imm;
+	}
+	ControlStructureImm remap(ControlStructureImm imm)
+	{
+		if(imm.type.format == IndexedBlockType::functionType)
+		{ imm.type.index = indexMap.types[imm.type.index]; }
+		return imm;
+	}
+	GetOrSetVariableImm<true> remap(GetOrSetVariableImm<true> imm)
+	{
+		imm.variableIndex = U32(indexMap.globals[imm.variableIndex]);
+		return imm;
+	}
+	ExceptionTypeImm remap(ExceptionTypeImm imm)
+	{
+		imm.exceptionTypeIndex = U32(indexMap.exceptionTypes[imm.exceptionTypeIndex]);
+		return imm;
+	}
+	template<typename Imm> Imm remap(Imm imm) { return imm; }
+};
+
+// Computes the features used by a linked module: the union of the features used by the modules
+// linked into it, which allows any of their code. This must handle every field of FeatureSpec.
+static FeatureSpec linkFeatureSpecs(const std::vector<LinkableModule>& modules)
+{
+	FeatureSpec featureSpec = modules[0].module->featureSpec;
+	for(Uptr moduleIndex = 1; moduleIndex < modules.size(); ++moduleIndex)
+	{
+		const FeatureSpec& moduleFeatureSpec = modules[moduleIndex].module->featureSpec;
+		featureSpec.mvp |= moduleFeatureSpec.mvp;
+		featureSpec.importExportMutableGlobals |= moduleFeatureSpec.importExportMutableGlobals;
+		featureSpec.extendedNamesSection |= moduleFeatureSpec.extendedNamesSection;
+		featureSpec.simd |= moduleFeatureSpec.simd;
+		featureSpec.atomics |= moduleFeatureSpec.atomics;
+		featureSpec.exceptionHandling |= moduleFeatureSpec.exceptionHandling;
+		featureSpec.nonTrappingFloatToInt |= moduleFeatureSpec.nonTrappingFloatToInt;
+		featureSpec.extendedSignExtension |= moduleFeatureSpec.extendedSignExtension;
+		featureSpec.multipleResultsAndBlockParams
+			|= moduleFeatureSpec.multipleResultsAndBlockParams;
+		featureSpec.sharedTables |= moduleFeatureSpec.sharedTables;
+
+		// Requiring the shared flag for atomic operators restricts modules, so it is only required
+		// if all the modules require it.
+		featureSpec.requireSharedFlagForAtomicOperators
+			&= moduleFeatureSpec.requireSharedFlagForAtomicOperators;
+
+		featureSpec.maxLocals = std::max(featureSpec.maxLocals, moduleFeatureSpec.maxLocals);
+		featureSpec.maxLabelsPerFunction
+			= std::max(featureSpec.maxLabelsPerFunction, moduleFeatureSpec.maxLabelsPerFunction);
+	}
+	return featureSpec;
+}
+
+static Uptr linkType(LinkState& state, FunctionType type)
+{
+	if(const Uptr* typeIndex = state.typeIndexMap.get(type)) { return *typeIndex; }
+
+	const Uptr typeIndex = state.outModule.types.size();
+	state.outModule.types.push_back(type);
+	state.typeIndexMap.add(type, typeIndex);
+	return typeIndex;
+}
+
+// Maps the type of an import or export to the linked module.
+static IndexedFunctionType linkImportType(const LinkedObjects& linkedObjects,
+										  IndexedFunctionType type)
+{
+	return {linkedObjects.types[type.index]};
+}
+template<typename Type> static Type linkImportType(const LinkedObjects&, Type type) { return type; }
+
+// Returns whether an object of exportType may be imported as importType.
+static bool isImportCompatible(IndexedFunctionType importType, IndexedFunctionType exportType)
+{
+	return importType.index == exportType.index;
+}
+static bool isImportCompatible(const TableType& importType, const TableType& exportType)
+{
+	return isSubset(importType, exportType);
+}
+static bool isImportCompatible(const MemoryType& importType, const MemoryType& exportType)
+{
+	return isSubset(importType, exportType);
+}
+static bool isImportCompatible(GlobalType importType, GlobalType exportType)
+{
+	return importType == exportType;
+}
+static bool isImportCompatible(const ExceptionType& importType, const ExceptionType& exportType)
+{
+	return importType == exportType;
+}
+
+// Merges the types of two imports of the same object into a type that the imported object must
+// match, or returns false if no object can match both types.
+static bool mergeImportTypes(IndexedFunctionType& type, IndexedFunctionType otherType)
+{
+	return type.index == otherType.index;
+}
+static bool mergeSizeConstraints(SizeConstraints& size, const SizeConstraints& otherSize)
+{
+	const SizeConstraints mergedSize
+		= {std::max(size.min, otherSize.min), std::min(size.max, otherSize.max)};
+	if(mergedSize.min > mergedSize.max) { return false; }
+	size = mergedSize;
+	return true;
+}
+static bool mergeImportTypes(TableType& type, const TableType& otherType)
+{
+	return type.elementType == otherType.elementType && type.isShared == otherType.isShared
+		   && mergeSizeConstraints(type.size, otherType.size);
+}
+static bool mergeImportTypes(MemoryType& type, const MemoryType& otherType)
+{
+	return type.isShared == otherType.isShared && mergeSizeConstraints(type.size, otherType.size);
+}
+static bool mergeImportTypes(GlobalType& type, GlobalType otherType) { return type == otherType; }
+static bool mergeImportTypes(ExceptionType& type, const ExceptionType& otherType)
+{
+	return type == otherType;
+}
+
+// Finds the module that an import is resolved to: the last module with the import's module name
+// that is linked before the importing module. Returns false if there is no such module, and throws
+// a LinkException if the module doesn't have a matching export.
+template<typename Type>
+static bool findExport(const LinkState& state,
+					   Uptr importerIndex,
+					   const Import<Type>& import,
+					   ObjectKind kind,
+					   Uptr& outExporterIndex,
+					   Uptr& outExportedIndex)
+{
+	for(Uptr exporterIndex = importerIndex; exporterIndex > 0; --exporterIndex)
+	{
+		const LinkableModule& exporter = state.modules[exporterIndex - 1];
+		if(exporter.name != import.moduleName) { continue; }
+
+		for(const Export& exportIt : exporter.module->exports)
+		{
+			if(exportIt.name == import.exportName && exportIt.kind == kind)
+			{
+				outExporterIndex = exporterIndex - 1;
+				outExportedIndex = exportIt.index;
+				return true;
+			}
+		}
+		throw LinkException("module " + state.modules[importerIndex].name + " imports "
+							+ import.moduleName + "." + import.exportName
+							+ ", which isn't exported by module " + exporter.name);
+	}
+	return false;
+}
+
+// Adds an import to the linked module, or merges it with an identical import added for another
+// module, and returns its index.
+template<typename Type>
+static Uptr addImport(std::vector<Import<Type>>& imports, const Import<Type>& import, Type type)
+{
+	for(Uptr importIndex = 0; importIndex < imports.size(); ++importIndex)
+	{
+		Import<Type>& existingImport = imports[importIndex];
+		if(existingImport.moduleName == import.moduleName
+		   && existingImport.exportName == import.exportName)
+		{
+			Type mergedType = existingImport.type;
+			if(mergeImportTypes(mergedType, type))
+			{
+				existingImport.type = mergedType;
+				return importIndex;
+			}
+		}
+	}
+
+	imports.push_back({type, import.moduleName, import.exportName});
+	return imports.size() - 1;
+}
+
+// Resolves the imports of one of the modules being linked, and adds its definitions to the
+// linked module. The definitions are transformed by linkDef, which may use the objects of the
+// module that are already linked.
+template<typename Def, typename Type, typename LinkDef>
+static void linkIndexSpace(LinkState& state,
+						   Uptr moduleIndex,
+						   ObjectKind kind,
+						   IndexSpace<Def, Type> Module::*indexSpace,
+						   std::vector<LinkedObject> LinkedObjects::*linkedObjects,
+						   LinkDef&& linkDef)
+{
+	const LinkableModule& linkableModule          = state.modules[moduleIndex];
+	const IndexSpace<Def, Type>& moduleIndexSpace = linkableModule.module->*indexSpace;
+	IndexSpace<Def, Type>& outIndexSpace          = state.outModule.*indexSpace;
+	std::vector<LinkedObject>& moduleObjects      = state.linkedObjects[moduleIndex].*linkedObjects;
+
+	for(const Import<Type>& import : moduleIndexSpace.imports)
+	{
+		const Type importType = linkImportType(state.linkedObjects[moduleIndex], import.type);
+
+		Uptr exporterIndex = 0;
+		Uptr exportedIndex = 0;
+		if(findExport(state, moduleIndex, import, kind, exporterIndex, exportedIndex))
+		{
+			const Module& exporter = *state.modules[exporterIndex].module;
+			const Type exportType = linkImportType(state.linkedObjects[exporterIndex],
+												   (exporter.*indexSpace).getType(exportedIndex));
+			if(!isImportCompatible(importType, exportType))
+			{
+				throw LinkException("module " + linkableModule.name + " imports "
+									+ import.moduleName + "." + import.exportName
+									+ " with a type that doesn't match the export");
+			}
+			const std::vector<LinkedObject>& exporterObjects
+				= state.linkedObjects[exporterIndex].*linkedObjects;
+			moduleObjects.push_back(exporterObjects[exportedIndex]);
+		}
+		else
+		{
+			moduleObjects.push_back({false, addImport(outIndexSpace.imports, import, importType)});
+		}
+	}
+
+	for(const Def& def : moduleIndexSpace.defs)
+	{
+		moduleObjects.push_back({true, outIndexSpace.defs.size()});
+		outIndexSpace.defs.push_back(linkDef(def));
+	}
+}
+
+static InitializerExpression linkInitializer(const LinkState& state,
+											 const LinkedObjects& linkedObjects,
+											 InitializerExpression initializer)
+{
+	if(initializer.type != InitializerExpression::Type::get_global) { return initializer; }
+
+	// An initializer may only get an immutable imported global. If the import was resolved to a
+	// global definition, its value is the value of the definition's initializer.
+	const LinkedObject& global = linkedObjects.globals[initializer.globalIndex];
+	if(global.isDef) { return state.outModule.globals.defs[global.index].initializer; }
+	else
+	{
+		return InitializerExpression(InitializerExpression::Type::get_global, global.index);
+	}
+}
+
+static void linkModuleDeclarations(LinkState& state, Uptr moduleIndex)
+{
+	const Module& module         = *state.modules[moduleIndex].module;
+	LinkedObjects& linkedObjects = state.linkedObjects[moduleIndex];
+
+	for(const FunctionType& type : module.types)
+	{ linkedObjects.types.push_back(linkType(state, type)); }
+
+	// The code of the function definitions is remapped after the declarations of all the modules
+	// are linked, when the indices of the function and global definitions are known.
+	linkIndexSpace(state,
+				   moduleIndex,
+				   ObjectKind::function,
+				   &Module::functions,
+				   &LinkedObjects::functions,
+				   [&](const FunctionDef& functionDef) {
+					   const Uptr typeIndex = linkedObjects.types[functionDef.type.index];
+					   FunctionDef linkedDef;
+					   linkedDef.type                   = {typeIndex};
+					   linkedDef.nonParameterLocalTypes = functionDef.nonParameterLocalTypes;
+					   return linkedDef;
+				   });
+	linkIndexSpace(state,
+				   moduleIndex,
+				   ObjectKind::table,
+				   &Module::tables,
+				   &LinkedObjects::tables,
+				   [](const TableDef& tableDef) { return tableDef; });
+	linkIndexSpace(state,
+				   moduleIndex,
+				   ObjectKind::memory,
+				   &Module::memories,
+				   &LinkedObjects::memories,
+				   [](const MemoryDef& memoryDef) { return memoryDef; });
+	linkIndexSpace(state,
+				   moduleIndex,
+				   ObjectKind::global,
+				   &Module::globals,
+				   &LinkedObjects::globals,
+				   [&](const GlobalDef& globalDef) {
+					   return GlobalDef{
+						   globalDef.type,
+						   linkInitializer(state, linkedObjects, globalDef.initializer)};
+				   });
+	linkIndexSpace(state,
+				   moduleIndex,
+				   ObjectKind::exceptionType,
+				   &Module::exceptionTypes,
+				   &LinkedObjects::exceptionTypes,
+				   [](const ExceptionTypeDef& exceptionTypeDef) { return exceptionTypeDef; });
+}
+
+static std::vector<Uptr> getLinkedIndices(const std::vector<LinkedObject>& linkedObjects,
+										  Uptr numImports)
+{
+	std::vector<Uptr> indices;
+	for(const LinkedObject& object : linkedObjects)
+	{ indices.push_back(object.isDef ? numImports + object.index : object.index); }
+	return indices;
+}
+
+static IndexMap getIndexMap(const LinkState& state, Uptr moduleIndex)
+{
+	const Module& outModule            = state.outModule;
+	const LinkedObjects& linkedObjects = state.linkedObjects[moduleIndex];
+
+	IndexMap indexMap;
+	indexMap.types = linkedObjects.types;
+	indexMap.functions
+		= getLinkedIndices(linkedObjects.functions, outModule.functions.imports.size());
+	indexMap.tables = getLinkedIndices(linkedObjects.tables, outModule.tables.imports.size());
+	indexMap.memories
+		= getLinkedIndices(linkedObjects.memories, outModule.memories.imports.size());
+	indexMap.globals = getLinkedIndices(linkedObjects.globals, outModule.globals.imports.size());
+	indexMap.exceptionTypes
+		= getLinkedIndices(linkedObjects.exceptionTypes, outModule.exceptionTypes.imports.size());
+	return indexMap;
+}
+
+static void linkModuleCode(LinkState& state, Uptr moduleIndex, const IndexMap& indexMap)
+{
+	const Module& module               = *state.modules[moduleIndex].module;
+	const LinkedObjects& linkedObjects = state.linkedObjects[moduleIndex];
+	Module& outModule                  = state.outModule;
+	ModuleArena& outArena              = *outModule.arena;
+
+	const Uptr numFunctionImports = module.functions.imports.size();
+	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+		++functionDefIndex)
+	{
+		const FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+		const LinkedObject& linkedFunction
+			= linkedObjects.functions[numFunctionImports + functionDefIndex];
+		FunctionDef& outFunctionDef = outModule.functions.defs[linkedFunction.index];
+
+		ArrayOutputStream codeStream;
+		OperatorEncoderStream encoder(codeStream);
+		IndexRemappingVisitor visitor(encoder, indexMap);
+		OperatorDecoderStream decoder(functionDef.code);
+		while(decoder) { decoder.decodeOp(visitor); };
+
+		outFunctionDef.code = outArena.copyArray(codeStream.getBytes());
+		wavmAssert(outFunctionDef.code.size() == functionDef.code.size());
+		for(const ArenaArray<U32>& branchTable : functionDef.branchTables)
+		{
+			outFunctionDef.branchTables.push_back(
+				outArena.copyArray(branchTable.data(), branchTable.size()));
+		}
+		outFunctionDef.controlPartOffsets = outArena.copyArray(
+			functionDef.controlPartOffsets.data(), functionDef.controlPartOffsets.size());
+	}
+
+	for(const DataSegment& dataSegment : module.dataSegments)
+	{
+		outModule.dataSegments.push_back(
+			{indexMap.memories[dataSegment.memoryIndex],
+			 linkInitializer(state, linkedObjects, dataSegment.baseOffset),
+			 dataSegment.data});
+	}
+	for(const TableSegment& tableSegment : module.tableSegments)
+	{
+		TableSegment outTableSegment;
+		outTableSegment.tableIndex = indexMap.tables[tableSegment.tableIndex];
+		outTableSegment.baseOffset = linkInitializer(state, linkedObjects, tableSegment.baseOffset);
+		for(Uptr functionIndex : tableSegment.indices)
+		{ outTableSegment.indices.push_back(indexMap.functions[functionIndex]); }
+		outModule.tableSegments.push_back(std::move(outTableSegment));
+	}
+}
+
+static void linkStartFunctions(LinkState& state, const std::vector<Uptr>& startFunctionIndices)
+{
+	Module& outModule = state.outModule;
+	if(startFunctionIndices.size() == 1) { outModule.startFunctionIndex = startFunctionIndices[0]; }
+	else if(startFunctionIndices.size() > 1)
+	{
+		// Add a function that calls the start functions of the modules in order.
+		ArrayOutputStream codeStream;
+		OperatorEncoderStream encoder(codeStream);
+		for(Uptr functionIndex : startFunctionIndices) { encoder.call({U32(functionIndex)}); }
+		encoder.end();
+
+		FunctionDef startFunctionDef;
+		startFunctionDef.type = {linkType(state, FunctionType())};
+		startFunctionDef.code = outModule.arena->copyArray(codeStream.getBytes());
+		startFunctionDef.controlPartOffsets
+			= computeControlPartOffsets(*outModule.arena, startFunctionDef.code);
+
+		outModule.startFunctionIndex = outModule.functions.size();
+		outModule.functions.defs.push_back(std::move(startFunctionDef));
+	}
+}
+
+static void linkExports(LinkState& state, const Module& module, const IndexMap& indexMap)
+{
+	for(const Export& exportIt : module.exports)
+	{
+		Uptr index;
+		switch(exportIt.kind)
+		{
+		case ObjectKind::function: index = indexMap.functions[exportIt.index]; break;
+		case ObjectKind::table: index = indexMap.tables[exportIt.index]; break;
+		case ObjectKind::memory: index = indexMap.memories[exportIt.index]; break;
+		case ObjectKind::global: index = indexMap.globals[exportIt.index]; break;
+		case ObjectKind::exceptionType: index = indexMap.exceptionTypes[exportIt.index]; break;
+		default: Errors::unreachable();
+		};
+		state.outModule.exports.push_back({exportIt.name, exportIt.kind, index});
+	}
+}
+
+// Copies a module's names to the linked module's names. If an object in the linked module is
+// imported by multiple modules, it keeps the name it has in the first module.
+static void linkNames(const std::vector<std::string>& names,
+					  const std::vector<Uptr>& indices,
+					  std::vector<std::string>& outNames)
+{
+	for(Uptr index = 0; index < names.size(); ++index)
+	{
+		std::string& outName = outNames[indices[index]];
+		if(outName.empty()) { outName = names[index]; }
+	}
+}
+
+static void linkDisassemblyNames(const LinkState& state, const std::vector<IndexMap>& indexMaps)
+{
+	DisassemblyNames outNames;
+	getDisassemblyNames(state.outModule, outNames);
+
+	bool hasNameSection = false;
+	for(Uptr moduleIndex = 0; moduleIndex < state.modules.size(); ++moduleIndex)
+	{
+		const Module& module     = *state.modules[moduleIndex].module;
+		const IndexMap& indexMap = indexMaps[moduleIndex];
+
+		Uptr nameSectionIndex = 0;
+		if(!findUserSection(module, "name", nameSectionIndex)) { continue; }
+		hasNameSection = true;
+
+		DisassemblyNames names;
+		getDisassemblyNames(module, names);
+		outNames.moduleName = names.moduleName;
+
+		// The locals and labels of a function definition are only in the module that defines it.
+		for(Uptr functionIndex = 0; functionIndex < names.functions.size(); ++functionIndex)
+		{
+			DisassemblyNames::Function& functionNames = names.functions[functionIndex];
+			DisassemblyNames::Function& outFunctionNames
+				= outNames.functions[indexMap.functions[functionIndex]];
+			if(functionIndex >= module.functions.imports.size())
+			{
+				outFunctionNames.locals = std::move(functionNames.locals);
+				outFunctionNames.labels = std::move(functionNames.labels);
+			}
+			if(outFunctionNames.name.empty())
+			{ outFunctionNames.name = std::move(functionNames.name); }
+		}
+		linkNames(names.types, indexMap.types, outNames.types);
+		linkNames(names.tables, indexMap.tables, outNames.tables);
+		linkNames(names.memories, indexMap.memories, outNames.memories);
+		linkNames(names.globals, indexMap.globals, outNames.globals);
+		linkNames(names.exceptionTypes, indexMap.exceptionTypes, outNames.exceptionTypes);
+	}
+
+	if(hasNameSection) { setDisassemblyNames(state.outModule, outNames); }
+}
+
+void IR::linkModules(const std::vector<LinkableModule>& modules, Module& outModule)
+{
+	wavmAssert(modules.size());
+	Timing::Timer timer;
+
+	LinkState state(modules, outModule);
+	outModule.featureSpec = linkFeatureSpecs(modules);
+
+	// Resolve the imports of the modules, and add their declarations to the linked module.
+	for(Uptr moduleIndex = 0; moduleIndex < modules.size(); ++moduleIndex)
+	{ linkModuleDeclarations(state, moduleIndex); }
+
+	if(outModule.tables.size() > 1)
+	{ throw LinkException("the linked modules have more than one distinct table"); }
+	if(outModule.memories.size() > 1)
+	{ throw LinkException("the linked modules have more than one distinct memory"); }
+
+	// Now that the number of imports in the linked module is known, remap the code and segments of
+	// the modules.
+	std::vector<IndexMap> indexMaps;
+	std::vector<Uptr> startFunctionIndices;
+	for(Uptr moduleIndex = 0; moduleIndex < modules.size(); ++moduleIndex)
+	{
+		indexMaps.push_back(getIndexMap(state, moduleIndex));
+		linkModuleCode(state, moduleIndex, indexMaps.back());
+
+		const Module& module = *modules[moduleIndex].module;
+		if(module.startFunctionIndex != UINTPTR_MAX)
+		{ startFunctionIndices.push_back(indexMaps.back().functions[module.startFunctionIndex]); }
+	}
+
+	linkStartFunctions(state, startFunctionIndices);
+	linkExports(state, *modules.back().module, indexMaps.back());
+	linkDisassemblyNames(state, indexMaps);
+
+	Timing::logTimer("Linked modules", timer);
+	Log::printf(Log::metrics,
+				"Linked %" PRIuPTR " modules into a module with %" PRIuPTR
+				" function definitions and %" PRIuPTR " function imports\n",
+				modules.size(),
+				outModule.functions.defs.size(),
+				outModule.functions.imports.size());
+}
@@ -1,5 +1,10 @@
 #include "Operators.h"
 
+#include <algorithm>
+#include <vector>
+
+using namespace IR;
+
 const char* IR::getOpcodeName(Opcode opcode)
 {
 	switch(opcode)
@@ -11,3 +16,97 @@ const char* IR::getOpcodeName(Opcode opcode)
 	default: return "unknown";
 	};
 }
+
+// Records the offsets of each control structure part as the operators are decoded.
+struct ControlPartOffsetVisitor
+{
+	typedef void Result;
+
+	OperatorDecoderStream& decoder;
+	Uptr opOffset;
+	Uptr opIndex;
+	std::vector<Uptr> partFirstOpOffsets;
+	std::vector<ControlPartOffsets> parts;
+
+	ControlPartOffsetVisitor(OperatorDecoderStream& inDecoder)
+	: decoder(inDecoder), opOffset(0), opIndex(0)
+	{
+		// The function body is a part that starts at the first operator.
+		partFirstOpOffsets.push_back(0);
+	}
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm imm) {}
+	ENUM_NONCONTROL_OPERATORS(VISIT_OP)
+	VISIT_OP(_, unknown, "unknown", Opcode)
+#undef VISIT_OP
+
+	// The decoder has already consumed the operator that begins a part, so its offset is the offset
+	// of the part's first operator.
+	void block(ControlStructureImm) { beginPart(); }
+	void loop(ControlStructureImm) { beginPart(); }
+	void if_(ControlStructureImm) { beginPart(); }
+	void try_(ControlStructureImm) { beginPart(); }
+
+	void else_(NoImm)
+	{
+		endPart();
+		beginPart();
+	}
+	void catch_(ExceptionTypeImm)
+	{
+		endPart();
+		beginPart();
+	}
+	void catch_all(NoImm)
+	{
+		endPart();
+		beginPart();
+	}
+	void end(NoImm) { endPart(); }
+
+private:
+	void beginPart() { partFirstOpOffsets.push_back(decoder.getOffset()); }
+	void endPart()
+	{
+		// Tolerate unbalanced code, which the WAST parser may produce for an invalid function.
+		if(partFirstOpOffsets.size())
+		{
+			parts.push_back({U32(partFirstOpOffsets.back()), U32(opOffset), U32(opIndex)});
+			partFirstOpOffsets.pop_back();
+		}
+	}
+};
+
+ArenaArray<ControlPartOffsets> IR::computeControlPartOffsets(ModuleArena& arena,
+															 const ArenaArray<U8>& code)
+{
+	OperatorDecoderStream decoder(code);
+	ControlPartOffsetVisitor visitor(decoder);
+	for(; decoder; ++visitor.opIndex)
+	{
+		visitor.opOffset = decoder.getOffset();
+		decoder.decodeOp(visitor);
+	}
+
+	// Parts are recorded in the order they end, so sort them by the offset they start at.
+	std::sort(visitor.parts.begin(),
+			  visitor.parts.end(),
+			  [](const ControlPartOffsets& left, const ControlPartOffsets& right) {
+				  return left.firstOpOffset < right.firstOpOffset;
+			  });
+	return arena.copyArray(visitor.parts);
+}
+
+const ControlPartOffsets* IR::findControlPart(const FunctionDef& functionDef, Uptr firstOpOffset)
+{
+	const ArenaArray<ControlPartOffsets>& parts = functionDef.controlPartOffsets;
+	const ControlPartOffsets* part
+		= std::lower_bound(parts.begin(),
+						   parts.end(),
+						   firstOpOffset,
+						   [](const ControlPartOffsets& part, Uptr offset) {
+							   return part.firstOpOffset < offset;
+						   });
+	return part != parts.end() && part->firstOpOffset == firstOpOffset ? part : nullptr;
+}
@@ -0,0 +1,326 @@
+#include "IR/Optimize.h"
+#include "IR/Module.h"
+#include "IR/Operators.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+
+#include <vector>
+
+using namespace IR;
+using namespace Serialization;
+
+// Records the functions called, the globals set, and the types used by a function's code.
+struct CodeReferenceVisitor
+{
+	typedef void Result;
+
+	std::vector<Uptr> calledFunctionIndices;
+	std::vector<Uptr> setGlobalIndices;
+	std::vector<Uptr> typeIndices;
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm imm) { visitOp(Opcode::name, imm); }
+	ENUM_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+	void unknown(Opcode) { Errors::unreachable(); }
+
+private:
+	void visitOp(Opcode, CallImm imm) { calledFunctionIndices.push_back(imm.functionIndex); }
+	void visitOp(Opcode, CallIndirectImm imm) { typeIndices.push_back(imm.type.index); }
+	void visitOp(Opcode, ControlStructureImm imm)
+	{
+		if(imm.type.format == IndexedBlockType::functionType)
+		{ typeIndices.push_back(imm.type.index); }
+	}
+	void visitOp(Opcode opcode, GetOrSetVariableImm<true> imm)
+	{
+		if(opcode == Opcode::set_global) { setGlobalIndices.push_back(imm.variableIndex); }
+	}
+	template<typename Imm> void visitOp(Opcode, Imm) {}
+};
+
+static void visitCodeReferences(const FunctionDef& functionDef, CodeReferenceVisitor& visitor)
+{
+	OperatorDecoderStream decoder(functionDef.code);
+	while(decoder) { decoder.decodeOp(visitor); };
+}
+
+// Re-encodes a function's code, renumbering the type indices used by its operators. The encoding
+// of an operator doesn't depend on the values of its immediates, so the offsets of the operators
+// are unchanged.
+struct TypeRenumberingVisitor
+{
+	typedef void Result;
+
+	TypeRenumberingVisitor(OperatorEncoderStream& inEncoder, const std::vector<Uptr>& inNewIndices)
+	: encoder(inEncoder), newTypeIndices(inNewIndices)
+	{
+	}
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm imm) { encoder.name(renumber(imm)); }
+	ENUM_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+	void unknown(Opcode) { Errors::unreachable(); }
+
+private:
+	OperatorEncoderStream& encoder;
+	const std::vector<Uptr>& newTypeIndices;
+
+	CallIndirectImm renumber(CallIndirectImm imm)
+	{
+		imm.type.index = newTypeIndices[imm.type.index];
+		return imm;
+	}
+	ControlStructureImm renumber(ControlStructureImm imm)
+	{
+		if(imm.type.format == IndexedBlockType::functionType)
+		{ imm.type.index = newTypeIndices[imm.type.index]; }
+		return imm;
+	}
+	template<typename Imm> Imm renumber(Imm imm) { return imm; }
+};
+
+// Copies of a module share its arena, so a module must be given an arena of its own before new
+// code is allocated for it. Otherwise, optimizing a copy of a module would grow the arena of the
+// module it was copied from, and of every other copy, each time it is optimized.
+static void useOwnArena(Module& module)
+{
+	if(module.arena.use_count() == 1) { return; }
+
+	std::shared_ptr<ModuleArena> arena = std::make_shared<ModuleArena>();
+	for(FunctionDef& functionDef : module.functions.defs)
+	{
+		functionDef.code = arena->copyArray(functionDef.code.data(), functionDef.code.size());
+		for(ArenaArray<U32>& branchTable : functionDef.branchTables)
+		{ branchTable = arena->copyArray(branchTable.data(), branchTable.size()); }
+		functionDef.controlPartOffsets = arena->copyArray(functionDef.controlPartOffsets.data(),
+														  functionDef.controlPartOffsets.size());
+	}
+	module.arena = std::move(arena);
+}
+
+static Uptr removeUnreachableFunctionBodies(Module& module)
+{
+	const Uptr numFunctionImports = module.functions.imports.size();
+
+	// Find the function definitions that are reachable from the exports, the start function, and
+	// the table segments. Table segments may be used by call_indirect, or by the embedder through
+	// an exported or imported table, so all functions in them are treated as reachable.
+	std::vector<bool> isReachable(module.functions.size(), false);
+	std::vector<Uptr> pendingFunctionDefIndices;
+	auto markReachable = [&](Uptr functionIndex) {
+		if(!isReachable[functionIndex])
+		{
+			isReachable[functionIndex] = true;
+			if(functionIndex >= numFunctionImports)
+			{ pendingFunctionDefIndices.push_back(functionIndex - numFunctionImports); }
+		}
+	};
+	for(const Export& exportIt : module.exports)
+	{
+		if(exportIt.kind == ObjectKind::function) { markReachable(exportIt.index); }
+	}
+	if(module.startFunctionIndex != UINTPTR_MAX) { markReachable(module.startFunctionIndex); }
+	for(const TableSegment& tableSegment : module.tableSegments)
+	{
+		for(Uptr functionIndex : tableSegment.indices) { markReachable(functionIndex); }
+	}
+
+	// Add the functions called by reachable functions until there are no new reachable functions.
+	CodeReferenceVisitor visitor;
+	while(pendingFunctionDefIndices.size())
+	{
+		const Uptr functionDefIndex = pendingFunctionDefIndices.back();
+		pendingFunctionDefIndices.pop_back();
+
+		visitor.calledFunctionIndices.clear();
+		visitCodeReferences(module.functions.defs[functionDefIndex], visitor);
+		for(Uptr functionIndex : visitor.calledFunctionIndices) { markReachable(functionIndex); }
+	}
+
+	std::vector<Uptr> unreachableFunctionDefIndices;
+	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+		++functionDefIndex)
+	{
+		if(!isReachable[numFunctionImports + functionDefIndex])
+		{ unreachableFunctionDefIndices.push_back(functionDefIndex); }
+	}
+	if(!unreachableFunctionDefIndices.size()) { return 0; }
+
+	// Read the module's names before changing the function definitions: the local names of the
+	// removed locals must be removed from the name section, or it would be invalid.
+	Uptr nameSectionIndex     = 0;
+	const bool hasNameSection = findUserSection(module, "name", nameSectionIndex);
+	DisassemblyNames names;
+	if(hasNameSection) { getDisassemblyNames(module, names); }
+
+	// Replace the unreachable function bodies with a shared body that just traps. They are replaced
+	// before copying the module's code to its own arena, so the code being removed isn't copied.
+	for(Uptr functionDefIndex : unreachableFunctionDefIndices)
+	{
+		FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+		functionDef.code         = ArenaArray<U8>();
+		functionDef.branchTables.clear();
+		functionDef.controlPartOffsets = ArenaArray<ControlPartOffsets>();
+	}
+	useOwnArena(module);
+
+	ArrayOutputStream stubCodeStream;
+	OperatorEncoderStream stubEncoder(stubCodeStream);
+	stubEncoder.unreachable();
+	stubEncoder.end();
+	const ArenaArray<U8> stubCode = module.arena->copyArray(stubCodeStream.getBytes());
+	const ArenaArray<ControlPartOffsets> stubControlPartOffsets
+		= computeControlPartOffsets(*module.arena, stubCode);
+	for(Uptr functionDefIndex : unreachableFunctionDefIndices)
+	{
+		FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+		functionDef.nonParameterLocalTypes.clear();
+		functionDef.code               = stubCode;
+		functionDef.controlPartOffsets = stubControlPartOffsets;
+
+		if(hasNameSection)
+		{
+			DisassemblyNames::Function& functionNames
+				= names.functions[numFunctionImports + functionDefIndex];
+			functionNames.locals.resize(module.types[functionDef.type.index].params().size());
+			functionNames.labels.clear();
+		}
+	}
+	if(hasNameSection) { setDisassemblyNames(module, names); }
+
+	return unreachableFunctionDefIndices.size();
+}
+
+static Uptr makeUnwrittenGlobalsImmutable(Module& module)
+{
+	// Exported globals may be set by other modules or the embedder.
+	std::vector<bool> isWritten(module.globals.size(), false);
+	for(const Export& exportIt : module.exports)
+	{
+		if(exportIt.kind == ObjectKind::global) { isWritten[exportIt.index] = true; }
+	}
+
+	CodeReferenceVisitor visitor;
+	for(const FunctionDef& functionDef : module.functions.defs)
+	{ visitCodeReferences(functionDef, visitor); }
+	for(Uptr globalIndex : visitor.setGlobalIndices) { isWritten[globalIndex] = true; }
+
+	Uptr numImmutableGlobals    = 0;
+	const Uptr numGlobalImports = module.globals.imports.size();
+	for(Uptr globalDefIndex = 0; globalDefIndex < module.globals.defs.size(); ++globalDefIndex)
+	{
+		GlobalDef& globalDef = module.globals.defs[globalDefIndex];
+		if(globalDef.type.isMutable && !isWritten[numGlobalImports + globalDefIndex])
+		{
+			globalDef.type.isMutable = false;
+			++numImmutableGlobals;
+		}
+	}
+	return numImmutableGlobals;
+}
+
+static Uptr removeUnusedTypes(Module& module)
+{
+	std::vector<bool> isUsed(module.types.size(), false);
+	for(const FunctionImport& functionImport : module.functions.imports)
+	{ isUsed[functionImport.type.index] = true; }
+
+	std::vector<bool> codeUsesTypes(module.functions.defs.size(), false);
+	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+		++functionDefIndex)
+	{
+		const FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+		isUsed[functionDef.type.index] = true;
+
+		CodeReferenceVisitor visitor;
+		visitCodeReferences(functionDef, visitor);
+		for(Uptr typeIndex : visitor.typeIndices) { isUsed[typeIndex] = true; }
+		codeUsesTypes[functionDefIndex] = visitor.typeIndices.size() > 0;
+	}
+
+	// Number the used types in their original order.
+	std::vector<FunctionType> newTypes;
+	std::vector<Uptr> newTypeIndices(module.types.size(), UINTPTR_MAX);
+	bool isRenumbered = false;
+	for(Uptr typeIndex = 0; typeIndex < module.types.size(); ++typeIndex)
+	{
+		if(isUsed[typeIndex])
+		{
+			if(newTypes.size() != typeIndex) { isRenumbered = true; }
+			newTypeIndices[typeIndex] = newTypes.size();
+			newTypes.push_back(module.types[typeIndex]);
+		}
+	}
+	const Uptr numRemovedTypes = module.types.size() - newTypes.size();
+	if(!numRemovedTypes) { return 0; }
+
+	Uptr nameSectionIndex     = 0;
+	const bool hasNameSection = findUserSection(module, "name", nameSectionIndex);
+	DisassemblyNames names;
+	if(hasNameSection) { getDisassemblyNames(module, names); }
+
+	// If only types after the last used type were removed, the used types keep their indices.
+	if(isRenumbered)
+	{
+		useOwnArena(module);
+		for(FunctionImport& functionImport : module.functions.imports)
+		{ functionImport.type.index = newTypeIndices[functionImport.type.index]; }
+		for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+			++functionDefIndex)
+		{
+			FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+			functionDef.type.index   = newTypeIndices[functionDef.type.index];
+			if(codeUsesTypes[functionDefIndex])
+			{
+				ArrayOutputStream codeStream;
+				OperatorEncoderStream encoder(codeStream);
+				TypeRenumberingVisitor visitor(encoder, newTypeIndices);
+				OperatorDecoderStream decoder(functionDef.code);
+				while(decoder) { decoder.decodeOp(visitor); };
+
+				const Uptr numCodeBytes = functionDef.code.size();
+				functionDef.code        = module.arena->copyArray(codeStream.getBytes());
+				wavmAssert(functionDef.code.size() == numCodeBytes);
+			}
+		}
+	}
+	module.types = std::move(newTypes);
+
+	if(hasNameSection)
+	{
+		std::vector<std::string> newTypeNames(module.types.size());
+		for(Uptr typeIndex = 0; typeIndex < names.types.size(); ++typeIndex)
+		{
+			if(newTypeIndices[typeIndex] != UINTPTR_MAX)
+			{ newTypeNames[newTypeIndices[typeIndex]] = std::move(names.types[typeIndex]); }
+		}
+		names.types = std::move(newTypeNames);
+		setDisassemblyNames(module, names);
+	}
+
+	return numRemovedTypes;
+}
+
+void IR::optimizeModule(Module& module)
+{
+	Timing::Timer timer;
+
+	// Remove the unreachable function bodies first, so the other passes ignore their code.
+	const Uptr numRemovedFunctionBodies = removeUnreachableFunctionBodies(module);
+	const Uptr numImmutableGlobals      = makeUnwrittenGlobalsImmutable(module);
+	const Uptr numRemovedTypes          = removeUnusedTypes(module);
+
+	Timing::logTimer("Optimized module", timer);
+	Log::printf(Log::metrics,
+				"Removed %" PRIuPTR " unreachable function bodies and %" PRIuPTR
+				" unused types, and made %" PRIuPTR " globals immutable\n",
+				numRemovedFunctionBodies,
+				numRemovedTypes,
+				numImmutableGlobals);
+}
@@ -359,7 +359,7 @@ struct FunctionValidationContext
 		popAndValidateTypeTuple("br_table argument", defaultTargetParams);
 
 		wavmAssert(imm.branchTableIndex < functionDef.branchTables.size());
-		const std::vector<U32>& targetDepths = functionDef.branchTables[imm.branchTableIndex];
+		const ArenaArray<U32>& targetDepths = functionDef.branchTables[imm.branchTableIndex];
 		for(Uptr targetIndex = 0; targetIndex < targetDepths.size(); ++targetIndex)
 		{
 			const TypeTuple targetParams = getBranchTargetByDepth(targetDepths[targetIndex]).params;
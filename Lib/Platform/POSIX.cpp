@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <pthread.h>
+#include <sched.h>
 #include <setjmp.h>
 #include <signal.h>
 #include <string.h>
@@ -21,11 +22,18 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <ucontext.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#include <sys/syscall.h>
+#endif
 #include <atomic>
 #include <cstdlib>
 #include <exception>
 #include <memory>
+#include <vector>
 
 #define UNW_LOCAL_ONLY
 #include "libunwind.h"
@@ -252,16 +260,19 @@ void Platform::decommitVirtualPages(U8* baseVirtualAddress, Uptr numPages)
 {
 	errorUnless(isPageAligned(baseVirtualAddress));
 	auto numBytes = numPages << getPageSizeLog2();
-	if(madvise(baseVirtualAddress, numBytes, MADV_DONTNEED))
-	{
-		Errors::fatalf("madvise(0x%" PRIxPTR ", %u, MADV_DONTNEED) failed! errno=%s",
-					   reinterpret_cast<Uptr>(baseVirtualAddress),
-					   numBytes,
-					   strerror(errno));
-	}
-	if(mprotect(baseVirtualAddress, numBytes, PROT_NONE))
+
+	// Replace the pages with a new anonymous mapping rather than using madvise(MADV_DONTNEED),
+	// which would revert pages mapped from a MappableImage to the image's contents instead of
+	// discarding them.
+	if(mmap(baseVirtualAddress,
+			numBytes,
+			PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+			-1,
+			0)
+	   == MAP_FAILED)
 	{
-		Errors::fatalf("mprotect(0x%" PRIxPTR ", %u, PROT_NONE) failed! errno=%s",
+		Errors::fatalf("mmap(0x%" PRIxPTR ", %u, PROT_NONE, MAP_FIXED) failed! errno=%s",
 					   reinterpret_cast<Uptr>(baseVirtualAddress),
 					   numBytes,
 					   strerror(errno));
@@ -292,6 +303,82 @@ void Platform::freeAlignedVirtualPages(U8* unalignedBaseAddress, Uptr numPages,
 	}
 }
 
+struct Platform::MappableImage
+{
+	int fd;
+};
+
+MappableImage* Platform::createMappableImage(const U8* bytes, Uptr numBytes)
+{
+#if defined(__linux__) && defined(SYS_memfd_create)
+	// Create an anonymous file to hold the image.
+	const int fd = int(syscall(SYS_memfd_create, "WAVM image", MFD_CLOEXEC));
+	if(fd < 0) { return nullptr; }
+
+	// Size the file to a whole number of pages, and write the bytes to it.
+	const Uptr pageSize     = Uptr(1) << getPageSizeLog2();
+	const Uptr numFileBytes = (numBytes + pageSize - 1) & ~(pageSize - 1);
+	if(ftruncate(fd, off_t(numFileBytes)))
+	{
+		close(fd);
+		return nullptr;
+	}
+	Uptr numWrittenBytes = 0;
+	while(numWrittenBytes < numBytes)
+	{
+		const ssize_t result = pwrite(
+			fd, bytes + numWrittenBytes, numBytes - numWrittenBytes, off_t(numWrittenBytes));
+		if(result < 0 && errno == EINTR) { continue; }
+		if(result <= 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+		numWrittenBytes += Uptr(result);
+	}
+
+	return new MappableImage{fd};
+#else
+	return nullptr;
+#endif
+}
+
+void Platform::destroyMappableImage(MappableImage* image)
+{
+	close(image->fd);
+	delete image;
+}
+
+bool Platform::mapImagePages(MappableImage* image,
+							 Uptr imagePageIndex,
+							 U8* baseVirtualAddress,
+							 Uptr numPages)
+{
+	errorUnless(isPageAligned(baseVirtualAddress));
+	const Uptr pageSizeLog2 = getPageSizeLog2();
+	void* result            = mmap(baseVirtualAddress,
+                        numPages << pageSizeLog2,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED,
+                        image->fd,
+                        off_t(imagePageIndex << pageSizeLog2));
+	if(result == MAP_FAILED)
+	{
+		fprintf(stderr,
+				"mmap(0x%" PRIxPTR ", %" PRIuPTR
+				", PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, %d, %" PRIuPTR
+				") failed! errno=%s\n",
+				reinterpret_cast<Uptr>(baseVirtualAddress),
+				numPages << pageSizeLog2,
+				image->fd,
+				imagePageIndex << pageSizeLog2,
+				strerror(errno));
+		dumpErrorCallStack(0);
+		return false;
+	}
+	return true;
+}
+
 bool Platform::describeInstructionPointer(Uptr ip, std::string& outDescription)
 {
 	// Look up static symbol information for the address.
@@ -355,7 +442,7 @@ static void getCurrentThreadStack(U8*& outMinAddr, U8*& outMaxAddr)
 struct SignalContext
 {
 	SignalContext* outerContext;
-	jmp_buf catchJump;
+	sigjmp_buf catchJump;
 	std::function<bool(Platform::Signal, const Platform::CallStack&)> filter;
 };
 
@@ -418,7 +505,14 @@ struct PlatformException
 
 static thread_local SigAltStack sigAltStack;
 static thread_local SignalContext* innermostSignalContext = nullptr;
+
+// catchSignals doesn't save the signal mask, since that requires a system call on every call.
+// When a signal handler jumps back to catchSignals, it saves the signal mask that was active when
+// the signal was raised, so catchSignals can restore it.
+static thread_local bool hasInterruptedSignalMask = false;
+static thread_local sigset_t interruptedSignalMask;
 static std::atomic<SignalHandler> portableSignalHandler;
+static std::atomic<Uptr> signalCallStackMaxFrames{UINTPTR_MAX};
 
 static void deliverSignal(Signal signal, const CallStack& callStack)
 {
@@ -438,7 +532,7 @@ static void deliverSignal(Signal signal, const CallStack& callStack)
 	if(portableSignalHandlerSnapshot) { portableSignalHandlerSnapshot(signal, callStack); }
 }
 
-[[noreturn]] static void signalHandler(int signalNumber, siginfo_t* signalInfo, void*)
+[[noreturn]] static void signalHandler(int signalNumber, siginfo_t* signalInfo, void* context)
 {
 	Signal signal;
 
@@ -469,9 +563,16 @@ static void deliverSignal(Signal signal, const CallStack& callStack)
 
 	// Capture the execution context, omitting this function and the function that called it, so the
 	// top of the callstack is the function that triggered the signal.
-	CallStack callStack = captureCallStack(2);
+	CallStack callStack
+		= captureCallStack(2, signalCallStackMaxFrames.load(std::memory_order_relaxed));
+
+	// Save the signal mask from before the signal handler was entered, so it can be restored if the
+	// signal is delivered to a catchSignals call.
+	interruptedSignalMask    = reinterpret_cast<ucontext_t*>(context)->uc_sigmask;
+	hasInterruptedSignalMask = true;
 
 	deliverSignal(signal, callStack);
+	hasInterruptedSignalMask = false;
 
 	switch(signalNumber)
 	{
@@ -516,8 +617,9 @@ bool Platform::catchSignals(const std::function<void()>& thunk,
 	signalContext.filter       = filter;
 
 	// Use sigsetjmp to capture the execution state into the signal context. If a signal is raised,
-	// the signal handler will jump back to here.
-	bool isReturningFromSignalHandler = sigsetjmp(signalContext.catchJump, 1) != 0;
+	// the signal handler will jump back to here. The signal mask isn't saved, which would require a
+	// system call here and another in siglongjmp.
+	bool isReturningFromSignalHandler = sigsetjmp(signalContext.catchJump, 0) != 0;
 	if(!isReturningFromSignalHandler)
 	{
 		innermostSignalContext = &signalContext;
@@ -525,11 +627,208 @@ bool Platform::catchSignals(const std::function<void()>& thunk,
 		// Call the thunk.
 		thunk();
 	}
+	else if(hasInterruptedSignalMask)
+	{
+		// The signal handler jumped here with the signals that it blocks still blocked, so restore
+		// the signal mask from before the signal was raised.
+		hasInterruptedSignalMask = false;
+		errorUnless(!pthread_sigmask(SIG_SETMASK, &interruptedSignalMask, nullptr));
+	}
 	innermostSignalContext = signalContext.outerContext;
 
 	return isReturningFromSignalHandler;
 }
 
+enum
+{
+	maxSampleFrames   = 32,
+	numSamplesPerRing = 512
+};
+
+// A call stack sample recorded by the SIGPROF handler.
+struct Sample
+{
+	Uptr numFrames;
+	Uptr frames[maxSampleFrames];
+};
+
+// The samples recorded for a thread. The thread's SIGPROF handler is the only writer, and
+// readSamples is the only reader, so the ring doesn't need a lock.
+struct SampleRing
+{
+	U8* stackMinAddr;
+	U8* stackMaxAddr;
+	std::atomic<Uptr> writeIndex{0};
+	std::atomic<Uptr> readIndex{0};
+	std::atomic<bool> isThreadExited{false};
+	Sample samples[numSamplesPerRing];
+};
+
+static std::atomic<bool> isSampling{false};
+static Platform::Mutex sampleRingsMutex;
+static std::vector<SampleRing*> sampleRings;
+
+// The SIGPROF handler only uses this trivially constructed thread-local, so it doesn't need to
+// initialize any thread-local state.
+static thread_local SampleRing* threadSampleRing = nullptr;
+
+// Marks the thread's sample ring as exited when the thread exits, so readSamples can free it once
+// it has read the remaining samples.
+struct ThreadSampleRingOwner
+{
+	~ThreadSampleRingOwner()
+	{
+		SampleRing* ring = threadSampleRing;
+		if(ring)
+		{
+			threadSampleRing = nullptr;
+			ring->isThreadExited.store(true, std::memory_order_release);
+		}
+	}
+};
+static thread_local ThreadSampleRingOwner threadSampleRingOwner;
+
+static void registerSampledThread()
+{
+	if(threadSampleRing) { return; }
+
+	SampleRing* ring = new SampleRing;
+	getCurrentThreadStack(ring->stackMinAddr, ring->stackMaxAddr);
+	{
+		Lock<Platform::Mutex> sampleRingsLock(sampleRingsMutex);
+		sampleRings.push_back(ring);
+	}
+
+	// Reference threadSampleRingOwner so its destructor is run when the thread exits.
+	(void)&threadSampleRingOwner;
+	threadSampleRing = ring;
+}
+
+static void sampleSignalHandler(int signalNumber, siginfo_t* signalInfo, void* contextVoid)
+{
+	SampleRing* ring = threadSampleRing;
+	if(!ring) { return; }
+
+	// If the reader hasn't made room in the ring, drop the sample.
+	const Uptr writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+	if(writeIndex - ring->readIndex.load(std::memory_order_acquire) >= numSamplesPerRing)
+	{ return; }
+	Sample& sample = ring->samples[writeIndex % numSamplesPerRing];
+
+	// Read the interrupted thread's instruction, stack, and frame pointers.
+	const ucontext_t* context = reinterpret_cast<const ucontext_t*>(contextVoid);
+#if defined(__x86_64__)
+	const Uptr ip = Uptr(context->uc_mcontext.gregs[REG_RIP]);
+	const Uptr sp = Uptr(context->uc_mcontext.gregs[REG_RSP]);
+	Uptr fp       = Uptr(context->uc_mcontext.gregs[REG_RBP]);
+#else
+	const Uptr ip = Uptr(context->uc_mcontext.pc);
+	const Uptr sp = Uptr(context->uc_mcontext.sp);
+	Uptr fp       = Uptr(context->uc_mcontext.regs[29]);
+#endif
+	sample.frames[0] = ip;
+	sample.numFrames = 1;
+
+	// Walk the frame pointer chain: each frame stores the caller's frame pointer followed by the
+	// return address. Only follow frame pointers that are aligned, within the thread's stack, and
+	// above the previous frame, so code that uses the frame pointer register for something else
+	// can't make the walk read outside the stack.
+	const Uptr stackMaxAddr = reinterpret_cast<Uptr>(ring->stackMaxAddr);
+	if(sp >= reinterpret_cast<Uptr>(ring->stackMinAddr) && sp < stackMaxAddr)
+	{
+		Uptr minFP = sp;
+		while(sample.numFrames < maxSampleFrames && fp >= minFP && !(fp & (sizeof(Uptr) - 1))
+			  && fp + 2 * sizeof(Uptr) <= stackMaxAddr)
+		{
+			const Uptr* frame        = reinterpret_cast<const Uptr*>(fp);
+			const Uptr returnAddress = frame[1];
+			if(!returnAddress) { break; }
+			sample.frames[sample.numFrames++] = returnAddress;
+
+			minFP = fp + 2 * sizeof(Uptr);
+			fp    = frame[0];
+		}
+	}
+
+	ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+bool Platform::startSampling(Uptr intervalMicroseconds)
+{
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+	wavmAssert(intervalMicroseconds > 0);
+
+	static bool hasInitializedSampleSignalHandler = false;
+	if(!hasInitializedSampleSignalHandler)
+	{
+		hasInitializedSampleSignalHandler = true;
+
+		struct sigaction signalAction;
+		memset(&signalAction, 0, sizeof(signalAction));
+		sigemptyset(&signalAction.sa_mask);
+		signalAction.sa_sigaction = sampleSignalHandler;
+		signalAction.sa_flags     = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+		errorUnless(!sigaction(SIGPROF, &signalAction, nullptr));
+	}
+
+	registerSampledThread();
+	isSampling.store(true, std::memory_order_relaxed);
+
+	// Start a timer that sends SIGPROF to the process every intervalMicroseconds of CPU time. The
+	// kernel delivers the signal to a thread that is using the CPU.
+	struct itimerval timer;
+	timer.it_interval.tv_sec  = time_t(intervalMicroseconds / 1000000);
+	timer.it_interval.tv_usec = suseconds_t(intervalMicroseconds % 1000000);
+	timer.it_value            = timer.it_interval;
+	errorUnless(!setitimer(ITIMER_PROF, &timer, nullptr));
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Platform::stopSampling()
+{
+	struct itimerval timer;
+	memset(&timer, 0, sizeof(timer));
+	errorUnless(!setitimer(ITIMER_PROF, &timer, nullptr));
+	isSampling.store(false, std::memory_order_relaxed);
+}
+
+void Platform::readSamples(const std::function<void(const CallStack&)>& visitSample)
+{
+	Lock<Platform::Mutex> sampleRingsLock(sampleRingsMutex);
+
+	CallStack callStack;
+	Uptr numRemainingRings = 0;
+	for(SampleRing* ring : sampleRings)
+	{
+		// Check whether the thread has exited before reading the samples, so no samples can be
+		// written after the last read.
+		const bool isThreadExited = ring->isThreadExited.load(std::memory_order_acquire);
+
+		const Uptr writeIndex = ring->writeIndex.load(std::memory_order_acquire);
+		Uptr readIndex        = ring->readIndex.load(std::memory_order_relaxed);
+		for(; readIndex != writeIndex; ++readIndex)
+		{
+			const Sample& sample = ring->samples[readIndex % numSamplesPerRing];
+			callStack.stackFrames.clear();
+			for(Uptr frameIndex = 0; frameIndex < sample.numFrames; ++frameIndex)
+			{ callStack.stackFrames.push_back({sample.frames[frameIndex]}); }
+			visitSample(callStack);
+		}
+		ring->readIndex.store(readIndex, std::memory_order_release);
+
+		// Free the rings of exited threads, and keep the rest.
+		if(isThreadExited) { delete ring; }
+		else
+		{
+			sampleRings[numRemainingRings++] = ring;
+		}
+	}
+	sampleRings.resize(numRemainingRings);
+}
+
 static void terminateHandler()
 {
 	try
@@ -550,6 +849,11 @@ static void terminateHandler()
 	}
 }
 
+void Platform::setSignalCallStackMaxFrames(Uptr maxFrames)
+{
+	signalCallStackMaxFrames.store(maxFrames, std::memory_order_relaxed);
+}
+
 void Platform::setSignalHandler(SignalHandler handler)
 {
 	initSignals();
@@ -560,9 +864,10 @@ void Platform::setSignalHandler(SignalHandler handler)
 	portableSignalHandler.store(handler);
 }
 
-CallStack Platform::captureCallStack(Uptr numOmittedFramesFromTop)
+CallStack Platform::captureCallStack(Uptr numOmittedFramesFromTop, Uptr maxFrames)
 {
 	CallStack result;
+	if(!maxFrames) { return result; }
 
 	unw_context_t context;
 	errorUnless(!unw_getcontext(&context));
@@ -570,7 +875,7 @@ CallStack Platform::captureCallStack(Uptr numOmittedFramesFromTop)
 	unw_cursor_t cursor;
 
 	errorUnless(!unw_init_local(&cursor, &context));
-	while(unw_step(&cursor) > 0)
+	while(result.stackFrames.size() < maxFrames && unw_step(&cursor) > 0)
 	{
 		if(numOmittedFramesFromTop) { --numOmittedFramesFromTop; }
 		else
@@ -656,7 +961,8 @@ std::type_info* Platform::getUserExceptionTypeInfo()
 
 [[noreturn]] void Platform::raisePlatformException(void* data)
 {
-	throw PlatformException{data, captureCallStack(1)};
+	throw PlatformException{
+		data, captureCallStack(1, signalCallStackMaxFrames.load(std::memory_order_relaxed))};
 	printf("unhandled PlatformException\n");
 	Errors::unreachable();
 }
@@ -695,6 +1001,7 @@ NO_ASAN static void* createThreadEntry(void* argsVoid)
 	try
 	{
 		sigAltStack.init();
+		if(isSampling.load(std::memory_order_relaxed)) { registerSampledThread(); }
 
 		threadEntryFramePointer = getStackPointer();
 
@@ -728,6 +1035,14 @@ Platform::Thread* Platform::createThread(Uptr numStackBytes,
 	return thread;
 }
 
+Uptr Platform::getNumberOfHardwareThreads()
+{
+	const long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	return numProcessors > 0 ? Uptr(numProcessors) : 1;
+}
+
+void Platform::yieldToAnotherThread() { sched_yield(); }
+
 void Platform::detachThread(Thread* thread)
 {
 	errorUnless(!pthread_detach(thread->id));
@@ -887,8 +1202,9 @@ Platform::Event::Event()
 	errorUnless(!pthread_condattr_setclock(&conditionVariableAttr, CLOCK_MONOTONIC));
 #endif
 
-	errorUnless(!pthread_cond_init((pthread_cond_t*)&pthreadCond, nullptr));
+	errorUnless(!pthread_cond_init((pthread_cond_t*)&pthreadCond, &conditionVariableAttr));
 	errorUnless(!pthread_mutex_init((pthread_mutex_t*)&pthreadMutex, nullptr));
+	isSignaled = false;
 
 	errorUnless(!pthread_condattr_destroy(&conditionVariableAttr));
 }
@@ -903,32 +1219,117 @@ bool Platform::Event::wait(U64 untilTime)
 {
 	errorUnless(!pthread_mutex_lock((pthread_mutex_t*)&pthreadMutex));
 
-	int result;
-	if(untilTime == UINT64_MAX)
-	{
-		result = pthread_cond_wait((pthread_cond_t*)&pthreadCond, (pthread_mutex_t*)&pthreadMutex);
-	}
-	else
+	// Loop until the event is signaled to handle spurious wakeups from pthread_cond_wait.
+	while(!isSignaled)
 	{
-		timespec untilTimeSpec;
-		untilTimeSpec.tv_sec  = untilTime / 1000000;
-		untilTimeSpec.tv_nsec = (untilTime % 1000000) * 1000;
+		int result;
+		if(untilTime == UINT64_MAX)
+		{
+			result
+				= pthread_cond_wait((pthread_cond_t*)&pthreadCond, (pthread_mutex_t*)&pthreadMutex);
+		}
+		else
+		{
+			timespec untilTimeSpec;
+			untilTimeSpec.tv_sec  = untilTime / 1000000;
+			untilTimeSpec.tv_nsec = (untilTime % 1000000) * 1000;
 
-		result = pthread_cond_timedwait(
-			(pthread_cond_t*)&pthreadCond, (pthread_mutex_t*)&pthreadMutex, &untilTimeSpec);
+			result = pthread_cond_timedwait(
+				(pthread_cond_t*)&pthreadCond, (pthread_mutex_t*)&pthreadMutex, &untilTimeSpec);
+		}
+
+		if(result == ETIMEDOUT) { break; }
+		errorUnless(!result);
 	}
 
+	// Reset the event when a wait returns because it was signaled, like a Windows auto-reset event.
+	const bool wasSignaled = isSignaled;
+	isSignaled             = false;
+
 	errorUnless(!pthread_mutex_unlock((pthread_mutex_t*)&pthreadMutex));
 
-	if(result == ETIMEDOUT) { return false; }
-	else
+	return wasSignaled;
+}
+
+void Platform::Event::signal()
+{
+	errorUnless(!pthread_mutex_lock((pthread_mutex_t*)&pthreadMutex));
+	isSignaled = true;
+	errorUnless(!pthread_cond_signal((pthread_cond_t*)&pthreadCond));
+	errorUnless(!pthread_mutex_unlock((pthread_mutex_t*)&pthreadMutex));
+}
+
+Platform::AddressWaitResult Platform::waitOnAddress32(const U32* address,
+													  U32 expectedValue,
+													  U64 untilClock)
+{
+#ifdef __linux__
+	while(true)
 	{
-		errorUnless(!result);
-		return true;
+		timespec timeoutSpec;
+		timespec* timeoutSpecPointer = nullptr;
+		if(untilClock != UINT64_MAX)
+		{
+			// FUTEX_WAIT takes a timeout relative to the current CLOCK_MONOTONIC time.
+			const U64 currentClock = getMonotonicClock();
+			if(currentClock >= untilClock)
+			{
+				return ((const std::atomic<U32>*)address)->load() == expectedValue
+						   ? AddressWaitResult::timedOut
+						   : AddressWaitResult::notEqual;
+			}
+
+			const U64 timeoutMicroseconds = untilClock - currentClock;
+			timeoutSpec.tv_sec            = timeoutMicroseconds / 1000000;
+			timeoutSpec.tv_nsec           = (timeoutMicroseconds % 1000000) * 1000;
+			timeoutSpecPointer            = &timeoutSpec;
+		}
+
+		if(!syscall(SYS_futex,
+					address,
+					FUTEX_WAIT_PRIVATE,
+					expectedValue,
+					timeoutSpecPointer,
+					nullptr,
+					0))
+		{ return AddressWaitResult::woken; }
+
+		switch(errno)
+		{
+		case EAGAIN: return AddressWaitResult::notEqual;
+		case ETIMEDOUT: return AddressWaitResult::timedOut;
+
+		// If the wait was interrupted by a signal, wait again with the remaining timeout.
+		case EINTR: break;
+
+		default:
+			Errors::fatalf("futex(0x%" PRIxPTR ", FUTEX_WAIT_PRIVATE) failed! errno=%s",
+						   reinterpret_cast<Uptr>(address),
+						   strerror(errno));
+		};
 	}
+#else
+	return AddressWaitResult::unsupported;
+#endif
 }
 
-void Platform::Event::signal() { errorUnless(!pthread_cond_signal((pthread_cond_t*)&pthreadCond)); }
+Uptr Platform::wakeAddress32(const U32* address, U32 numToWake)
+{
+#ifdef __linux__
+	const int futexNumToWake = numToWake > U32(INT_MAX) ? INT_MAX : int(numToWake);
+	const long result
+		= syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, futexNumToWake, nullptr, nullptr, 0);
+	if(result < 0)
+	{
+		Errors::fatalf("futex(0x%" PRIxPTR ", FUTEX_WAKE_PRIVATE) failed! errno=%s",
+					   reinterpret_cast<Uptr>(address),
+					   strerror(errno));
+	}
+	return Uptr(result);
+#else
+	return 0;
+#endif
+}
 
 // Instead of just reinterpreting the file descriptor as a pointer, use -fd - 1, which maps fd=0 to
 // a non-null value, and fd=-1 to null.
@@ -1021,6 +1422,17 @@ bool Platform::writeFile(File* file, const void* data, Uptr numBytes, Uptr* outN
 
 bool Platform::flushFileWrites(File* file) { return fsync(filePtrToIndex(file)) == 0; }
 
+const U8* Platform::mapFile(File* file, Uptr numBytes)
+{
+	void* result = mmap(nullptr, numBytes, PROT_READ, MAP_PRIVATE, filePtrToIndex(file), 0);
+	return result == MAP_FAILED ? nullptr : (const U8*)result;
+}
+
+void Platform::unmapFile(const U8* bytes, Uptr numBytes)
+{
+	errorUnless(!munmap(const_cast<U8*>(bytes), numBytes));
+}
+
 std::string Platform::getCurrentWorkingDirectory()
 {
 	const Uptr maxPathBytes = pathconf(".", _PC_PATH_MAX);
@@ -205,6 +205,18 @@ void Platform::freeAlignedVirtualPages(U8* unalignedBaseAddress, Uptr numPages,
 	if(unalignedBaseAddress && !result) { Errors::fatal("VirtualFree(MEM_RELEASE) failed"); }
 }
 
+MappableImage* Platform::createMappableImage(const U8* bytes, Uptr numBytes) { return nullptr; }
+
+void Platform::destroyMappableImage(MappableImage* image) { Errors::unreachable(); }
+
+bool Platform::mapImagePages(MappableImage* image,
+							 Uptr imagePageIndex,
+							 U8* baseVirtualAddress,
+							 Uptr numPages)
+{
+	Errors::unreachable();
+}
+
 static Mutex& getErrorReportingMutex()
 {
 	static Platform::Mutex mutex;
@@ -327,7 +339,11 @@ bool Platform::describeInstructionPointer(Uptr ip, std::string& outDescription)
 	}
 }
 
-static CallStack unwindStack(const CONTEXT& immutableContext, Uptr numOmittedFramesFromTop)
+static std::atomic<Uptr> signalCallStackMaxFrames{UINTPTR_MAX};
+
+static CallStack unwindStack(const CONTEXT& immutableContext,
+							 Uptr numOmittedFramesFromTop,
+							 Uptr maxFrames)
 {
 	// Make a mutable copy of the context.
 	CONTEXT context;
@@ -337,7 +353,7 @@ static CallStack unwindStack(const CONTEXT& immutableContext, Uptr numOmittedFra
 	// reached the base.
 	CallStack callStack;
 #ifdef _WIN64
-	while(context.Rip)
+	while(context.Rip && callStack.stackFrames.size() < maxFrames)
 	{
 		if(numOmittedFramesFromTop) { --numOmittedFramesFromTop; }
 		else
@@ -374,16 +390,31 @@ static CallStack unwindStack(const CONTEXT& immutableContext, Uptr numOmittedFra
 	return callStack;
 }
 
-CallStack Platform::captureCallStack(Uptr numOmittedFramesFromTop)
+// Unwinds the stack from the context of a signal or platform exception.
+static CallStack unwindSignalStack(const CONTEXT& context)
+{
+	return unwindStack(context, 0, signalCallStackMaxFrames.load(std::memory_order_relaxed));
+}
+
+CallStack Platform::captureCallStack(Uptr numOmittedFramesFromTop, Uptr maxFrames)
 {
 	// Capture the current processor state.
 	CONTEXT context;
 	RtlCaptureContext(&context);
 
 	// Unwind the stack.
-	return unwindStack(context, numOmittedFramesFromTop + 1);
+	return unwindStack(context, numOmittedFramesFromTop + 1, maxFrames);
 }
 
+void Platform::setSignalCallStackMaxFrames(Uptr maxFrames)
+{
+	signalCallStackMaxFrames.store(maxFrames, std::memory_order_relaxed);
+}
+
+bool Platform::startSampling(Uptr intervalMicroseconds) { return false; }
+void Platform::stopSampling() {}
+void Platform::readSamples(const std::function<void(const CallStack&)>& visitSample) {}
+
 void Platform::registerEHFrames(const U8* imageBase, const U8* ehFrames, Uptr numBytes)
 {
 	const U32 numFunctions = (U32)(numBytes / sizeof(RUNTIME_FUNCTION));
@@ -432,7 +463,7 @@ sehSignalFilterFunctionNonReentrant(EXCEPTION_POINTERS* exceptionPointers,
 	else
 	{
 		// Unwind the stack frames from the context of the exception.
-		CallStack callStack = unwindStack(*exceptionPointers->ContextRecord, 0);
+		CallStack callStack = unwindSignalStack(*exceptionPointers->ContextRecord);
 
 		if(filter(signal, callStack)) { return EXCEPTION_EXECUTE_HANDLER; }
 		else
@@ -499,7 +530,7 @@ static LONG NTAPI unhandledExceptionFilterNonRentrant(struct _EXCEPTION_POINTERS
 	}
 
 	// Unwind the stack frames from the context of the exception.
-	CallStack callStack = unwindStack(*exceptionPointers->ContextRecord, 0);
+	CallStack callStack = unwindSignalStack(*exceptionPointers->ContextRecord);
 
 	(signalHandler.load())(signal, callStack);
 
@@ -543,7 +574,7 @@ static LONG CALLBACK sehPlatformExceptionFilterFunction(EXCEPTION_POINTERS* exce
 			= reinterpret_cast<void*>(exceptionPointers->ExceptionRecord->ExceptionInformation[0]);
 
 		// Unwind the stack frames from the context of the exception.
-		outCallStack = new CallStack(unwindStack(*exceptionPointers->ContextRecord, 0));
+		outCallStack = new CallStack(unwindSignalStack(*exceptionPointers->ContextRecord));
 		return EXCEPTION_EXECUTE_HANDLER;
 	}
 }
@@ -699,6 +730,15 @@ Platform::Thread* Platform::createThread(Uptr numStackBytes,
 	return args->thread;
 }
 
+Uptr Platform::getNumberOfHardwareThreads()
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwNumberOfProcessors;
+}
+
+void Platform::yieldToAnotherThread() { SwitchToThread(); }
+
 void Platform::detachThread(Thread* thread)
 {
 	wavmAssert(thread);
@@ -923,6 +963,15 @@ bool Platform::Event::wait(U64 untilTime)
 
 void Platform::Event::signal() { errorUnless(SetEvent(handle)); }
 
+Platform::AddressWaitResult Platform::waitOnAddress32(const U32* address,
+													  U32 expectedValue,
+													  U64 untilClock)
+{
+	return AddressWaitResult::unsupported;
+}
+
+Uptr Platform::wakeAddress32(const U32* address, U32 numToWake) { return 0; }
+
 static File* fileHandleToPointer(HANDLE handle)
 {
 	return reinterpret_cast<File*>(reinterpret_cast<Uptr>(handle) + 1);
@@ -1036,6 +1085,23 @@ bool Platform::flushFileWrites(File* file)
 	return FlushFileBuffers(filePointerToHandle(file)) != 0;
 }
 
+const U8* Platform::mapFile(File* file, Uptr numBytes)
+{
+	HANDLE mappingHandle
+		= CreateFileMappingW(filePointerToHandle(file), nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(!mappingHandle) { return nullptr; }
+
+	// The view keeps the file mapping object alive, so the handle may be closed immediately.
+	void* result = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, numBytes);
+	errorUnless(CloseHandle(mappingHandle));
+	return (const U8*)result;
+}
+
+void Platform::unmapFile(const U8* bytes, Uptr numBytes)
+{
+	errorUnless(UnmapViewOfFile(bytes));
+}
+
 std::string Platform::getCurrentWorkingDirectory()
 {
 	U16 buffer[MAX_PATH];
@@ -1,12 +1,12 @@
 #include "Inline/Assert.h"
 #include "Inline/BasicTypes.h"
-#include "Inline/HashMap.h"
+#include "Inline/Errors.h"
+#include "Inline/Hash.h"
 #include "Inline/Lock.h"
 #include "Intrinsics.h"
 #include "Logging/Logging.h"
 #include "RuntimePrivate.h"
 
-#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <memory>
@@ -14,58 +14,53 @@
 
 using namespace Runtime;
 
-// Holds a list of threads (in the form of events that will wake them) that
-// are waiting on a specific address.
-struct WaitList
+// A thread waiting on an address in the parking lot.
+struct Waiter
 {
-	Platform::Mutex mutex;
-	std::vector<Platform::Event*> wakeEvents;
-	std::atomic<Uptr> numReferences;
+	Uptr address;
+	Waiter* next;
+	bool isWoken;
+	Platform::Event wakeEvent;
+};
+
+// A waiter that is reused within a thread whenever it waits in the parking lot.
+thread_local std::unique_ptr<Waiter> threadWaiter = nullptr;
 
-	WaitList() : numReferences(1) {}
+// The parking lot hashes addresses that are waited on into a fixed number of buckets, each with its
+// own lock and FIFO queue of waiters, so waits and wakes on unrelated addresses rarely contend.
+enum
+{
+	numParkingLotBuckets = 256
 };
 
-// An event that is reused within a thread when it waits on a WaitList.
-thread_local std::unique_ptr<Platform::Event> threadWakeEvent = nullptr;
+struct alignas(64) ParkingLotBucket
+{
+	Platform::Mutex mutex;
+	Waiter* firstWaiter = nullptr;
+	Waiter* lastWaiter  = nullptr;
+
+	// The number of threads natively waiting on an address in this bucket with
+	// Platform::waitOnAddress32. Wakes skip the native wake if it's zero.
+	std::atomic<Uptr> numNativeWaiters{0};
+};
 
-// A map from address to a list of threads waiting on that address.
-static Platform::Mutex addressToWaitListMapMutex;
-static HashMap<Uptr, WaitList*> addressToWaitListMap;
+static ParkingLotBucket parkingLotBuckets[numParkingLotBuckets];
 
-// Opens the wait list for a given address.
-// Increases the wait list's reference count, and returns a pointer to it.
-// Note that it does not lock the wait list mutex.
-// A call to openWaitList should be followed by a call to closeWaitList to avoid leaks.
-static WaitList* openWaitList(Uptr address)
+static ParkingLotBucket& getParkingLotBucket(Uptr address)
 {
-	Lock<Platform::Mutex> mapLock(addressToWaitListMapMutex);
-	auto waitListPtr = addressToWaitListMap.get(address);
-	if(waitListPtr)
-	{
-		++(*waitListPtr)->numReferences;
-		return *waitListPtr;
-	}
-	else
-	{
-		WaitList* waitList = new WaitList();
-		addressToWaitListMap.set(address, waitList);
-		return waitList;
-	}
+	return parkingLotBuckets[XXH64_fixed(U64(address), 0) % numParkingLotBuckets];
 }
 
-// Closes a wait list, deleting it and removing it from the global map if it was the last reference.
-static void closeWaitList(Uptr address, WaitList* waitList)
+// Removes a waiter from a bucket's queue. The caller must hold the bucket's mutex.
+static void unlinkWaiter(ParkingLotBucket& bucket, Waiter* previousWaiter, Waiter* waiter)
 {
-	if(--waitList->numReferences == 0)
+	if(previousWaiter) { previousWaiter->next = waiter->next; }
+	else
 	{
-		Lock<Platform::Mutex> mapLock(addressToWaitListMapMutex);
-		if(!waitList->numReferences)
-		{
-			wavmAssert(!waitList->wakeEvents.size());
-			delete waitList;
-			addressToWaitListMap.remove(address);
-		}
+		bucket.firstWaiter = waiter->next;
 	}
+	if(bucket.lastWaiter == waiter) { bucket.lastWaiter = previousWaiter; }
+	waiter->next = nullptr;
 }
 
 // Loads a value from memory with seq_cst memory order.
@@ -104,93 +99,132 @@ static U64 getEndTimeFromTimeout(U64 startTime, F64 timeout)
 }
 
 template<typename Value>
-static U32 waitOnAddress(Value* valuePointer, Value expectedValue, F64 timeout)
+static U32 waitOnAddressImpl(Value* valuePointer, Value expectedValue, F64 timeout)
 {
 	const U64 endTime = getEndTimeFromTimeout(Platform::getMonotonicClock(), timeout);
 
-	// Open the wait list for this address.
-	const Uptr address = reinterpret_cast<Uptr>(valuePointer);
-	WaitList* waitList = openWaitList(address);
+	const Uptr address       = reinterpret_cast<Uptr>(valuePointer);
+	ParkingLotBucket& bucket = getParkingLotBucket(address);
 
-	// Lock the wait list, and check that *valuePointer is still what the caller expected it to be.
+	// If the platform supports it, wait on 32-bit values directly with the OS's address-keyed wait
+	// primitive, which avoids taking the bucket's mutex.
+	if(sizeof(Value) == sizeof(U32))
 	{
-		Lock<Platform::Mutex> waitListLock(waitList->mutex);
-		if(atomicLoad(valuePointer) != expectedValue)
+		++bucket.numNativeWaiters;
+		const Platform::AddressWaitResult waitResult
+			= Platform::waitOnAddress32((const U32*)valuePointer, U32(expectedValue), endTime);
+		--bucket.numNativeWaiters;
+
+		switch(waitResult)
 		{
-			// If *valuePointer wasn't the expected value, unlock the wait list and return.
-			waitListLock.unlock();
-			closeWaitList(address, waitList);
-			return 1;
-		}
+		case Platform::AddressWaitResult::woken: return 0;
+		case Platform::AddressWaitResult::notEqual: return 1;
+		case Platform::AddressWaitResult::timedOut: return 2;
+		case Platform::AddressWaitResult::unsupported: break;
+		default: Errors::unreachable();
+		};
+	}
+
+	// If the thread hasn't yet created a waiter, do so.
+	if(!threadWaiter) { threadWaiter = std::unique_ptr<Waiter>(new Waiter()); }
+	Waiter* waiter = threadWaiter.get();
+
+	// Lock the bucket, and check that *valuePointer is still what the caller expected it to be.
+	{
+		Lock<Platform::Mutex> bucketLock(bucket.mutex);
+		if(atomicLoad(valuePointer) != expectedValue) { return 1; }
+
+		// Add the waiter to the end of the bucket's queue.
+		waiter->address = address;
+		waiter->next    = nullptr;
+		waiter->isWoken = false;
+		if(bucket.lastWaiter) { bucket.lastWaiter->next = waiter; }
 		else
 		{
-			// If the thread hasn't yet created a wake event, do so.
-			if(!threadWakeEvent)
-			{ threadWakeEvent = std::unique_ptr<Platform::Event>(new Platform::Event()); }
-
-			// Add the wake event to the wait list, and unlock the wait list.
-			waitList->wakeEvents.push_back(threadWakeEvent.get());
-			waitListLock.unlock();
+			bucket.firstWaiter = waiter;
 		}
+		bucket.lastWaiter = waiter;
 	}
 
-	// Wait for the thread's wake event to be signaled.
-	bool timedOut = false;
-	if(!threadWakeEvent->wait(endTime))
+	// Wait for the waiter's wake event to be signaled.
+	if(!waiter->wakeEvent.wait(endTime))
 	{
-		// If the wait timed out, lock the wait list and check if the thread's wake event is still
-		// in the wait list.
-		Lock<Platform::Mutex> waitListLock(waitList->mutex);
-		auto wakeEventIt = std::find(
-			waitList->wakeEvents.begin(), waitList->wakeEvents.end(), threadWakeEvent.get());
-		if(wakeEventIt != waitList->wakeEvents.end())
+		// If the wait timed out, lock the bucket and check if the waiter is still in its queue.
+		Lock<Platform::Mutex> bucketLock(bucket.mutex);
+		if(!waiter->isWoken)
 		{
-			// If the event was still on the wait list, remove it, and return the "timed out"
-			// result.
-			waitList->wakeEvents.erase(wakeEventIt);
-			timedOut = true;
+			// If the waiter was still in the queue, remove it, and return the "timed out" result.
+			Waiter* previousWaiter = nullptr;
+			Waiter* queuedWaiter   = bucket.firstWaiter;
+			while(queuedWaiter != waiter)
+			{
+				wavmAssert(queuedWaiter);
+				previousWaiter = queuedWaiter;
+				queuedWaiter   = queuedWaiter->next;
+			}
+			unlinkWaiter(bucket, previousWaiter, waiter);
+			return 2;
 		}
 		else
 		{
-			// In between the wait timing out and locking the wait list, some other thread tried to
+			// In between the wait timing out and locking the bucket, some other thread tried to
 			// wake this thread. The event will now be signaled, so use an immediately expiring wait
 			// on it to reset it.
-			errorUnless(threadWakeEvent->wait(Platform::getMonotonicClock()));
+			errorUnless(waiter->wakeEvent.wait(Platform::getMonotonicClock()));
 		}
 	}
 
-	closeWaitList(address, waitList);
-	return timedOut ? 2 : 0;
+	return 0;
 }
 
-static U32 wakeAddress(Uptr address, U32 numToWake)
+U32 Runtime::waitOnAddress(I32* valuePointer, I32 expectedValue, F64 timeout)
 {
-	if(numToWake == 0) { return 0; }
+	return waitOnAddressImpl(valuePointer, expectedValue, timeout);
+}
 
-	// Open the wait list for this address.
-	WaitList* waitList   = openWaitList(address);
-	Uptr actualNumToWake = numToWake;
-	{
-		Lock<Platform::Mutex> waitListLock(waitList->mutex);
+U32 Runtime::waitOnAddress(I64* valuePointer, I64 expectedValue, F64 timeout)
+{
+	return waitOnAddressImpl(valuePointer, expectedValue, timeout);
+}
+
+U32 Runtime::wakeAddress(Uptr address, U32 numToWake)
+{
+	if(numToWake == 0) { return 0; }
 
-		// Determine how many threads to wake.
-		// numToWake==UINT32_MAX means wake all waiting threads.
-		if(actualNumToWake == UINT32_MAX || actualNumToWake > waitList->wakeEvents.size())
-		{ actualNumToWake = waitList->wakeEvents.size(); }
+	// numToWake==UINT32_MAX means wake all waiting threads.
+	const Uptr maxToWake     = numToWake == UINT32_MAX ? UINTPTR_MAX : Uptr(numToWake);
+	ParkingLotBucket& bucket = getParkingLotBucket(address);
 
-		// Signal the events corresponding to the oldest waiting threads.
-		for(Uptr wakeIndex = 0; wakeIndex < actualNumToWake; ++wakeIndex)
-		{ waitList->wakeEvents[wakeIndex]->signal(); }
+	// Wake threads natively waiting on the address, but skip the system call if no thread is
+	// natively waiting on any address in the bucket.
+	Uptr numWoken = 0;
+	if(bucket.numNativeWaiters.load())
+	{ numWoken = Platform::wakeAddress32((const U32*)address, numToWake); }
 
-		// Remove the events from the wait list.
-		waitList->wakeEvents.erase(waitList->wakeEvents.begin(),
-								   waitList->wakeEvents.begin() + actualNumToWake);
+	// Wake the oldest threads waiting on the address in the parking lot.
+	if(numWoken < maxToWake)
+	{
+		Lock<Platform::Mutex> bucketLock(bucket.mutex);
+		Waiter* previousWaiter = nullptr;
+		Waiter* waiter         = bucket.firstWaiter;
+		while(waiter && numWoken < maxToWake)
+		{
+			Waiter* nextWaiter = waiter->next;
+			if(waiter->address != address) { previousWaiter = waiter; }
+			else
+			{
+				unlinkWaiter(bucket, previousWaiter, waiter);
+				waiter->isWoken = true;
+				waiter->wakeEvent.signal();
+				++numWoken;
+			}
+			waiter = nextWaiter;
+		}
 	}
-	closeWaitList(address, waitList);
 
-	if(actualNumToWake > UINT32_MAX)
+	if(numWoken > UINT32_MAX)
 	{ Runtime::throwException(Runtime::Exception::integerDivideByZeroOrOverflowType); }
-	return U32(actualNumToWake);
+	return U32(numWoken);
 }
 
 DEFINE_INTRINSIC_FUNCTION_WITH_MEM_AND_TABLE(wavmIntrinsics,
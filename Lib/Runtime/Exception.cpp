@@ -1,5 +1,6 @@
 #include "Inline/Assert.h"
 #include "Inline/BasicTypes.h"
+#include "Inline/Lock.h"
 #include "Intrinsics.h"
 #include "Logging/Logging.h"
 #include "Runtime.h"
@@ -48,6 +49,11 @@ std::vector<std::string> Runtime::describeCallStack(const Platform::CallStack& c
 	return frameDescriptions;
 }
 
+void Runtime::setExceptionCallStackMaxFrames(Uptr maxFrames)
+{
+	Platform::setSignalCallStackMaxFrames(maxFrames);
+}
+
 ExceptionTypeInstance* Runtime::createExceptionTypeInstance(IR::ExceptionType type,
 															std::string&& debugName)
 {
@@ -79,21 +85,37 @@ std::string Runtime::describeException(const Exception& exception)
 		}
 		result += ')';
 	}
-	std::vector<std::string> callStackDescription = describeCallStack(exception.callStack);
-	result += "\nCall stack:\n";
-	for(auto calledFunction : callStackDescription)
+	if(exception.callStack.stackFrames.size())
 	{
-		result += "  ";
-		result += calledFunction.c_str();
-		result += '\n';
+		std::vector<std::string> callStackDescription = describeCallStack(exception.callStack);
+		result += "\nCall stack:\n";
+		for(auto calledFunction : callStackDescription)
+		{
+			result += "  ";
+			result += calledFunction.c_str();
+			result += '\n';
+		}
 	}
 	return result;
 }
 
+void Runtime::countTrap(ExceptionTypeInstance* typeInstance)
+{
+	Compartment* compartment = currentInvokeCompartment;
+	if(compartment)
+	{
+		const std::string typeName = describeExceptionType(typeInstance);
+
+		Lock<Platform::Mutex> trapCountsLock(compartment->trapCountsMutex);
+		++compartment->numTrapsByExceptionType.getOrAdd(typeName, 0);
+	}
+}
+
 [[noreturn]] void Runtime::throwException(ExceptionTypeInstance* typeInstance,
 										  std::vector<UntaggedValue>&& arguments)
 {
 	wavmAssert(arguments.size() == typeInstance->type.params.size());
+	countTrap(typeInstance);
 	ExceptionData* exceptionData
 		= (ExceptionData*)malloc(ExceptionData::calcNumBytes(typeInstance->type.params.size()));
 	exceptionData->typeInstance    = typeInstance;
@@ -116,6 +138,7 @@ DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics,
 {
 	auto typeInstance = reinterpret_cast<ExceptionTypeInstance*>(Uptr(exceptionTypeInstanceBits));
 	auto args         = reinterpret_cast<const UntaggedValue*>(Uptr(argsBits));
+	countTrap(typeInstance);
 
 	ExceptionData* exceptionData
 		= (ExceptionData*)malloc(ExceptionData::calcNumBytes(typeInstance->type.params.size()));
@@ -177,16 +200,23 @@ static bool translateSignalToRuntimeException(const Platform::Signal& signal,
 void Runtime::catchRuntimeExceptions(const std::function<void()>& thunk,
 									 const std::function<void(Exception&&)>& catchThunk)
 {
+	// If a runtime exception interrupts an invoke, the invoke won't restore
+	// currentInvokeCompartment, so save it here to restore after catching the exception.
+	Compartment* savedInvokeCompartment = currentInvokeCompartment;
+
 	// Catch platform exceptions and translate them into C++ exceptions.
 	Platform::catchPlatformExceptions(
-		[thunk, catchThunk] {
+		[thunk, catchThunk, savedInvokeCompartment] {
 			Platform::catchSignals(
 				thunk,
-				[catchThunk](Platform::Signal signal,
-							 const Platform::CallStack& callStack) -> bool {
+				[catchThunk, savedInvokeCompartment](Platform::Signal signal,
+													 const Platform::CallStack& callStack) -> bool {
 					Exception exception;
 					if(translateSignalToRuntimeException(signal, callStack, exception))
 					{
+						if(signal.type != Platform::Signal::Type::unhandledException)
+						{ countTrap(exception.typeInstance); }
+						currentInvokeCompartment = savedInvokeCompartment;
 						catchThunk(std::move(exception));
 						return true;
 					}
@@ -196,7 +226,9 @@ void Runtime::catchRuntimeExceptions(const std::function<void()>& thunk,
 					}
 				});
 		},
-		[catchThunk](void* exceptionData, const Platform::CallStack& callStack) {
+		[catchThunk, savedInvokeCompartment](void* exceptionData,
+											 const Platform::CallStack& callStack) {
+			currentInvokeCompartment = savedInvokeCompartment;
 			catchThunk(translateExceptionDataToException(
 				reinterpret_cast<ExceptionData*>(exceptionData), callStack));
 		});
@@ -0,0 +1,1806 @@
+#include "IR/Module.h"
+#include "IR/Operators.h"
+#include "IR/Types.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Floats.h"
+#include "Intrinsics.h"
+#include "Platform/Platform.h"
+#include "Runtime.h"
+#include "RuntimePrivate.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <alloca.h>
+#endif
+
+using namespace IR;
+using namespace Runtime;
+
+// The interpreter translates a function definition to threaded code the first time it is called.
+// Each instruction is the index of its handler followed by its operand words. Instead of pushing
+// and popping an operand stack, instructions name the slots of the function's frame that they read
+// and write: the frame has a 64-bit slot for each of the function's locals, followed by a slot for
+// each level of the WebAssembly operand stack. The translator tracks which slot holds each operand
+// stack value, so get_local doesn't copy the local, and set_local usually just changes the slot
+// written by the instruction that computed the value.
+//
+// Interpreted calls are nested native calls, so the interpreter traps on stack overflow the same
+// way as compiled code. However, the frame holds pointers into the native stack, so a thread with
+// interpreted functions on its stack can't be forked by Platform::forkCurrentThread.
+
+static_assert(sizeof(Uptr) == sizeof(U64), "The interpreter stores 64-bit values in code words");
+
+// The dispatch loop jumps directly from each instruction's handler to the next instruction's
+// handler if the compiler supports computed gotos, and uses a switch otherwise.
+#if defined(__GNUC__)
+#define USE_COMPUTED_GOTO 1
+#else
+#define USE_COMPUTED_GOTO 0
+#endif
+
+// clang-format off
+
+// Instructions with an encoding that doesn't fit one of the lists below.
+#define ENUM_INTERPRETER_SPECIAL_OPS(visitOp) \
+	visitOp(br) \
+	visitOp(br_if) \
+	visitOp(br_unless) \
+	visitOp(br_table) \
+	visitOp(return_) \
+	visitOp(unreachable) \
+	visitOp(copy) \
+	visitOp(const_) \
+	visitOp(select) \
+	visitOp(get_immutable_global) \
+	visitOp(get_mutable_global32) \
+	visitOp(get_mutable_global64) \
+	visitOp(set_mutable_global32) \
+	visitOp(set_mutable_global64) \
+	visitOp(call_interpreted) \
+	visitOp(call_import) \
+	visitOp(call_native) \
+	visitOp(call_indirect) \
+	visitOp(memory_size) \
+	visitOp(memory_grow) \
+	visitOp(atomic_wake) \
+	visitOp(i32_atomic_wait) \
+	visitOp(i64_atomic_wait)
+
+// Instructions that compute a result from one operand: name, operand slot field, result slot
+// field, and the expression that computes the result from the operand a.
+#define ENUM_INTERPRETER_UNARY_OPS(visitOp) \
+	visitOp(i32_eqz, i32, i32, a == 0) \
+	visitOp(i64_eqz, i64, i32, a == 0) \
+	visitOp(i32_clz, u32, u32, Platform::countLeadingZeroes(a)) \
+	visitOp(i32_ctz, u32, u32, Platform::countTrailingZeroes(a)) \
+	visitOp(i32_popcnt, u32, u32, countSetBits(a)) \
+	visitOp(i64_clz, u64, u64, Platform::countLeadingZeroes(a)) \
+	visitOp(i64_ctz, u64, u64, Platform::countTrailingZeroes(a)) \
+	visitOp(i64_popcnt, u64, u64, countSetBits(a)) \
+	visitOp(f32_abs, f32, f32, fabs(a)) \
+	visitOp(f32_neg, f32, f32, -a) \
+	visitOp(f32_ceil, f32, f32, Floats::floatCeil(a)) \
+	visitOp(f32_floor, f32, f32, Floats::floatFloor(a)) \
+	visitOp(f32_trunc, f32, f32, Floats::floatTrunc(a)) \
+	visitOp(f32_nearest, f32, f32, Floats::floatNearest(a)) \
+	visitOp(f32_sqrt, f32, f32, sqrt(a)) \
+	visitOp(f64_abs, f64, f64, fabs(a)) \
+	visitOp(f64_neg, f64, f64, -a) \
+	visitOp(f64_ceil, f64, f64, Floats::floatCeil(a)) \
+	visitOp(f64_floor, f64, f64, Floats::floatFloor(a)) \
+	visitOp(f64_trunc, f64, f64, Floats::floatTrunc(a)) \
+	visitOp(f64_nearest, f64, f64, Floats::floatNearest(a)) \
+	visitOp(f64_sqrt, f64, f64, sqrt(a)) \
+	visitOp(i32_wrap_i64, u64, u32, U32(a)) \
+	visitOp(i32_trunc_s_f32, f32, i32, truncOrTrap<I32>(a, -2147483904.0f, 2147483648.0f)) \
+	visitOp(i32_trunc_u_f32, f32, u32, truncOrTrap<U32>(a, -1.0f, 4294967296.0f)) \
+	visitOp(i32_trunc_s_f64, f64, i32, truncOrTrap<I32>(a, -2147483649.0, 2147483648.0)) \
+	visitOp(i32_trunc_u_f64, f64, u32, truncOrTrap<U32>(a, -1.0, 4294967296.0)) \
+	visitOp(i64_extend_s_i32, i32, i64, I64(a)) \
+	visitOp(i64_extend_u_i32, u32, u64, U64(a)) \
+	visitOp(i64_trunc_s_f32, f32, i64, truncOrTrap<I64>(a, -9223373136366403584.0f, 9223372036854775808.0f)) \
+	visitOp(i64_trunc_u_f32, f32, u64, truncOrTrap<U64>(a, -1.0f, 18446744073709551616.0f)) \
+	visitOp(i64_trunc_s_f64, f64, i64, truncOrTrap<I64>(a, -9223372036854777856.0, 9223372036854775808.0)) \
+	visitOp(i64_trunc_u_f64, f64, u64, truncOrTrap<U64>(a, -1.0, 18446744073709551616.0)) \
+	visitOp(f32_convert_s_i32, i32, f32, F32(a)) \
+	visitOp(f32_convert_u_i32, u32, f32, F32(a)) \
+	visitOp(f32_convert_s_i64, i64, f32, F32(a)) \
+	visitOp(f32_convert_u_i64, u64, f32, F32(a)) \
+	visitOp(f32_demote_f64, f64, f32, F32(a)) \
+	visitOp(f64_convert_s_i32, i32, f64, F64(a)) \
+	visitOp(f64_convert_u_i32, u32, f64, F64(a)) \
+	visitOp(f64_convert_s_i64, i64, f64, F64(a)) \
+	visitOp(f64_convert_u_i64, u64, f64, F64(a)) \
+	visitOp(f64_promote_f32, f32, f64, F64(a)) \
+	visitOp(i32_extend8_s, i32, i32, I32(I8(a))) \
+	visitOp(i32_extend16_s, i32, i32, I32(I16(a))) \
+	visitOp(i64_extend8_s, i64, i64, I64(I8(a))) \
+	visitOp(i64_extend16_s, i64, i64, I64(I16(a))) \
+	visitOp(i64_extend32_s, i64, i64, I64(I32(a))) \
+	visitOp(i32_trunc_s_sat_f32, f32, i32, truncSaturate<I32>(a)) \
+	visitOp(i32_trunc_u_sat_f32, f32, u32, truncSaturate<U32>(a)) \
+	visitOp(i32_trunc_s_sat_f64, f64, i32, truncSaturate<I32>(a)) \
+	visitOp(i32_trunc_u_sat_f64, f64, u32, truncSaturate<U32>(a)) \
+	visitOp(i64_trunc_s_sat_f32, f32, i64, truncSaturate<I64>(a)) \
+	visitOp(i64_trunc_u_sat_f32, f32, u64, truncSaturate<U64>(a)) \
+	visitOp(i64_trunc_s_sat_f64, f64, i64, truncSaturate<I64>(a)) \
+	visitOp(i64_trunc_u_sat_f64, f64, u64, truncSaturate<U64>(a))
+
+// Instructions that compute a result from two operands: name, operand slot field, result slot
+// field, and the expression that computes the result from the operands a and b.
+#define ENUM_INTERPRETER_BINARY_OPS(visitOp) \
+	visitOp(i32_eq, i32, i32, a == b) \
+	visitOp(i32_ne, i32, i32, a != b) \
+	visitOp(i32_lt_s, i32, i32, a < b) \
+	visitOp(i32_lt_u, u32, i32, a < b) \
+	visitOp(i32_gt_s, i32, i32, a > b) \
+	visitOp(i32_gt_u, u32, i32, a > b) \
+	visitOp(i32_le_s, i32, i32, a <= b) \
+	visitOp(i32_le_u, u32, i32, a <= b) \
+	visitOp(i32_ge_s, i32, i32, a >= b) \
+	visitOp(i32_ge_u, u32, i32, a >= b) \
+	visitOp(i64_eq, i64, i32, a == b) \
+	visitOp(i64_ne, i64, i32, a != b) \
+	visitOp(i64_lt_s, i64, i32, a < b) \
+	visitOp(i64_lt_u, u64, i32, a < b) \
+	visitOp(i64_gt_s, i64, i32, a > b) \
+	visitOp(i64_gt_u, u64, i32, a > b) \
+	visitOp(i64_le_s, i64, i32, a <= b) \
+	visitOp(i64_le_u, u64, i32, a <= b) \
+	visitOp(i64_ge_s, i64, i32, a >= b) \
+	visitOp(i64_ge_u, u64, i32, a >= b) \
+	visitOp(f32_eq, f32, i32, a == b) \
+	visitOp(f32_ne, f32, i32, a != b) \
+	visitOp(f32_lt, f32, i32, a < b) \
+	visitOp(f32_gt, f32, i32, a > b) \
+	visitOp(f32_le, f32, i32, a <= b) \
+	visitOp(f32_ge, f32, i32, a >= b) \
+	visitOp(f64_eq, f64, i32, a == b) \
+	visitOp(f64_ne, f64, i32, a != b) \
+	visitOp(f64_lt, f64, i32, a < b) \
+	visitOp(f64_gt, f64, i32, a > b) \
+	visitOp(f64_le, f64, i32, a <= b) \
+	visitOp(f64_ge, f64, i32, a >= b) \
+	visitOp(i32_add, u32, u32, a + b) \
+	visitOp(i32_sub, u32, u32, a - b) \
+	visitOp(i32_mul, u32, u32, a * b) \
+	visitOp(i32_div_s, i32, i32, divideSigned(a, b)) \
+	visitOp(i32_div_u, u32, u32, divideUnsigned(a, b)) \
+	visitOp(i32_rem_s, i32, i32, remainderSigned(a, b)) \
+	visitOp(i32_rem_u, u32, u32, remainderUnsigned(a, b)) \
+	visitOp(i32_and, u32, u32, a & b) \
+	visitOp(i32_or, u32, u32, a | b) \
+	visitOp(i32_xor, u32, u32, a ^ b) \
+	visitOp(i32_shl, u32, u32, a << (b & 31)) \
+	visitOp(i32_shr_s, i32, i32, a >> (b & 31)) \
+	visitOp(i32_shr_u, u32, u32, a >> (b & 31)) \
+	visitOp(i32_rotl, u32, u32, rotateLeft(a, b)) \
+	visitOp(i32_rotr, u32, u32, rotateRight(a, b)) \
+	visitOp(i64_add, u64, u64, a + b) \
+	visitOp(i64_sub, u64, u64, a - b) \
+	visitOp(i64_mul, u64, u64, a * b) \
+	visitOp(i64_div_s, i64, i64, divideSigned(a, b)) \
+	visitOp(i64_div_u, u64, u64, divideUnsigned(a, b)) \
+	visitOp(i64_rem_s, i64, i64, remainderSigned(a, b)) \
+	visitOp(i64_rem_u, u64, u64, remainderUnsigned(a, b)) \
+	visitOp(i64_and, u64, u64, a & b) \
+	visitOp(i64_or, u64, u64, a | b) \
+	visitOp(i64_xor, u64, u64, a ^ b) \
+	visitOp(i64_shl, u64, u64, a << (b & 63)) \
+	visitOp(i64_shr_s, i64, i64, a >> (b & 63)) \
+	visitOp(i64_shr_u, u64, u64, a >> (b & 63)) \
+	visitOp(i64_rotl, u64, u64, rotateLeft(a, b)) \
+	visitOp(i64_rotr, u64, u64, rotateRight(a, b)) \
+	visitOp(f32_add, f32, f32, a + b) \
+	visitOp(f32_sub, f32, f32, a - b) \
+	visitOp(f32_mul, f32, f32, a * b) \
+	visitOp(f32_div, f32, f32, a / b) \
+	visitOp(f32_min, f32, f32, Floats::floatMin(a, b)) \
+	visitOp(f32_max, f32, f32, Floats::floatMax(a, b)) \
+	visitOp(f32_copysign, f32, f32, copysign(a, b)) \
+	visitOp(f64_add, f64, f64, a + b) \
+	visitOp(f64_sub, f64, f64, a - b) \
+	visitOp(f64_mul, f64, f64, a * b) \
+	visitOp(f64_div, f64, f64, a / b) \
+	visitOp(f64_min, f64, f64, Floats::floatMin(a, b)) \
+	visitOp(f64_max, f64, f64, Floats::floatMax(a, b)) \
+	visitOp(f64_copysign, f64, f64, copysign(a, b))
+
+// Memory access instructions: name, the type of the value in memory, and the slot field of the
+// value that is loaded or stored.
+#define ENUM_INTERPRETER_LOAD_OPS(visitOp) \
+	visitOp(i32_load, I32, i32) \
+	visitOp(i64_load, I64, i64) \
+	visitOp(f32_load, F32, f32) \
+	visitOp(f64_load, F64, f64) \
+	visitOp(i32_load8_s, I8, i32) \
+	visitOp(i32_load8_u, U8, u32) \
+	visitOp(i32_load16_s, I16, i32) \
+	visitOp(i32_load16_u, U16, u32) \
+	visitOp(i64_load8_s, I8, i64) \
+	visitOp(i64_load8_u, U8, u64) \
+	visitOp(i64_load16_s, I16, i64) \
+	visitOp(i64_load16_u, U16, u64) \
+	visitOp(i64_load32_s, I32, i64) \
+	visitOp(i64_load32_u, U32, u64)
+
+#define ENUM_INTERPRETER_STORE_OPS(visitOp) \
+	visitOp(i32_store, I32, i32) \
+	visitOp(i64_store, I64, i64) \
+	visitOp(f32_store, F32, f32) \
+	visitOp(f64_store, F64, f64) \
+	visitOp(i32_store8, U8, u32) \
+	visitOp(i32_store16, U16, u32) \
+	visitOp(i64_store8, U8, u64) \
+	visitOp(i64_store16, U16, u64) \
+	visitOp(i64_store32, U32, u64)
+
+#define ENUM_INTERPRETER_ATOMIC_LOAD_OPS(visitOp) \
+	visitOp(i32_atomic_load, U32, u32) \
+	visitOp(i64_atomic_load, U64, u64) \
+	visitOp(i32_atomic_load8_u, U8, u32) \
+	visitOp(i32_atomic_load16_u, U16, u32) \
+	visitOp(i64_atomic_load8_u, U8, u64) \
+	visitOp(i64_atomic_load16_u, U16, u64) \
+	visitOp(i64_atomic_load32_u, U32, u64)
+
+#define ENUM_INTERPRETER_ATOMIC_STORE_OPS(visitOp) \
+	visitOp(i32_atomic_store, U32, u32) \
+	visitOp(i64_atomic_store, U64, u64) \
+	visitOp(i32_atomic_store8, U8, u32) \
+	visitOp(i32_atomic_store16, U16, u32) \
+	visitOp(i64_atomic_store8, U8, u64) \
+	visitOp(i64_atomic_store16, U16, u64) \
+	visitOp(i64_atomic_store32, U32, u64)
+
+#define ENUM_INTERPRETER_ATOMIC_CMPXCHG_OPS(visitOp) \
+	visitOp(i32_atomic_rmw_cmpxchg, U32, u32) \
+	visitOp(i64_atomic_rmw_cmpxchg, U64, u64) \
+	visitOp(i32_atomic_rmw8_u_cmpxchg, U8, u32) \
+	visitOp(i32_atomic_rmw16_u_cmpxchg, U16, u32) \
+	visitOp(i64_atomic_rmw8_u_cmpxchg, U8, u64) \
+	visitOp(i64_atomic_rmw16_u_cmpxchg, U16, u64) \
+	visitOp(i64_atomic_rmw32_u_cmpxchg, U32, u64)
+
+// Atomic read-modify-write instructions: name, the type of the value in memory, the slot field of
+// the operand and result, and the std::atomic member function that implements it.
+#define ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, op, function) \
+	visitOp(i32_atomic_rmw_##op, U32, u32, function) \
+	visitOp(i64_atomic_rmw_##op, U64, u64, function) \
+	visitOp(i32_atomic_rmw8_u_##op, U8, u32, function) \
+	visitOp(i32_atomic_rmw16_u_##op, U16, u32, function) \
+	visitOp(i64_atomic_rmw8_u_##op, U8, u64, function) \
+	visitOp(i64_atomic_rmw16_u_##op, U16, u64, function) \
+	visitOp(i64_atomic_rmw32_u_##op, U32, u64, function)
+
+#define ENUM_INTERPRETER_ATOMIC_RMW_OPS(visitOp) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, add, fetch_add) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, sub, fetch_sub) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, and, fetch_and) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, or, fetch_or) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, xor, fetch_xor) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS_WITH_FUNCTION(visitOp, xchg, exchange)
+
+#define ENUM_INTERPRETER_OPS(visitOp) \
+	ENUM_INTERPRETER_SPECIAL_OPS(visitOp) \
+	ENUM_INTERPRETER_UNARY_OPS(visitOp) \
+	ENUM_INTERPRETER_BINARY_OPS(visitOp) \
+	ENUM_INTERPRETER_LOAD_OPS(visitOp) \
+	ENUM_INTERPRETER_STORE_OPS(visitOp) \
+	ENUM_INTERPRETER_ATOMIC_LOAD_OPS(visitOp) \
+	ENUM_INTERPRETER_ATOMIC_STORE_OPS(visitOp) \
+	ENUM_INTERPRETER_ATOMIC_CMPXCHG_OPS(visitOp) \
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS(visitOp)
+
+// clang-format on
+
+enum class InterpreterOp : Uptr
+{
+#define VISIT_INTERPRETER_OP(name, ...) name,
+	ENUM_INTERPRETER_OPS(VISIT_INTERPRETER_OP)
+#undef VISIT_INTERPRETER_OP
+};
+
+// A slot in an interpreted function's frame.
+union Slot
+{
+	I32 i32;
+	U32 u32;
+	I64 i64;
+	U64 u64;
+	F32 f32;
+	F64 f64;
+};
+
+struct Interpreter::FunctionCode
+{
+	std::vector<Uptr> words;
+	Uptr numParams;
+	Uptr numLocals;
+	Uptr numSlots;
+};
+
+void Interpreter::freeFunctionCode(FunctionCode* functionCode) { delete functionCode; }
+
+//
+// The implementations of the operators that aren't a single C++ operator.
+//
+
+template<typename Int> static Int countSetBits(Int value)
+{
+	Int result = 0;
+	while(value)
+	{
+		value &= value - 1;
+		++result;
+	}
+	return result;
+}
+
+template<typename Int> static Int rotateLeft(Int value, Int numBits)
+{
+	const Int mask = sizeof(Int) * 8 - 1;
+	return (value << (numBits & mask)) | (value >> ((0 - numBits) & mask));
+}
+
+template<typename Int> static Int rotateRight(Int value, Int numBits)
+{
+	const Int mask = sizeof(Int) * 8 - 1;
+	return (value >> (numBits & mask)) | (value << ((0 - numBits) & mask));
+}
+
+template<typename Int> static Int divideSigned(Int left, Int right)
+{
+	if(right == 0 || (left == std::numeric_limits<Int>::min() && right == -1))
+	{ throwException(Exception::integerDivideByZeroOrOverflowType); }
+	return left / right;
+}
+
+template<typename Int> static Int divideUnsigned(Int left, Int right)
+{
+	if(right == 0) { throwException(Exception::integerDivideByZeroOrOverflowType); }
+	return left / right;
+}
+
+template<typename Int> static Int remainderSigned(Int left, Int right)
+{
+	if(right == 0) { throwException(Exception::integerDivideByZeroOrOverflowType); }
+
+	// INT_MIN % -1 overflows in C++, but is 0 in WebAssembly.
+	return right == -1 ? 0 : left % right;
+}
+
+template<typename Int> static Int remainderUnsigned(Int left, Int right)
+{
+	if(right == 0) { throwException(Exception::integerDivideByZeroOrOverflowType); }
+	return left % right;
+}
+
+// Truncates a float to an integer, trapping if it is a NaN or if the truncated value isn't between
+// the exclusive bounds minValue and maxValue.
+template<typename Int, typename Float>
+static Int truncOrTrap(Float value, Float minValue, Float maxValue)
+{
+	if(value != value) { throwException(Exception::invalidFloatOperationType); }
+	if(value <= minValue || value >= maxValue)
+	{ throwException(Exception::integerDivideByZeroOrOverflowType); }
+	return Int(value);
+}
+
+// Truncates a float to an integer, saturating values that are out of the integer's range, and
+// converting NaNs to zero.
+template<typename Int, typename Float> static Int truncSaturate(Float value)
+{
+	if(value != value) { return 0; }
+	else if(value >= Float(std::numeric_limits<Int>::max()))
+	{
+		return std::numeric_limits<Int>::max();
+	}
+	else if(value <= Float(std::numeric_limits<Int>::min()))
+	{
+		return std::numeric_limits<Int>::min();
+	}
+	else
+	{
+		return Int(value);
+	}
+}
+
+//
+// Execution
+//
+
+static const Interpreter::FunctionCode* getFunctionCode(const CompiledModule& compiledModule,
+														 Uptr functionDefIndex);
+
+static ContextRuntimeData* execute(const Interpreter::FunctionCode* functionCode,
+								   ModuleInstance* moduleInstance,
+								   ContextRuntimeData* contextRuntimeData,
+								   Slot* argsAndResults)
+{
+	const Uptr* code = functionCode->words.data();
+	const Uptr* ip   = code;
+
+	// Allocate the frame on the native stack. If it is larger than a page, touch a byte in each
+	// page from the top down, so a stack overflow hits the guard page instead of skipping it.
+	const Uptr numFrameBytes = functionCode->numSlots * sizeof(Slot);
+	Slot* slots              = (Slot*)alloca(numFrameBytes);
+	const Uptr numPageBytes  = Uptr(1) << Platform::getPageSizeLog2();
+	for(Uptr offset = numFrameBytes; offset > numPageBytes; offset -= numPageBytes)
+	{ ((volatile U8*)slots)[offset - numPageBytes] = 0; }
+
+	// Initialize the parameters from the arguments, and the other locals to zero.
+	memcpy(slots, argsAndResults, functionCode->numParams * sizeof(Slot));
+	memset(slots + functionCode->numParams,
+		   0,
+		   (functionCode->numLocals - functionCode->numParams) * sizeof(Slot));
+
+	MemoryInstance* defaultMemory = moduleInstance->defaultMemory;
+	U8* memoryBase                = defaultMemory ? getCompartmentRuntimeData(contextRuntimeData)
+										 ->memories[defaultMemory->id]
+									: nullptr;
+
+	// The state used by the handlers below is declared here, since the handlers jump between each
+	// other, and may not jump past the initialization of a variable.
+	void* callee                   = nullptr;
+	InvokeThunkPointer invokeThunk = nullptr;
+	Uptr argsSlot                  = 0;
+	Uptr numArgs                   = 0;
+	Uptr numResults                = 0;
+
+#if USE_COMPUTED_GOTO
+	static const void* const handlers[] = {
+#define VISIT_INTERPRETER_OP(name, ...) &&name##Handler,
+		ENUM_INTERPRETER_OPS(VISIT_INTERPRETER_OP)
+#undef VISIT_INTERPRETER_OP
+	};
+#define DISPATCH() goto* handlers[*ip]
+	DISPATCH();
+#else
+#define DISPATCH() goto dispatch
+dispatch:
+	switch(InterpreterOp(*ip))
+	{
+#define VISIT_INTERPRETER_OP(name, ...)                                                            \
+	case InterpreterOp::name: goto name##Handler;
+		ENUM_INTERPRETER_OPS(VISIT_INTERPRETER_OP)
+#undef VISIT_INTERPRETER_OP
+	default: Errors::unreachable();
+	};
+#endif
+
+	//
+	// Control flow: br(target), br_if(condition, target), br_unless(condition, target),
+	// br_table(index, numTargets, targets..., defaultTarget), return_(numResults, results...),
+	// unreachable.
+	//
+
+brHandler:
+	ip = code + ip[1];
+	DISPATCH();
+
+br_ifHandler:
+	ip = slots[ip[1]].i32 ? code + ip[2] : ip + 3;
+	DISPATCH();
+
+br_unlessHandler:
+	ip = slots[ip[1]].i32 ? ip + 3 : code + ip[2];
+	DISPATCH();
+
+br_tableHandler:
+{
+	const U32 index       = slots[ip[1]].u32;
+	const Uptr numTargets = ip[2];
+	ip                    = code + ip[3 + (index < numTargets ? index : numTargets)];
+	DISPATCH();
+}
+
+return_Handler:
+	for(Uptr resultIndex = 0; resultIndex < ip[1]; ++resultIndex)
+	{ argsAndResults[resultIndex] = slots[ip[2 + resultIndex]]; }
+	return contextRuntimeData;
+
+unreachableHandler:
+	throwException(Exception::reachedUnreachableType);
+
+	//
+	// Operand stack and variable access: copy(source, destination), const_(value, destination),
+	// select(trueValue, falseValue, condition, destination), get_*_global(globalIndex,
+	// destination), set_mutable_global*(globalIndex, value).
+	//
+
+copyHandler:
+	slots[ip[2]] = slots[ip[1]];
+	ip += 3;
+	DISPATCH();
+
+const_Handler:
+	slots[ip[2]].u64 = ip[1];
+	ip += 3;
+	DISPATCH();
+
+selectHandler:
+	slots[ip[4]] = slots[ip[3]].i32 ? slots[ip[1]] : slots[ip[2]];
+	ip += 5;
+	DISPATCH();
+
+get_immutable_globalHandler:
+	slots[ip[2]].u64 = moduleInstance->globals[ip[1]]->initialValue.u64;
+	ip += 3;
+	DISPATCH();
+
+get_mutable_global32Handler:
+	memcpy(&slots[ip[2]].u32,
+		   contextRuntimeData->globalData + moduleInstance->globals[ip[1]]->mutableDataOffset,
+		   sizeof(U32));
+	ip += 3;
+	DISPATCH();
+
+get_mutable_global64Handler:
+	memcpy(&slots[ip[2]].u64,
+		   contextRuntimeData->globalData + moduleInstance->globals[ip[1]]->mutableDataOffset,
+		   sizeof(U64));
+	ip += 3;
+	DISPATCH();
+
+set_mutable_global32Handler:
+	memcpy(contextRuntimeData->globalData + moduleInstance->globals[ip[1]]->mutableDataOffset,
+		   &slots[ip[2]].u32,
+		   sizeof(U32));
+	ip += 3;
+	DISPATCH();
+
+set_mutable_global64Handler:
+	memcpy(contextRuntimeData->globalData + moduleInstance->globals[ip[1]]->mutableDataOffset,
+		   &slots[ip[2]].u64,
+		   sizeof(U64));
+	ip += 3;
+	DISPATCH();
+
+	//
+	// Calls: call_interpreted(functionDefIndex, argsSlot) calls another interpreted function in the
+	// same module directly, passing it the part of this frame that holds the arguments.
+	// call_import(functionImportIndex, ...), call_native(functionDefIndex, ...), and
+	// call_indirect(elementIndex, typeEncoding, ...) call native code through an invoke thunk,
+	// followed by (invokeThunk, argsSlot, numArgs, numResults, resultLayouts...). Each result
+	// layout word is the result's byte offset in the thunk's return data shifted left by one, ORed
+	// with whether it is a 64-bit value.
+	//
+
+call_interpretedHandler:
+	contextRuntimeData = execute(getFunctionCode(*moduleInstance->compiledModule, ip[1]),
+								 moduleInstance,
+								 contextRuntimeData,
+								 slots + ip[2]);
+	ip += 3;
+	DISPATCH();
+
+call_importHandler:
+	callee = moduleInstance->functionImportCode[ip[1]];
+	ip += 2;
+	goto callThroughThunk;
+
+call_nativeHandler:
+	callee = moduleInstance->functionDefCode[ip[1]];
+	ip += 2;
+	goto callThroughThunk;
+
+call_indirectHandler:
+{
+	// An element index that is out of the table's bounds will fault on the table's reserved
+	// pages, which is translated to an undefinedTableElement exception.
+	const TableInstance::FunctionElement* tableBase
+		= getCompartmentRuntimeData(contextRuntimeData)->tables[moduleInstance->defaultTable->id];
+	const TableInstance::FunctionElement& element = tableBase[slots[ip[1]].u32];
+	if(element.typeEncoding.impl != ip[2])
+	{
+		throwException(element.value ? Exception::indirectCallSignatureMismatchType
+									 : Exception::undefinedTableElementType);
+	}
+	callee = element.value;
+	ip += 3;
+	goto callThroughThunk;
+}
+
+callThroughThunk:
+	invokeThunk = reinterpret_cast<InvokeThunkPointer>(ip[0]);
+	argsSlot    = ip[1];
+	numArgs     = ip[2];
+	numResults  = ip[3];
+	for(Uptr argIndex = 0; argIndex < numArgs; ++argIndex)
+	{
+		memcpy(contextRuntimeData->thunkArgAndReturnData + argIndex * sizeof(Slot),
+			   &slots[argsSlot + argIndex],
+			   sizeof(Slot));
+	}
+	contextRuntimeData = (*invokeThunk)(callee, contextRuntimeData);
+	for(Uptr resultIndex = 0; resultIndex < numResults; ++resultIndex)
+	{
+		const Uptr resultLayout = ip[4 + resultIndex];
+		memcpy(&slots[argsSlot + resultIndex],
+			   contextRuntimeData->thunkArgAndReturnData + (resultLayout >> 1),
+			   (resultLayout & 1) ? sizeof(U64) : sizeof(U32));
+	}
+	ip += 4 + numResults;
+	DISPATCH();
+
+	//
+	// Memory: memory_size(destination), memory_grow(deltaPages, destination),
+	// loads(address, offset, destination), stores(address, value, offset),
+	// atomic RMWs(address, value, offset, destination),
+	// cmpxchgs(address, expected, replacement, offset, destination),
+	// atomic_wake(address, numToWake, offset, destination),
+	// atomic_waits(address, expected, timeout, offset, destination).
+	//
+
+memory_sizeHandler:
+{
+	const Uptr numPages = getMemoryNumPages(defaultMemory);
+	slots[ip[1]].u32    = numPages > UINT32_MAX ? UINT32_MAX : U32(numPages);
+	ip += 2;
+	DISPATCH();
+}
+
+memory_growHandler:
+{
+	const U32 deltaPages = slots[ip[1]].u32;
+	defaultMemory->compartment->numGrowMemoryCalls.fetch_add(1, std::memory_order_relaxed);
+	if(getMemoryNumPages(defaultMemory) + Uptr(deltaPages) > IR::maxMemoryPages)
+	{ slots[ip[2]].i32 = -1; }
+	else
+	{
+		slots[ip[2]].i32 = I32(growMemory(defaultMemory, Uptr(deltaPages)));
+	}
+	ip += 3;
+	DISPATCH();
+}
+
+#define LOAD_OP(name, Memory, resultField)                                                         \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		Memory value;                                                                              \
+		memcpy(&value, memoryBase + U64(slots[ip[1]].u32) + ip[2], sizeof(Memory));                \
+		slots[ip[3]].resultField = value;                                                          \
+		ip += 4;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_LOAD_OPS(LOAD_OP)
+#undef LOAD_OP
+
+#define STORE_OP(name, Memory, operandField)                                                       \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		const Memory value = Memory(slots[ip[2]].operandField);                                    \
+		memcpy(memoryBase + U64(slots[ip[1]].u32) + ip[3], &value, sizeof(Memory));                \
+		ip += 4;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_STORE_OPS(STORE_OP)
+#undef STORE_OP
+
+#define GET_ATOMIC(Memory, addressSlotIndex, offsetWordIndex)                                      \
+	const U64 address = U64(slots[ip[addressSlotIndex]].u32) + ip[offsetWordIndex];                \
+	if(address & (sizeof(Memory) - 1))                                                             \
+	{ throwException(Exception::misalignedAtomicMemoryAccessType); }                               \
+	std::atomic<Memory>* atomic = reinterpret_cast<std::atomic<Memory>*>(memoryBase + address);
+
+#define ATOMIC_LOAD_OP(name, Memory, resultField)                                                  \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		GET_ATOMIC(Memory, 1, 2);                                                                  \
+		slots[ip[3]].resultField = atomic->load();                                                 \
+		ip += 4;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_ATOMIC_LOAD_OPS(ATOMIC_LOAD_OP)
+#undef ATOMIC_LOAD_OP
+
+#define ATOMIC_STORE_OP(name, Memory, operandField)                                                \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		const Memory value = Memory(slots[ip[2]].operandField);                                    \
+		GET_ATOMIC(Memory, 1, 3);                                                                  \
+		atomic->store(value);                                                                      \
+		ip += 4;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_ATOMIC_STORE_OPS(ATOMIC_STORE_OP)
+#undef ATOMIC_STORE_OP
+
+#define ATOMIC_RMW_OP(name, Memory, operandField, function)                                        \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		const Memory operand = Memory(slots[ip[2]].operandField);                                  \
+		GET_ATOMIC(Memory, 1, 3);                                                                  \
+		slots[ip[4]].operandField = atomic->function(operand);                                     \
+		ip += 5;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_ATOMIC_RMW_OPS(ATOMIC_RMW_OP)
+#undef ATOMIC_RMW_OP
+
+#define ATOMIC_CMPXCHG_OP(name, Memory, operandField)                                              \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		Memory expected          = Memory(slots[ip[2]].operandField);                              \
+		const Memory replacement = Memory(slots[ip[3]].operandField);                              \
+		GET_ATOMIC(Memory, 1, 4);                                                                  \
+		atomic->compare_exchange_strong(expected, replacement);                                    \
+		slots[ip[5]].operandField = expected;                                                      \
+		ip += 6;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_ATOMIC_CMPXCHG_OPS(ATOMIC_CMPXCHG_OP)
+#undef ATOMIC_CMPXCHG_OP
+
+#define CHECK_WAIT_OR_WAKE_ADDRESS(Value)                                                          \
+	if(address + sizeof(Value) > U64(getMemoryNumPages(defaultMemory)) * IR::numBytesPerPage)      \
+	{ throwException(Exception::accessViolationType); }
+
+atomic_wakeHandler:
+{
+	const U32 numToWake = slots[ip[2]].u32;
+	GET_ATOMIC(U32, 1, 3);
+	CHECK_WAIT_OR_WAKE_ADDRESS(U32);
+	slots[ip[4]].u32 = wakeAddress(reinterpret_cast<Uptr>(atomic), numToWake);
+	ip += 5;
+	DISPATCH();
+}
+
+i32_atomic_waitHandler:
+{
+	const I32 expectedValue = slots[ip[2]].i32;
+	const F64 timeout       = slots[ip[3]].f64;
+	GET_ATOMIC(I32, 1, 4);
+	CHECK_WAIT_OR_WAKE_ADDRESS(I32);
+	slots[ip[5]].u32 = waitOnAddress(reinterpret_cast<I32*>(atomic), expectedValue, timeout);
+	ip += 6;
+	DISPATCH();
+}
+
+i64_atomic_waitHandler:
+{
+	const I64 expectedValue = slots[ip[2]].i64;
+	const F64 timeout       = slots[ip[3]].f64;
+	GET_ATOMIC(I64, 1, 4);
+	CHECK_WAIT_OR_WAKE_ADDRESS(I64);
+	slots[ip[5]].u32 = waitOnAddress(reinterpret_cast<I64*>(atomic), expectedValue, timeout);
+	ip += 6;
+	DISPATCH();
+}
+
+#undef CHECK_WAIT_OR_WAKE_ADDRESS
+#undef GET_ATOMIC
+
+	//
+	// Numeric operators: unary(operand, destination), binary(left, right, destination).
+	//
+
+#define UNARY_OP(name, operandField, resultField, expression)                                      \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		const auto a             = slots[ip[1]].operandField;                                      \
+		slots[ip[2]].resultField = expression;                                                     \
+		ip += 3;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_UNARY_OPS(UNARY_OP)
+#undef UNARY_OP
+
+#define BINARY_OP(name, operandField, resultField, expression)                                     \
+	name##Handler:                                                                                 \
+	{                                                                                              \
+		const auto a             = slots[ip[1]].operandField;                                      \
+		const auto b             = slots[ip[2]].operandField;                                      \
+		slots[ip[3]].resultField = expression;                                                     \
+		ip += 4;                                                                                   \
+		DISPATCH();                                                                                \
+	}
+	ENUM_INTERPRETER_BINARY_OPS(BINARY_OP)
+#undef BINARY_OP
+
+#undef DISPATCH
+}
+
+DEFINE_INTRINSIC_FUNCTION_WITH_CONTEXT_SWITCH(wavmIntrinsics,
+											  "interpretFunction",
+											  void,
+											  interpretFunction,
+											  I64 moduleInstanceBits,
+											  I32 functionDefIndex,
+											  I64 argsAndResultsBits)
+{
+	ModuleInstance* moduleInstance = reinterpret_cast<ModuleInstance*>(Uptr(moduleInstanceBits));
+	const Interpreter::FunctionCode* functionCode
+		= getFunctionCode(*moduleInstance->compiledModule, U32(functionDefIndex));
+	contextRuntimeData = execute(functionCode,
+								 moduleInstance,
+								 contextRuntimeData,
+								 reinterpret_cast<Slot*>(Uptr(argsAndResultsBits)));
+	return reinterpret_cast<Intrinsics::ResultInContextRuntimeData<void>*>(contextRuntimeData);
+}
+
+//
+// Translation
+//
+
+// Decodes the operators in unreachable code until the else or end that ends it, which is passed to
+// the translator.
+template<typename Translator> struct UnreachableOpVisitor
+{
+	typedef void Result;
+
+	UnreachableOpVisitor(Translator& inTranslator) : translator(inTranslator), depth(0) {}
+
+	Uptr getDepth() const { return depth; }
+
+	void unknown(Opcode) { Errors::unreachable(); }
+
+	void block(ControlStructureImm) { ++depth; }
+	void loop(ControlStructureImm) { ++depth; }
+	void if_(ControlStructureImm) { ++depth; }
+	void try_(ControlStructureImm) { ++depth; }
+
+	void else_(NoImm imm)
+	{
+		if(!depth) { translator.else_(imm); }
+	}
+	void catch_(ExceptionTypeImm) { Errors::unreachable(); }
+	void catch_all(NoImm) { Errors::unreachable(); }
+	void end(NoImm imm)
+	{
+		if(depth) { --depth; }
+		else
+		{
+			translator.end(imm);
+		}
+	}
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm) {}
+	ENUM_NONCONTROL_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+
+private:
+	Translator& translator;
+	Uptr depth;
+};
+
+// Translates a function definition's operators to threaded code.
+struct FunctionTranslator
+{
+	typedef void Result;
+
+	FunctionTranslator(const CompiledModule& inCompiledModule,
+					   Uptr functionDefIndex,
+					   Interpreter::FunctionCode& inFunctionCode)
+	: module(inCompiledModule.module)
+	, compiledModule(inCompiledModule)
+	, functionDef(inCompiledModule.module.functions.defs[functionDefIndex])
+	, functionType(inCompiledModule.module.types[functionDef.type.index])
+	, functionCode(inFunctionCode)
+	, words(inFunctionCode.words)
+	, decoder(functionDef.code)
+	, numLocals(functionType.params().size() + functionDef.nonParameterLocalTypes.size())
+	, maxStackHeight(0)
+	, lastResultWordIndex(UINTPTR_MAX)
+	{
+	}
+
+	void translate()
+	{
+		functionCode.numParams = functionType.params().size();
+		functionCode.numLocals = numLocals;
+
+		ControlFrame functionFrame;
+		functionFrame.type          = ControlFrame::Type::function;
+		functionFrame.baseHeight    = 0;
+		functionFrame.params        = TypeTuple();
+		functionFrame.results       = functionType.results();
+		functionFrame.partOffsets   = nullptr;
+		functionFrame.elseWordIndex = UINTPTR_MAX;
+		functionFrame.loopWordIndex = UINTPTR_MAX;
+		functionFrame.isReachable   = true;
+		controlStack.push_back(functionFrame);
+
+		UnreachableOpVisitor<FunctionTranslator> unreachableOpVisitor(*this);
+		while(decoder && controlStack.size())
+		{
+			if(controlStack.back().isReachable) { decoder.decodeOp(*this); }
+			else
+			{
+				// If the offset of the else or end that ends the unreachable code is known, skip
+				// directly to it.
+				const ControlPartOffsets* partOffsets = controlStack.back().partOffsets;
+				if(partOffsets && !unreachableOpVisitor.getDepth())
+				{ decoder.seek(partOffsets->endOpOffset); }
+				decoder.decodeOp(unreachableOpVisitor);
+			}
+		}
+		wavmAssert(!controlStack.size());
+
+		functionCode.numSlots = std::max(numLocals + maxStackHeight, Uptr(1));
+	}
+
+	void unknown(Opcode) { Errors::unreachable(); }
+
+	//
+	// Control operators
+	//
+
+	void block(ControlStructureImm imm)
+	{
+		const FunctionType blockType = resolveBlockType(module, imm.type);
+		materializeStack();
+		pushControlFrame(ControlFrame::Type::block, blockType);
+	}
+
+	void loop(ControlStructureImm imm)
+	{
+		const FunctionType blockType = resolveBlockType(module, imm.type);
+		materializeStack();
+		pushControlFrame(ControlFrame::Type::loop, blockType);
+		bindLabel();
+		controlStack.back().loopWordIndex = words.size();
+	}
+
+	void if_(ControlStructureImm imm)
+	{
+		const FunctionType blockType = resolveBlockType(module, imm.type);
+		const Uptr conditionSlot     = pop();
+		materializeStack();
+
+		emitOp(InterpreterOp::br_unless);
+		emitWord(conditionSlot);
+		const Uptr elseWordIndex = words.size();
+		emitWord(0);
+
+		pushControlFrame(ControlFrame::Type::ifThen, blockType);
+		controlStack.back().elseWordIndex = elseWordIndex;
+	}
+
+	void else_(NoImm)
+	{
+		ControlFrame& frame = controlStack.back();
+		wavmAssert(frame.type == ControlFrame::Type::ifThen);
+
+		// Branch from the end of the then part to the end of the if.
+		if(frame.isReachable)
+		{
+			materializeTop(frame.baseHeight, frame.results.size());
+			emitOp(InterpreterOp::br);
+			frame.endWordIndices.push_back(words.size());
+			emitWord(0);
+		}
+
+		// Start the else part with the if's parameters on the operand stack.
+		bindLabel();
+		words[frame.elseWordIndex] = words.size();
+		frame.elseWordIndex        = UINTPTR_MAX;
+		frame.type                 = ControlFrame::Type::ifElse;
+		frame.isReachable          = true;
+		frame.partOffsets          = findControlPart(functionDef, decoder.getOffset());
+		resetStack(frame.baseHeight, frame.params.size());
+	}
+
+	void end(NoImm)
+	{
+		ControlFrame& frame = controlStack.back();
+		if(frame.type == ControlFrame::Type::function)
+		{
+			if(frame.isReachable) { emitReturn(); }
+			controlStack.pop_back();
+			return;
+		}
+
+		if(frame.isReachable) { materializeTop(frame.baseHeight, frame.results.size()); }
+
+		// Bind the branches to the end of the control structure, and the else branch of an if
+		// without an else part.
+		bindLabel();
+		for(Uptr wordIndex : frame.endWordIndices) { words[wordIndex] = words.size(); }
+		if(frame.elseWordIndex != UINTPTR_MAX) { words[frame.elseWordIndex] = words.size(); }
+
+		resetStack(frame.baseHeight, frame.results.size());
+		controlStack.pop_back();
+	}
+
+	void try_(ControlStructureImm) { Errors::unreachable(); }
+	void catch_(ExceptionTypeImm) { Errors::unreachable(); }
+	void catch_all(NoImm) { Errors::unreachable(); }
+	void throw_(ExceptionTypeImm) { Errors::unreachable(); }
+	void rethrow(RethrowImm) { Errors::unreachable(); }
+
+	//
+	// Parametric operators
+	//
+
+	void unreachable(NoImm)
+	{
+		emitOp(InterpreterOp::unreachable);
+		enterUnreachable();
+	}
+
+	void br(BranchImm imm)
+	{
+		emitBranch(getBranchTarget(imm.targetDepth));
+		enterUnreachable();
+	}
+
+	void br_if(BranchImm imm)
+	{
+		const Uptr conditionSlot = pop();
+		ControlFrame& target     = getBranchTarget(imm.targetDepth);
+		if(target.type != ControlFrame::Type::function && !needsBranchCopies(target))
+		{
+			emitOp(InterpreterOp::br_if);
+			emitWord(conditionSlot);
+			emitBranchTargetWord(target);
+		}
+		else
+		{
+			// If the branch needs to copy its arguments or return from the function, skip over
+			// that code if the condition is false.
+			emitOp(InterpreterOp::br_unless);
+			emitWord(conditionSlot);
+			const Uptr skipWordIndex = words.size();
+			emitWord(0);
+			emitBranch(target);
+			bindLabel();
+			words[skipWordIndex] = words.size();
+		}
+	}
+
+	void br_table(BranchTableImm imm)
+	{
+		const Uptr indexSlot                = pop();
+		const ArenaArray<U32>& targetDepths = functionDef.branchTables[imm.branchTableIndex];
+		const Uptr numTargets               = targetDepths.size();
+
+		emitOp(InterpreterOp::br_table);
+		emitWord(indexSlot);
+		emitWord(numTargets);
+		const Uptr firstTargetWordIndex = words.size();
+		for(Uptr targetIndex = 0; targetIndex <= numTargets; ++targetIndex) { emitWord(0); }
+
+		// Targets that need to copy the branch arguments or return from the function go through
+		// a trampoline that does that. Each target depth only needs one trampoline.
+		std::vector<std::pair<Uptr, Uptr>> trampolineWordIndices;
+		for(Uptr targetIndex = 0; targetIndex <= numTargets; ++targetIndex)
+		{
+			const Uptr targetDepth
+				= targetIndex < numTargets ? targetDepths[targetIndex] : imm.defaultTargetDepth;
+			const Uptr targetWordIndex = firstTargetWordIndex + targetIndex;
+			ControlFrame& target       = getBranchTarget(targetDepth);
+			if(target.type == ControlFrame::Type::function || needsBranchCopies(target))
+			{
+				Uptr trampolineWordIndex = UINTPTR_MAX;
+				for(const auto& depthAndWordIndex : trampolineWordIndices)
+				{
+					if(depthAndWordIndex.first == targetDepth)
+					{ trampolineWordIndex = depthAndWordIndex.second; }
+				}
+				if(trampolineWordIndex == UINTPTR_MAX)
+				{
+					bindLabel();
+					trampolineWordIndex = words.size();
+					trampolineWordIndices.push_back({targetDepth, trampolineWordIndex});
+					emitBranch(target);
+				}
+				words[targetWordIndex] = trampolineWordIndex;
+			}
+			else if(target.type == ControlFrame::Type::loop)
+			{
+				words[targetWordIndex] = target.loopWordIndex;
+			}
+			else
+			{
+				target.endWordIndices.push_back(targetWordIndex);
+			}
+		}
+
+		enterUnreachable();
+	}
+
+	void return_(NoImm)
+	{
+		emitReturn();
+		enterUnreachable();
+	}
+
+	void call(CallImm imm)
+	{
+		const FunctionType calleeType
+			= module.types[module.functions.getType(imm.functionIndex).index];
+		const Uptr argsSlot = popCallArgs(calleeType.params().size());
+
+		const Uptr numFunctionImports = module.functions.imports.size();
+		if(imm.functionIndex < numFunctionImports)
+		{
+			emitOp(InterpreterOp::call_import);
+			emitWord(imm.functionIndex);
+			emitThunkCall(calleeType, argsSlot);
+		}
+		else if(compiledModule.interpretedFunctionDefs[imm.functionIndex - numFunctionImports])
+		{
+			emitOp(InterpreterOp::call_interpreted);
+			emitWord(imm.functionIndex - numFunctionImports);
+			emitWord(argsSlot);
+		}
+		else
+		{
+			emitOp(InterpreterOp::call_native);
+			emitWord(imm.functionIndex - numFunctionImports);
+			emitThunkCall(calleeType, argsSlot);
+		}
+
+		pushResults(calleeType.results().size());
+	}
+
+	void call_indirect(CallIndirectImm imm)
+	{
+		const FunctionType calleeType = module.types[imm.type.index];
+		const Uptr elementIndexSlot   = pop();
+		const Uptr argsSlot           = popCallArgs(calleeType.params().size());
+
+		emitOp(InterpreterOp::call_indirect);
+		emitWord(elementIndexSlot);
+		emitWord(calleeType.getEncoding().impl);
+		emitThunkCall(calleeType, argsSlot);
+
+		pushResults(calleeType.results().size());
+	}
+
+	void drop(NoImm) { pop(); }
+
+	void select(NoImm)
+	{
+		const Uptr conditionSlot  = pop();
+		const Uptr falseValueSlot = pop();
+		const Uptr trueValueSlot  = pop();
+		emitOp(InterpreterOp::select);
+		emitWord(trueValueSlot);
+		emitWord(falseValueSlot);
+		emitWord(conditionSlot);
+		emitResultWord(pushResult());
+	}
+
+	void get_local(GetOrSetVariableImm<false> imm) { push(imm.variableIndex); }
+
+	void set_local(GetOrSetVariableImm<false> imm) { setLocal(imm.variableIndex, pop()); }
+
+	void tee_local(GetOrSetVariableImm<false> imm)
+	{
+		setLocal(imm.variableIndex, pop());
+		push(imm.variableIndex);
+	}
+
+	void get_global(GetOrSetVariableImm<true> imm)
+	{
+		const GlobalType globalType = module.globals.getType(imm.variableIndex);
+		if(!globalType.isMutable) { emitOp(InterpreterOp::get_immutable_global); }
+		else if(getTypeByteWidth(globalType.valueType) == sizeof(U32))
+		{
+			emitOp(InterpreterOp::get_mutable_global32);
+		}
+		else
+		{
+			emitOp(InterpreterOp::get_mutable_global64);
+		}
+		emitWord(imm.variableIndex);
+		emitResultWord(pushResult());
+	}
+
+	void set_global(GetOrSetVariableImm<true> imm)
+	{
+		const GlobalType globalType = module.globals.getType(imm.variableIndex);
+		const Uptr valueSlot        = pop();
+		emitOp(getTypeByteWidth(globalType.valueType) == sizeof(U32)
+				   ? InterpreterOp::set_mutable_global32
+				   : InterpreterOp::set_mutable_global64);
+		emitWord(imm.variableIndex);
+		emitWord(valueSlot);
+	}
+
+	//
+	// Non-parametric operators
+	//
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+	void name(Imm imm) { translateOp(Opcode::name, imm); }
+	ENUM_NONCONTROL_NONPARAMETRIC_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+
+private:
+	struct ControlFrame
+	{
+		enum class Type : U8
+		{
+			function,
+			block,
+			loop,
+			ifThen,
+			ifElse
+		};
+
+		Type type;
+
+		// The operand stack height at the start of the control structure, excluding its
+		// parameters.
+		Uptr baseHeight;
+		TypeTuple params;
+		TypeTuple results;
+
+		// The offsets of the current part of the control structure, or null if unknown.
+		const ControlPartOffsets* partOffsets;
+
+		// The words to patch with the offset of the control structure's end, the word to patch
+		// with the offset of an if's else part, and the offset of a loop's start.
+		std::vector<Uptr> endWordIndices;
+		Uptr elseWordIndex;
+		Uptr loopWordIndex;
+
+		bool isReachable;
+	};
+
+	const Module& module;
+	const CompiledModule& compiledModule;
+	const FunctionDef& functionDef;
+	const FunctionType functionType;
+	Interpreter::FunctionCode& functionCode;
+	std::vector<Uptr>& words;
+	OperatorDecoderStream decoder;
+
+	std::vector<ControlFrame> controlStack;
+
+	// The slot holding each value on the operand stack. This is either the slot for the value's
+	// height on the stack, or the slot of a local that has been pushed by get_local and not
+	// written since.
+	std::vector<Uptr> stack;
+
+	const Uptr numLocals;
+	Uptr maxStackHeight;
+
+	// The index of the word that holds the destination slot of the last emitted instruction, if
+	// it computes a single result that may be redirected to a local by set_local.
+	Uptr lastResultWordIndex;
+
+	//
+	// Operand stack
+	//
+
+	Uptr getHeightSlot(Uptr height) const { return numLocals + height; }
+
+	void push(Uptr slot)
+	{
+		stack.push_back(slot);
+		if(stack.size() > maxStackHeight) { maxStackHeight = stack.size(); }
+	}
+
+	Uptr pushResult()
+	{
+		const Uptr slot = getHeightSlot(stack.size());
+		push(slot);
+		return slot;
+	}
+
+	void pushResults(Uptr numResults)
+	{
+		for(Uptr resultIndex = 0; resultIndex < numResults; ++resultIndex) { pushResult(); }
+	}
+
+	Uptr pop()
+	{
+		wavmAssert(stack.size() > controlStack.back().baseHeight);
+		const Uptr slot = stack.back();
+		stack.pop_back();
+		return slot;
+	}
+
+	// Copies the value at a height of the operand stack to the slot for that height, if it's in a
+	// local's slot.
+	void materialize(Uptr height)
+	{
+		const Uptr heightSlot = getHeightSlot(height);
+		if(stack[height] != heightSlot)
+		{
+			emitCopy(stack[height], heightSlot);
+			stack[height] = heightSlot;
+		}
+	}
+
+	void materializeTop(Uptr baseHeight, Uptr numValues)
+	{
+		wavmAssert(stack.size() == baseHeight + numValues);
+		for(Uptr height = baseHeight; height < stack.size(); ++height) { materialize(height); }
+	}
+
+	// Control structures start with all values on the operand stack in the slots for their
+	// heights, so the code that branches to the control structure's labels can agree on where
+	// the values are.
+	void materializeStack()
+	{
+		for(Uptr height = 0; height < stack.size(); ++height) { materialize(height); }
+	}
+
+	// Resets the operand stack at the start of a control structure part or after its end to the
+	// base height followed by numValues values in the slots for their heights.
+	void resetStack(Uptr baseHeight, Uptr numValues)
+	{
+		stack.resize(baseHeight);
+		pushResults(numValues);
+	}
+
+	Uptr popCallArgs(Uptr numArgs)
+	{
+		wavmAssert(stack.size() >= numArgs);
+		const Uptr baseHeight = stack.size() - numArgs;
+		for(Uptr height = baseHeight; height < stack.size(); ++height) { materialize(height); }
+		stack.resize(baseHeight);
+		return getHeightSlot(baseHeight);
+	}
+
+	void setLocal(Uptr localIndex, Uptr valueSlot)
+	{
+		// Copy the local's old value to the slots of any values on the operand stack that refer to
+		// it.
+		for(Uptr height = 0; height < stack.size(); ++height)
+		{
+			if(stack[height] == localIndex) { materialize(height); }
+		}
+
+		if(valueSlot == localIndex) { return; }
+		else if(lastResultWordIndex != UINTPTR_MAX && words[lastResultWordIndex] == valueSlot
+				&& valueSlot >= numLocals)
+		{
+			// If the value was computed by the last instruction, write it directly to the local.
+			words[lastResultWordIndex] = localIndex;
+			lastResultWordIndex        = UINTPTR_MAX;
+		}
+		else
+		{
+			emitCopy(valueSlot, localIndex);
+		}
+	}
+
+	//
+	// Code emission
+	//
+
+	void emitOp(InterpreterOp op)
+	{
+		words.push_back(Uptr(op));
+		lastResultWordIndex = UINTPTR_MAX;
+	}
+
+	void emitWord(Uptr word) { words.push_back(word); }
+
+	void emitResultWord(Uptr slot)
+	{
+		lastResultWordIndex = words.size();
+		words.push_back(slot);
+	}
+
+	void emitCopy(Uptr sourceSlot, Uptr destSlot)
+	{
+		emitOp(InterpreterOp::copy);
+		emitWord(sourceSlot);
+		emitResultWord(destSlot);
+	}
+
+	// Marks the current offset as the target of a branch, so instructions after it can't be
+	// changed by set_local.
+	void bindLabel() { lastResultWordIndex = UINTPTR_MAX; }
+
+	void emitThunkCall(FunctionType calleeType, Uptr argsSlot)
+	{
+		emitWord(reinterpret_cast<Uptr>(
+			LLVMJIT::getInvokeThunk(calleeType, CallingConvention::wasm)));
+		emitWord(argsSlot);
+		emitWord(calleeType.params().size());
+		emitWord(calleeType.results().size());
+
+		// The invoke thunk writes each result at the next offset aligned to the result's size.
+		Uptr resultOffset = 0;
+		for(ValueType resultType : calleeType.results())
+		{
+			const Uptr numResultBytes = getTypeByteWidth(resultType);
+			resultOffset              = (resultOffset + numResultBytes - 1) & ~(numResultBytes - 1);
+			emitWord((resultOffset << 1) | (numResultBytes == sizeof(U64) ? 1 : 0));
+			resultOffset += numResultBytes;
+		}
+	}
+
+	void emitReturn()
+	{
+		const Uptr numResults = functionType.results().size();
+		wavmAssert(stack.size() >= numResults);
+		emitOp(InterpreterOp::return_);
+		emitWord(numResults);
+		for(Uptr resultIndex = 0; resultIndex < numResults; ++resultIndex)
+		{ emitWord(stack[stack.size() - numResults + resultIndex]); }
+	}
+
+	void enterUnreachable()
+	{
+		controlStack.back().isReachable = false;
+		stack.resize(controlStack.back().baseHeight);
+	}
+
+	void pushControlFrame(ControlFrame::Type type, FunctionType blockType)
+	{
+		wavmAssert(stack.size() >= blockType.params().size());
+
+		ControlFrame frame;
+		frame.type          = type;
+		frame.baseHeight    = stack.size() - blockType.params().size();
+		frame.params        = blockType.params();
+		frame.results       = blockType.results();
+		frame.partOffsets   = findControlPart(functionDef, decoder.getOffset());
+		frame.elseWordIndex = UINTPTR_MAX;
+		frame.loopWordIndex = UINTPTR_MAX;
+		frame.isReachable   = true;
+		controlStack.push_back(std::move(frame));
+	}
+
+	//
+	// Branches
+	//
+
+	ControlFrame& getBranchTarget(Uptr depth)
+	{
+		wavmAssert(depth < controlStack.size());
+		return controlStack[controlStack.size() - depth - 1];
+	}
+
+	static TypeTuple getBranchArgTypes(const ControlFrame& target)
+	{
+		return target.type == ControlFrame::Type::loop ? target.params : target.results;
+	}
+
+	// Returns whether any of the branch arguments aren't already in the slots for the heights
+	// the target expects them at.
+	bool needsBranchCopies(const ControlFrame& target) const
+	{
+		const Uptr numArgs = getBranchArgTypes(target).size();
+		wavmAssert(stack.size() >= numArgs);
+		for(Uptr argIndex = 0; argIndex < numArgs; ++argIndex)
+		{
+			if(stack[stack.size() - numArgs + argIndex]
+			   != getHeightSlot(target.baseHeight + argIndex))
+			{ return true; }
+		}
+		return false;
+	}
+
+	void emitBranchCopies(const ControlFrame& target)
+	{
+		// The target's base height is at most the current stack height, so each copy only writes
+		// a slot that is below the branch arguments that haven't been copied yet.
+		const Uptr numArgs = getBranchArgTypes(target).size();
+		for(Uptr argIndex = 0; argIndex < numArgs; ++argIndex)
+		{
+			const Uptr sourceSlot = stack[stack.size() - numArgs + argIndex];
+			const Uptr destSlot   = getHeightSlot(target.baseHeight + argIndex);
+			if(sourceSlot != destSlot) { emitCopy(sourceSlot, destSlot); }
+		}
+	}
+
+	void emitBranchTargetWord(ControlFrame& target)
+	{
+		if(target.type == ControlFrame::Type::loop) { emitWord(target.loopWordIndex); }
+		else
+		{
+			target.endWordIndices.push_back(words.size());
+			emitWord(0);
+		}
+	}
+
+	void emitBranch(ControlFrame& target)
+	{
+		if(target.type == ControlFrame::Type::function) { emitReturn(); }
+		else
+		{
+			emitBranchCopies(target);
+			emitOp(InterpreterOp::br);
+			emitBranchTargetWord(target);
+		}
+	}
+
+	//
+	// Non-parametric operators
+	//
+
+	void translateUnaryOp(InterpreterOp op)
+	{
+		const Uptr operandSlot = pop();
+		emitOp(op);
+		emitWord(operandSlot);
+		emitResultWord(pushResult());
+	}
+
+	void translateBinaryOp(InterpreterOp op)
+	{
+		const Uptr rightSlot = pop();
+		const Uptr leftSlot  = pop();
+		emitOp(op);
+		emitWord(leftSlot);
+		emitWord(rightSlot);
+		emitResultWord(pushResult());
+	}
+
+	void translateConst(U64 bits)
+	{
+		emitOp(InterpreterOp::const_);
+		emitWord(bits);
+		emitResultWord(pushResult());
+	}
+
+	void translateOp(Opcode opcode, NoImm)
+	{
+		switch(opcode)
+		{
+		case Opcode::nop: break;
+
+		// Reinterpreting a value doesn't change the bits in its slot.
+		case Opcode::i32_reinterpret_f32:
+		case Opcode::i64_reinterpret_f64:
+		case Opcode::f32_reinterpret_i32:
+		case Opcode::f64_reinterpret_i64: break;
+
+#define VISIT_UNARY_OP(name, ...)                                                                  \
+	case Opcode::name: translateUnaryOp(InterpreterOp::name); break;
+			ENUM_INTERPRETER_UNARY_OPS(VISIT_UNARY_OP)
+#undef VISIT_UNARY_OP
+
+#define VISIT_BINARY_OP(name, ...)                                                                 \
+	case Opcode::name: translateBinaryOp(InterpreterOp::name); break;
+			ENUM_INTERPRETER_BINARY_OPS(VISIT_BINARY_OP)
+#undef VISIT_BINARY_OP
+
+		default: Errors::unreachable();
+		};
+	}
+
+	void translateOp(Opcode opcode, MemoryImm)
+	{
+		if(opcode == Opcode::memory_size)
+		{
+			emitOp(InterpreterOp::memory_size);
+			emitResultWord(pushResult());
+		}
+		else
+		{
+			wavmAssert(opcode == Opcode::memory_grow);
+			translateUnaryOp(InterpreterOp::memory_grow);
+		}
+	}
+
+	void translateOp(Opcode, LiteralImm<I32> imm) { translateConst(U32(imm.value)); }
+	void translateOp(Opcode, LiteralImm<I64> imm) { translateConst(U64(imm.value)); }
+	void translateOp(Opcode, LiteralImm<F32> imm)
+	{
+		U32 bits;
+		memcpy(&bits, &imm.value, sizeof(U32));
+		translateConst(bits);
+	}
+	void translateOp(Opcode, LiteralImm<F64> imm)
+	{
+		U64 bits;
+		memcpy(&bits, &imm.value, sizeof(U64));
+		translateConst(bits);
+	}
+
+	template<Uptr naturalAlignmentLog2>
+	void translateOp(Opcode opcode, LoadOrStoreImm<naturalAlignmentLog2> imm)
+	{
+		switch(opcode)
+		{
+#define VISIT_LOAD_OP(name, ...)                                                                   \
+	case Opcode::name:                                                                             \
+	{                                                                                              \
+		const Uptr addressSlot = pop();                                                            \
+		emitOp(InterpreterOp::name);                                                               \
+		emitWord(addressSlot);                                                                     \
+		emitWord(imm.offset);                                                                      \
+		emitResultWord(pushResult());                                                              \
+		break;                                                                                     \
+	}
+			ENUM_INTERPRETER_LOAD_OPS(VISIT_LOAD_OP)
+#undef VISIT_LOAD_OP
+
+#define VISIT_STORE_OP(name, ...)                                                                  \
+	case Opcode::name:                                                                             \
+	{                                                                                              \
+		const Uptr valueSlot   = pop();                                                            \
+		const Uptr addressSlot = pop();                                                            \
+		emitOp(InterpreterOp::name);                                                               \
+		emitWord(addressSlot);                                                                     \
+		emitWord(valueSlot);                                                                       \
+		emitWord(imm.offset);                                                                      \
+		break;                                                                                     \
+	}
+			ENUM_INTERPRETER_STORE_OPS(VISIT_STORE_OP)
+#undef VISIT_STORE_OP
+
+		default: Errors::unreachable();
+		};
+	}
+
+	template<Uptr naturalAlignmentLog2>
+	void translateOp(Opcode opcode, AtomicLoadOrStoreImm<naturalAlignmentLog2> imm)
+	{
+		// Pop the operands, and emit the instruction with the address first, then the other
+		// operands, the offset, and the result.
+		Uptr numOperands = 0;
+		InterpreterOp op = InterpreterOp::unreachable;
+		bool hasResult   = true;
+		switch(opcode)
+		{
+#define VISIT_ATOMIC_OP(name, numOperandsForOp, hasResultForOp)                                    \
+	case Opcode::name:                                                                             \
+		op          = InterpreterOp::name;                                                         \
+		numOperands = numOperandsForOp;                                                            \
+		hasResult   = hasResultForOp;                                                              \
+		break;
+#define VISIT_ATOMIC_LOAD_OP(name, ...) VISIT_ATOMIC_OP(name, 1, true)
+#define VISIT_ATOMIC_STORE_OP(name, ...) VISIT_ATOMIC_OP(name, 2, false)
+#define VISIT_ATOMIC_RMW_OP(name, ...) VISIT_ATOMIC_OP(name, 2, true)
+#define VISIT_ATOMIC_CMPXCHG_OP(name, ...) VISIT_ATOMIC_OP(name, 3, true)
+			ENUM_INTERPRETER_ATOMIC_LOAD_OPS(VISIT_ATOMIC_LOAD_OP)
+			ENUM_INTERPRETER_ATOMIC_STORE_OPS(VISIT_ATOMIC_STORE_OP)
+			ENUM_INTERPRETER_ATOMIC_RMW_OPS(VISIT_ATOMIC_RMW_OP)
+			ENUM_INTERPRETER_ATOMIC_CMPXCHG_OPS(VISIT_ATOMIC_CMPXCHG_OP)
+			VISIT_ATOMIC_OP(atomic_wake, 2, true)
+			VISIT_ATOMIC_OP(i32_atomic_wait, 3, true)
+			VISIT_ATOMIC_OP(i64_atomic_wait, 3, true)
+#undef VISIT_ATOMIC_LOAD_OP
+#undef VISIT_ATOMIC_STORE_OP
+#undef VISIT_ATOMIC_RMW_OP
+#undef VISIT_ATOMIC_CMPXCHG_OP
+#undef VISIT_ATOMIC_OP
+		default: Errors::unreachable();
+		};
+
+		wavmAssert(stack.size() >= numOperands);
+		const Uptr firstOperandHeight = stack.size() - numOperands;
+		emitOp(op);
+		for(Uptr height = firstOperandHeight; height < stack.size(); ++height)
+		{ emitWord(stack[height]); }
+		emitWord(imm.offset);
+		stack.resize(firstOperandHeight);
+		if(hasResult) { emitResultWord(pushResult()); }
+	}
+
+	template<typename Imm> void translateOp(Opcode, Imm) { Errors::unreachable(); }
+};
+
+static Interpreter::FunctionCode* translateFunction(const CompiledModule& compiledModule,
+													 Uptr functionDefIndex)
+{
+	Interpreter::FunctionCode* functionCode = new Interpreter::FunctionCode;
+	FunctionTranslator(compiledModule, functionDefIndex, *functionCode).translate();
+	return functionCode;
+}
+
+static const Interpreter::FunctionCode* getFunctionCode(const CompiledModule& compiledModule,
+														 Uptr functionDefIndex)
+{
+	wavmAssert(compiledModule.interpretedFunctionDefs[functionDefIndex]);
+	std::atomic<Interpreter::FunctionCode*>& cachedFunctionCode
+		= compiledModule.interpreterFunctionCode[functionDefIndex];
+
+	// Translate the function the first time it is called. This is called while executing the
+	// caller, so a stack overflow may unwind out of it with longjmp: no lock is held while
+	// translating. If another thread publishes a translation first, this thread's is discarded.
+	Interpreter::FunctionCode* functionCode = cachedFunctionCode.load(std::memory_order_acquire);
+	if(!functionCode)
+	{
+		Interpreter::FunctionCode* newFunctionCode
+			= translateFunction(compiledModule, functionDefIndex);
+		if(cachedFunctionCode.compare_exchange_strong(
+			   functionCode, newFunctionCode, std::memory_order_acq_rel, std::memory_order_acquire))
+		{ functionCode = newFunctionCode; }
+		else
+		{
+			delete newFunctionCode;
+		}
+	}
+	return functionCode;
+}
+
+//
+// Support checking
+//
+
+static bool isSupportedType(ValueType type) { return type != ValueType::v128; }
+
+static bool isSupportedFunctionType(FunctionType type)
+{
+	for(ValueType param : type.params())
+	{
+		if(!isSupportedType(param)) { return false; }
+	}
+	for(ValueType result : type.results())
+	{
+		if(!isSupportedType(result)) { return false; }
+	}
+	return true;
+}
+
+// Checks whether the interpreter supports the operators in a function.
+struct InterpreterSupportVisitor
+{
+	typedef bool Result;
+
+	InterpreterSupportVisitor(const Module& inModule) : module(inModule)
+	{
+		supportedFeatures.simd              = false;
+		supportedFeatures.exceptionHandling = false;
+	}
+
+	bool unknown(Opcode) { return false; }
+
+#define VISIT_OP(opcode, name, nameString, Imm, signature, feature)                                \
+	bool name(Imm imm) { return supportedFeatures.feature && isSupported(imm); }
+	ENUM_OPERATORS(VISIT_OP)
+#undef VISIT_OP
+
+private:
+	const Module& module;
+	FeatureSpec supportedFeatures;
+
+	// Calls through an invoke thunk pass their arguments in its fixed-size argument buffer.
+	static bool isSupportedCalleeType(FunctionType type)
+	{
+		return isSupportedFunctionType(type)
+			   && type.params().size() * sizeof(U64) <= maxThunkArgAndReturnBytes;
+	}
+
+	bool isSupported(ControlStructureImm imm)
+	{
+		return isSupportedFunctionType(resolveBlockType(module, imm.type));
+	}
+	bool isSupported(GetOrSetVariableImm<true> imm)
+	{
+		return isSupportedType(module.globals.getType(imm.variableIndex).valueType);
+	}
+	bool isSupported(CallImm imm)
+	{
+		return isSupportedCalleeType(
+			module.types[module.functions.getType(imm.functionIndex).index]);
+	}
+	bool isSupported(CallIndirectImm imm)
+	{
+		return isSupportedCalleeType(module.types[imm.type.index]);
+	}
+	template<typename Imm> bool isSupported(Imm) { return true; }
+};
+
+bool Interpreter::canInterpretFunction(const Module& module, const FunctionDef& functionDef)
+{
+	const FunctionType functionType = module.types[functionDef.type.index];
+	if(!isSupportedFunctionType(functionType)) { return false; }
+	for(ValueType localType : functionDef.nonParameterLocalTypes)
+	{
+		if(!isSupportedType(localType)) { return false; }
+	}
+
+	InterpreterSupportVisitor visitor(module);
+	OperatorDecoderStream decoder(functionDef.code);
+	while(decoder)
+	{
+		if(!decoder.decodeOp(visitor)) { return false; }
+	}
+	return true;
+}
@@ -1,4 +1,5 @@
 #include "Intrinsics.h"
+#include "IR/Module.h"
 #include "Inline/BasicTypes.h"
 #include "Inline/HashMap.h"
 #include "Runtime.h"
@@ -36,6 +37,8 @@ Intrinsics::Function::Function(Intrinsics::Module& moduleRef,
 , type(inType)
 , nativeFunction(inNativeFunction)
 , callingConvention(inCallingConvention)
+, bitcode(nullptr)
+, numBitcodeBytes(0)
 {
 	initializeModule(moduleRef);
 
@@ -49,6 +52,43 @@ Runtime::FunctionInstance* Intrinsics::Function::instantiate(Runtime::Compartmen
 	return new Runtime::FunctionInstance(nullptr, type, nativeFunction, callingConvention, name);
 }
 
+const Intrinsics::Function* Intrinsics::getUninstantiatedFunction(
+	const Intrinsics::Module& moduleRef,
+	const std::string& name)
+{
+	if(!moduleRef.impl) { return nullptr; }
+	Intrinsics::Function* const* functionPtr = moduleRef.impl->functionMap.get(name);
+	return functionPtr ? *functionPtr : nullptr;
+}
+
+Runtime::CompiledModuleRef Intrinsics::compileModule(
+	const IR::Module& module,
+	const HashMap<std::string, const Intrinsics::Module*>& importModules)
+{
+	// Find the function imports that will be bound to intrinsic functions with bitcode bodies.
+	std::vector<const Function*> inlinedFunctionImports(module.functions.imports.size(), nullptr);
+	for(Uptr importIndex = 0; importIndex < module.functions.imports.size(); ++importIndex)
+	{
+		const auto& functionImport = module.functions.imports[importIndex];
+		const Intrinsics::Module* const* importModule
+			= importModules.get(functionImport.moduleName);
+		if(!importModule) { continue; }
+
+		const Function* function
+			= getUninstantiatedFunction(**importModule, functionImport.exportName);
+		if(function && function->getBitcode()
+		   && function->getCallingConvention() == Runtime::CallingConvention::intrinsic
+		   && function->getType() == module.types[functionImport.type.index])
+		{ inlinedFunctionImports[importIndex] = function; }
+	}
+
+	// Compile the module as written. Modules compiled against intrinsics are usually small, so
+	// removing their unused code wouldn't make compiling them noticeably faster.
+	Runtime::CompileOptions options;
+	options.optimizeModule = false;
+	return Runtime::compileModule(module, std::move(inlinedFunctionImports), options);
+}
+
 Intrinsics::Global::Global(Intrinsics::Module& moduleRef,
 						   const char* inName,
 						   IR::ValueType inType,
@@ -113,6 +113,7 @@ void EmitFunctionContext::else_(NoImm imm)
 	currentContext.type        = ControlContext::Type::ifElse;
 	currentContext.isReachable = true;
 	currentContext.elseBlock   = nullptr;
+	currentContext.partOffsets = findNextControlPart();
 }
 void EmitFunctionContext::end(NoImm)
 {
@@ -243,7 +244,7 @@ void EmitFunctionContext::br_table(BranchTableImm imm)
 
 	// Create a LLVM switch instruction.
 	wavmAssert(imm.branchTableIndex < functionDef.branchTables.size());
-	const std::vector<U32>& targetDepths = functionDef.branchTables[imm.branchTableIndex];
+	const ArenaArray<U32>& targetDepths = functionDef.branchTables[imm.branchTableIndex];
 	auto llvmSwitch
 		= irBuilder.CreateSwitch(index, defaultTarget.block, (unsigned int)targetDepths.size());
 
@@ -298,28 +299,36 @@ void EmitFunctionContext::unreachable(NoImm)
 void EmitFunctionContext::call(CallImm imm)
 {
 	// Map the callee function index to either an imported function pointer or a function in this
-	// module.
+	// module. Imported functions are always called with the WASM calling convention: when the
+	// module is loaded for an instance, imports with other calling conventions are bound to a
+	// thunk.
 	llvm::Value* callee;
 	FunctionType calleeType;
-	CallingConvention callingConvention;
-	if(imm.functionIndex < module.functions.imports.size())
+	CallingConvention calleeCallingConvention = CallingConvention::wasm;
+	if(imm.functionIndex < module.functions.imports.size()
+	   && moduleContext.inlinedFunctionImports[imm.functionIndex])
 	{
-		wavmAssert(imm.functionIndex < moduleContext.moduleInstance->functions.size());
-		FunctionInstance* importedCallee
-			= moduleContext.moduleInstance->functions[imm.functionIndex];
-		calleeType = importedCallee->type;
-		callee     = emitLiteralPointer(
-            importedCallee->nativeFunction,
-            asLLVMType(importedCallee->type, importedCallee->callingConvention)->getPointerTo());
-		callingConvention = importedCallee->callingConvention;
+		// If the import will be bound to an intrinsic function with a bitcode body, call the body
+		// linked into the module so LLVM may inline it.
+		const Intrinsics::Function* intrinsicFunction
+			= moduleContext.inlinedFunctionImports[imm.functionIndex];
+		calleeType              = intrinsicFunction->getType();
+		calleeCallingConvention = intrinsicFunction->getCallingConvention();
+		callee                  = moduleContext.getIntrinsicBitcodeFunction(intrinsicFunction);
+	}
+	else if(imm.functionIndex < module.functions.imports.size())
+	{
+		calleeType = module.types[module.functions.imports[imm.functionIndex].type.index];
+		callee     = moduleContext.getInstancePointer(
+            "functionImport" + std::to_string(imm.functionIndex),
+            asLLVMType(calleeType, CallingConvention::wasm)->getPointerTo());
 	}
 	else
 	{
 		const Uptr functionDefIndex = imm.functionIndex - module.functions.imports.size();
 		wavmAssert(functionDefIndex < moduleContext.functionDefs.size());
-		callee            = moduleContext.functionDefs[functionDefIndex];
-		calleeType        = module.types[module.functions.defs[functionDefIndex].type.index];
-		callingConvention = CallingConvention::wasm;
+		callee     = moduleContext.functionDefs[functionDefIndex];
+		calleeType = module.types[module.functions.defs[functionDefIndex].type.index];
 	}
 
 	// Pop the call arguments from the operand stack.
@@ -335,7 +344,7 @@ void EmitFunctionContext::call(CallImm imm)
 	ValueVector results = emitCallOrInvoke(callee,
 										   llvm::ArrayRef<llvm::Value*>(llvmArgs, numArguments),
 										   calleeType,
-										   callingConvention,
+										   calleeCallingConvention,
 										   getInnermostUnwindToBlock());
 
 	// Push the results on the operand stack.
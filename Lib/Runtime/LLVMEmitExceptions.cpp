@@ -148,7 +148,7 @@ void EmitFunctionContext::try_(ControlStructureImm imm)
 
 static llvm::Function* createSEHFilterFunction(
 	EmitFunctionContext& functionContext,
-	const Runtime::ExceptionTypeInstance* catchTypeInstance,
+	llvm::Value* catchTypeInstanceI64,
 	llvm::Value*& outExceptionDataAlloca)
 {
 	// Insert an alloca for the exception point at the beginning of the function, and add it as a
@@ -218,7 +218,7 @@ static llvm::Function* createSEHFilterFunction(
 		exceptionData,
 		filterIRBuilder.CreatePointerCast(exceptionDataAlloca, llvmI64Type->getPointerTo()));
 
-	if(!catchTypeInstance)
+	if(!catchTypeInstanceI64)
 	{
 		// If the exception code is SEH_WAVM_EXCEPTION, and the exception is a user exception,
 		// return 1 from the filter function.
@@ -233,8 +233,8 @@ static llvm::Function* createSEHFilterFunction(
 		// exception type, return 1 from the filter function.
 		auto exceptionTypeInstance = filterIRBuilder.CreateLoad(
 			filterIRBuilder.CreateIntToPtr(exceptionData, llvmI64Type->getPointerTo()));
-		auto isExpectedTypeInstance = filterIRBuilder.CreateICmpEQ(
-			exceptionTypeInstance, emitLiteral(reinterpret_cast<I64>(catchTypeInstance)));
+		auto isExpectedTypeInstance
+			= filterIRBuilder.CreateICmpEQ(exceptionTypeInstance, catchTypeInstanceI64);
 		filterIRBuilder.CreateRet(filterIRBuilder.CreateZExt(isExpectedTypeInstance, llvmI32Type));
 	}
 
@@ -259,17 +259,17 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 
 		branchToEndOfControlContext();
 
-		// Look up the exception type instance to be caught
-		wavmAssert(imm.exceptionTypeIndex
-				   < moduleContext.moduleInstance->exceptionTypeInstances.size());
-		const Runtime::ExceptionTypeInstance* catchTypeInstance
-			= moduleContext.moduleInstance->exceptionTypeInstances[imm.exceptionTypeIndex];
+		// Look up the exception type to be caught
+		wavmAssert(imm.exceptionTypeIndex < module.exceptionTypes.size());
+		const ExceptionType catchType = module.exceptionTypes.getType(imm.exceptionTypeIndex);
+		llvm::Value* catchTypeInstanceI64 = moduleContext.getInstanceValue(
+			"exceptionType" + std::to_string(imm.exceptionTypeIndex));
 
 		// Create a filter function that returns 1 for the specific exception type this instruction
 		// catches.
 		llvm::Value* exceptionDataAlloca = nullptr;
 		auto filterFunction
-			= createSEHFilterFunction(*this, catchTypeInstance, exceptionDataAlloca);
+			= createSEHFilterFunction(*this, catchTypeInstanceI64, exceptionDataAlloca);
 
 		// Create a block+catchpad that the catchswitch will transfer control to if the filter
 		// function returns 1.
@@ -286,15 +286,14 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 		irBuilder.SetInsertPoint(catchBlock);
 
 		catchContext.exceptionPointer = irBuilder.CreateLoad(exceptionDataAlloca);
-		for(Uptr argumentIndex = 0; argumentIndex < catchTypeInstance->type.params.size();
-			++argumentIndex)
+		for(Uptr argumentIndex = 0; argumentIndex < catchType.params.size(); ++argumentIndex)
 		{
-			const ValueType parameters = catchTypeInstance->type.params[argumentIndex];
+			const ValueType parameters = catchType.params[argumentIndex];
 			auto argument              = loadFromUntypedPointer(
                 irBuilder.CreateInBoundsGEP(
                     catchContext.exceptionPointer,
                     {emitLiteral(offsetof(ExceptionData, arguments)
-                                 + (catchTypeInstance->type.params.size() - argumentIndex - 1)
+                                 + (catchType.params.size() - argumentIndex - 1)
                                        * sizeof(ExceptionData::arguments[0]))}),
                 asLLVMType(parameters));
 			push(argument);
@@ -303,6 +302,7 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 		// Change the top of the control stack to a catch clause.
 		controlContext.type        = ControlContext::Type::catch_;
 		controlContext.isReachable = true;
+		controlContext.partOffsets = findNextControlPart();
 	}
 	else
 	{
@@ -320,16 +320,15 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 
 		branchToEndOfControlContext();
 
-		// Look up the exception type instance to be caught
-		wavmAssert(imm.exceptionTypeIndex
-				   < moduleContext.moduleInstance->exceptionTypeInstances.size());
-		const Runtime::ExceptionTypeInstance* catchTypeInstance
-			= moduleContext.moduleInstance->exceptionTypeInstances[imm.exceptionTypeIndex];
+		// Look up the exception type to be caught
+		wavmAssert(imm.exceptionTypeIndex < module.exceptionTypes.size());
+		const ExceptionType catchType = module.exceptionTypes.getType(imm.exceptionTypeIndex);
 
 		irBuilder.SetInsertPoint(catchContext.nextHandlerBlock);
-		auto isExceptionType
-			= irBuilder.CreateICmpEQ(catchContext.exceptionTypeInstance,
-									 emitLiteral(reinterpret_cast<Uptr>(catchTypeInstance)));
+		auto isExceptionType = irBuilder.CreateICmpEQ(
+			catchContext.exceptionTypeInstance,
+			moduleContext.getInstanceValue("exceptionType"
+										   + std::to_string(imm.exceptionTypeIndex)));
 
 		auto catchBlock     = llvm::BasicBlock::Create(*llvmContext, "catch", llvmFunction);
 		auto unhandledBlock = llvm::BasicBlock::Create(*llvmContext, "unhandled", llvmFunction);
@@ -337,10 +336,9 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 		catchContext.nextHandlerBlock = unhandledBlock;
 		irBuilder.SetInsertPoint(catchBlock);
 
-		for(Iptr argumentIndex = catchTypeInstance->type.params.size() - 1; argumentIndex >= 0;
-			--argumentIndex)
+		for(Iptr argumentIndex = catchType.params.size() - 1; argumentIndex >= 0; --argumentIndex)
 		{
-			const ValueType parameters = catchTypeInstance->type.params[argumentIndex];
+			const ValueType parameters = catchType.params[argumentIndex];
 			const Uptr argumentOffset  = offsetof(ExceptionData, arguments)
 										+ sizeof(ExceptionData::arguments[0]) * argumentIndex;
 			auto argument
@@ -353,6 +351,7 @@ void EmitFunctionContext::catch_(ExceptionTypeImm imm)
 		// Change the top of the control stack to a catch clause.
 		controlContext.type        = ControlContext::Type::catch_;
 		controlContext.isReachable = true;
+		controlContext.partOffsets = findNextControlPart();
 	}
 }
 void EmitFunctionContext::catch_all(NoImm)
@@ -397,6 +396,7 @@ void EmitFunctionContext::catch_all(NoImm)
 		// Change the top of the control stack to a catch clause.
 		controlContext.type        = ControlContext::Type::catch_;
 		controlContext.isReachable = true;
+		controlContext.partOffsets = findNextControlPart();
 	}
 	else
 	{
@@ -432,6 +432,7 @@ void EmitFunctionContext::catch_all(NoImm)
 		// Change the top of the control stack to a catch clause.
 		controlContext.type        = ControlContext::Type::catch_;
 		controlContext.isReachable = true;
+		controlContext.partOffsets = findNextControlPart();
 	}
 }
 
@@ -447,14 +448,14 @@ void EmitFunctionContext::emitThrow(llvm::Value* exceptionTypeInstanceI64,
 
 void EmitFunctionContext::throw_(ExceptionTypeImm imm)
 {
-	const Runtime::ExceptionTypeInstance* exceptionTypeInstance
-		= moduleContext.moduleInstance->exceptionTypeInstances[imm.exceptionTypeIndex];
+	wavmAssert(imm.exceptionTypeIndex < module.exceptionTypes.size());
+	const ExceptionType exceptionType = module.exceptionTypes.getType(imm.exceptionTypeIndex);
 
-	const Uptr numArgs     = exceptionTypeInstance->type.params.size();
+	const Uptr numArgs     = exceptionType.params.size();
 	const Uptr numArgBytes = numArgs * sizeof(UntaggedValue);
 	auto argBaseAddress    = irBuilder.CreateAlloca(llvmI8Type, emitLiteral(numArgBytes));
 
-	for(Uptr argIndex = 0; argIndex < exceptionTypeInstance->type.params.size(); ++argIndex)
+	for(Uptr argIndex = 0; argIndex < exceptionType.params.size(); ++argIndex)
 	{
 		auto elementValue = pop();
 		irBuilder.CreateStore(
@@ -466,7 +467,8 @@ void EmitFunctionContext::throw_(ExceptionTypeImm imm)
 				elementValue->getType()->getPointerTo()));
 	}
 
-	emitThrow(emitLiteral((U64) reinterpret_cast<Uptr>(exceptionTypeInstance)),
+	emitThrow(moduleContext.getInstanceValue("exceptionType"
+											 + std::to_string(imm.exceptionTypeIndex)),
 			  sizeof(Uptr) == 8
 				  ? irBuilder.CreatePtrToInt(argBaseAddress, llvmI64Type)
 				  : zext(irBuilder.CreatePtrToInt(argBaseAddress, llvmI32Type), llvmI64Type),
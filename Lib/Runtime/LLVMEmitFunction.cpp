@@ -122,20 +122,29 @@ ValueVector EmitFunctionContext::emitRuntimeIntrinsic(
 	FunctionType intrinsicType,
 	const std::initializer_list<llvm::Value*>& args)
 {
-	Object* intrinsicObject = Runtime::getInstanceExport(
-		moduleContext.moduleInstance->compartment->wavmIntrinsics, intrinsicName);
-	wavmAssert(intrinsicObject);
-	wavmAssert(isA(intrinsicObject, intrinsicType));
-	FunctionInstance* intrinsicFunction = asFunction(intrinsicObject);
-	wavmAssert(intrinsicFunction->type == intrinsicType);
-	auto intrinsicFunctionPointer = emitLiteralPointer(
-		intrinsicFunction->nativeFunction,
-		asLLVMType(intrinsicType, intrinsicFunction->callingConvention)->getPointerTo());
+	// The WAVM intrinsics' native functions are the same in every compartment, so look them up in
+	// the uninstantiated intrinsic module.
+	const Intrinsics::Function* intrinsicFunction = Intrinsics::getUninstantiatedFunction(
+		INTRINSIC_MODULE_REF(wavmIntrinsics), intrinsicName);
+	wavmAssert(intrinsicFunction);
+	wavmAssert(intrinsicFunction->getType() == intrinsicType);
+
+	// If the intrinsic has a bitcode body, call the body linked into the module so LLVM may inline
+	// it. Otherwise, call the native function through a literal pointer.
+	llvm::Value* intrinsicFunctionPointer;
+	if(intrinsicFunction->getBitcode())
+	{ intrinsicFunctionPointer = moduleContext.getIntrinsicBitcodeFunction(intrinsicFunction); }
+	else
+	{
+		intrinsicFunctionPointer = emitLiteralPointer(
+			intrinsicFunction->getNativeFunction(),
+			asLLVMType(intrinsicType, intrinsicFunction->getCallingConvention())->getPointerTo());
+	}
 
 	return emitCallOrInvoke(intrinsicFunctionPointer,
 							args,
 							intrinsicType,
-							intrinsicFunction->callingConvention,
+							intrinsicFunction->getCallingConvention(),
 							getInnermostUnwindToBlock());
 }
 
@@ -183,7 +192,8 @@ void EmitFunctionContext::pushControlStack(ControlContext::Type type,
 							resultTypes,
 							stack.size(),
 							branchTargetStack.size(),
-							true});
+							true,
+							findNextControlPart()});
 }
 
 void EmitFunctionContext::pushBranchTarget(TypeTuple branchArgumentType,
@@ -287,7 +297,7 @@ void EmitFunctionContext::emit()
 	auto diParamArray   = moduleContext.diBuilder.getOrCreateTypeArray(diFunctionParameterTypes);
 	auto diFunctionType = moduleContext.diBuilder.createSubroutineType(diParamArray);
 	diFunction          = moduleContext.diBuilder.createFunction(moduleContext.diModuleScope,
-                                                        functionInstance->debugName,
+                                                        debugName,
                                                         llvmFunction->getName(),
                                                         moduleContext.diModuleScope,
                                                         0,
@@ -346,16 +356,26 @@ void EmitFunctionContext::emit()
 	{
 		emitRuntimeIntrinsic("debugEnterFunction",
 							 FunctionType(TypeTuple{}, TypeTuple{ValueType::i64}),
-							 {emitLiteral(reinterpret_cast<U64>(functionInstance))});
+							 {moduleContext.getInstanceValue("functionDefInstance"
+															 + std::to_string(functionDefIndex))});
 	}
 
 	// Decode the WebAssembly opcodes and emit LLVM IR for them.
-	OperatorDecoderStream decoder(functionDef.code);
 	UnreachableOpVisitor unreachableOpVisitor(*this);
 	OperatorPrinter operatorPrinter(module, functionDef);
 	Uptr opIndex = 0;
 	while(decoder && controlStack.size())
 	{
+		// If the rest of the current control structure part is unreachable, and its end offset is
+		// known, skip directly to the else, catch, or end operator that ends it.
+		const ControlPartOffsets* unreachablePart
+			= controlStack.back().isReachable ? nullptr : controlStack.back().partOffsets;
+		if(unreachablePart)
+		{
+			decoder.seek(unreachablePart->endOpOffset);
+			opIndex = unreachablePart->endOpIndex;
+		}
+
 		irBuilder.SetCurrentDebugLocation(
 			llvm::DILocation::get(*llvmContext, (unsigned int)opIndex++, 0, diFunction));
 		if(ENABLE_LOGGING) { logOperator(decoder.decodeOpWithoutConsume(operatorPrinter)); }
@@ -373,7 +393,8 @@ void EmitFunctionContext::emit()
 	{
 		emitRuntimeIntrinsic("debugExitFunction",
 							 FunctionType(TypeTuple{}, TypeTuple{ValueType::i64}),
-							 {emitLiteral(reinterpret_cast<U64>(functionInstance))});
+							 {moduleContext.getInstanceValue("functionDefInstance"
+															 + std::to_string(functionDefIndex))});
 	}
 
 	// Emit the function return.
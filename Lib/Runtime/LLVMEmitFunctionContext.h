@@ -19,7 +19,8 @@ namespace LLVMJIT
 		const IR::Module& module;
 		const IR::FunctionDef& functionDef;
 		IR::FunctionType functionType;
-		Runtime::FunctionInstance* functionInstance;
+		Uptr functionDefIndex;
+		const std::string& debugName;
 		llvm::Function* llvmFunction;
 
 		std::vector<llvm::Value*> localPointers;
@@ -52,6 +53,10 @@ namespace LLVMJIT
 			Uptr outerStackSize;
 			Uptr outerBranchTargetStackSize;
 			bool isReachable;
+
+			// The offsets of the control structure part currently being emitted, or null if they
+			// weren't computed for the function.
+			const IR::ControlPartOffsets* partOffsets;
 		};
 
 		struct BranchTarget
@@ -61,6 +66,8 @@ namespace LLVMJIT
 			PHIVector phis;
 		};
 
+		IR::OperatorDecoderStream decoder;
+
 		std::vector<ControlContext> controlStack;
 		std::vector<BranchTarget> branchTargetStack;
 		std::vector<llvm::Value*> stack;
@@ -68,17 +75,19 @@ namespace LLVMJIT
 		EmitFunctionContext(EmitModuleContext& inModuleContext,
 							const Module& inModule,
 							const FunctionDef& inFunctionDef,
-							FunctionInstance* inFunctionInstance,
+							Uptr inFunctionDefIndex,
+							const std::string& inDebugName,
 							llvm::Function* inLLVMFunction)
-		: EmitContext(inModuleContext.moduleInstance->defaultMemory,
-					  inModuleContext.moduleInstance->defaultTable)
+		: EmitContext(inModuleContext.defaultMemoryId, inModuleContext.defaultTableId)
 		, moduleContext(inModuleContext)
 		, module(inModule)
 		, functionDef(inFunctionDef)
 		, functionType(inModule.types[inFunctionDef.type.index])
-		, functionInstance(inFunctionInstance)
+		, functionDefIndex(inFunctionDefIndex)
+		, debugName(inDebugName)
 		, llvmFunction(inLLVMFunction)
 		, localEscapeBlock(nullptr)
+		, decoder(inFunctionDef.code)
 		{
 		}
 
@@ -180,6 +189,13 @@ namespace LLVMJIT
 
 		void branchToEndOfControlContext();
 
+		// Called by the operators that begin a control structure part, after the decoder has
+		// consumed them, to find the offsets of the part.
+		const IR::ControlPartOffsets* findNextControlPart()
+		{
+			return IR::findControlPart(functionDef, decoder.getOffset());
+		}
+
 		BranchTarget& getBranchTargetByDepth(Uptr depth)
 		{
 			wavmAssert(depth < branchTargetStack.size());
@@ -55,7 +55,7 @@ void EmitFunctionContext::memory_grow(MemoryImm)
 	ValueVector previousNumPages = emitRuntimeIntrinsic(
 		"growMemory",
 		FunctionType(TypeTuple(ValueType::i32), TypeTuple({ValueType::i32, ValueType::i64})),
-		{deltaNumPages, emitLiteral(U64(moduleContext.moduleInstance->defaultMemory->id))});
+		{deltaNumPages, moduleContext.defaultMemoryId});
 	wavmAssert(previousNumPages.size() == 1);
 	push(previousNumPages[0]);
 }
@@ -64,7 +64,7 @@ void EmitFunctionContext::memory_size(MemoryImm)
 	ValueVector currentNumPages
 		= emitRuntimeIntrinsic("currentMemory",
 							   FunctionType(TypeTuple(ValueType::i32), TypeTuple(ValueType::i64)),
-							   {emitLiteral(U64(moduleContext.moduleInstance->defaultMemory->id))});
+							   {moduleContext.defaultMemoryId});
 	wavmAssert(currentNumPages.size() == 1);
 	push(currentNumPages[0]);
 }
@@ -144,7 +144,7 @@ void EmitFunctionContext::atomic_wake(AtomicLoadOrStoreImm<2> imm)
 {
 	llvm::Value* numWaiters     = pop();
 	llvm::Value* address        = pop();
-	llvm::Value* memoryId       = emitLiteral(U64(moduleContext.moduleInstance->defaultMemory->id));
+	llvm::Value* memoryId       = moduleContext.defaultMemoryId;
 	llvm::Value* boundedAddress = getOffsetAndBoundedAddress(irBuilder, address, imm.offset);
 	trapIfMisalignedAtomic(boundedAddress, imm.alignmentLog2);
 	push(emitRuntimeIntrinsic(
@@ -158,7 +158,7 @@ void EmitFunctionContext::i32_atomic_wait(AtomicLoadOrStoreImm<2> imm)
 	llvm::Value* timeout        = pop();
 	llvm::Value* expectedValue  = pop();
 	llvm::Value* address        = pop();
-	llvm::Value* memoryId       = emitLiteral(U64(moduleContext.moduleInstance->defaultMemory->id));
+	llvm::Value* memoryId       = moduleContext.defaultMemoryId;
 	llvm::Value* boundedAddress = getOffsetAndBoundedAddress(irBuilder, address, imm.offset);
 	trapIfMisalignedAtomic(boundedAddress, imm.alignmentLog2);
 	push(emitRuntimeIntrinsic(
@@ -172,7 +172,7 @@ void EmitFunctionContext::i64_atomic_wait(AtomicLoadOrStoreImm<3> imm)
 	llvm::Value* timeout        = pop();
 	llvm::Value* expectedValue  = pop();
 	llvm::Value* address        = pop();
-	llvm::Value* memoryId       = emitLiteral(U64(moduleContext.moduleInstance->defaultMemory->id));
+	llvm::Value* memoryId       = moduleContext.defaultMemoryId;
 	llvm::Value* boundedAddress = getOffsetAndBoundedAddress(irBuilder, address, imm.offset);
 	trapIfMisalignedAtomic(boundedAddress, imm.alignmentLog2);
 	push(emitRuntimeIntrinsic(
@@ -1,19 +1,32 @@
 #include "IR/OperatorPrinter.h"
 #include "IR/Operators.h"
 #include "Inline/Assert.h"
+#include "Inline/Errors.h"
 #include "Inline/Timing.h"
 #include "LLVMEmitFunctionContext.h"
 #include "LLVMJIT.h"
 
+#include "LLVMPreInclude.h"
+
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/SourceMgr.h"
+
+#include "LLVMPostInclude.h"
+
 using namespace LLVMJIT;
 using namespace IR;
 
-EmitModuleContext::EmitModuleContext(const Module& inModule,
-									 ModuleInstance* inModuleInstance,
-									 llvm::Module* inLLVMModule)
+EmitModuleContext::EmitModuleContext(
+	const Module& inModule,
+	const std::vector<const Intrinsics::Function*>& inInlinedFunctionImports,
+	llvm::Module* inLLVMModule)
 : module(inModule)
-, moduleInstance(inModuleInstance)
+, inlinedFunctionImports(inInlinedFunctionImports)
 , llvmModule(inLLVMModule)
+, defaultMemoryId(nullptr)
+, defaultTableId(nullptr)
 , diBuilder(*inLLVMModule)
 {
 	diModuleScope = diBuilder.createFile("unknown", "unknown");
@@ -55,14 +68,173 @@ EmitModuleContext::EmitModuleContext(const Module& inModule,
 									 "__cxa_begin_catch",
 									 llvmModule);
 	}
+
+	// Reference the default memory and table IDs through symbols, so the compiled code may be
+	// loaded for instances that use different memories and tables.
+	if(module.memories.size()) { defaultMemoryId = getInstanceValue("defaultMemoryId"); }
+	if(module.tables.size()) { defaultTableId = getInstanceValue("defaultTableId"); }
+}
+
+static llvm::GlobalVariable* getInstanceSymbol(llvm::Module* llvmModule,
+											   const std::string& symbolName)
+{
+	llvm::GlobalVariable* symbol = llvmModule->getNamedGlobal(symbolName);
+	if(!symbol)
+	{
+		symbol = new llvm::GlobalVariable(*llvmModule,
+										  llvmI8Type,
+										  true,
+										  llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+										  nullptr,
+										  symbolName);
+	}
+	return symbol;
+}
+
+llvm::Constant* EmitModuleContext::getInstancePointer(const std::string& symbolName,
+													  llvm::Type* type)
+{
+	return llvm::ConstantExpr::getPointerCast(
+		llvm::ConstantExpr::getGetElementPtr(
+			llvmI8Type, getInstanceSymbol(llvmModule, symbolName), emitLiteral(I64(-1))),
+		type);
+}
+
+llvm::Constant* EmitModuleContext::getInstanceValue(const std::string& symbolName)
+{
+	return llvm::ConstantExpr::getSub(
+		llvm::ConstantExpr::getPtrToInt(getInstanceSymbol(llvmModule, symbolName), llvmI64Type),
+		emitLiteral(U64(1)));
+}
+
+llvm::Constant* EmitModuleContext::getIntrinsicBitcodeFunction(
+	const Intrinsics::Function* intrinsicFunction)
+{
+	wavmAssert(intrinsicFunction->getBitcode());
+	llvm::Type* functionPointerType
+		= asLLVMType(intrinsicFunction->getType(), intrinsicFunction->getCallingConvention())
+			  ->getPointerTo();
+
+	// Each intrinsic function's bitcode is only linked into the module once.
+	auto bitcodeFunctionIt = intrinsicBitcodeFunctions.find(intrinsicFunction);
+	if(bitcodeFunctionIt != intrinsicBitcodeFunctions.end())
+	{ return llvm::ConstantExpr::getPointerCast(bitcodeFunctionIt->second, functionPointerType); }
+
+	// Parse the bitcode or assembly text. The assembly parser expects the null terminator to follow
+	// the buffer instead of being part of it.
+	const char* name     = intrinsicFunction->getName();
+	const U8* bitcode    = intrinsicFunction->getBitcode();
+	Uptr numBitcodeBytes = intrinsicFunction->getNumBitcodeBytes();
+	if(!llvm::isBitcode(bitcode, bitcode + numBitcodeBytes) && numBitcodeBytes
+	   && bitcode[numBitcodeBytes - 1] == 0)
+	{ --numBitcodeBytes; }
+	llvm::SMDiagnostic parseError;
+	std::unique_ptr<llvm::Module> bitcodeModule = llvm::parseIR(
+		llvm::MemoryBufferRef(llvm::StringRef((const char*)bitcode, numBitcodeBytes), name),
+		parseError,
+		*llvmContext);
+	if(!bitcodeModule)
+	{
+		Errors::fatalf("Failed to parse the bitcode for intrinsic function %s: %s",
+					   name,
+					   parseError.getMessage().str().c_str());
+	}
+
+	llvm::Function* bitcodeFunction = bitcodeModule->getFunction(name);
+	if(!bitcodeFunction || bitcodeFunction->isDeclaration())
+	{ Errors::fatalf("The bitcode for intrinsic function %s doesn't define it", name); }
+
+	// Give everything but the intrinsic function internal linkage, so the helpers defined by
+	// the bitcode of different intrinsics don't conflict.
+	for(llvm::GlobalValue& globalValue : bitcodeModule->global_values())
+	{
+		if(&globalValue != bitcodeFunction && !globalValue.isDeclaration())
+		{ globalValue.setLinkage(llvm::GlobalValue::InternalLinkage); }
+	}
+	bitcodeModule->setTargetTriple(llvmModule->getTargetTriple());
+	bitcodeModule->setDataLayout(llvmModule->getDataLayout());
+
+	// Link the bitcode into the module.
+	if(llvm::Linker::linkModules(*llvmModule, std::move(bitcodeModule)))
+	{ Errors::fatalf("Failed to link the bitcode for intrinsic function %s", name); }
+
+	// Make the linked function internal, and ask LLVM to always inline it.
+	llvm::Function* linkedFunction = llvmModule->getFunction(name);
+	wavmAssert(linkedFunction);
+	linkedFunction->setLinkage(llvm::GlobalValue::InternalLinkage);
+	linkedFunction->removeFnAttr(llvm::Attribute::NoInline);
+	linkedFunction->removeFnAttr(llvm::Attribute::OptimizeNone);
+	linkedFunction->addFnAttr(llvm::Attribute::AlwaysInline);
+
+	intrinsicBitcodeFunctions.emplace(intrinsicFunction, linkedFunction);
+	return llvm::ConstantExpr::getPointerCast(linkedFunction, functionPointerType);
+}
+
+// Emits the body of a function definition that is executed by the interpreter: it passes the
+// function's arguments to the interpreter in an array of 64-bit slots, and returns the results the
+// interpreter writes to the same array.
+static void emitInterpreterStub(EmitModuleContext& moduleContext,
+								FunctionType functionType,
+								Uptr functionDefIndex,
+								llvm::Function* llvmFunction)
+{
+	EmitContext emitContext(nullptr, nullptr);
+	emitContext.irBuilder.SetInsertPoint(
+		llvm::BasicBlock::Create(*llvmContext, "entry", llvmFunction));
+
+	// The first argument is the context pointer, followed by the function's parameters.
+	auto llvmArgIt                     = llvmFunction->arg_begin();
+	emitContext.contextPointerVariable = emitContext.irBuilder.CreateAlloca(llvmI8PtrType);
+	emitContext.irBuilder.CreateStore(&*llvmArgIt++, emitContext.contextPointerVariable);
+
+	const TypeTuple params  = functionType.params();
+	const TypeTuple results = functionType.results();
+	const Uptr numSlots     = std::max(std::max(params.size(), results.size()), Uptr(1));
+	llvm::Value* slots
+		= emitContext.irBuilder.CreateAlloca(llvmI64Type, emitLiteral(U32(numSlots)));
+	for(Uptr paramIndex = 0; paramIndex < params.size(); ++paramIndex)
+	{
+		emitContext.irBuilder.CreateStore(
+			&*llvmArgIt++,
+			emitContext.irBuilder.CreatePointerCast(
+				emitContext.irBuilder.CreateInBoundsGEP(slots, {emitLiteral(U32(paramIndex))}),
+				asLLVMType(params[paramIndex])->getPointerTo()));
+	}
+
+	// Call the interpreter. It may switch the context, so it uses the intrinsicWithContextSwitch
+	// calling convention.
+	const Intrinsics::Function* interpretFunction = Intrinsics::getUninstantiatedFunction(
+		INTRINSIC_MODULE_REF(wavmIntrinsics), "interpretFunction");
+	wavmAssert(interpretFunction);
+	emitContext.emitCallOrInvoke(
+		emitLiteralPointer(interpretFunction->getNativeFunction(),
+						   asLLVMType(interpretFunction->getType(),
+									  interpretFunction->getCallingConvention())
+							   ->getPointerTo()),
+		{moduleContext.getInstanceValue("moduleInstance"),
+		 emitLiteral(U32(functionDefIndex)),
+		 emitContext.irBuilder.CreatePtrToInt(slots, llvmI64Type)},
+		interpretFunction->getType(),
+		interpretFunction->getCallingConvention());
+
+	ValueVector resultValues;
+	for(Uptr resultIndex = 0; resultIndex < results.size(); ++resultIndex)
+	{
+		resultValues.push_back(emitContext.loadFromUntypedPointer(
+			emitContext.irBuilder.CreateInBoundsGEP(slots, {emitLiteral(U32(resultIndex))}),
+			asLLVMType(results[resultIndex])));
+	}
+	emitContext.emitReturn(results, resultValues);
 }
 
 void LLVMJIT::emitModule(const Module& module,
-						 ModuleInstance* moduleInstance,
+						 const std::vector<std::string>& functionDefNames,
+						 const std::vector<const Intrinsics::Function*>& inlinedFunctionImports,
+						 const std::vector<bool>& interpretedFunctionDefs,
 						 llvm::Module& outLLVMModule)
 {
 	Timing::Timer emitTimer;
-	EmitModuleContext moduleContext(module, moduleInstance, &outLLVMModule);
+	EmitModuleContext moduleContext(module, inlinedFunctionImports, &outLLVMModule);
 
 	// Create an external reference to the appropriate exception personality function.
 	auto personalityFunction
@@ -83,22 +255,39 @@ void LLVMJIT::emitModule(const Module& module,
 		FunctionType functionType
 			= module.types[module.functions.defs[functionDefIndex].type.index];
 		auto llvmFunctionType = asLLVMType(functionType, CallingConvention::wasm);
-		auto externalName     = getExternalFunctionName(moduleInstance, functionDefIndex);
-		auto llvmFunction     = llvm::Function::Create(
+		auto externalName
+			= getExternalFunctionName(functionDefIndex, functionDefNames[functionDefIndex]);
+		auto llvmFunction = llvm::Function::Create(
             llvmFunctionType, llvm::Function::ExternalLinkage, externalName, &outLLVMModule);
 		llvmFunction->setPersonalityFn(personalityFunction);
 		llvmFunction->setCallingConv(asLLVMCallingConv(CallingConvention::wasm));
+
+		// Keep the frame pointer, so the sampling profiler can walk the stack through
+		// WebAssembly functions.
+		llvmFunction->addFnAttr("no-frame-pointer-elim", "true");
+
 		moduleContext.functionDefs[functionDefIndex] = llvmFunction;
 	}
 
-	// Compile each function in the module.
+	// Compile each function in the module, or a stub that calls the interpreter for the functions
+	// that are interpreted.
 	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
 		++functionDefIndex)
 	{
+		if(interpretedFunctionDefs[functionDefIndex])
+		{
+			emitInterpreterStub(moduleContext,
+								module.types[module.functions.defs[functionDefIndex].type.index],
+								functionDefIndex,
+								moduleContext.functionDefs[functionDefIndex]);
+			continue;
+		}
+
 		EmitFunctionContext(moduleContext,
 							module,
 							module.functions.defs[functionDefIndex],
-							moduleInstance->functionDefs[functionDefIndex],
+							functionDefIndex,
+							functionDefNames[functionDefIndex],
 							moduleContext.functionDefs[functionDefIndex])
 			.emit();
 	}
@@ -8,16 +8,21 @@
 
 #include "LLVMPostInclude.h"
 
+#include <map>
+
 namespace LLVMJIT
 {
 	struct EmitModuleContext
 	{
 		const IR::Module& module;
-		Runtime::ModuleInstance* moduleInstance;
+		const std::vector<const Intrinsics::Function*>& inlinedFunctionImports;
 
 		llvm::Module* llvmModule;
 		std::vector<llvm::Function*> functionDefs;
 
+		llvm::Value* defaultMemoryId;
+		llvm::Value* defaultTableId;
+
 		llvm::DIBuilder diBuilder;
 		llvm::DICompileUnit* diCompileUnit;
 		llvm::DIFile* diModuleScope;
@@ -33,10 +38,23 @@ namespace LLVMJIT
 		llvm::Function* tryPrologueDummyFunction;
 		llvm::Function* cxaBeginCatchFunction;
 
+		// The intrinsic functions whose bitcode has been linked into the module.
+		std::map<const Intrinsics::Function*, llvm::Function*> intrinsicBitcodeFunctions;
+
 		EmitModuleContext(const Module& inModule,
-						  ModuleInstance* inModuleInstance,
+						  const std::vector<const Intrinsics::Function*>& inInlinedFunctionImports,
 						  llvm::Module* inLLVMModule);
 
+		// Return a pointer or I64 value that is bound to a module instance when the compiled module
+		// is loaded. The symbols are resolved to the value plus one, since the object loader treats
+		// a symbol that resolves to zero as undefined.
+		llvm::Constant* getInstancePointer(const std::string& symbolName, llvm::Type* type);
+		llvm::Constant* getInstanceValue(const std::string& symbolName);
+
+		// Links the bitcode body of an intrinsic function into the module, and returns a pointer to
+		// the linked function with the LLVM type of the intrinsic's native function.
+		llvm::Constant* getIntrinsicBitcodeFunction(const Intrinsics::Function* intrinsicFunction);
+
 		inline llvm::Function* getLLVMIntrinsic(llvm::ArrayRef<llvm::Type*> typeArguments,
 												llvm::Intrinsic::ID id)
 		{
@@ -37,52 +37,78 @@ void EmitFunctionContext::tee_local(GetOrSetVariableImm<false> imm)
 
 void EmitFunctionContext::get_global(GetOrSetVariableImm<true> imm)
 {
-	wavmAssert(imm.variableIndex < moduleContext.moduleInstance->globals.size());
-	GlobalInstance* global    = moduleContext.moduleInstance->globals[imm.variableIndex];
-	llvm::Type* llvmValueType = asLLVMType(global->type.valueType);
+	wavmAssert(imm.variableIndex < module.globals.size());
+	const GlobalType globalType = module.globals.getType(imm.variableIndex);
+	llvm::Type* llvmValueType   = asLLVMType(globalType.valueType);
 
-	if(global->type.isMutable)
+	if(globalType.isMutable)
 	{
+		llvm::Value* globalOffset
+			= moduleContext.getInstanceValue("globalOffset" + std::to_string(imm.variableIndex));
 		llvm::Value* globalPointer = irBuilder.CreatePointerCast(
-			irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable),
-										{emitLiteral(Uptr(offsetof(ContextRuntimeData, globalData))
-													 + global->mutableDataOffset)}),
+			irBuilder.CreateInBoundsGEP(
+				irBuilder.CreateLoad(contextPointerVariable),
+				{irBuilder.CreateAdd(emitLiteral(U64(offsetof(ContextRuntimeData, globalData))),
+									 globalOffset)}),
 			llvmValueType->getPointerTo());
 		push(irBuilder.CreateLoad(globalPointer));
 	}
 	else
 	{
-		if(getTypeByteWidth(global->type.valueType) > sizeof(void*))
+		// If the global is defined in this module with a constant initializer, its value is the
+		// same for every instance, so it can be emitted as a literal.
+		const GlobalDef* globalDef = nullptr;
+		if(imm.variableIndex >= module.globals.imports.size())
+		{ globalDef = &module.globals.defs[imm.variableIndex - module.globals.imports.size()]; }
+
+		llvm::Constant* immutableValue = nullptr;
+		if(globalDef)
 		{
-			llvm::Value* globalPointer
-				= emitLiteralPointer(&global->initialValue, llvmValueType->getPointerTo());
-			push(irBuilder.CreateLoad(globalPointer));
+			const InitializerExpression& initializer = globalDef->initializer;
+			switch(initializer.type)
+			{
+			case InitializerExpression::Type::i32_const:
+				immutableValue = emitLiteral(initializer.i32);
+				break;
+			case InitializerExpression::Type::i64_const:
+				immutableValue = emitLiteral(initializer.i64);
+				break;
+			case InitializerExpression::Type::f32_const:
+				immutableValue = emitLiteral(initializer.f32);
+				break;
+			case InitializerExpression::Type::f64_const:
+				immutableValue = emitLiteral(initializer.f64);
+				break;
+			case InitializerExpression::Type::v128_const:
+				immutableValue = emitLiteral(initializer.v128);
+				break;
+			default: break;
+			};
 		}
+
+		if(immutableValue) { push(immutableValue); }
 		else
 		{
-			llvm::Constant* immutableValue;
-			switch(global->type.valueType)
-			{
-			case ValueType::i32: immutableValue = emitLiteral(global->initialValue.i32); break;
-			case ValueType::i64: immutableValue = emitLiteral(global->initialValue.i64); break;
-			case ValueType::f32: immutableValue = emitLiteral(global->initialValue.f32); break;
-			case ValueType::f64: immutableValue = emitLiteral(global->initialValue.f64); break;
-			default: Errors::unreachable();
-			};
-			push(immutableValue);
+			// Otherwise, load the value from the instance's GlobalInstance.
+			llvm::Value* globalPointer = moduleContext.getInstancePointer(
+				"globalValue" + std::to_string(imm.variableIndex), llvmValueType->getPointerTo());
+			push(irBuilder.CreateLoad(globalPointer));
 		}
 	}
 }
 void EmitFunctionContext::set_global(GetOrSetVariableImm<true> imm)
 {
-	wavmAssert(imm.variableIndex < moduleContext.moduleInstance->globals.size());
-	GlobalInstance* global = moduleContext.moduleInstance->globals[imm.variableIndex];
-	wavmAssert(global->type.isMutable);
-	llvm::Type* llvmValueType  = asLLVMType(global->type.valueType);
+	wavmAssert(imm.variableIndex < module.globals.size());
+	const GlobalType globalType = module.globals.getType(imm.variableIndex);
+	wavmAssert(globalType.isMutable);
+	llvm::Type* llvmValueType = asLLVMType(globalType.valueType);
+	llvm::Value* globalOffset
+		= moduleContext.getInstanceValue("globalOffset" + std::to_string(imm.variableIndex));
 	llvm::Value* globalPointer = irBuilder.CreatePointerCast(
-		irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable),
-									{emitLiteral(Uptr(offsetof(ContextRuntimeData, globalData)
-													  + global->mutableDataOffset))}),
+		irBuilder.CreateInBoundsGEP(
+			irBuilder.CreateLoad(contextPointerVariable),
+			{irBuilder.CreateAdd(emitLiteral(U64(offsetof(ContextRuntimeData, globalData))),
+								 globalOffset)}),
 		llvmValueType->getPointerTo());
 	auto value = irBuilder.CreateBitCast(pop(), llvmValueType);
 	irBuilder.CreateStore(value, globalPointer);
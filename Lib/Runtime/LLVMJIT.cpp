@@ -14,7 +14,6 @@
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
-#include "llvm/ExecutionEngine/ObjectMemoryBuffer.h"
 #include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DebugLoc.h"
@@ -27,10 +26,13 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/Memory.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Scalar.h"
 
 #include "LLVMPostInclude.h"
 
+#include <tuple>
+
 // This needs to be 1 to allow debuggers such as Visual Studio to place breakpoints and step through
 // the JITed code.
 #define USE_WRITEABLE_JIT_CODE_PAGES WAVM_DEBUG
@@ -80,11 +82,40 @@ static llvm::JITEventListener* gdbRegistrationListener = nullptr;
 static Platform::Mutex addressToSymbolMapMutex;
 static std::map<Uptr, struct JITSymbol*> addressToSymbolMap;
 
-// A map from function types to JIT symbols for cached invoke thunks (C++ -> WASM)
-static HashMap<FunctionType, struct JITSymbol*> invokeThunkTypeToSymbolMap;
+// The key of a cached invoke thunk: the code of a thunk depends on both the type and the calling
+// convention of the functions it calls.
+struct InvokeThunkKey
+{
+	FunctionType functionType;
+	CallingConvention callingConvention;
 
-// A map from function types to JIT symbols for cached native thunks (WASM -> C++)
-static HashMap<void*, struct JITSymbol*> intrinsicFunctionToThunkSymbolMap;
+	friend bool operator==(const InvokeThunkKey& left, const InvokeThunkKey& right)
+	{
+		return left.functionType == right.functionType
+			   && left.callingConvention == right.callingConvention;
+	}
+};
+
+template<> struct Hash<InvokeThunkKey>
+{
+	Uptr operator()(const InvokeThunkKey& key, Uptr seed = 0) const
+	{
+		return Hash<FunctionType>()(key.functionType,
+									Hash<Uptr>()(Uptr(key.callingConvention), seed));
+	}
+};
+
+// A map from function types and calling conventions to JIT symbols for cached invoke thunks
+// (C++ -> WASM)
+static HashMap<InvokeThunkKey, struct JITSymbol*> invokeThunkKeyToSymbolMap;
+
+// A map from function types and calling conventions to JIT symbols for cached invoke batch thunks
+// (C++ -> WASM)
+static HashMap<InvokeThunkKey, struct JITSymbol*> invokeBatchThunkKeyToSymbolMap;
+
+// A map from native functions and the default memory/table IDs passed to them to JIT symbols for
+// cached native thunks (WASM -> C++)
+static std::map<std::tuple<void*, I64, I64>, struct JITSymbol*> intrinsicFunctionToThunkSymbolMap;
 
 static void initLLVM();
 
@@ -93,29 +124,35 @@ struct JITSymbol
 {
 	enum class Type
 	{
-		functionInstance,
+		functionDef,
 		invokeThunk
 	};
 	Type type;
 	union
 	{
-		FunctionInstance* functionInstance;
+		struct
+		{
+			ModuleInstance* moduleInstance;
+			Uptr functionDefIndex;
+		} functionDef;
 		FunctionType invokeThunkType;
 	};
 	Uptr baseAddress;
 	Uptr numBytes;
 	std::map<U32, U32> offsetToOpIndexMap;
 
-	JITSymbol(FunctionInstance* inFunctionInstance,
+	JITSymbol(ModuleInstance* inModuleInstance,
+			  Uptr inFunctionDefIndex,
 			  Uptr inBaseAddress,
 			  Uptr inNumBytes,
 			  std::map<U32, U32>&& inOffsetToOpIndexMap)
-	: type(Type::functionInstance)
-	, functionInstance(inFunctionInstance)
+	: type(Type::functionDef)
 	, baseAddress(inBaseAddress)
 	, numBytes(inNumBytes)
 	, offsetToOpIndexMap(inOffsetToOpIndexMap)
 	{
+		functionDef.moduleInstance   = inModuleInstance;
+		functionDef.functionDefIndex = inFunctionDefIndex;
 	}
 
 	JITSymbol(FunctionType inInvokeThunkType,
@@ -263,6 +300,12 @@ struct UnitMemoryManager : llvm::RTDyldMemoryManager
 	}
 
 	U8* getImageBaseAddress() const { return imageBaseAddress; }
+	Uptr getNumCodeBytes() const { return codeSection.numPages << Platform::getPageSizeLog2(); }
+	Uptr getNumDataBytes() const
+	{
+		return (readOnlySection.numPages + readWriteSection.numPages)
+			   << Platform::getPageSizeLog2();
+	}
 
 private:
 	struct Section
@@ -326,6 +369,7 @@ struct JITUnit
 	~JITUnit() {}
 
 	void compileAndLoad(llvm::Module&& llvmModule);
+	void load(const U8* objectBytes, Uptr numObjectBytes);
 
 	virtual void notifySymbolLoaded(const char* name,
 									Uptr baseAddress,
@@ -333,15 +377,40 @@ struct JITUnit
 									std::map<U32, U32>&& offsetToOpIndexMap)
 		= 0;
 
+	// Returns the number of bytes allocated for the loaded object's code and data sections.
+	Uptr getNumCodeBytes() const { return memoryManager.getNumCodeBytes(); }
+	Uptr getNumDataBytes() const { return memoryManager.getNumDataBytes(); }
+
+	// Resolves a symbol that is referenced, but not defined, by the loaded object.
+	virtual llvm::JITEvaluatedSymbol resolveSymbol(const std::string& name)
+	{
+		return resolveJITImport(name);
+	}
+
 private:
 	UnitMemoryManager memoryManager;
 	bool shouldLogMetrics;
+};
 
-	typedef llvm::SmallVector<char, 0> ObjectBytes;
+typedef llvm::SmallVector<char, 0> ObjectBytes;
 
-	ObjectBytes compile(llvm::Module&& llvmModule);
-	void load(ObjectBytes&& objectBytes);
-};
+static ObjectBytes compileLLVMModule(llvm::Module&& llvmModule,
+									 bool shouldLogMetrics,
+									 bool inlineFunctions = false);
+
+// Parses a symbol name of the form <prefix><index>.
+static bool parseIndexedSymbolName(const std::string& name, const char* prefix, Uptr& outIndex)
+{
+	const Uptr numPrefixChars = strlen(prefix);
+	if(name.size() <= numPrefixChars || strncmp(name.c_str(), prefix, numPrefixChars))
+	{ return false; }
+
+	char* numberEnd = nullptr;
+	U64 index       = std::strtoull(name.c_str() + numPrefixChars, &numberEnd, 10);
+	if(*numberEnd != 0 || index > UINTPTR_MAX) { return false; }
+	outIndex = Uptr(index);
+	return true;
+}
 
 // The JIT compilation unit for a WebAssembly module instance.
 struct JITModule : JITUnit, JITModuleBase
@@ -363,6 +432,9 @@ struct JITModule : JITUnit, JITModuleBase
 		}
 	}
 
+	Uptr getNumCodeBytes() const override { return JITUnit::getNumCodeBytes(); }
+	Uptr getNumDataBytes() const override { return JITUnit::getNumDataBytes(); }
+
 	void notifySymbolLoaded(const char* name,
 							Uptr baseAddress,
 							Uptr numBytes,
@@ -373,12 +445,29 @@ struct JITModule : JITUnit, JITModuleBase
 		if(getFunctionIndexFromExternalName(name, functionDefIndex))
 		{
 			wavmAssert(moduleInstance);
-			wavmAssert(functionDefIndex < moduleInstance->functionDefs.size());
-			FunctionInstance* functionInstance = moduleInstance->functionDefs[functionDefIndex];
-			auto symbol                        = new JITSymbol(
-                functionInstance, baseAddress, numBytes, std::move(offsetToOpIndexMap));
+			wavmAssert(functionDefIndex < moduleInstance->functionDefCode.size());
+			auto symbol = new JITSymbol(moduleInstance,
+										functionDefIndex,
+										baseAddress,
+										numBytes,
+										std::move(offsetToOpIndexMap));
 			functionDefSymbols.push_back(symbol);
-			functionInstance->nativeFunction = reinterpret_cast<void*>(baseAddress);
+
+			// Record the function's code for when its FunctionInstance is created. If the
+			// FunctionInstance was already created to resolve a reference from the object code,
+			// update its code pointer.
+			{
+				Lock<Platform::Mutex> functionsLock(moduleInstance->functionsMutex);
+				moduleInstance->functionDefCode[functionDefIndex]
+					= reinterpret_cast<void*>(baseAddress);
+
+				const Uptr numFunctionImports
+					= moduleInstance->functions.size() - moduleInstance->functionDefCode.size();
+				FunctionInstance* functionInstance
+					= moduleInstance->functions[numFunctionImports + functionDefIndex];
+				if(functionInstance)
+				{ functionInstance->nativeFunction = reinterpret_cast<void*>(baseAddress); }
+			}
 
 			{
 				Lock<Platform::Mutex> addressToSymbolMapLock(addressToSymbolMapMutex);
@@ -386,6 +475,66 @@ struct JITModule : JITUnit, JITModuleBase
 			}
 		}
 	}
+
+	llvm::JITEvaluatedSymbol resolveSymbol(const std::string& name) override
+	{
+#if(defined(_WIN32) && !defined(_WIN64))
+		const std::string symbolName = name.size() && name[0] == '_' ? name.substr(1) : name;
+#else
+		const std::string& symbolName = name;
+#endif
+
+		// Bind the symbols emitted by EmitModuleContext::getInstancePointer/getInstanceValue to
+		// this module instance. The symbols are resolved to the value plus one.
+		Uptr value;
+		Uptr index;
+		if(symbolName == "moduleInstance") { value = reinterpret_cast<Uptr>(moduleInstance); }
+		else if(symbolName == "defaultMemoryId")
+		{
+			wavmAssert(moduleInstance->defaultMemory);
+			value = moduleInstance->defaultMemory->id;
+		}
+		else if(symbolName == "defaultTableId")
+		{
+			wavmAssert(moduleInstance->defaultTable);
+			value = moduleInstance->defaultTable->id;
+		}
+		else if(parseIndexedSymbolName(symbolName, "functionImport", index))
+		{
+			wavmAssert(index < moduleInstance->functionImportCode.size());
+			value = reinterpret_cast<Uptr>(moduleInstance->functionImportCode[index]);
+		}
+		else if(parseIndexedSymbolName(symbolName, "functionDefInstance", index))
+		{
+			wavmAssert(index < moduleInstance->functionDefCode.size());
+			const Uptr numFunctionImports
+				= moduleInstance->functions.size() - moduleInstance->functionDefCode.size();
+			value = reinterpret_cast<Uptr>(
+				getFunctionInstance(moduleInstance, numFunctionImports + index));
+		}
+		else if(parseIndexedSymbolName(symbolName, "globalOffset", index))
+		{
+			wavmAssert(index < moduleInstance->globals.size());
+			wavmAssert(moduleInstance->globals[index]->type.isMutable);
+			value = moduleInstance->globals[index]->mutableDataOffset;
+		}
+		else if(parseIndexedSymbolName(symbolName, "globalValue", index))
+		{
+			wavmAssert(index < moduleInstance->globals.size());
+			value = reinterpret_cast<Uptr>(&moduleInstance->globals[index]->initialValue);
+		}
+		else if(parseIndexedSymbolName(symbolName, "exceptionType", index))
+		{
+			wavmAssert(index < moduleInstance->exceptionTypeInstances.size());
+			value = reinterpret_cast<Uptr>(moduleInstance->exceptionTypeInstances[index]);
+		}
+		else
+		{
+			return resolveJITImport(name);
+		}
+
+		return llvm::JITEvaluatedSymbol(value + 1, llvm::JITSymbolFlags::None);
+	}
 };
 
 // The JIT compilation unit for a single invoke thunk.
@@ -509,9 +658,15 @@ static void printModule(const llvm::Module& llvmModule, const char* filename)
 	Log::printf(Log::debug, "Dumped LLVM module to: %s\n", augmentedFilename.c_str());
 }
 
-void JITUnit::compileAndLoad(llvm::Module&& llvmModule) { load(compile(std::move(llvmModule))); }
+void JITUnit::compileAndLoad(llvm::Module&& llvmModule)
+{
+	ObjectBytes objectBytes = compileLLVMModule(std::move(llvmModule), shouldLogMetrics);
+	load(reinterpret_cast<const U8*>(objectBytes.data()), objectBytes.size());
+}
 
-JITUnit::ObjectBytes JITUnit::compile(llvm::Module&& llvmModule)
+static ObjectBytes compileLLVMModule(llvm::Module&& llvmModule,
+									 bool shouldLogMetrics,
+									 bool inlineFunctions)
 {
 	// Get a target machine object for this host, and set the module to use its data layout.
 	llvmModule.setDataLayout(targetMachine->createDataLayout());
@@ -544,6 +699,33 @@ JITUnit::ObjectBytes JITUnit::compile(llvm::Module&& llvmModule)
 	{ fpm->run(*functionIt); }
 	delete fpm;
 
+	// Inline the intrinsic functions that were linked into the module from bitcode, and if
+	// inlineFunctions is true, any other calls that LLVM's inliner thinks are worth inlining. This
+	// is done after the function passes, since instcombine turns the calls through a pointer cast
+	// to the intrinsic function into direct calls that the inliner can see.
+	bool hasAlwaysInlineFunctions = false;
+	for(const llvm::Function& function : llvmModule)
+	{
+		if(function.hasFnAttribute(llvm::Attribute::AlwaysInline))
+		{
+			hasAlwaysInlineFunctions = true;
+			break;
+		}
+	}
+	if(inlineFunctions || hasAlwaysInlineFunctions)
+	{
+		// The general inliner also inlines the functions that are marked always-inline.
+		llvm::legacy::PassManager inlinePassManager;
+		if(inlineFunctions) { inlinePassManager.add(llvm::createFunctionInliningPass()); }
+		else
+		{
+			inlinePassManager.add(llvm::createAlwaysInlinerLegacyPass());
+		}
+		inlinePassManager.add(llvm::createInstructionCombiningPass());
+		inlinePassManager.add(llvm::createCFGSimplificationPass());
+		inlinePassManager.run(llvmModule);
+	}
+
 	if(shouldLogMetrics)
 	{
 		Timing::logRatePerSecond(
@@ -584,28 +766,32 @@ JITUnit::ObjectBytes JITUnit::compile(llvm::Module&& llvmModule)
 	return objectBytes;
 }
 
-void JITUnit::load(ObjectBytes&& objectBytes)
+void JITUnit::load(const U8* objectBytes, Uptr numObjectBytes)
 {
 	Timing::Timer loadObjectTimer;
 
-	llvm::ObjectMemoryBuffer objectBuffer(std::move(objectBytes));
+	llvm::MemoryBufferRef objectBuffer(
+		llvm::StringRef(reinterpret_cast<const char*>(objectBytes), numObjectBytes), "");
 
-	auto object
-		= cantFail(llvm::object::ObjectFile::createObjectFile(objectBuffer.getMemBufferRef()));
+	auto object = cantFail(llvm::object::ObjectFile::createObjectFile(objectBuffer));
 
 	// Create the LLVM object loader.
 	struct SymbolResolver : llvm::JITSymbolResolver
 	{
+		JITUnit& unit;
+
+		SymbolResolver(JITUnit& inUnit) : unit(inUnit) {}
+
 		virtual llvm::JITSymbol findSymbolInLogicalDylib(const std::string& name) override
 		{
-			return resolveJITImport(name);
+			return unit.resolveSymbol(name);
 		}
 		virtual llvm::JITSymbol findSymbol(const std::string& name) override
 		{
-			return resolveJITImport(name);
+			return unit.resolveSymbol(name);
 		}
 	};
-	SymbolResolver symbolResolver;
+	SymbolResolver symbolResolver(*this);
 	llvm::RuntimeDyld loader(memoryManager, symbolResolver);
 
 	// Process all sections on non-Windows platforms. On Windows, this triggers errors due to
@@ -758,14 +944,17 @@ void JITUnit::load(ObjectBytes&& objectBytes)
 
 	if(shouldLogMetrics)
 	{
-		Timing::logRatePerSecond("Loaded object",
-								 loadObjectTimer,
-								 (F64)objectBuffer.getBufferSize() / 1024.0 / 1024.0,
-								 "MB");
+		Timing::logRatePerSecond(
+			"Loaded object", loadObjectTimer, (F64)numObjectBytes / 1024.0 / 1024.0, "MB");
 	}
 }
 
-void LLVMJIT::instantiateModule(const IR::Module& module, ModuleInstance* moduleInstance)
+std::vector<U8> LLVMJIT::compileModule(
+	const IR::Module& module,
+	const std::vector<std::string>& functionDefNames,
+	const std::vector<const Intrinsics::Function*>& inlinedFunctionImports,
+	const std::vector<bool>& interpretedFunctionDefs,
+	bool inlineFunctionDefs)
 {
 	Lock<Platform::Mutex> llvmLock(llvmMutex);
 
@@ -773,21 +962,53 @@ void LLVMJIT::instantiateModule(const IR::Module& module, ModuleInstance* module
 
 	// Emit LLVM IR for the module.
 	llvm::Module llvmModule("", *llvmContext);
-	emitModule(module, moduleInstance, llvmModule);
+	emitModule(
+		module, functionDefNames, inlinedFunctionImports, interpretedFunctionDefs, llvmModule);
+
+	// Compile the module to an object file.
+	ObjectBytes objectBytes = compileLLVMModule(std::move(llvmModule), true, inlineFunctionDefs);
+	return std::vector<U8>(objectBytes.begin(), objectBytes.end());
+}
 
+void LLVMJIT::loadModule(const std::vector<U8>& objectCode, ModuleInstance* moduleInstance)
+{
 	// Construct the JIT compilation pipeline for this module.
 	auto jitModule            = new JITModule(moduleInstance);
 	moduleInstance->jitModule = jitModule;
 
-	// Compile the module.
-	jitModule->compileAndLoad(std::move(llvmModule));
+	// The compiled code and the interpreter call imported functions with the WASM calling
+	// convention, so imports that use another calling convention are called through a thunk. This
+	// must be done before locking llvmMutex, since getIntrinsicThunk also locks it.
+	const Uptr numFunctionImports
+		= moduleInstance->functions.size() - moduleInstance->functionDefCode.size();
+	moduleInstance->functionImportCode.reserve(numFunctionImports);
+	for(Uptr importIndex = 0; importIndex < numFunctionImports; ++importIndex)
+	{
+		FunctionInstance* functionImport = moduleInstance->functions[importIndex];
+		void* code                       = functionImport->nativeFunction;
+		if(functionImport->callingConvention != CallingConvention::wasm)
+		{
+			code = getIntrinsicThunk(
+				code,
+				functionImport->type,
+				functionImport->callingConvention,
+				moduleInstance->defaultMemory ? I64(moduleInstance->defaultMemory->id) : -1,
+				moduleInstance->defaultTable ? I64(moduleInstance->defaultTable->id) : -1);
+		}
+		moduleInstance->functionImportCode.push_back(code);
+	}
+
+	Lock<Platform::Mutex> llvmLock(llvmMutex);
+
+	initLLVM();
+
+	// Load the object, binding its references to instance symbols to this module instance.
+	jitModule->load(objectCode.data(), objectCode.size());
 }
 
-std::string LLVMJIT::getExternalFunctionName(ModuleInstance* moduleInstance, Uptr functionDefIndex)
+std::string LLVMJIT::getExternalFunctionName(Uptr functionDefIndex, const std::string& debugName)
 {
-	wavmAssert(functionDefIndex < moduleInstance->functionDefs.size());
-	return "wasmFunc" + std::to_string(functionDefIndex) + "_"
-		   + moduleInstance->functionDefs[functionDefIndex]->debugName;
+	return "wasmFunc" + std::to_string(functionDefIndex) + "_" + debugName;
 }
 
 bool LLVMJIT::getFunctionIndexFromExternalName(const char* externalName, Uptr& outFunctionDefIndex)
@@ -825,12 +1046,14 @@ bool LLVMJIT::describeInstructionPointer(Uptr ip, std::string& outDescription)
 
 	switch(symbol->type)
 	{
-	case JITSymbol::Type::functionInstance:
+	case JITSymbol::Type::functionDef:
 	{
-		outDescription = "wasm!";
-		outDescription += symbol->functionInstance->moduleInstance->debugName;
+		ModuleInstance* moduleInstance = symbol->functionDef.moduleInstance;
+		const Uptr functionDefIndex    = symbol->functionDef.functionDefIndex;
+		outDescription                 = "wasm!";
+		outDescription += moduleInstance->debugName;
 		outDescription += '!';
-		outDescription += symbol->functionInstance->debugName;
+		outDescription += moduleInstance->compiledModule->functionDefNames[functionDefIndex];
 		outDescription += '+';
 
 		// Find the highest entry in the offsetToOpIndexMap whose offset is <= the symbol-relative
@@ -866,8 +1089,9 @@ InvokeFunctionPointer LLVMJIT::getInvokeThunk(FunctionType functionType,
 
 	initLLVM();
 
-	// Reuse cached invoke thunks for the same function type.
-	JITSymbol*& invokeThunkSymbol = invokeThunkTypeToSymbolMap.getOrAdd(functionType, nullptr);
+	// Reuse cached invoke thunks for the same function type and calling convention.
+	JITSymbol*& invokeThunkSymbol
+		= invokeThunkKeyToSymbolMap.getOrAdd({functionType, callingConvention}, nullptr);
 	if(invokeThunkSymbol)
 	{ return reinterpret_cast<InvokeFunctionPointer>(invokeThunkSymbol->baseAddress); }
 
@@ -953,21 +1177,143 @@ InvokeFunctionPointer LLVMJIT::getInvokeThunk(FunctionType functionType,
 	return reinterpret_cast<InvokeFunctionPointer>(invokeThunkSymbol->baseAddress);
 }
 
+InvokeBatchFunctionPointer LLVMJIT::getInvokeBatchThunk(FunctionType functionType,
+														CallingConvention callingConvention)
+{
+	Lock<Platform::Mutex> llvmLock(llvmMutex);
+
+	initLLVM();
+
+	// Reuse cached invoke batch thunks for the same function type and calling convention.
+	JITSymbol*& invokeBatchThunkSymbol
+		= invokeBatchThunkKeyToSymbolMap.getOrAdd({functionType, callingConvention}, nullptr);
+	if(invokeBatchThunkSymbol)
+	{ return reinterpret_cast<InvokeBatchFunctionPointer>(invokeBatchThunkSymbol->baseAddress); }
+
+	llvm::Module llvmModule("", *llvmContext);
+	auto llvmFunctionType = llvm::FunctionType::get(
+		llvmI8PtrType,
+		{asLLVMType(functionType, callingConvention)->getPointerTo(),
+		 llvmI8PtrType,
+		 llvmI8PtrType,
+		 llvmI8PtrType,
+		 llvmI64Type,
+		 llvmI64Type->getPointerTo()},
+		false);
+	auto llvmFunction = llvm::Function::Create(
+		llvmFunctionType, llvm::Function::ExternalLinkage, "thunk", &llvmModule);
+	llvm::Value* functionPointer            = &*(llvmFunction->args().begin() + 0);
+	llvm::Value* contextPointer             = &*(llvmFunction->args().begin() + 1);
+	llvm::Value* argumentsPointer           = &*(llvmFunction->args().begin() + 2);
+	llvm::Value* resultsPointer             = &*(llvmFunction->args().begin() + 3);
+	llvm::Value* numInvokes                 = &*(llvmFunction->args().begin() + 4);
+	llvm::Value* numCompletedInvokesPointer = &*(llvmFunction->args().begin() + 5);
+
+	EmitContext emitContext(nullptr, nullptr);
+	auto entryBlock = llvm::BasicBlock::Create(*llvmContext, "entry", llvmFunction);
+	auto loopBlock  = llvm::BasicBlock::Create(*llvmContext, "loop", llvmFunction);
+	auto endBlock   = llvm::BasicBlock::Create(*llvmContext, "end", llvmFunction);
+	emitContext.irBuilder.SetInsertPoint(entryBlock);
+
+	emitContext.contextPointerVariable = emitContext.irBuilder.CreateAlloca(llvmI8PtrType);
+	emitContext.irBuilder.CreateStore(contextPointer, emitContext.contextPointerVariable);
+	emitContext.irBuilder.CreateCondBr(
+		emitContext.irBuilder.CreateICmpEQ(numInvokes, emitLiteral(U64(0))), endBlock, loopBlock);
+
+	// Each iteration of the loop invokes the function with the next tuple of arguments.
+	emitContext.irBuilder.SetInsertPoint(loopBlock);
+	llvm::PHINode* invokeIndex = emitContext.irBuilder.CreatePHI(llvmI64Type, 2);
+	invokeIndex->addIncoming(emitLiteral(U64(0)), entryBlock);
+
+	// Write the index of the current invoke to the caller's memory before calling the function,
+	// so the caller knows which invoke threw if it unwinds out of the thunk.
+	emitContext.irBuilder.CreateStore(invokeIndex, numCompletedInvokesPointer, true);
+
+	// Load the function's arguments from an array of UntaggedValues.
+	const Uptr numParams         = functionType.params().size();
+	llvm::Value* invokeArguments = emitContext.irBuilder.CreateInBoundsGEP(
+		argumentsPointer,
+		{emitContext.irBuilder.CreateMul(invokeIndex,
+										 emitLiteral(U64(numParams * sizeof(UntaggedValue))))});
+	std::vector<llvm::Value*> arguments;
+	for(Uptr paramIndex = 0; paramIndex < numParams; ++paramIndex)
+	{
+		arguments.push_back(emitContext.loadFromUntypedPointer(
+			emitContext.irBuilder.CreateInBoundsGEP(
+				invokeArguments, {emitLiteral(U64(paramIndex * sizeof(UntaggedValue)))}),
+			asLLVMType(functionType.params()[paramIndex])));
+	}
+
+	// Call the function.
+	ValueVector results
+		= emitContext.emitCallOrInvoke(functionPointer, arguments, functionType, callingConvention);
+
+	// Write the function's results to an array of UntaggedValues.
+	wavmAssert(results.size() == functionType.results().size());
+	llvm::Value* invokeResults = emitContext.irBuilder.CreateInBoundsGEP(
+		resultsPointer,
+		{emitContext.irBuilder.CreateMul(
+			invokeIndex, emitLiteral(U64(results.size() * sizeof(UntaggedValue))))});
+	for(Uptr resultIndex = 0; resultIndex < results.size(); ++resultIndex)
+	{
+		const ValueType resultType = functionType.results()[resultIndex];
+		emitContext.irBuilder.CreateStore(
+			results[resultIndex],
+			emitContext.irBuilder.CreatePointerCast(
+				emitContext.irBuilder.CreateInBoundsGEP(
+					invokeResults, {emitLiteral(U64(resultIndex * sizeof(UntaggedValue)))}),
+				asLLVMType(resultType)->getPointerTo()));
+	}
+
+	// Loop until all the invokes are done.
+	llvm::Value* nextInvokeIndex
+		= emitContext.irBuilder.CreateAdd(invokeIndex, emitLiteral(U64(1)));
+	invokeIndex->addIncoming(nextInvokeIndex, emitContext.irBuilder.GetInsertBlock());
+	emitContext.irBuilder.CreateCondBr(
+		emitContext.irBuilder.CreateICmpULT(nextInvokeIndex, numInvokes), loopBlock, endBlock);
+
+	emitContext.irBuilder.SetInsertPoint(endBlock);
+	emitContext.irBuilder.CreateStore(numInvokes, numCompletedInvokesPointer, true);
+	emitContext.irBuilder.CreateRet(
+		emitContext.irBuilder.CreateLoad(emitContext.contextPointerVariable));
+
+	// Compile the invoke batch thunk.
+	auto jitUnit = new JITThunkUnit(functionType);
+	jitUnit->compileAndLoad(std::move(llvmModule));
+
+	wavmAssert(jitUnit->symbol);
+	invokeBatchThunkSymbol = jitUnit->symbol;
+
+	{
+		Lock<Platform::Mutex> addressToSymbolMapLock(addressToSymbolMapMutex);
+		addressToSymbolMap[jitUnit->symbol->baseAddress + jitUnit->symbol->numBytes]
+			= jitUnit->symbol;
+	}
+
+	return reinterpret_cast<InvokeBatchFunctionPointer>(invokeBatchThunkSymbol->baseAddress);
+}
+
 void* LLVMJIT::getIntrinsicThunk(void* nativeFunction,
 								 FunctionType functionType,
-								 CallingConvention callingConvention)
+								 CallingConvention callingConvention,
+								 I64 defaultMemoryId,
+								 I64 defaultTableId)
 {
 	wavmAssert(callingConvention == CallingConvention::intrinsic
 			   || callingConvention == CallingConvention::intrinsicWithContextSwitch
 			   || callingConvention == CallingConvention::intrinsicWithMemAndTable);
 
+	// Only intrinsicWithMemAndTable functions are passed the default memory and table IDs.
+	if(callingConvention != CallingConvention::intrinsicWithMemAndTable)
+	{ defaultMemoryId = defaultTableId = -1; }
+
 	Lock<Platform::Mutex> llvmLock(llvmMutex);
 
 	initLLVM();
 
-	// Reuse cached intrinsic thunks for the same function type.
-	JITSymbol*& intrinsicThunkSymbol
-		= intrinsicFunctionToThunkSymbolMap.getOrAdd(nativeFunction, nullptr);
+	// Reuse cached intrinsic thunks for the same function and default memory/table.
+	JITSymbol*& intrinsicThunkSymbol = intrinsicFunctionToThunkSymbolMap[std::make_tuple(
+		nativeFunction, defaultMemoryId, defaultTableId)];
 	if(intrinsicThunkSymbol) { return reinterpret_cast<void*>(intrinsicThunkSymbol->baseAddress); }
 
 	// Create a LLVM module containing a single function with the same signature as the native
@@ -976,9 +1322,9 @@ void* LLVMJIT::getIntrinsicThunk(void* nativeFunction,
 	auto llvmFunctionType = asLLVMType(functionType, CallingConvention::wasm);
 	auto llvmFunction     = llvm::Function::Create(
         llvmFunctionType, llvm::Function::ExternalLinkage, "thunk", &llvmModule);
-	llvmFunction->setCallingConv(asLLVMCallingConv(callingConvention));
+	llvmFunction->setCallingConv(asLLVMCallingConv(CallingConvention::wasm));
 
-	EmitContext emitContext(nullptr, nullptr);
+	EmitContext emitContext(emitLiteral(defaultMemoryId), emitLiteral(defaultTableId));
 	emitContext.irBuilder.SetInsertPoint(
 		llvm::BasicBlock::Create(*llvmContext, "entry", llvmFunction));
 
@@ -243,13 +243,15 @@ namespace LLVMJIT
 		llvm::Value* memoryBasePointerVariable;
 		llvm::Value* tableBasePointerVariable;
 
-		EmitContext(MemoryInstance* inDefaultMemory, TableInstance* inDefaultTable)
+		// The default memory and table are identified by I64 values for their IDs, which may be
+		// null if there is no default memory or table.
+		EmitContext(llvm::Value* inDefaultMemoryId, llvm::Value* inDefaultTableId)
 		: irBuilder(*llvmContext)
 		, contextPointerVariable(nullptr)
 		, memoryBasePointerVariable(nullptr)
 		, tableBasePointerVariable(nullptr)
-		, defaultMemory(inDefaultMemory)
-		, defaultTable(inDefaultTable)
+		, defaultMemoryId(inDefaultMemoryId)
+		, defaultTableId(inDefaultTableId)
 		{
 		}
 
@@ -272,27 +274,28 @@ namespace LLVMJIT
 			// Load the defaultMemoryBase and defaultTableBase values from the runtime data for this
 			// module instance.
 
-			if(defaultMemory)
+			if(defaultMemoryId)
 			{
-				const Uptr defaultMemoryBaseOffset
-					= offsetof(CompartmentRuntimeData, memories) + sizeof(U8*) * defaultMemory->id;
+				llvm::Value* defaultMemoryBaseOffset = irBuilder.CreateAdd(
+					emitLiteral(U64(offsetof(CompartmentRuntimeData, memories))),
+					irBuilder.CreateMul(defaultMemoryId, emitLiteral(U64(sizeof(U8*)))));
 				irBuilder.CreateStore(
 					loadFromUntypedPointer(
-						irBuilder.CreateInBoundsGEP(compartmentAddress,
-													{emitLiteral(defaultMemoryBaseOffset)}),
+						irBuilder.CreateInBoundsGEP(compartmentAddress, {defaultMemoryBaseOffset}),
 						llvmI8PtrType),
 					memoryBasePointerVariable);
 			}
 
-			if(defaultTable)
+			if(defaultTableId)
 			{
-				const Uptr defaultTableBaseOffset
-					= offsetof(CompartmentRuntimeData, tables)
-					  + sizeof(TableInstance::FunctionElement*) * defaultTable->id;
+				llvm::Value* defaultTableBaseOffset = irBuilder.CreateAdd(
+					emitLiteral(U64(offsetof(CompartmentRuntimeData, tables))),
+					irBuilder.CreateMul(
+						defaultTableId,
+						emitLiteral(U64(sizeof(TableInstance::FunctionElement*)))));
 				irBuilder.CreateStore(
 					loadFromUntypedPointer(
-						irBuilder.CreateInBoundsGEP(compartmentAddress,
-													{emitLiteral(defaultTableBaseOffset)}),
+						irBuilder.CreateInBoundsGEP(compartmentAddress, {defaultTableBaseOffset}),
 						llvmI8PtrType),
 					tableBasePointerVariable);
 			}
@@ -315,10 +318,8 @@ namespace LLVMJIT
 					= (llvm::Value**)alloca(sizeof(llvm::Value*) * (args.size() + 3));
 				augmentedArgs = llvm::ArrayRef<llvm::Value*>(augmentedArgsAlloca, args.size() + 3);
 				augmentedArgsAlloca[0] = irBuilder.CreateLoad(contextPointerVariable);
-				augmentedArgsAlloca[1]
-					= defaultMemory ? emitLiteral(I64(defaultMemory->id)) : emitLiteral(I64(-1));
-				augmentedArgsAlloca[2]
-					= defaultTable ? emitLiteral(I64(defaultTable->id)) : emitLiteral(I64(-1));
+				augmentedArgsAlloca[1] = defaultMemoryId ? defaultMemoryId : emitLiteral(I64(-1));
+				augmentedArgsAlloca[2] = defaultTableId ? defaultTableId : emitLiteral(I64(-1));
 				for(Uptr argIndex = 0; argIndex < args.size(); ++argIndex)
 				{ augmentedArgsAlloca[3 + argIndex] = args[argIndex]; }
 			}
@@ -474,17 +475,21 @@ namespace LLVMJIT
 		}
 
 	private:
-		MemoryInstance* defaultMemory;
-		TableInstance* defaultTable;
+		llvm::Value* defaultMemoryId;
+		llvm::Value* defaultTableId;
 	};
 
 	// Functions that map between the symbols used for externally visible functions and the function
-	std::string getExternalFunctionName(ModuleInstance* moduleInstance, Uptr functionDefIndex);
+	std::string getExternalFunctionName(Uptr functionDefIndex, const std::string& debugName);
 	bool getFunctionIndexFromExternalName(const char* externalName, Uptr& outFunctionDefIndex);
 
-	// Emits LLVM IR for a module.
+	// Emits LLVM IR for a module. The IR doesn't depend on any module instance: values that are
+	// specific to an instance are referenced through symbols that are resolved when the compiled
+	// module is loaded for an instance.
 	void emitModule(const IR::Module& module,
-					ModuleInstance* moduleInstance,
+					const std::vector<std::string>& functionDefNames,
+					const std::vector<const Intrinsics::Function*>& inlinedFunctionImports,
+					const std::vector<bool>& interpretedFunctionDefs,
 					llvm::Module& outLLVMModule);
 
 	// Used to override LLVM's default behavior of looking up unresolved symbols in DLL exports.
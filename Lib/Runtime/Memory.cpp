@@ -4,6 +4,8 @@
 #include "Runtime.h"
 #include "RuntimePrivate.h"
 
+#include <string.h>
+
 using namespace Runtime;
 
 // Global lists of memories; used to query whether an address is reserved by one of them.
@@ -204,3 +206,36 @@ U8* Runtime::getValidatedMemoryOffsetRange(MemoryInstance* memory, Uptr offset,
 	{ throwException(Exception::accessViolationType, {}); }
 	return address;
 }
+
+MemorySpan<const char> Runtime::memoryStringSpan(MemoryInstance* memory, Uptr offset)
+{
+	// Search for the NUL with memchr, which is much faster than validating each character.
+	const U8* string       = getValidatedMemoryOffsetRange(memory, offset, 0);
+	const Uptr maxNumBytes = memory->baseAddress + memory->endOffset - string;
+	const U8* nul          = (const U8*)memchr(string, 0, maxNumBytes);
+	if(!nul) { throwException(Exception::accessViolationType, {}); }
+	return MemorySpan<const char>((const char*)string, nul - string);
+}
+
+Uptr Runtime::getMemoryIoVecs(MemoryInstance* memory,
+							  Uptr ioVecsOffset,
+							  Uptr numIoVecs,
+							  MemoryIoVec* outIoVecs)
+{
+	if(numIoVecs > maxMemoryIoVecs) { throwException(Exception::invalidArgumentType); }
+	MemorySpan<const GuestIoVec> guestIoVecs
+		= memorySpan<const GuestIoVec>(memory, ioVecsOffset, numIoVecs);
+
+	Uptr numBytes = 0;
+	for(Uptr ioVecIndex = 0; ioVecIndex < numIoVecs; ++ioVecIndex)
+	{
+		// Copy the iovec out of memory before validating it, so the WebAssembly code can't change
+		// it between validation and use.
+		const GuestIoVec guestIoVec = guestIoVecs[ioVecIndex];
+		outIoVecs[ioVecIndex].base
+			= getValidatedMemoryOffsetRange(memory, guestIoVec.address, guestIoVec.numBytes);
+		outIoVecs[ioVecIndex].numBytes = guestIoVec.numBytes;
+		numBytes += guestIoVec.numBytes;
+	}
+	return numBytes;
+}
@@ -1,13 +1,30 @@
 #include "IR/Module.h"
+#include "IR/Optimize.h"
 #include "Inline/Assert.h"
 #include "Inline/BasicTypes.h"
+#include "Inline/Lock.h"
 #include "Runtime.h"
 #include "RuntimePrivate.h"
 
 #include <string.h>
+#include <algorithm>
 
 using namespace Runtime;
 
+Runtime::FunctionInstance::FunctionInstance(ModuleInstance* inModuleInstance,
+											FunctionType inType,
+											void* inNativeFunction,
+											CallingConvention inCallingConvention,
+											std::string&& inDebugName)
+: ObjectImpl(ObjectKind::function, nullptr, inModuleInstance)
+, moduleInstance(inModuleInstance)
+, type(inType)
+, nativeFunction(inNativeFunction)
+, callingConvention(inCallingConvention)
+, debugName(std::move(inDebugName))
+{
+}
+
 static Value evaluateInitializer(ModuleInstance* moduleInstance, InitializerExpression expression)
 {
 	switch(expression.type)
@@ -29,11 +46,199 @@ static Value evaluateInitializer(ModuleInstance* moduleInstance, InitializerExpr
 	};
 }
 
+// Data segments totaling less than this many bytes are copied into each instance of a memory
+// instead of being mapped from a MemoryImage.
+static constexpr Uptr minMemoryImageDataBytes = IR::numBytesPerPage;
+
+static void createMemoryImage(const IR::Module& module,
+							  Uptr memoryDefIndex,
+							  MemoryImage& outMemoryImage)
+{
+	const Uptr pageSizeLog2  = Platform::getPageSizeLog2();
+	const Uptr memoryIndex   = module.memories.imports.size() + memoryDefIndex;
+	const U64 numMemoryBytes = module.memories.defs[memoryDefIndex].type.size.min
+							   << IR::numBytesPerPageLog2;
+
+	// Find the platform pages touched by the memory's data segments. The image can only be used if
+	// all the segments have constant base offsets, and fit in the memory's initial pages.
+	std::vector<MemoryImage::Run> segmentPages;
+	Uptr numDataBytes = 0;
+	for(const DataSegment& dataSegment : module.dataSegments)
+	{
+		if(dataSegment.memoryIndex != memoryIndex || !dataSegment.data.size()) { continue; }
+		if(dataSegment.baseOffset.type != InitializerExpression::Type::i32_const) { return; }
+
+		const U64 baseOffset = U32(dataSegment.baseOffset.i32);
+		const U64 endOffset  = baseOffset + dataSegment.data.size();
+		if(endOffset > numMemoryBytes) { return; }
+
+		const Uptr firstPageIndex = Uptr(baseOffset >> pageSizeLog2);
+		const Uptr endPageIndex
+			= Uptr((endOffset + (Uptr(1) << pageSizeLog2) - 1) >> pageSizeLog2);
+		segmentPages.push_back({firstPageIndex, 0, endPageIndex - firstPageIndex});
+		numDataBytes += dataSegment.data.size();
+	}
+	if(numDataBytes < minMemoryImageDataBytes) { return; }
+
+	// Merge the overlapping and adjacent page ranges into runs, and assign each run a range of
+	// pages in the image.
+	std::sort(segmentPages.begin(),
+			  segmentPages.end(),
+			  [](const MemoryImage::Run& left, const MemoryImage::Run& right) {
+				  return left.memoryPageIndex < right.memoryPageIndex;
+			  });
+	std::vector<MemoryImage::Run> runs;
+	Uptr numImagePages = 0;
+	for(const MemoryImage::Run& pages : segmentPages)
+	{
+		if(runs.size()
+		   && runs.back().memoryPageIndex + runs.back().numPages >= pages.memoryPageIndex)
+		{
+			MemoryImage::Run& run = runs.back();
+			const Uptr endPageIndex = std::max(run.memoryPageIndex + run.numPages,
+											   pages.memoryPageIndex + pages.numPages);
+			numImagePages += endPageIndex - (run.memoryPageIndex + run.numPages);
+			run.numPages = endPageIndex - run.memoryPageIndex;
+		}
+		else
+		{
+			runs.push_back({pages.memoryPageIndex, numImagePages, pages.numPages});
+			numImagePages += pages.numPages;
+		}
+	}
+
+	// Copy the data segments into the image in order, so later segments overwrite earlier ones
+	// like they would if they were copied into the memory.
+	std::vector<U8> imageBytes(numImagePages << pageSizeLog2, 0);
+	for(const DataSegment& dataSegment : module.dataSegments)
+	{
+		if(dataSegment.memoryIndex != memoryIndex || !dataSegment.data.size()) { continue; }
+
+		const Uptr baseOffset = Uptr(U32(dataSegment.baseOffset.i32));
+		const Uptr pageIndex  = baseOffset >> pageSizeLog2;
+		auto runIt            = std::upper_bound(
+            runs.begin(), runs.end(), pageIndex, [](Uptr pageIndex, const MemoryImage::Run& run) {
+                return pageIndex < run.memoryPageIndex;
+            });
+		wavmAssert(runIt != runs.begin());
+		--runIt;
+		wavmAssert(pageIndex >= runIt->memoryPageIndex
+				   && pageIndex < runIt->memoryPageIndex + runIt->numPages);
+
+		const Uptr imageOffset = (runIt->imagePageIndex << pageSizeLog2) + baseOffset
+								 - (runIt->memoryPageIndex << pageSizeLog2);
+		wavmAssert(imageOffset + dataSegment.data.size() <= imageBytes.size());
+		memcpy(imageBytes.data() + imageOffset, dataSegment.data.data(), dataSegment.data.size());
+	}
+
+	// Create the image. If the platform doesn't support it, the data segments will be copied.
+	outMemoryImage.image = Platform::createMappableImage(imageBytes.data(), imageBytes.size());
+	if(outMemoryImage.image) { outMemoryImage.runs = std::move(runs); }
+}
+
+Runtime::CompiledModule::~CompiledModule()
+{
+	for(MemoryImage& memoryImage : memoryDefImages)
+	{
+		if(memoryImage.image) { Platform::destroyMappableImage(memoryImage.image); }
+	}
+	for(std::atomic<Interpreter::FunctionCode*>& functionCode : interpreterFunctionCode)
+	{
+		if(functionCode.load()) { Interpreter::freeFunctionCode(functionCode.load()); }
+	}
+}
+
+CompiledModuleRef Runtime::compileModule(const IR::Module& module, const CompileOptions& options)
+{
+	return compileModule(
+		module,
+		std::vector<const Intrinsics::Function*>(module.functions.imports.size(), nullptr),
+		options);
+}
+
+CompiledModuleRef Runtime::compileModule(const IR::Module& module, ExecutionBackend backend)
+{
+	CompileOptions options;
+	options.backend = backend;
+	return compileModule(module, options);
+}
+
+CompiledModuleRef Runtime::compileModule(
+	const IR::Module& inModule,
+	std::vector<const Intrinsics::Function*>&& inlinedFunctionImports,
+	const CompileOptions& options)
+{
+	wavmAssert(inlinedFunctionImports.size() == inModule.functions.imports.size());
+
+	auto compiledModule                    = std::make_shared<CompiledModule>();
+	compiledModule->module                 = inModule;
+	compiledModule->inlinedFunctionImports = std::move(inlinedFunctionImports);
+
+	// Remove unreachable code and unused declarations from the compiled module's copy of the IR.
+	if(options.optimizeModule) { IR::optimizeModule(compiledModule->module); }
+	const IR::Module& module = compiledModule->module;
+
+	// Get disassembly names for the module's function definitions.
+	DisassemblyNames disassemblyNames;
+	IR::getDisassemblyNames(module, disassemblyNames);
+	compiledModule->functionDefNames.reserve(module.functions.defs.size());
+	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+		++functionDefIndex)
+	{
+		const Uptr functionIndex = module.functions.imports.size() + functionDefIndex;
+		std::string debugName    = disassemblyNames.functions[functionIndex].name;
+		if(!debugName.size())
+		{ debugName = "<function #" + std::to_string(functionDefIndex) + ">"; }
+		compiledModule->functionDefNames.push_back(std::move(debugName));
+	}
+
+	// Choose which function definitions to interpret. Functions that use operators the interpreter
+	// doesn't support are compiled even if the module is compiled for the interpreter.
+	compiledModule->interpretedFunctionDefs.resize(module.functions.defs.size(), false);
+	if(options.backend == ExecutionBackend::interpreter)
+	{
+		for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
+			++functionDefIndex)
+		{
+			const FunctionDef& functionDef = module.functions.defs[functionDefIndex];
+			compiledModule->interpretedFunctionDefs[functionDefIndex]
+				= Interpreter::canInterpretFunction(module, functionDef);
+		}
+	}
+	compiledModule->interpreterFunctionCode
+		= std::vector<std::atomic<Interpreter::FunctionCode*>>(module.functions.defs.size());
+
+	// Generate machine code for the module.
+	compiledModule->objectCode = LLVMJIT::compileModule(module,
+														compiledModule->functionDefNames,
+														compiledModule->inlinedFunctionImports,
+														compiledModule->interpretedFunctionDefs,
+														options.inlineFunctionDefs);
+
+	// Create the images of the module's memory definitions' initial contents.
+	compiledModule->memoryDefImages.resize(module.memories.defs.size());
+	for(Uptr memoryDefIndex = 0; memoryDefIndex < module.memories.defs.size(); ++memoryDefIndex)
+	{ createMemoryImage(module, memoryDefIndex, compiledModule->memoryDefImages[memoryDefIndex]); }
+
+	return compiledModule;
+}
+
 ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 										   const IR::Module& module,
 										   ImportBindings&& imports,
 										   std::string&& moduleDebugName)
 {
+	return instantiateModule(
+		compartment, compileModule(module), std::move(imports), std::move(moduleDebugName));
+}
+
+ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
+										   CompiledModuleRef compiledModule,
+										   ImportBindings&& imports,
+										   std::string&& moduleDebugName)
+{
+	const IR::Module& module = compiledModule->module;
+
 	ModuleInstance* moduleInstance = new ModuleInstance(compartment,
 														std::move(imports.functions),
 														std::move(imports.tables),
@@ -42,16 +247,20 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 														std::move(imports.exceptionTypes),
 														std::move(moduleDebugName));
 
-	// Get disassembly names for the module's objects.
-	DisassemblyNames disassemblyNames;
-	IR::getDisassemblyNames(module, disassemblyNames);
-
 	// Check the type of the ModuleInstance's imports.
 	errorUnless(moduleInstance->functions.size() == module.functions.imports.size());
 	for(Uptr importIndex = 0; importIndex < module.functions.imports.size(); ++importIndex)
 	{
-		errorUnless(isA(moduleInstance->functions[importIndex],
-						module.types[module.functions.imports[importIndex].type.index]));
+		FunctionInstance* function = moduleInstance->functions[importIndex];
+		errorUnless(isA(function, module.types[module.functions.imports[importIndex].type.index]));
+
+		// If the compiled code inlined an intrinsic function in place of the import, it must be
+		// bound to that intrinsic function.
+		const Intrinsics::Function* inlinedFunction
+			= compiledModule->inlinedFunctionImports[importIndex];
+		errorUnless(!inlinedFunction
+					|| (function->nativeFunction == inlinedFunction->getNativeFunction()
+						&& function->callingConvention == inlinedFunction->getCallingConvention()));
 	}
 	errorUnless(moduleInstance->tables.size() == module.tables.imports.size());
 	for(Uptr importIndex = 0; importIndex < module.tables.imports.size(); ++importIndex)
@@ -130,9 +339,35 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 		{ throwException(Exception::invalidSegmentOffsetType); }
 	}
 
-	// Copy the module's data segments into the module's default memory.
+	// Map the images of the module's memory definitions' initial contents.
+	const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+	for(Uptr memoryDefIndex = 0; memoryDefIndex < module.memories.defs.size(); ++memoryDefIndex)
+	{
+		const MemoryImage& memoryImage = compiledModule->memoryDefImages[memoryDefIndex];
+		if(!memoryImage.image) { continue; }
+
+		MemoryInstance* memory
+			= moduleInstance->memories[module.memories.imports.size() + memoryDefIndex];
+		for(const MemoryImage::Run& run : memoryImage.runs)
+		{
+			if(!Platform::mapImagePages(memoryImage.image,
+										run.imagePageIndex,
+										memory->baseAddress + (run.memoryPageIndex << pageSizeLog2),
+										run.numPages))
+			{ throwException(Exception::outOfMemoryType); }
+		}
+	}
+
+	// Copy the module's data segments that weren't mapped from an image into the module's default
+	// memory.
 	for(const DataSegment& dataSegment : module.dataSegments)
 	{
+		if(dataSegment.memoryIndex >= module.memories.imports.size()
+		   && compiledModule
+				  ->memoryDefImages[dataSegment.memoryIndex - module.memories.imports.size()]
+				  .image)
+		{ continue; }
+
 		MemoryInstance* memory = moduleInstance->memories[dataSegment.memoryIndex];
 
 		const Value baseOffsetValue = evaluateInitializer(moduleInstance, dataSegment.baseOffset);
@@ -164,27 +399,22 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 			createExceptionTypeInstance(exceptionTypeDef.type, "wasmException"));
 	}
 
-	// Create the FunctionInstance objects for the module's function definitions.
-	for(Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size();
-		++functionDefIndex)
+	// Reserve entries for the module's function definitions. Their FunctionInstances are allocated
+	// in a single block owned by the ModuleInstance, but are only constructed when they are first
+	// referenced.
+	moduleInstance->compiledModule = compiledModule;
+	if(module.functions.defs.size())
 	{
-		const Uptr functionIndex                        = moduleInstance->functions.size();
-		const DisassemblyNames::Function& functionNames = disassemblyNames.functions[functionIndex];
-		std::string debugName                           = functionNames.name;
-		if(!debugName.size())
-		{ debugName = "<function #" + std::to_string(functionDefIndex) + ">"; }
-		auto functionInstance
-			= new FunctionInstance(moduleInstance,
-								   module.types[module.functions.defs[functionDefIndex].type.index],
-								   nullptr,
-								   CallingConvention::wasm,
-								   std::move(debugName));
-		moduleInstance->functionDefs.push_back(functionInstance);
-		moduleInstance->functions.push_back(functionInstance);
+		moduleInstance->functionDefBlock = (FunctionInstance*)malloc(
+			sizeof(FunctionInstance) * module.functions.defs.size());
+		if(!moduleInstance->functionDefBlock) { throwException(Exception::outOfMemoryType); }
 	}
+	moduleInstance->functions.resize(moduleInstance->functions.size()
+									 + module.functions.defs.size());
+	moduleInstance->functionDefCode.resize(module.functions.defs.size());
 
-	// Generate machine code for the module.
-	LLVMJIT::instantiateModule(module, moduleInstance);
+	// Load the compiled module's machine code, binding it to this instance.
+	LLVMJIT::loadModule(compiledModule->objectCode, moduleInstance);
 
 	// Set up the instance's exports.
 	for(const Export& exportIt : module.exports)
@@ -193,7 +423,7 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 		switch(exportIt.kind)
 		{
 		case IR::ObjectKind::function:
-			exportedObject = moduleInstance->functions[exportIt.index];
+			exportedObject = getFunctionInstance(moduleInstance, exportIt.index);
 			break;
 		case IR::ObjectKind::table: exportedObject = moduleInstance->tables[exportIt.index]; break;
 		case IR::ObjectKind::memory:
@@ -211,6 +441,7 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 	}
 
 	// Copy the module's table segments into the module's default table.
+	std::vector<FunctionInstance*> segmentFunctions;
 	for(const TableSegment& tableSegment : module.tableSegments)
 	{
 		TableInstance* table = moduleInstance->tables[tableSegment.tableIndex];
@@ -220,18 +451,17 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 		const U32 baseOffset = baseOffsetValue.i32;
 		wavmAssert(baseOffset + tableSegment.indices.size() <= table->elements.size());
 
-		for(Uptr index = 0; index < tableSegment.indices.size(); ++index)
-		{
-			const Uptr functionIndex = tableSegment.indices[index];
-			wavmAssert(functionIndex < moduleInstance->functions.size());
-			setTableElement(table, baseOffset + index, moduleInstance->functions[functionIndex]);
-		}
+		segmentFunctions.clear();
+		for(Uptr functionIndex : tableSegment.indices)
+		{ segmentFunctions.push_back(getFunctionInstance(moduleInstance, functionIndex)); }
+		setTableElements(table, baseOffset, segmentFunctions.data(), segmentFunctions.size());
 	}
 
 	// Look up the module's start function.
 	if(module.startFunctionIndex != UINTPTR_MAX)
 	{
-		moduleInstance->startFunction = moduleInstance->functions[module.startFunctionIndex];
+		moduleInstance->startFunction
+			= getFunctionInstance(moduleInstance, module.startFunctionIndex);
 		wavmAssert(moduleInstance->startFunction->type == IR::FunctionType());
 	}
 
@@ -241,6 +471,43 @@ ModuleInstance* Runtime::instantiateModule(Compartment* compartment,
 Runtime::ModuleInstance::~ModuleInstance()
 {
 	if(jitModule) { delete jitModule; }
+
+	// Destroy the FunctionInstances that were constructed for the module's function definitions,
+	// and free the block they were allocated in.
+	const Uptr numFunctionImports = functions.size() - functionDefCode.size();
+	for(Uptr functionIndex = numFunctionImports; functionIndex < functions.size(); ++functionIndex)
+	{
+		if(functions[functionIndex]) { functions[functionIndex]->~FunctionInstance(); }
+	}
+	if(functionDefBlock) { free(functionDefBlock); }
+}
+
+FunctionInstance* Runtime::getFunctionInstance(ModuleInstance* moduleInstance, Uptr functionIndex)
+{
+	Lock<Platform::Mutex> functionsLock(moduleInstance->functionsMutex);
+	wavmAssert(functionIndex < moduleInstance->functions.size());
+
+	FunctionInstance*& functionInstance = moduleInstance->functions[functionIndex];
+	if(!functionInstance)
+	{
+		// Construct the FunctionInstance for a function definition in its slot of the block.
+		const Uptr numFunctionImports
+			= moduleInstance->functions.size() - moduleInstance->functionDefCode.size();
+		wavmAssert(functionIndex >= numFunctionImports);
+		const Uptr functionDefIndex = functionIndex - numFunctionImports;
+
+		const CompiledModule& compiledModule = *moduleInstance->compiledModule;
+		const IR::Module& module             = compiledModule.module;
+		const FunctionType functionType
+			= module.types[module.functions.defs[functionDefIndex].type.index];
+		functionInstance = new(moduleInstance->functionDefBlock + functionDefIndex)
+			FunctionInstance(moduleInstance,
+							 functionType,
+							 moduleInstance->functionDefCode[functionDefIndex],
+							 CallingConvention::wasm,
+							 std::string(compiledModule.functionDefNames[functionDefIndex]));
+	}
+	return functionInstance;
 }
 
 FunctionInstance* Runtime::getStartFunction(ModuleInstance* moduleInstance)
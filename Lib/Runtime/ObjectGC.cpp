@@ -11,12 +11,37 @@
 
 using namespace Runtime;
 
-// Keep a global list of all objects.
+// An object that has been created, but not yet added to the global or compartment object sets.
+struct NewObject
+{
+	ObjectImpl* object;
+	Compartment* compartment;
+};
+
+// A list of the objects created by a thread that haven't been added to an object set yet. The
+// mutex is only contended by the garbage collector, so creating objects on multiple threads doesn't
+// serialize on a shared lock.
+struct ThreadObjectList
+{
+	Platform::Mutex mutex;
+	std::vector<NewObject> objects;
+
+	ThreadObjectList();
+	~ThreadObjectList();
+};
+
+// Keep a global list of the objects that aren't owned by a compartment. Compartments keep their own
+// list of the objects they own.
 struct GCGlobals
 {
 	Platform::Mutex mutex;
 	HashSet<ObjectImpl*> allObjects;
 
+	// The new object lists for all threads, and the new objects left by threads that have exited.
+	Platform::Mutex threadObjectListsMutex;
+	std::vector<ThreadObjectList*> threadObjectLists;
+	std::vector<NewObject> exitedThreadObjects;
+
 	static GCGlobals& get()
 	{
 		static GCGlobals globals;
@@ -27,37 +52,191 @@ private:
 	GCGlobals() {}
 };
 
-Runtime::ObjectImpl::ObjectImpl(ObjectKind inKind) : Object(inKind), numRootReferences(0)
+static thread_local ThreadObjectList threadObjectList;
+
+ThreadObjectList::ThreadObjectList()
+{
+	GCGlobals& gcGlobals = GCGlobals::get();
+	Lock<Platform::Mutex> threadObjectListsLock(gcGlobals.threadObjectListsMutex);
+	gcGlobals.threadObjectLists.push_back(this);
+}
+
+ThreadObjectList::~ThreadObjectList()
+{
+	// Remove the thread's list from the global array, and move any objects that the garbage
+	// collector hasn't taken yet to the exited thread object list.
+	GCGlobals& gcGlobals = GCGlobals::get();
+	Lock<Platform::Mutex> threadObjectListsLock(gcGlobals.threadObjectListsMutex);
+	for(Uptr listIndex = 0; listIndex < gcGlobals.threadObjectLists.size(); ++listIndex)
+	{
+		if(gcGlobals.threadObjectLists[listIndex] == this)
+		{
+			gcGlobals.threadObjectLists.erase(gcGlobals.threadObjectLists.begin() + listIndex);
+			break;
+		}
+	}
+
+	Lock<Platform::Mutex> lock(mutex);
+	gcGlobals.exitedThreadObjects.insert(
+		gcGlobals.exitedThreadObjects.end(), objects.begin(), objects.end());
+	objects.clear();
+}
+
+// Moves the objects owned by a compartment from a new object list to outObjects. If compartment is
+// null, all objects are moved.
+static void takeNewObjects(std::vector<NewObject>& objects,
+						   Compartment* compartment,
+						   std::vector<NewObject>& outObjects)
+{
+	if(!compartment)
+	{
+		outObjects.insert(outObjects.end(), objects.begin(), objects.end());
+		objects.clear();
+	}
+	else
+	{
+		Uptr numRemainingObjects = 0;
+		for(const NewObject& newObject : objects)
+		{
+			if(newObject.compartment == compartment) { outObjects.push_back(newObject); }
+			else
+			{
+				objects[numRemainingObjects++] = newObject;
+			}
+		}
+		objects.resize(numRemainingObjects);
+	}
+}
+
+// Takes the new objects owned by a compartment from all threads' new object lists. If compartment
+// is null, all new objects are taken.
+static std::vector<NewObject> takeAllThreadsNewObjects(Compartment* compartment)
 {
-	// Add the object to the global array.
-	Lock<Platform::Mutex> lock(GCGlobals::get().mutex);
-	GCGlobals::get().allObjects.add(this);
+	GCGlobals& gcGlobals = GCGlobals::get();
+	Lock<Platform::Mutex> threadObjectListsLock(gcGlobals.threadObjectListsMutex);
+
+	std::vector<NewObject> result;
+	takeNewObjects(gcGlobals.exitedThreadObjects, compartment, result);
+	for(ThreadObjectList* list : gcGlobals.threadObjectLists)
+	{
+		Lock<Platform::Mutex> lock(list->mutex);
+		takeNewObjects(list->objects, compartment, result);
+	}
+	return result;
+}
+
+Runtime::ObjectImpl::ObjectImpl(ObjectKind inKind, Compartment* inCompartment, ObjectImpl* inOwner)
+: Object(inKind), numRootReferences(0), owner(inOwner)
+{
+	if(!owner)
+	{
+		// Add the object to the calling thread's new object list.
+		Lock<Platform::Mutex> lock(threadObjectList.mutex);
+		threadObjectList.objects.push_back({this, inCompartment});
+	}
+}
+
+// Returns the object that the garbage collector tracks the lifetime of the given object with.
+static ObjectImpl* getGCObject(Object* object)
+{
+	ObjectImpl* objectImpl = (ObjectImpl*)object;
+	return objectImpl && objectImpl->owner ? objectImpl->owner : objectImpl;
 }
 
 void Runtime::addGCRoot(Object* object)
 {
-	ObjectImpl* gcObject = (ObjectImpl*)object;
+	ObjectImpl* gcObject = getGCObject(object);
 	++gcObject->numRootReferences;
 }
 
 void Runtime::removeGCRoot(Object* object)
 {
-	ObjectImpl* gcObject = (ObjectImpl*)object;
+	ObjectImpl* gcObject = getGCObject(object);
 	--gcObject->numRootReferences;
 }
 
-void Runtime::collectGarbage()
+static void getChildReferences(Object* object, std::vector<Object*>& outChildReferences)
 {
-	GCGlobals& gcGlobals = GCGlobals::get();
-	Lock<Platform::Mutex> lock(gcGlobals.mutex);
-	Timing::Timer timer;
+	switch(object->kind)
+	{
+	case Runtime::ObjectKind::function:
+	{
+		FunctionInstance* function = asFunction(object);
+		outChildReferences.push_back(function->moduleInstance);
+		break;
+	}
+	case Runtime::ObjectKind::table:
+	{
+		TableInstance* table = asTable(object);
+		outChildReferences.push_back(table->compartment);
+		outChildReferences.insert(
+			outChildReferences.end(), table->elements.begin(), table->elements.end());
+		break;
+	}
+	case Runtime::ObjectKind::memory:
+	{
+		MemoryInstance* memory = asMemory(object);
+		outChildReferences.push_back(memory->compartment);
+		break;
+	}
+	case Runtime::ObjectKind::global:
+	{
+		GlobalInstance* global = asGlobal(object);
+		outChildReferences.push_back(global->compartment);
+		break;
+	}
+	case Runtime::ObjectKind::module:
+	{
+		ModuleInstance* moduleInstance = asModule(object);
+		outChildReferences.push_back(moduleInstance->compartment);
+		{
+			Lock<Platform::Mutex> functionsLock(moduleInstance->functionsMutex);
+			outChildReferences.insert(outChildReferences.begin(),
+									  moduleInstance->functions.begin(),
+									  moduleInstance->functions.end());
+		}
+		outChildReferences.insert(outChildReferences.begin(),
+								  moduleInstance->tables.begin(),
+								  moduleInstance->tables.end());
+		outChildReferences.insert(outChildReferences.begin(),
+								  moduleInstance->memories.begin(),
+								  moduleInstance->memories.end());
+		outChildReferences.insert(outChildReferences.begin(),
+								  moduleInstance->globals.begin(),
+								  moduleInstance->globals.end());
+		outChildReferences.insert(outChildReferences.begin(),
+								  moduleInstance->exceptionTypeInstances.begin(),
+								  moduleInstance->exceptionTypeInstances.end());
+		outChildReferences.push_back(moduleInstance->defaultMemory);
+		outChildReferences.push_back(moduleInstance->defaultTable);
+		break;
+	}
+	case Runtime::ObjectKind::context:
+	{
+		Context* context = asContext(object);
+		outChildReferences.push_back(context->compartment);
+		break;
+	}
+	case Runtime::ObjectKind::compartment:
+	{
+		Compartment* compartment = asCompartment(object);
+		outChildReferences.push_back(compartment->wavmIntrinsics);
+		break;
+	}
 
-	HashSet<ObjectImpl*> referencedObjects;
-	std::vector<Object*> pendingScanObjects;
+	case Runtime::ObjectKind::exceptionTypeInstance: break;
 
-	// Initialize the referencedObjects set from the rooted object set.
+	default: Errors::unreachable();
+	};
+}
+
+// Adds the objects in a set that are rooted to the referenced set and to the pending scan list.
+static Uptr addRootedObjects(const HashSet<ObjectImpl*>& objects,
+							 HashSet<ObjectImpl*>& referencedObjects,
+							 std::vector<Object*>& pendingScanObjects)
+{
 	Uptr numRoots = 0;
-	for(ObjectImpl* object : gcGlobals.allObjects)
+	for(ObjectImpl* object : objects)
 	{
 		if(object && object->numRootReferences > 0)
 		{
@@ -66,117 +245,190 @@ void Runtime::collectGarbage()
 			++numRoots;
 		}
 	}
+	return numRoots;
+}
 
-	// Scan the objects added to the referenced set so far: gather their child references and
-	// recurse.
+// Scans the objects in pendingScanObjects: gathers their child references, adds them to the
+// referenced set, and recurses. If scopeObjects is non-null, references to objects that aren't in
+// it aren't followed.
+static void scanReferencedObjects(std::vector<Object*>& pendingScanObjects,
+								  HashSet<ObjectImpl*>& referencedObjects,
+								  const HashSet<ObjectImpl*>* scopeObjects)
+{
+	std::vector<Object*> childReferences;
 	while(pendingScanObjects.size())
 	{
 		Object* scanObject = pendingScanObjects.back();
 		pendingScanObjects.pop_back();
 
 		// Gather the child references for this object based on its kind.
-		std::vector<Object*> childReferences;
-		switch(scanObject->kind)
-		{
-		case ObjectKind::function:
-		{
-			FunctionInstance* function = asFunction(scanObject);
-			childReferences.push_back(function->moduleInstance);
-			break;
-		}
-		case ObjectKind::table:
-		{
-			TableInstance* table = asTable(scanObject);
-			childReferences.push_back(table->compartment);
-			childReferences.insert(
-				childReferences.end(), table->elements.begin(), table->elements.end());
-			break;
-		}
-		case ObjectKind::memory:
-		{
-			MemoryInstance* memory = asMemory(scanObject);
-			childReferences.push_back(memory->compartment);
-			break;
-		}
-		case ObjectKind::global:
-		{
-			GlobalInstance* global = asGlobal(scanObject);
-			childReferences.push_back(global->compartment);
-			break;
-		}
-		case ObjectKind::module:
-		{
-			ModuleInstance* moduleInstance = asModule(scanObject);
-			childReferences.push_back(moduleInstance->compartment);
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->functionDefs.begin(),
-								   moduleInstance->functionDefs.end());
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->functions.begin(),
-								   moduleInstance->functions.end());
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->tables.begin(),
-								   moduleInstance->tables.end());
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->memories.begin(),
-								   moduleInstance->memories.end());
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->globals.begin(),
-								   moduleInstance->globals.end());
-			childReferences.insert(childReferences.begin(),
-								   moduleInstance->exceptionTypeInstances.begin(),
-								   moduleInstance->exceptionTypeInstances.end());
-			childReferences.push_back(moduleInstance->defaultMemory);
-			childReferences.push_back(moduleInstance->defaultTable);
-			break;
-		}
-		case ObjectKind::context:
-		{
-			Context* context = asContext(scanObject);
-			childReferences.push_back(context->compartment);
-			break;
-		}
-		case ObjectKind::compartment:
-		{
-			Compartment* compartment = asCompartment(scanObject);
-			childReferences.push_back(compartment->wavmIntrinsics);
-			break;
-		}
-
-		case ObjectKind::exceptionTypeInstance: break;
-
-		default: Errors::unreachable();
-		};
+		childReferences.clear();
+		getChildReferences(scanObject, childReferences);
 
 		// Add the object's child references to the referenced set, and enqueue them for
 		// scanning.
-		for(Object* reference : childReferences)
+		for(Object* childReference : childReferences)
 		{
-			if(reference && referencedObjects.add((ObjectImpl*)reference))
+			ObjectImpl* reference = getGCObject(childReference);
+			if(reference && (!scopeObjects || scopeObjects->contains(reference))
+			   && referencedObjects.add(reference))
 			{ pendingScanObjects.push_back(reference); }
 		}
 	};
+}
 
-	// Find the objects that weren't reached, and call finalize on each of them.
-	std::vector<ObjectImpl*> finalizedObjects;
-	for(ObjectImpl* object : gcGlobals.allObjects)
+// Finds the objects in a set that weren't reached, calls finalize on each of them, and removes them
+// from the set. The set can't be modified while iterating over it, so the objects are removed after
+// they have all been found.
+static void finalizeUnreferencedObjects(HashSet<ObjectImpl*>& objects,
+										const HashSet<ObjectImpl*>& referencedObjects,
+										std::vector<ObjectImpl*>& outFinalizedObjects)
+{
+	const Uptr firstFinalizedObjectIndex = outFinalizedObjects.size();
+	for(ObjectImpl* object : objects)
 	{
 		if(!referencedObjects.contains(object))
 		{
 			object->finalize();
-			finalizedObjects.push_back(object);
+			outFinalizedObjects.push_back(object);
 		}
 	}
-	gcGlobals.allObjects = std::move(referencedObjects);
+
+	for(Uptr objectIndex = firstFinalizedObjectIndex; objectIndex < outFinalizedObjects.size();
+		++objectIndex)
+	{ errorUnless(objects.remove(outFinalizedObjects[objectIndex])); }
+}
+
+void Runtime::collectGarbage()
+{
+	GCGlobals& gcGlobals = GCGlobals::get();
+	Lock<Platform::Mutex> lock(gcGlobals.mutex);
+	Timing::Timer timer;
+
+	// Take the objects that were created since the last collection from all threads, and add the
+	// objects that aren't owned by a compartment to the global object set.
+	std::vector<NewObject> newObjects = takeAllThreadsNewObjects(nullptr);
+	for(const NewObject& newObject : newObjects)
+	{
+		if(!newObject.compartment) { gcGlobals.allObjects.add(newObject.object); }
+	}
+
+	// Lock the object sets of all compartments. Compartments are always in the global object set.
+	std::vector<Compartment*> compartments;
+	for(ObjectImpl* object : gcGlobals.allObjects)
+	{
+		if(object->kind == Runtime::ObjectKind::compartment)
+		{
+			Compartment* compartment = asCompartment(object);
+			compartment->objectsMutex.lock();
+			compartments.push_back(compartment);
+		}
+	}
+
+	// Add the new objects owned by compartments to their compartment's object set.
+	for(const NewObject& newObject : newObjects)
+	{
+		if(newObject.compartment) { newObject.compartment->objects.add(newObject.object); }
+	}
+
+	HashSet<ObjectImpl*> referencedObjects;
+	std::vector<Object*> pendingScanObjects;
+
+	// Initialize the referencedObjects set from the rooted object set.
+	Uptr numRoots = addRootedObjects(gcGlobals.allObjects, referencedObjects, pendingScanObjects);
+	for(Compartment* compartment : compartments)
+	{
+		numRoots += addRootedObjects(compartment->objects, referencedObjects, pendingScanObjects);
+	}
+
+	// Scan the objects added to the referenced set so far: gather their child references and
+	// recurse.
+	scanReferencedObjects(pendingScanObjects, referencedObjects, nullptr);
+
+	// Find the objects that weren't reached, and call finalize on each of them.
+	std::vector<ObjectImpl*> finalizedObjects;
+	finalizeUnreferencedObjects(gcGlobals.allObjects, referencedObjects, finalizedObjects);
+	for(Compartment* compartment : compartments)
+	{
+		finalizeUnreferencedObjects(compartment->objects, referencedObjects, finalizedObjects);
+		compartment->objectsMutex.unlock();
+	}
 
 	// Delete all the finalized objects.
 	for(ObjectImpl* object : finalizedObjects) { delete object; }
 
+	// Add the pause time to the surviving compartments' statistics.
+	const U64 pauseMicroseconds = timer.getMicroseconds();
+	for(Compartment* compartment : compartments)
+	{
+		if(referencedObjects.contains(compartment))
+		{
+			compartment->gcPauseMicroseconds.fetch_add(pauseMicroseconds,
+													   std::memory_order_relaxed);
+		}
+	}
+
 	Log::printf(Log::metrics,
 				"Collected garbage in %.2fms: %" PRIuPTR " roots, %" PRIuPTR " objects, %" PRIuPTR
 				" garbage\n",
 				timer.getMilliseconds(),
 				numRoots,
-				Uptr(gcGlobals.allObjects.size() + finalizedObjects.size()),
+				Uptr(referencedObjects.size() + finalizedObjects.size()),
 				Uptr(finalizedObjects.size()));
 }
+
+void Runtime::collectCompartmentGarbage(Compartment* compartment)
+{
+	wavmAssert(compartment);
+	Lock<Platform::Mutex> lock(compartment->objectsMutex);
+	Timing::Timer timer;
+
+	// Take the objects owned by the compartment that were created since the last collection from
+	// all threads, and add them to the compartment's object set.
+	for(const NewObject& newObject : takeAllThreadsNewObjects(compartment))
+	{ compartment->objects.add(newObject.object); }
+
+	HashSet<ObjectImpl*> referencedObjects;
+	std::vector<Object*> pendingScanObjects;
+
+	// Initialize the referencedObjects set from the compartment's rooted objects. The compartment
+	// itself is kept alive by the caller, so treat it as a root as well.
+	Uptr numRoots = addRootedObjects(compartment->objects, referencedObjects, pendingScanObjects);
+	pendingScanObjects.push_back(compartment);
+
+	// Scan the objects added to the referenced set so far, without following references to objects
+	// outside the compartment.
+	scanReferencedObjects(pendingScanObjects, referencedObjects, &compartment->objects);
+
+	// Find the compartment's objects that weren't reached, and call finalize on each of them.
+	std::vector<ObjectImpl*> finalizedObjects;
+	finalizeUnreferencedObjects(compartment->objects, referencedObjects, finalizedObjects);
+
+	// Delete all the finalized objects.
+	for(ObjectImpl* object : finalizedObjects) { delete object; }
+
+	compartment->gcPauseMicroseconds.fetch_add(timer.getMicroseconds(),
+											   std::memory_order_relaxed);
+
+	Log::printf(Log::metrics,
+				"Collected compartment garbage in %.2fms: %" PRIuPTR " roots, %" PRIuPTR
+				" objects, %" PRIuPTR " garbage\n",
+				timer.getMilliseconds(),
+				numRoots,
+				Uptr(compartment->objects.size() + finalizedObjects.size()),
+				Uptr(finalizedObjects.size()));
+}
+
+void Runtime::visitCompartmentObjects(Compartment* compartment,
+									  const std::function<void(ObjectImpl*)>& visitObject)
+{
+	wavmAssert(compartment);
+	Lock<Platform::Mutex> lock(compartment->objectsMutex);
+
+	// Take the objects owned by the compartment that were created since the last collection from
+	// all threads, so they are visited as well.
+	for(const NewObject& newObject : takeAllThreadsNewObjects(compartment))
+	{ compartment->objects.add(newObject.object); }
+
+	for(ObjectImpl* object : compartment->objects) { visitObject(object); }
+}
@@ -0,0 +1,129 @@
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/HashMap.h"
+#include "Inline/Lock.h"
+#include "Platform/Platform.h"
+#include "Runtime.h"
+#include "RuntimePrivate.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace Runtime;
+
+// How often the profiler thread reads the samples recorded by the sampled threads. The samples are
+// described by looking up the JIT code they were taken in, so they need to be read before the code
+// is unloaded.
+static constexpr U64 readSamplesIntervalMicroseconds = 20000;
+
+struct Profiler
+{
+	Platform::Thread* thread;
+	Platform::Event stopEvent;
+
+	// The number of samples of each distinct call stack, in the folded stack format.
+	HashMap<std::string, U64> foldedStackCounts;
+
+	// Descriptions of instruction pointers seen since the last time samples were read.
+	HashMap<Uptr, std::string> frameDescriptionCache;
+};
+
+static Platform::Mutex profilerMutex;
+static Profiler* profiler = nullptr;
+
+static const std::string& describeSampleFrame(Profiler& profiler, Uptr ip)
+{
+	const std::string* cachedDescription = profiler.frameDescriptionCache.get(ip);
+	if(cachedDescription) { return *cachedDescription; }
+
+	std::string description;
+	if(!LLVMJIT::describeInstructionPointer(ip, description)
+	   && !Platform::describeInstructionPointer(ip, description))
+	{ description = "<unknown function>"; }
+
+	// The folded stack format separates frames with semicolons.
+	std::replace(description.begin(), description.end(), ';', ':');
+
+	return profiler.frameDescriptionCache.getOrAdd(ip, std::move(description));
+}
+
+static void readProfilerSamples(Profiler& profiler)
+{
+	std::string foldedStack;
+	Platform::readSamples([&profiler, &foldedStack](const Platform::CallStack& callStack) {
+		// Build the folded representation of the call stack: its frames from outermost to
+		// innermost, separated by semicolons.
+		foldedStack.clear();
+		for(Uptr frameIndex = callStack.stackFrames.size(); frameIndex > 0; --frameIndex)
+		{
+			// The frames other than the innermost are return addresses, so describe the call
+			// instruction before the return address.
+			Uptr ip = callStack.stackFrames[frameIndex - 1].ip;
+			if(frameIndex > 1) { --ip; }
+
+			if(foldedStack.size()) { foldedStack += ';'; }
+			foldedStack += describeSampleFrame(profiler, ip);
+		}
+		++profiler.foldedStackCounts.getOrAdd(foldedStack, 0);
+	});
+
+	// JIT code may be unloaded and other code loaded at the same address before the next read, so
+	// don't reuse the descriptions.
+	profiler.frameDescriptionCache = HashMap<Uptr, std::string>();
+}
+
+static I64 profilerThreadEntry(void* profilerVoid)
+{
+	Profiler& profiler = *(Profiler*)profilerVoid;
+	while(!profiler.stopEvent.wait(Platform::getMonotonicClock()
+								   + readSamplesIntervalMicroseconds))
+	{ readProfilerSamples(profiler); }
+	return 0;
+}
+
+bool Runtime::startProfiling(Uptr intervalMicroseconds)
+{
+	Lock<Platform::Mutex> profilerLock(profilerMutex);
+	if(profiler) { return false; }
+
+	// Create the profiler thread before starting sampling, so it isn't sampled itself.
+	profiler         = new Profiler;
+	profiler->thread = Platform::createThread(1024 * 1024, profilerThreadEntry, profiler);
+
+	if(!Platform::startSampling(intervalMicroseconds))
+	{
+		profiler->stopEvent.signal();
+		Platform::joinThread(profiler->thread);
+		delete profiler;
+		profiler = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+std::string Runtime::stopProfiling()
+{
+	Lock<Platform::Mutex> profilerLock(profilerMutex);
+	if(!profiler) { return std::string(); }
+
+	// Stop sampling and the profiler thread, and read the remaining samples.
+	Platform::stopSampling();
+	profiler->stopEvent.signal();
+	Platform::joinThread(profiler->thread);
+	readProfilerSamples(*profiler);
+
+	// Write one line for each distinct call stack, followed by the number of samples of it.
+	std::string result;
+	for(const auto& pair : profiler->foldedStackCounts)
+	{
+		result += pair.key;
+		result += ' ';
+		result += std::to_string(pair.value);
+		result += '\n';
+	}
+
+	delete profiler;
+	profiler = nullptr;
+	return result;
+}
@@ -7,6 +7,23 @@
 
 using namespace Runtime;
 
+thread_local Compartment* Runtime::currentInvokeCompartment = nullptr;
+
+// Sets currentInvokeCompartment for the duration of an invoke. If the invoke is interrupted by a
+// signal, the destructor won't run, and catchRuntimeExceptions restores currentInvokeCompartment
+// instead.
+struct InvokeCompartmentScope
+{
+	InvokeCompartmentScope(Compartment* compartment) : outerCompartment(currentInvokeCompartment)
+	{
+		currentInvokeCompartment = compartment;
+	}
+	~InvokeCompartmentScope() { currentInvokeCompartment = outerCompartment; }
+
+private:
+	Compartment* outerCompartment;
+};
+
 bool Runtime::isA(Object* object, const ObjectType& type)
 {
 	if(Runtime::ObjectKind(type.kind) != object->kind) { return false; }
@@ -69,8 +86,7 @@ UntaggedValue* Runtime::invokeFunctionUnchecked(Context* context,
 	}
 
 	// Call the invoke thunk.
-	contextRuntimeData = (ContextRuntimeData*)(*invokeFunctionPointer)(function->nativeFunction,
-																	   contextRuntimeData);
+	contextRuntimeData = callInvokeThunk(context, invokeFunctionPointer, function->nativeFunction);
 
 	// Return a pointer to the return value that was written to the ContextRuntimeData.
 	return (UntaggedValue*)contextRuntimeData->thunkArgAndReturnData;
@@ -120,8 +136,61 @@ ValueTuple Runtime::invokeFunctionChecked(Context* context,
 	return results;
 }
 
+Uptr Runtime::invokeFunctionBatch(Context* context,
+								  FunctionInstance* function,
+								  const UntaggedValue* arguments,
+								  UntaggedValue* results,
+								  Uptr numInvokes,
+								  Exception* outException)
+{
+	// Get the invoke batch thunk for this function type.
+	auto invokeBatchFunctionPointer
+		= LLVMJIT::getInvokeBatchThunk(function->type, function->callingConvention);
+
+	// Call the thunk, which writes the index of each invoke to numCompletedInvokes before calling
+	// the function. If an invoke throws, numCompletedInvokes will be the index of that invoke.
+	ContextRuntimeData* contextRuntimeData = getContextRuntimeData(context);
+	volatile U64 numCompletedInvokes       = 0;
+	bool threwException                    = false;
+	catchRuntimeExceptions(
+		[&] {
+			InvokeCompartmentScope invokeCompartmentScope(context->compartment);
+			(*invokeBatchFunctionPointer)(function->nativeFunction,
+										  contextRuntimeData,
+										  arguments,
+										  results,
+										  U64(numInvokes),
+										  &numCompletedInvokes);
+		},
+		[&](Exception&& exception) {
+			threwException = true;
+			if(outException) { *outException = std::move(exception); }
+		});
+
+	wavmAssert(numCompletedInvokes <= numInvokes);
+	context->compartment->numInvokes.fetch_add(numCompletedInvokes + (threwException ? 1 : 0),
+											   std::memory_order_relaxed);
+	return Uptr(numCompletedInvokes);
+}
+
 FunctionType Runtime::getFunctionType(FunctionInstance* function) { return function->type; }
 
+InvokeThunkPointer Runtime::getFunctionInvokeThunk(FunctionInstance* function,
+												   void*& outNativeFunction)
+{
+	outNativeFunction = function->nativeFunction;
+	return LLVMJIT::getInvokeThunk(function->type, function->callingConvention);
+}
+
+ContextRuntimeData* Runtime::callInvokeThunk(Context* context,
+											 InvokeThunkPointer invokeThunk,
+											 void* nativeFunction)
+{
+	context->compartment->numInvokes.fetch_add(1, std::memory_order_relaxed);
+	InvokeCompartmentScope invokeCompartmentScope(context->compartment);
+	return (*invokeThunk)(nativeFunction, getContextRuntimeData(context));
+}
+
 GlobalInstance* Runtime::createGlobal(Compartment* compartment, GlobalType type, Value initialValue)
 {
 	wavmAssert(initialValue.type == type.valueType);
@@ -139,13 +208,24 @@ GlobalInstance* Runtime::createGlobal(Compartment* compartment, GlobalType type,
 		const U32 numBytes = getTypeByteWidth(type.valueType);
 		U32 dataOffset     = (compartment->numGlobalBytes + numBytes - 1) & ~(numBytes - 1);
 		if(dataOffset + numBytes >= maxGlobalBytes) { return nullptr; }
-		compartment->numGlobalBytes = dataOffset + numBytes;
 
-		// Initialize the global value for each context, and the data used to initialize new
-		// contexts.
+		// Initialize the data used to initialize new contexts, and the global value for each
+		// existing context. The version is odd while the initial data is being changed, so
+		// concurrent calls to createContext will retry copying it.
+		compartment->initialContextGlobalDataVersion.fetch_add(1);
 		memcpy(compartment->initialContextGlobalData + dataOffset, &initialValue, numBytes);
-		for(Context* context : compartment->contexts)
-		{ memcpy(context->runtimeData->globalData + dataOffset, &initialValue, numBytes); }
+		compartment->numGlobalBytes = dataOffset + numBytes;
+		const Uptr numContextSlots  = compartment->numContextSlots.load();
+		for(Uptr contextId = 0; contextId < numContextSlots; ++contextId)
+		{
+			if(compartment->contextSlots[contextId].context.load())
+			{
+				memcpy(compartment->runtimeData->contexts[contextId].globalData + dataOffset,
+					   &initialValue,
+					   numBytes);
+			}
+		}
+		compartment->initialContextGlobalDataVersion.fetch_add(1);
 
 		globalInstance = new GlobalInstance(compartment, type, dataOffset, initialValue);
 	}
@@ -189,8 +269,22 @@ Value Runtime::setGlobalValue(Context* context, GlobalInstance* global, Value ne
 	return previousValue;
 }
 
+static Uptr getNumContextSlotPages()
+{
+	const Uptr pageSize = Uptr(1) << Platform::getPageSizeLog2();
+	return (sizeof(Compartment::ContextSlot) * maxContexts + pageSize - 1) / pageSize;
+}
+
 Runtime::Compartment::Compartment()
-: ObjectImpl(ObjectKind::compartment), unalignedRuntimeData(nullptr), numGlobalBytes(0)
+: ObjectImpl(ObjectKind::compartment, nullptr)
+, unalignedRuntimeData(nullptr)
+, numGlobalBytes(0)
+, numCommittedContextSlotPages(0)
+, numContextSlots(0)
+, initialContextGlobalDataVersion(0)
+, numInvokes(0)
+, numGrowMemoryCalls(0)
+, gcPauseMicroseconds(0)
 {
 	runtimeData = (CompartmentRuntimeData*)Platform::allocateAlignedVirtualPages(
 		compartmentReservedBytes >> Platform::getPageSizeLog2(),
@@ -203,11 +297,19 @@ Runtime::Compartment::Compartment()
 
 	runtimeData->compartment = this;
 
+	// Reserve the address space for the context slots. The pages are committed by createContext
+	// as they are needed.
+	contextSlots = (ContextSlot*)Platform::allocateVirtualPages(getNumContextSlotPages());
+	errorUnless(contextSlots);
+
 	wavmIntrinsics = instantiateWAVMIntrinsics(this);
 }
 
 Runtime::Compartment::~Compartment()
 {
+	Platform::freeVirtualPages((U8*)contextSlots, getNumContextSlotPages());
+	contextSlots = nullptr;
+
 	Platform::decommitVirtualPages((U8*)runtimeData,
 								   compartmentReservedBytes >> Platform::getPageSizeLog2());
 	Platform::freeAlignedVirtualPages(unalignedRuntimeData,
@@ -257,37 +359,171 @@ Compartment* Runtime::cloneCompartment(Compartment* compartment)
 	return newCompartment;
 }
 
-Context* Runtime::createContext(Compartment* compartment)
+CompartmentStatistics Runtime::getStatistics(Compartment* compartment)
 {
 	wavmAssert(compartment);
-	Context* context = new Context(compartment);
+	CompartmentStatistics statistics;
+	memset(statistics.numObjectsByKind, 0, sizeof(statistics.numObjectsByKind));
+	statistics.numMemoryPages   = 0;
+	statistics.numTableElements = 0;
+	statistics.numJITCodeBytes  = 0;
+	statistics.numJITDataBytes  = 0;
+
+	// Count the compartment's objects, and the code and data of its module instances.
+	visitCompartmentObjects(compartment, [&statistics](ObjectImpl* object) {
+		wavmAssert(Uptr(object->kind) <= Uptr(ObjectKind::compartment));
+		++statistics.numObjectsByKind[Uptr(object->kind)];
+
+		if(object->kind == ObjectKind::module)
+		{
+			ModuleInstance* moduleInstance = asModule(object);
+			if(moduleInstance->jitModule)
+			{
+				statistics.numJITCodeBytes += moduleInstance->jitModule->getNumCodeBytes();
+				statistics.numJITDataBytes += moduleInstance->jitModule->getNumDataBytes();
+			}
+
+			// The FunctionInstances for the module's function definitions are owned by the module
+			// instance, so they aren't in the compartment's object set.
+			Lock<Platform::Mutex> functionsLock(moduleInstance->functionsMutex);
+			const Uptr numFunctionImports
+				= moduleInstance->functions.size() - moduleInstance->functionDefCode.size();
+			for(Uptr functionIndex = numFunctionImports;
+				functionIndex < moduleInstance->functions.size();
+				++functionIndex)
+			{
+				if(moduleInstance->functions[functionIndex])
+				{ ++statistics.numObjectsByKind[Uptr(ObjectKind::function)]; }
+			}
+		}
+	});
+
+	// Sum the sizes of the compartment's memories and tables.
 	{
-		Lock<Platform::Mutex> lock(compartment->mutex);
+		Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+		for(MemoryInstance* memory : compartment->memories)
+		{
+			if(memory) { statistics.numMemoryPages += memory->numPages; }
+		}
+		for(TableInstance* table : compartment->tables)
+		{
+			if(table) { statistics.numTableElements += getTableNumElements(table); }
+		}
+	}
 
-		// Allocate an ID for the context in the compartment.
-		context->id          = compartment->contexts.size();
-		context->runtimeData = &compartment->runtimeData->contexts[context->id];
-		compartment->contexts.push_back(context);
+	// Read the counters.
+	statistics.numInvokes = compartment->numInvokes.load(std::memory_order_relaxed);
+	statistics.numGrowMemoryCalls
+		= compartment->numGrowMemoryCalls.load(std::memory_order_relaxed);
+	statistics.gcPauseMicroseconds
+		= compartment->gcPauseMicroseconds.load(std::memory_order_relaxed);
+	{
+		Lock<Platform::Mutex> trapCountsLock(compartment->trapCountsMutex);
+		for(const auto& pair : compartment->numTrapsByExceptionType)
+		{ statistics.numTrapsByExceptionType.push_back({pair.key, pair.value}); }
+	}
 
-		// Commit the page(s) for the context's runtime data.
-		errorUnless(Platform::commitVirtualPages(
-			(U8*)context->runtimeData, sizeof(ContextRuntimeData) >> Platform::getPageSizeLog2()));
+	return statistics;
+}
+
+// Copies the compartment's initial global data to a context. This doesn't lock the compartment's
+// mutex, so if createGlobal changes the initial data during the copy, it retries.
+static void initContextGlobalData(Context* context)
+{
+	Compartment* compartment = context->compartment;
+	while(true)
+	{
+		const U32 version = compartment->initialContextGlobalDataVersion.load();
+		if(version & 1)
+		{
+			// createGlobal is changing the initial data, so let it run before trying again.
+			Platform::yieldToAnotherThread();
+			continue;
+		}
 
-		// Initialize the context's global data.
 		memcpy(context->runtimeData->globalData,
 			   compartment->initialContextGlobalData,
-			   compartment->numGlobalBytes);
+			   compartment->numGlobalBytes.load(std::memory_order_relaxed));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(compartment->initialContextGlobalDataVersion.load(std::memory_order_relaxed) == version)
+		{ break; }
 	}
+}
+
+// Commits the pages of a compartment's context slots up to the page containing the slot for a
+// context ID. Context IDs are allocated lowest first, so the committed pages grow with the largest
+// number of contexts that have existed at once.
+static void commitContextSlot(Compartment* compartment, Uptr contextId)
+{
+	const Uptr pageSizeLog2     = Platform::getPageSizeLog2();
+	const Uptr pageSize         = Uptr(1) << pageSizeLog2;
+	const Uptr numRequiredBytes = (contextId + 1) * sizeof(Compartment::ContextSlot);
+	const Uptr numRequiredPages = (numRequiredBytes + pageSize - 1) >> pageSizeLog2;
+	if(compartment->numCommittedContextSlotPages.load(std::memory_order_acquire)
+	   >= numRequiredPages)
+	{ return; }
+
+	Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+	const Uptr numCommittedPages
+		= compartment->numCommittedContextSlotPages.load(std::memory_order_relaxed);
+	if(numCommittedPages < numRequiredPages)
+	{
+		errorUnless(Platform::commitVirtualPages(
+			(U8*)compartment->contextSlots + (numCommittedPages << pageSizeLog2),
+			numRequiredPages - numCommittedPages));
+		compartment->numCommittedContextSlotPages.store(numRequiredPages,
+														std::memory_order_release);
+	}
+}
+
+Context* Runtime::createContext(Compartment* compartment)
+{
+	wavmAssert(compartment);
+
+	// Allocate an ID for the context in the compartment.
+	Uptr contextId;
+	if(!compartment->contextIdAllocator.alloc(contextId))
+	{ throwException(Exception::outOfMemoryType); }
+
+	// Commit the page(s) for the context's slot and runtime data if the ID hasn't been used before.
+	commitContextSlot(compartment, contextId);
+	Compartment::ContextSlot& slot   = compartment->contextSlots[contextId];
+	ContextRuntimeData* runtimeData = &compartment->runtimeData->contexts[contextId];
+	if(!slot.isRuntimeDataCommitted.load(std::memory_order_acquire))
+	{
+		errorUnless(Platform::commitVirtualPages(
+			(U8*)runtimeData, sizeof(ContextRuntimeData) >> Platform::getPageSizeLog2()));
+		slot.isRuntimeDataCommitted.store(true, std::memory_order_release);
+	}
+
+	Context* context     = new Context(compartment);
+	context->id          = contextId;
+	context->runtimeData = runtimeData;
+
+	// Publish the context in its slot before copying the initial global data, so a concurrent
+	// createGlobal either sees the context or changes the initial data before it is copied.
+	Uptr numContextSlots = compartment->numContextSlots.load();
+	while(numContextSlots <= contextId
+		  && !compartment->numContextSlots.compare_exchange_weak(numContextSlots, contextId + 1))
+	{
+	}
+	slot.context.store(context);
+
+	// Initialize the context's global data.
+	initContextGlobalData(context);
 
 	return context;
 }
 
 void Runtime::Context::finalize()
 {
-	Lock<Platform::Mutex> compartmentLock(compartment->mutex);
-	compartment->contexts[id] = nullptr;
+	compartment->contextSlots[id].context.store(nullptr);
+	compartment->contextIdAllocator.free(id);
 }
 
+void Runtime::resetContext(Context* context) { initContextGlobalData(context); }
+
 Compartment* Runtime::getCompartmentFromContext(Context* context) { return context->compartment; }
 
 Context* Runtime::cloneContext(Context* context, Compartment* newCompartment)
@@ -301,13 +537,68 @@ Context* Runtime::cloneContext(Context* context, Compartment* newCompartment)
 	return clonedContext;
 }
 
+struct Runtime::ContextPool
+{
+	Compartment* compartment;
+	Uptr maxPooledContexts;
+
+	Platform::Mutex mutex;
+	std::vector<Context*> contexts;
+};
+
+ContextPool* Runtime::createContextPool(Compartment* compartment, Uptr maxPooledContexts)
+{
+	ContextPool* pool        = new ContextPool;
+	pool->compartment        = compartment;
+	pool->maxPooledContexts  = maxPooledContexts;
+	addGCRoot(compartment);
+	return pool;
+}
+
+void Runtime::destroyContextPool(ContextPool* pool)
+{
+	for(Context* context : pool->contexts) { removeGCRoot(context); }
+	removeGCRoot(pool->compartment);
+	delete pool;
+}
+
+Context* Runtime::acquireContext(ContextPool* pool)
+{
+	{
+		Lock<Platform::Mutex> poolLock(pool->mutex);
+		if(pool->contexts.size())
+		{
+			Context* context = pool->contexts.back();
+			pool->contexts.pop_back();
+			removeGCRoot(context);
+			return context;
+		}
+	}
+
+	return createContext(pool->compartment);
+}
+
+void Runtime::releaseContext(ContextPool* pool, Context* context)
+{
+	wavmAssert(context->compartment == pool->compartment);
+	resetContext(context);
+
+	// If the pool is full, leave the context for the garbage collector to free.
+	Lock<Platform::Mutex> poolLock(pool->mutex);
+	if(pool->contexts.size() < pool->maxPooledContexts)
+	{
+		addGCRoot(context);
+		pool->contexts.push_back(context);
+	}
+}
+
 Context* Runtime::getContextFromRuntimeData(ContextRuntimeData* contextRuntimeData)
 {
 	const CompartmentRuntimeData* compartmentRuntimeData
 		= getCompartmentRuntimeData(contextRuntimeData);
 	const Uptr contextId = contextRuntimeData - compartmentRuntimeData->contexts;
-	Lock<Platform::Mutex> compartmentLock(compartmentRuntimeData->compartment->mutex);
-	return compartmentRuntimeData->compartment->contexts[contextId];
+	return compartmentRuntimeData->compartment->contextSlots[contextId].context.load(
+		std::memory_order_acquire);
 }
 
 ContextRuntimeData* Runtime::getContextRuntimeData(Context* context)
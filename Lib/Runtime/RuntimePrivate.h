@@ -1,7 +1,10 @@
 #pragma once
 
+#include "IR/Module.h"
 #include "Inline/BasicTypes.h"
 #include "Inline/HashMap.h"
+#include "Inline/HashSet.h"
+#include "Inline/IndexAllocator.h"
 #include "Runtime/Intrinsics.h"
 #include "Runtime/Runtime.h"
 
@@ -25,22 +28,70 @@ namespace LLVMJIT
 	struct JITModuleBase
 	{
 		virtual ~JITModuleBase() {}
+
+		// Returns the number of bytes allocated for the module's code and data.
+		virtual Uptr getNumCodeBytes() const = 0;
+		virtual Uptr getNumDataBytes() const = 0;
 	};
 
-	void instantiateModule(const IR::Module& module, Runtime::ModuleInstance* moduleInstance);
+	// Compiles a module to an object file that may be loaded for any number of instances of the
+	// module. Calls to the function imports with a non-null element in inlinedFunctionImports call
+	// the intrinsic function's bitcode body instead of the import. The function definitions with a
+	// true element in interpretedFunctionDefs are compiled to stubs that call the interpreter. If
+	// inlineFunctionDefs is true, calls between the function definitions may be inlined.
+	std::vector<U8> compileModule(
+		const IR::Module& module,
+		const std::vector<std::string>& functionDefNames,
+		const std::vector<const Intrinsics::Function*>& inlinedFunctionImports,
+		const std::vector<bool>& interpretedFunctionDefs,
+		bool inlineFunctionDefs);
+
+	// Loads an object file created by compileModule for a module instance. This does a full
+	// RuntimeDyld load of the object for every instance: the code is copied into new memory and
+	// relocated to refer to the instance's objects, so instances don't share machine code.
+	void loadModule(const std::vector<U8>& objectCode, Runtime::ModuleInstance* moduleInstance);
 	bool describeInstructionPointer(Uptr ip, std::string& outDescription);
 
-	typedef Runtime::ContextRuntimeData* (*InvokeFunctionPointer)(void*,
-																  Runtime::ContextRuntimeData*);
+	typedef Runtime::InvokeThunkPointer InvokeFunctionPointer;
 
 	// Generates an invoke thunk for a specific function type.
 	InvokeFunctionPointer getInvokeThunk(IR::FunctionType functionType,
 										 Runtime::CallingConvention callingConvention);
 
-	// Generates a thunk to call a native function from generated code.
+	typedef Runtime::ContextRuntimeData* (*InvokeBatchFunctionPointer)(
+		void*,
+		Runtime::ContextRuntimeData*,
+		const IR::UntaggedValue* arguments,
+		IR::UntaggedValue* results,
+		U64 numInvokes,
+		volatile U64* outNumCompletedInvokes);
+
+	// Generates a thunk that invokes a function of a specific type once for each tuple in an array
+	// of arguments, writing the number of completed invokes to outNumCompletedInvokes before each
+	// invoke.
+	InvokeBatchFunctionPointer getInvokeBatchThunk(IR::FunctionType functionType,
+												   Runtime::CallingConvention callingConvention);
+
+	// Generates a thunk to call a native function from generated code. Native functions with the
+	// intrinsicWithMemAndTable calling convention are passed the given default memory and table
+	// IDs.
 	void* getIntrinsicThunk(void* nativeFunction,
 							IR::FunctionType functionType,
-							Runtime::CallingConvention callingConvention);
+							Runtime::CallingConvention callingConvention,
+							I64 defaultMemoryId = -1,
+							I64 defaultTableId  = -1);
+}
+
+namespace Interpreter
+{
+	// The threaded code the interpreter translates a function definition to.
+	struct FunctionCode;
+
+	// Returns whether the interpreter supports all the operators and types used by a function
+	// definition.
+	bool canInterpretFunction(const IR::Module& module, const IR::FunctionDef& functionDef);
+
+	void freeFunctionCode(FunctionCode* functionCode);
 }
 
 namespace Runtime
@@ -52,7 +103,16 @@ namespace Runtime
 	{
 		std::atomic<Uptr> numRootReferences;
 
-		ObjectImpl(ObjectKind inKind);
+		// If non-null, the object whose lifetime this object shares. Objects with an owner aren't
+		// registered with the garbage collector: references to them are treated as references to
+		// their owner, and the owner is responsible for deleting them.
+		ObjectImpl* const owner;
+
+		// Registers the object with the garbage collector. If the object is owned by a compartment,
+		// it will be added to the compartment's object set; otherwise it will be added to the
+		// global set. The object is initially added to a list of new objects for the calling
+		// thread, so registration doesn't contend with other threads creating objects.
+		ObjectImpl(ObjectKind inKind, Compartment* inCompartment, ObjectImpl* inOwner = nullptr);
 
 		// Called on all objects that are about to be deleted before any of them are deleted.
 		virtual void finalize() {}
@@ -72,15 +132,7 @@ namespace Runtime
 						 FunctionType inType,
 						 void* inNativeFunction,
 						 CallingConvention inCallingConvention,
-						 std::string&& inDebugName)
-		: ObjectImpl(ObjectKind::function)
-		, moduleInstance(inModuleInstance)
-		, type(inType)
-		, nativeFunction(inNativeFunction)
-		, callingConvention(inCallingConvention)
-		, debugName(std::move(inDebugName))
-		{
-		}
+						 std::string&& inDebugName);
 	};
 
 	// An instance of a WebAssembly Table.
@@ -105,7 +157,7 @@ namespace Runtime
 		std::vector<Object*> elements;
 
 		TableInstance(Compartment* inCompartment, const TableType& inType)
-		: ObjectImpl(ObjectKind::table)
+		: ObjectImpl(ObjectKind::table, inCompartment)
 		, compartment(inCompartment)
 		, id(UINTPTR_MAX)
 		, type(inType)
@@ -130,7 +182,7 @@ namespace Runtime
 		Uptr endOffset;
 
 		MemoryInstance(Compartment* inCompartment, const MemoryType& inType)
-		: ObjectImpl(ObjectKind::memory)
+		: ObjectImpl(ObjectKind::memory, inCompartment)
 		, compartment(inCompartment)
 		, id(UINTPTR_MAX)
 		, type(inType)
@@ -157,7 +209,7 @@ namespace Runtime
 					   GlobalType inType,
 					   U32 inMutableDataOffset,
 					   UntaggedValue inInitialValue)
-		: ObjectImpl(ObjectKind::global)
+		: ObjectImpl(ObjectKind::global, inCompartment)
 		, compartment(inCompartment)
 		, id(UINTPTR_MAX)
 		, type(inType)
@@ -187,13 +239,58 @@ namespace Runtime
 		std::string debugName;
 
 		ExceptionTypeInstance(ExceptionType inType, std::string&& inDebugName)
-		: ObjectImpl(ObjectKind::exceptionTypeInstance)
+		: ObjectImpl(ObjectKind::exceptionTypeInstance, nullptr)
 		, type(inType)
 		, debugName(std::move(inDebugName))
 		{
 		}
 	};
 
+	// The initial contents of a memory defined by a module, built from its data segments. The
+	// platform pages touched by the data segments are stored in a MappableImage that is mapped
+	// copy-on-write into each instance of the memory, so instances share the physical pages until
+	// they write to them.
+	struct MemoryImage
+	{
+		// A range of consecutive platform pages in the memory, and where they are in the image.
+		struct Run
+		{
+			Uptr memoryPageIndex;
+			Uptr imagePageIndex;
+			Uptr numPages;
+		};
+
+		Platform::MappableImage* image = nullptr;
+		std::vector<Run> runs;
+	};
+
+	struct CompiledModule
+	{
+		IR::Module module;
+
+		// The debug names of the module's function definitions.
+		std::vector<std::string> functionDefNames;
+
+		// For each function import, either null or the intrinsic function whose bitcode body was
+		// inlined into the compiled code in place of calls to the import.
+		std::vector<const Intrinsics::Function*> inlinedFunctionImports;
+
+		// The object file generated by LLVMJIT::compileModule.
+		std::vector<U8> objectCode;
+
+		// The images for the module's memory definitions. If a memory definition's image is null,
+		// its data segments are copied into each instance of the memory.
+		std::vector<MemoryImage> memoryDefImages;
+
+		// Which of the module's function definitions are executed by the interpreter, and the
+		// threaded code for those that have been translated. The threaded code is translated the
+		// first time a function is called, and shared by all instances of the module.
+		std::vector<bool> interpretedFunctionDefs;
+		mutable std::vector<std::atomic<Interpreter::FunctionCode*>> interpreterFunctionCode;
+
+		~CompiledModule();
+	};
+
 	// An instance of a WebAssembly module.
 	struct ModuleInstance : ObjectImpl
 	{
@@ -201,9 +298,27 @@ namespace Runtime
 
 		HashMap<std::string, Object*> exportMap;
 
-		std::vector<FunctionInstance*> functionDefs;
+		// The compiled module this is an instance of. Null for intrinsic module instances.
+		CompiledModuleRef compiledModule;
 
+		// The FunctionInstances for the module's function definitions are allocated in a single
+		// block owned by the ModuleInstance, and aren't individually registered with the garbage
+		// collector.
+		FunctionInstance* functionDefBlock;
+
+		// The module's function imports, followed by its function definitions. The
+		// FunctionInstances for function definitions are constructed in functionDefBlock on demand
+		// by getFunctionInstance, so the entries for definitions may be null.
+		Platform::Mutex functionsMutex;
 		std::vector<FunctionInstance*> functions;
+
+		// The native code for each of the module's function definitions.
+		std::vector<void*> functionDefCode;
+
+		// The code to call for each of the module's function imports with the WASM calling
+		// convention.
+		std::vector<void*> functionImportCode;
+
 		std::vector<TableInstance*> tables;
 		std::vector<MemoryInstance*> memories;
 		std::vector<GlobalInstance*> globals;
@@ -224,8 +339,9 @@ namespace Runtime
 					   std::vector<GlobalInstance*>&& inGlobalImports,
 					   std::vector<ExceptionTypeInstance*>&& inExceptionTypeInstanceImports,
 					   std::string&& inDebugName)
-		: ObjectImpl(ObjectKind::module)
+		: ObjectImpl(ObjectKind::module, inCompartment)
 		, compartment(inCompartment)
+		, functionDefBlock(nullptr)
 		, functions(inFunctionImports)
 		, tables(inTableImports)
 		, memories(inMemoryImports)
@@ -249,7 +365,7 @@ namespace Runtime
 		struct ContextRuntimeData* runtimeData;
 
 		Context(Compartment* inCompartment)
-		: ObjectImpl(ObjectKind::context)
+		: ObjectImpl(ObjectKind::context, inCompartment)
 		, compartment(inCompartment)
 		, id(UINTPTR_MAX)
 		, runtimeData(nullptr)
@@ -275,35 +391,17 @@ namespace Runtime
 				  "maxThunkArgAndReturnBytes must be large enough to hold IR::maxReturnValues * "
 				  "sizeof(UntaggedValue)");
 
-	struct Compartment : ObjectImpl
-	{
-		Platform::Mutex mutex;
-
-		struct CompartmentRuntimeData* runtimeData;
-		U8* unalignedRuntimeData;
-		std::atomic<U32> numGlobalBytes;
-
-		// These are weak references that aren't followed by the garbage collector.
-		// If the referenced object is deleted, it will null the reference here.
-		std::vector<GlobalInstance*> globals;
-		std::vector<MemoryInstance*> memories;
-		std::vector<TableInstance*> tables;
-		std::vector<Context*> contexts;
-
-		U8 initialContextGlobalData[maxGlobalBytes];
-
-		ModuleInstance* wavmIntrinsics;
-
-		Compartment();
-		~Compartment() override;
-	};
-
 	struct ContextRuntimeData
 	{
 		U8 thunkArgAndReturnData[maxThunkArgAndReturnBytes];
 		U8 globalData[maxGlobalBytes];
 	};
 
+	// Intrinsics.h and TypedFunction.h assume that the invoke thunk arguments and results are at
+	// the start of ContextRuntimeData.
+	static_assert(offsetof(ContextRuntimeData, thunkArgAndReturnData) == 0,
+				  "thunkArgAndReturnData must be at the start of ContextRuntimeData");
+
 	struct CompartmentRuntimeData
 	{
 		Compartment* compartment;
@@ -326,6 +424,60 @@ namespace Runtime
 					  == 4ull * 1024 * 1024 * 1024,
 				  "CompartmentRuntimeData isn't the expected size");
 
+	struct Compartment : ObjectImpl
+	{
+		Platform::Mutex mutex;
+
+		struct CompartmentRuntimeData* runtimeData;
+		U8* unalignedRuntimeData;
+		std::atomic<U32> numGlobalBytes;
+
+		// These are weak references that aren't followed by the garbage collector.
+		// If the referenced object is deleted, it will null the reference here.
+		std::vector<GlobalInstance*> globals;
+		std::vector<MemoryInstance*> memories;
+		std::vector<TableInstance*> tables;
+
+		// The compartment's contexts, indexed by context ID. The array has room for maxContexts
+		// slots. Its pages are committed as context IDs reach them, which is the only time
+		// creating a context locks the compartment's mutex. A context's runtime data is committed
+		// the first time its ID is allocated, and stays committed when it is freed.
+		struct ContextSlot
+		{
+			std::atomic<Context*> context;
+			std::atomic<bool> isRuntimeDataCommitted;
+		};
+		ContextSlot* contextSlots;
+		std::atomic<Uptr> numCommittedContextSlotPages;
+		std::atomic<Uptr> numContextSlots;
+		ConcurrentIndexAllocator<maxContexts> contextIdAllocator;
+
+		// The global data used to initialize new contexts. initialContextGlobalDataVersion is
+		// incremented before and after it is changed, so it may be copied without locking mutex.
+		U8 initialContextGlobalData[maxGlobalBytes];
+		std::atomic<U32> initialContextGlobalDataVersion;
+
+		ModuleInstance* wavmIntrinsics;
+
+		// The objects owned by this compartment. collectCompartmentGarbage only scans these
+		// objects, so its pause time is proportional to the size of the compartment.
+		Platform::Mutex objectsMutex;
+		HashSet<ObjectImpl*> objects;
+
+		// Counters for getStatistics. They are updated with relaxed atomic operations.
+		std::atomic<U64> numInvokes;
+		std::atomic<U64> numGrowMemoryCalls;
+		std::atomic<U64> gcPauseMicroseconds;
+
+		// The number of runtime exceptions raised by invokes in the compartment, by exception
+		// type name. Runtime exceptions are rare enough that a mutex is fine here.
+		Platform::Mutex trapCountsMutex;
+		HashMap<std::string, U64> numTrapsByExceptionType;
+
+		Compartment();
+		~Compartment() override;
+	};
+
 	inline CompartmentRuntimeData* getCompartmentRuntimeData(ContextRuntimeData* contextRuntimeData)
 	{
 		return reinterpret_cast<CompartmentRuntimeData*>(reinterpret_cast<Uptr>(contextRuntimeData)
@@ -339,6 +491,42 @@ namespace Runtime
 	// Initializes global state used by the WAVM intrinsics.
 	Runtime::ModuleInstance* instantiateWAVMIntrinsics(Compartment* compartment);
 
+	// Compiles a module, inlining the bitcode bodies of intrinsic functions in place of calls to
+	// the function imports that have a non-null element in inlinedFunctionImports.
+	CompiledModuleRef compileModule(
+		const IR::Module& module,
+		std::vector<const Intrinsics::Function*>&& inlinedFunctionImports,
+		const CompileOptions& options = CompileOptions());
+
+	// Returns the FunctionInstance for a function in a module instance, creating it if it is a
+	// function definition that hasn't been referenced before.
+	FunctionInstance* getFunctionInstance(ModuleInstance* moduleInstance, Uptr functionIndex);
+
+	// Sets a range of table elements to the given functions, locking the table only once.
+	// Throws an accessViolation exception if the range isn't within the table's bounds.
+	void setTableElements(TableInstance* table,
+						  Uptr baseIndex,
+						  FunctionInstance* const* functions,
+						  Uptr numFunctions);
+
+	// The compartment of the innermost invoke on the calling thread, or null if the thread isn't
+	// executing an invoke. Used to attribute runtime exceptions to compartments.
+	extern thread_local Compartment* currentInvokeCompartment;
+
+	// Counts a runtime exception raised by an invoke in currentInvokeCompartment.
+	void countTrap(ExceptionTypeInstance* typeInstance);
+
+	// Calls visitObject for each garbage-collected object owned by a compartment, with the
+	// compartment's objectsMutex locked.
+	void visitCompartmentObjects(Compartment* compartment,
+								 const std::function<void(ObjectImpl*)>& visitObject);
+
+	// Waits on or wakes threads waiting on an address with the semantics of the atomic.wait and
+	// atomic.wake operators. The caller must check that the address is naturally aligned.
+	U32 waitOnAddress(I32* valuePointer, I32 expectedValue, F64 timeout);
+	U32 waitOnAddress(I64* valuePointer, I64 expectedValue, F64 timeout);
+	U32 wakeAddress(Uptr address, U32 numToWake);
+
 	// Checks whether an address is owned by a table or memory.
 	bool isAddressOwnedByTable(U8* address);
 	bool isAddressOwnedByMemory(U8* address);
@@ -4,6 +4,9 @@
 #include "Runtime.h"
 #include "RuntimePrivate.h"
 
+#include <string.h>
+#include <algorithm>
+
 using namespace Runtime;
 
 // Global lists of tables; used to query whether an address is reserved by one of them.
@@ -138,11 +141,11 @@ bool Runtime::isAddressOwnedByTable(U8* address)
 	return false;
 }
 
-Object* Runtime::setTableElement(TableInstance* table, Uptr index, Object* newValue)
+// Returns the indirect function call data for a function.
+static TableInstance::FunctionElement getFunctionElement(FunctionInstance* functionInstance)
 {
-	// Look up the new function's code pointer.
-	FunctionInstance* functionInstance = asFunction(newValue);
-	void* nativeFunction               = functionInstance->nativeFunction;
+	// Look up the function's code pointer.
+	void* nativeFunction = functionInstance->nativeFunction;
 	wavmAssert(nativeFunction);
 
 	// If the function isn't a WASM function, generate a thunk for it.
@@ -152,6 +155,16 @@ Object* Runtime::setTableElement(TableInstance* table, Uptr index, Object* newVa
 			nativeFunction, functionInstance->type, functionInstance->callingConvention);
 	}
 
+	TableInstance::FunctionElement functionElement;
+	functionElement.typeEncoding = functionInstance->type.getEncoding();
+	functionElement.value        = nativeFunction;
+	return functionElement;
+}
+
+Object* Runtime::setTableElement(TableInstance* table, Uptr index, Object* newValue)
+{
+	const TableInstance::FunctionElement functionElement = getFunctionElement(asFunction(newValue));
+
 	// Lock the table's elements array.
 	Lock<Platform::Mutex> elementsLock(table->elementsMutex);
 
@@ -164,14 +177,42 @@ Object* Runtime::setTableElement(TableInstance* table, Uptr index, Object* newVa
 
 	// Write the new table element to both the table's elements array and its indirect function call
 	// data.
-	table->baseAddress[saturatedIndex].typeEncoding = functionInstance->type.getEncoding();
-	table->baseAddress[saturatedIndex].value        = nativeFunction;
+	table->baseAddress[saturatedIndex] = functionElement;
 
 	auto oldValue                   = table->elements[saturatedIndex];
 	table->elements[saturatedIndex] = newValue;
 	return oldValue;
 }
 
+void Runtime::setTableElements(TableInstance* table,
+							   Uptr baseIndex,
+							   FunctionInstance* const* functions,
+							   Uptr numFunctions)
+{
+	// Build the indirect function call data for the functions before locking the table.
+	std::vector<TableInstance::FunctionElement> functionElements;
+	functionElements.reserve(numFunctions);
+	for(Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex)
+	{ functionElements.push_back(getFunctionElement(functions[functionIndex])); }
+
+	// Lock the table's elements array.
+	Lock<Platform::Mutex> elementsLock(table->elementsMutex);
+
+	// Verify the range is within the table's bounds.
+	if(baseIndex > table->elements.size() || table->elements.size() - baseIndex < numFunctions)
+	{ throwException(Exception::accessViolationType); }
+
+	// Copy the new table elements to both the table's elements array and its indirect function call
+	// data.
+	if(numFunctions)
+	{
+		memcpy(table->baseAddress + baseIndex,
+			   functionElements.data(),
+			   numFunctions * sizeof(TableInstance::FunctionElement));
+		std::copy(functions, functions + numFunctions, table->elements.begin() + baseIndex);
+	}
+}
+
 Object* Runtime::getTableElement(TableInstance* table, Uptr index)
 {
 	// Verify the index is within the table's bounds.
@@ -5,8 +5,6 @@
 #include "Logging/Logging.h"
 #include "RuntimePrivate.h"
 
-#include <math.h>
-
 using namespace Runtime;
 
 namespace Runtime
@@ -14,158 +12,85 @@ namespace Runtime
 	DEFINE_INTRINSIC_MODULE(wavmIntrinsics)
 }
 
-template<typename Float> Float quietNaN(Float value)
-{
-	Floats::FloatComponents<Float> components;
-	components.value = value;
-	components.bits.significand |= typename Floats::FloatComponents<Float>::Bits(1)
-								   << (Floats::FloatComponents<Float>::numSignificandBits - 1);
-	return components.value;
-}
-
-template<typename Float> Float floatMin(Float left, Float right)
-{
-	// If either operand is a NaN, convert it to a quiet NaN and return it.
-	if(left != left) { return quietNaN(left); }
-	else if(right != right)
-	{
-		return quietNaN(right);
-	}
-	// If either operand is less than the other, return it.
-	else if(left < right)
-	{
-		return left;
-	}
-	else if(right < left)
-	{
-		return right;
-	}
-	else
-	{
-		// Finally, if the operands are apparently equal, compare their integer values to
-		// distinguish -0.0 from +0.0
-		Floats::FloatComponents<Float> leftComponents;
-		leftComponents.value = left;
-		Floats::FloatComponents<Float> rightComponents;
-		rightComponents.value = right;
-		return leftComponents.bitcastInt < rightComponents.bitcastInt ? right : left;
-	}
-}
-
-template<typename Float> Float floatMax(Float left, Float right)
-{
-	// If either operand is a NaN, convert it to a quiet NaN and return it.
-	if(left != left) { return quietNaN(left); }
-	else if(right != right)
-	{
-		return quietNaN(right);
-	}
-	// If either operand is less than the other, return it.
-	else if(left > right)
-	{
-		return left;
-	}
-	else if(right > left)
-	{
-		return right;
-	}
-	else
-	{
-		// Finally, if the operands are apparently equal, compare their integer values to
-		// distinguish -0.0 from +0.0
-		Floats::FloatComponents<Float> leftComponents;
-		leftComponents.value = left;
-		Floats::FloatComponents<Float> rightComponents;
-		rightComponents.value = right;
-		return leftComponents.bitcastInt > rightComponents.bitcastInt ? right : left;
-	}
-}
-
-template<typename Float> Float floatCeil(Float value)
-{
-	if(value != value) { return quietNaN(value); }
-	else
-	{
-		return ceil(value);
-	}
-}
-
-template<typename Float> Float floatFloor(Float value)
-{
-	if(value != value) { return quietNaN(value); }
-	else
-	{
-		return floor(value);
-	}
-}
-
-template<typename Float> Float floatTrunc(Float value)
-{
-	if(value != value) { return quietNaN(value); }
-	else
-	{
-		return trunc(value);
-	}
-}
-
-template<typename Float> Float floatNearest(Float value)
-{
-	if(value != value) { return quietNaN(value); }
-	else
-	{
-		return nearbyint(value);
-	}
-}
-
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.min", F32, f32Min, F32 left, F32 right)
 {
-	return floatMin(left, right);
+	return Floats::floatMin(left, right);
 }
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.min", F64, f64Min, F64 left, F64 right)
 {
-	return floatMin(left, right);
+	return Floats::floatMin(left, right);
 }
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.max", F32, f32Max, F32 left, F32 right)
 {
-	return floatMax(left, right);
+	return Floats::floatMax(left, right);
 }
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.max", F64, f64Max, F64 left, F64 right)
 {
-	return floatMax(left, right);
-}
+	return Floats::floatMax(left, right);
+}
+
+// Defines the LLVM assembly body of a float rounding intrinsic, so the JIT may inline it instead of
+// calling the native function. Like Floats::quietNaN, a NaN input is returned with its quiet bit
+// set.
+#define DEFINE_FLOAT_ROUNDING_LLVM_IR(cName, name, type, intType, quietBit, intrinsic)             \
+	static const char cName##LLVMIR[]                                                              \
+		= "define " type " @\"" name "\"(i8* %context, " type " %value) {\n"                       \
+		  "  %bits = bitcast " type " %value to " intType "\n"                                     \
+		  "  %quietBits = or " intType " %bits, " quietBit "\n"                                    \
+		  "  %quietNaN = bitcast " intType " %quietBits to " type "\n"                             \
+		  "  %rounded = call " type " @" intrinsic "(" type " %value)\n"                           \
+		  "  %isNaN = fcmp uno " type " %value, %value\n"                                          \
+		  "  %result = select i1 %isNaN, " type " %quietNaN, " type " %rounded\n"                  \
+		  "  ret " type " %result\n"                                                               \
+		  "}\n"                                                                                    \
+		  "declare " type " @" intrinsic "(" type ")\n";                                           \
+	DEFINE_INTRINSIC_FUNCTION_BITCODE(cName, cName##LLVMIR)
+
+#define DEFINE_F32_ROUNDING_LLVM_IR(cName, name, intrinsic)                                        \
+	DEFINE_FLOAT_ROUNDING_LLVM_IR(cName, name, "float", "i32", "4194304", intrinsic)
+#define DEFINE_F64_ROUNDING_LLVM_IR(cName, name, intrinsic)                                        \
+	DEFINE_FLOAT_ROUNDING_LLVM_IR(cName, name, "double", "i64", "2251799813685248", intrinsic)
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.ceil", F32, f32Ceil, F32 value)
 {
-	return floatCeil(value);
+	return Floats::floatCeil(value);
 }
+DEFINE_F32_ROUNDING_LLVM_IR(f32Ceil, "f32.ceil", "llvm.ceil.f32")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.ceil", F64, f64Ceil, F64 value)
 {
-	return floatCeil(value);
+	return Floats::floatCeil(value);
 }
+DEFINE_F64_ROUNDING_LLVM_IR(f64Ceil, "f64.ceil", "llvm.ceil.f64")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.floor", F32, f32Floor, F32 value)
 {
-	return floatFloor(value);
+	return Floats::floatFloor(value);
 }
+DEFINE_F32_ROUNDING_LLVM_IR(f32Floor, "f32.floor", "llvm.floor.f32")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.floor", F64, f64Floor, F64 value)
 {
-	return floatFloor(value);
+	return Floats::floatFloor(value);
 }
+DEFINE_F64_ROUNDING_LLVM_IR(f64Floor, "f64.floor", "llvm.floor.f64")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.trunc", F32, f32Trunc, F32 value)
 {
-	return floatTrunc(value);
+	return Floats::floatTrunc(value);
 }
+DEFINE_F32_ROUNDING_LLVM_IR(f32Trunc, "f32.trunc", "llvm.trunc.f32")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.trunc", F64, f64Trunc, F64 value)
 {
-	return floatTrunc(value);
+	return Floats::floatTrunc(value);
 }
+DEFINE_F64_ROUNDING_LLVM_IR(f64Trunc, "f64.trunc", "llvm.trunc.f64")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f32.nearest", F32, f32Nearest, F32 value)
 {
-	return floatNearest(value);
+	return Floats::floatNearest(value);
 }
+DEFINE_F32_ROUNDING_LLVM_IR(f32Nearest, "f32.nearest", "llvm.nearbyint.f32")
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "f64.nearest", F64, f64Nearest, F64 value)
 {
-	return floatNearest(value);
+	return Floats::floatNearest(value);
 }
+DEFINE_F64_ROUNDING_LLVM_IR(f64Nearest, "f64.nearest", "llvm.nearbyint.f64")
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics,
 						  "divideByZeroOrIntegerOverflowTrap",
@@ -235,6 +160,7 @@ DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics,
 {
 	MemoryInstance* memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
 	wavmAssert(memory);
+	memory->compartment->numGrowMemoryCalls.fetch_add(1, std::memory_order_relaxed);
 	if(getMemoryNumPages(memory) + Uptr(deltaPages) > IR::maxMemoryPages) { return -1; }
 	const Iptr numPreviousMemoryPages = growMemory(memory, (Uptr)deltaPages);
 	wavmAssert(numPreviousMemoryPages < INT32_MAX);
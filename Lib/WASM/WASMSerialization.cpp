@@ -3,6 +3,7 @@
 #include "IR/Types.h"
 #include "IR/Validate.h"
 #include "Inline/BasicTypes.h"
+#include "Inline/Parallel.h"
 #include "Inline/Serialization.h"
 #include "Inline/Unicode.h"
 #include "WASM.h"
@@ -268,9 +269,16 @@ static void serialize(OutputStream& stream, SectionType sectionType)
 	*stream.advance(1) = serializedSectionId;
 }
 
-template<typename Stream> void serialize(Stream& stream, NoImm&, const FunctionDef&) {}
+// The function that an operator's immediates are serialized for, and the module that contains it.
+struct FunctionContext
+{
+	Module& module;
+	FunctionDef& functionDef;
+};
 
-static void serialize(InputStream& stream, ControlStructureImm& imm, const FunctionDef&)
+template<typename Stream> void serialize(Stream& stream, NoImm&, const FunctionContext&) {}
+
+static void serialize(InputStream& stream, ControlStructureImm& imm, const FunctionContext&)
 {
 	Iptr encodedBlockType;
 	serializeVarInt32(stream, encodedBlockType);
@@ -291,7 +299,7 @@ static void serialize(InputStream& stream, ControlStructureImm& imm, const Funct
 	}
 }
 
-static void serialize(OutputStream& stream, const ControlStructureImm& imm, const FunctionDef&)
+static void serialize(OutputStream& stream, const ControlStructureImm& imm, const FunctionContext&)
 {
 	Iptr encodedBlockType;
 	switch(imm.type.format)
@@ -304,65 +312,68 @@ static void serialize(OutputStream& stream, const ControlStructureImm& imm, cons
 	serializeVarInt32(stream, encodedBlockType);
 }
 
-template<typename Stream> void serialize(Stream& stream, BranchImm& imm, const FunctionDef&)
+template<typename Stream> void serialize(Stream& stream, BranchImm& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.targetDepth);
 }
 
-static void serialize(InputStream& stream, BranchTableImm& imm, FunctionDef& functionDef)
+static void serialize(InputStream& stream, BranchTableImm& imm, const FunctionContext& function)
 {
 	std::vector<U32> branchTable;
 	serializeArray(stream, branchTable, [](InputStream& stream, U32& targetDepth) {
 		serializeVarUInt32(stream, targetDepth);
 	});
-	imm.branchTableIndex = functionDef.branchTables.size();
-	functionDef.branchTables.push_back(std::move(branchTable));
+	imm.branchTableIndex = function.functionDef.branchTables.size();
+	function.functionDef.branchTables.push_back(function.module.arena->copyArray(branchTable));
 	serializeVarUInt32(stream, imm.defaultTargetDepth);
 }
-static void serialize(OutputStream& stream, BranchTableImm& imm, FunctionDef& functionDef)
+static void serialize(OutputStream& stream, BranchTableImm& imm, const FunctionContext& function)
 {
-	wavmAssert(imm.branchTableIndex < functionDef.branchTables.size());
-	std::vector<U32>& branchTable = functionDef.branchTables[imm.branchTableIndex];
-	serializeArray(stream, branchTable, [](OutputStream& stream, U32& targetDepth) {
-		serializeVarUInt32(stream, targetDepth);
-	});
+	wavmAssert(imm.branchTableIndex < function.functionDef.branchTables.size());
+	const ArenaArray<U32>& branchTable = function.functionDef.branchTables[imm.branchTableIndex];
+	Uptr numTargetDepths               = branchTable.size();
+	serializeVarUInt32(stream, numTargetDepths);
+	for(U32 targetDepth : branchTable) { serializeVarUInt32(stream, targetDepth); }
 	serializeVarUInt32(stream, imm.defaultTargetDepth);
 }
 
-template<typename Stream> void serialize(Stream& stream, LiteralImm<I32>& imm, const FunctionDef&)
+template<typename Stream>
+void serialize(Stream& stream, LiteralImm<I32>& imm, const FunctionContext&)
 {
 	serializeVarInt32(stream, imm.value);
 }
 
-template<typename Stream> void serialize(Stream& stream, LiteralImm<I64>& imm, const FunctionDef&)
+template<typename Stream>
+void serialize(Stream& stream, LiteralImm<I64>& imm, const FunctionContext&)
 {
 	serializeVarInt64(stream, imm.value);
 }
 
 template<typename Stream, bool isGlobal>
-void serialize(Stream& stream, GetOrSetVariableImm<isGlobal>& imm, const FunctionDef&)
+void serialize(Stream& stream, GetOrSetVariableImm<isGlobal>& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.variableIndex);
 }
 
-template<typename Stream> void serialize(Stream& stream, CallImm& imm, const FunctionDef&)
+template<typename Stream> void serialize(Stream& stream, CallImm& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.functionIndex);
 }
 
-template<typename Stream> void serialize(Stream& stream, CallIndirectImm& imm, const FunctionDef&)
+template<typename Stream>
+void serialize(Stream& stream, CallIndirectImm& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.type.index);
 	serializeConstant(stream, "call_indirect immediate reserved field must be 0", U8(0));
 }
 
 template<typename Stream, Uptr naturalAlignmentLog2>
-void serialize(Stream& stream, LoadOrStoreImm<naturalAlignmentLog2>& imm, const FunctionDef&)
+void serialize(Stream& stream, LoadOrStoreImm<naturalAlignmentLog2>& imm, const FunctionContext&)
 {
 	serializeVarUInt7(stream, imm.alignmentLog2);
 	serializeVarUInt32(stream, imm.offset);
 }
-template<typename Stream> void serialize(Stream& stream, MemoryImm& imm, const FunctionDef&)
+template<typename Stream> void serialize(Stream& stream, MemoryImm& imm, const FunctionContext&)
 {
 	serializeConstant(stream, "memory.grow/memory.size immediate reserved field must be 0", U8(0));
 }
@@ -373,37 +384,40 @@ template<typename Stream> void serialize(Stream& stream, V128& v128)
 }
 
 template<typename Stream, Uptr numLanes>
-void serialize(Stream& stream, LaneIndexImm<numLanes>& imm, const FunctionDef&)
+void serialize(Stream& stream, LaneIndexImm<numLanes>& imm, const FunctionContext&)
 {
 	serializeVarUInt7(stream, imm.laneIndex);
 }
 
 template<typename Stream, Uptr numLanes>
-void serialize(Stream& stream, ShuffleImm<numLanes>& imm, const FunctionDef&)
+void serialize(Stream& stream, ShuffleImm<numLanes>& imm, const FunctionContext&)
 {
 	for(Uptr laneIndex = 0; laneIndex < numLanes; ++laneIndex)
 	{ serializeVarUInt7(stream, imm.laneIndices[laneIndex]); }
 }
 
 template<typename Stream, Uptr naturalAlignmentLog2>
-void serialize(Stream& stream, AtomicLoadOrStoreImm<naturalAlignmentLog2>& imm, const FunctionDef&)
+void serialize(Stream& stream,
+			   AtomicLoadOrStoreImm<naturalAlignmentLog2>& imm,
+			   const FunctionContext&)
 {
 	serializeVarUInt7(stream, imm.alignmentLog2);
 	serializeVarUInt32(stream, imm.offset);
 }
 
-template<typename Stream> void serialize(Stream& stream, ExceptionTypeImm& imm, const FunctionDef&)
+template<typename Stream>
+void serialize(Stream& stream, ExceptionTypeImm& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.exceptionTypeIndex);
 }
 
-template<typename Stream> void serialize(Stream& stream, RethrowImm& imm, const FunctionDef&)
+template<typename Stream> void serialize(Stream& stream, RethrowImm& imm, const FunctionContext&)
 {
 	serializeVarUInt32(stream, imm.catchDepth);
 }
 
 template<typename Stream, typename Value>
-void serialize(Stream& stream, LiteralImm<Value>& imm, const FunctionDef&)
+void serialize(Stream& stream, LiteralImm<Value>& imm, const FunctionContext&)
 {
 	serialize(stream, imm.value);
 }
@@ -424,7 +438,8 @@ void serializeSection(InputStream& stream, SectionType type, SerializeSection se
 {
 	Uptr numSectionBytes = 0;
 	serializeVarUInt32(stream, numSectionBytes);
-	MemoryInputStream sectionStream(stream.advance(numSectionBytes), numSectionBytes);
+	MemoryInputStream sectionStream(
+		stream.advance(numSectionBytes), numSectionBytes, stream.getOwner());
 	serializeSectionBody(sectionStream);
 	if(sectionStream.capacity())
 	{ throw FatalSerializationException("section contained more data than expected"); }
@@ -445,11 +460,11 @@ static void serialize(InputStream& stream, UserSection& userSection)
 	Uptr numSectionBytes = 0;
 	serializeVarUInt32(stream, numSectionBytes);
 
-	MemoryInputStream sectionStream(stream.advance(numSectionBytes), numSectionBytes);
+	MemoryInputStream sectionStream(
+		stream.advance(numSectionBytes), numSectionBytes, stream.getOwner());
 	serialize(sectionStream, userSection.name);
 	throwIfNotValidUTF8(userSection.name);
-	userSection.data.resize(sectionStream.capacity());
-	serializeBytes(sectionStream, userSection.data.data(), userSection.data.size());
+	userSection.data = sectionStream.advanceShared(sectionStream.capacity());
 	wavmAssert(!sectionStream.capacity());
 }
 
@@ -469,8 +484,9 @@ struct OperatorSerializerStream
 {
 	typedef void Result;
 
-	OperatorSerializerStream(Serialization::OutputStream& inByteStream, FunctionDef& inFunctionDef)
-	: byteStream(inByteStream), functionDef(inFunctionDef)
+	OperatorSerializerStream(Serialization::OutputStream& inByteStream,
+							 const FunctionContext& inFunction)
+	: byteStream(inByteStream), function(inFunction)
 	{
 	}
 
@@ -479,7 +495,7 @@ struct OperatorSerializerStream
 	{                                                                                              \
 		Opcode opcode = Opcode::name;                                                              \
 		serializeOpcode(byteStream, opcode);                                                       \
-		serialize(byteStream, imm, functionDef);                                                   \
+		serialize(byteStream, imm, function);                                                      \
 	}
 	ENUM_OPERATORS(VISIT_OPCODE)
 #undef VISIT_OPCODE
@@ -488,12 +504,10 @@ struct OperatorSerializerStream
 
 private:
 	Serialization::OutputStream& byteStream;
-	FunctionDef& functionDef;
+	FunctionContext function;
 };
 
-static void serializeFunctionBody(OutputStream& sectionStream,
-								  Module& module,
-								  FunctionDef& functionDef)
+static std::vector<U8> encodeFunctionBody(Module& module, FunctionDef& functionDef)
 {
 	ArrayOutputStream bodyStream;
 
@@ -525,21 +539,18 @@ static void serializeFunctionBody(OutputStream& sectionStream,
 
 	// Serialize the function code.
 	OperatorDecoderStream irDecoderStream(functionDef.code);
-	OperatorSerializerStream wasmOpEncoderStream(bodyStream, functionDef);
+	OperatorSerializerStream wasmOpEncoderStream(bodyStream, {module, functionDef});
 	while(irDecoderStream) { irDecoderStream.decodeOp(wasmOpEncoderStream); };
 
-	std::vector<U8> bodyBytes = bodyStream.getBytes();
-	serialize(sectionStream, bodyBytes);
+	return bodyStream.getBytes();
 }
 
-static void serializeFunctionBody(InputStream& sectionStream,
-								  Module& module,
-								  FunctionDef& functionDef)
+static void decodeFunctionBody(const U8* bodyBytes,
+							   Uptr numBodyBytes,
+							   Module& module,
+							   FunctionDef& functionDef)
 {
-	Uptr numBodyBytes = 0;
-	serializeVarUInt32(sectionStream, numBodyBytes);
-
-	MemoryInputStream bodyStream(sectionStream.advance(numBodyBytes), numBodyBytes);
+	MemoryInputStream bodyStream(bodyBytes, numBodyBytes);
 
 	// Deserialize local sets and unpack them into a linear array of local types.
 	Uptr numLocalSets = 0;
@@ -550,14 +561,17 @@ static void serializeFunctionBody(InputStream& sectionStream,
 		serialize(bodyStream, localSet);
 		if(functionDef.nonParameterLocalTypes.size() + localSet.num >= module.featureSpec.maxLocals)
 		{ throw FatalSerializationException("too many locals"); }
-		for(Uptr index = 0; index < localSet.num; ++index)
-		{ functionDef.nonParameterLocalTypes.push_back(localSet.type); }
+		functionDef.nonParameterLocalTypes.insert(
+			functionDef.nonParameterLocalTypes.end(), localSet.num, localSet.type);
 	}
 
-	// Deserialize the function code, validate it, and re-encode it in the IR format.
+	// Deserialize the function code, validate it, and re-encode it in the IR format. The IR
+	// encoding is usually about twice the size of the WebAssembly encoding.
 	ArrayOutputStream irCodeByteStream;
+	irCodeByteStream.reserve(numBodyBytes * 2);
 	OperatorEncoderStream irEncoderStream(irCodeByteStream);
 	CodeValidationStream codeValidationStream(module, functionDef);
+	const FunctionContext function{module, functionDef};
 	while(bodyStream.capacity())
 	{
 		Opcode opcode;
@@ -568,7 +582,7 @@ static void serializeFunctionBody(InputStream& sectionStream,
 	case Opcode::name:                                                                             \
 	{                                                                                              \
 		Imm imm;                                                                                   \
-		serialize(bodyStream, imm, functionDef);                                                   \
+		serialize(bodyStream, imm, function);                                                      \
 		codeValidationStream.name(imm);                                                            \
 		irEncoderStream.name(imm);                                                                 \
 		break;                                                                                     \
@@ -580,7 +594,8 @@ static void serializeFunctionBody(InputStream& sectionStream,
 	};
 	codeValidationStream.finish();
 
-	functionDef.code = std::move(irCodeByteStream.getBytes());
+	functionDef.code               = module.arena->copyArray(irCodeByteStream.getBytes());
+	functionDef.controlPartOffsets = computeControlPartOffsets(*module.arena, functionDef.code);
 }
 
 template<typename Stream> void serializeTypeSection(Stream& moduleStream, Module& module)
@@ -800,19 +815,79 @@ template<typename Stream> void serializeElementSection(Stream& moduleStream, Mod
 	});
 }
 
-template<typename Stream> void serializeCodeSection(Stream& moduleStream, Module& module)
+// Function bodies are encoded and decoded in parallel, using one thread for each multiple of this
+// many bytes of code, so small modules don't pay for creating threads.
+static constexpr Uptr numCodeBytesPerThread = 64 * 1024;
+
+struct FunctionBodyBytes
+{
+	const U8* data;
+	Uptr numBytes;
+};
+
+// Decodes and validates a sequence of function bodies into consecutive function definitions
+// starting at firstFunctionDefIndex.
+static void decodeFunctionBodies(Module& module,
+								 Uptr firstFunctionDefIndex,
+								 const std::vector<FunctionBodyBytes>& bodies)
+{
+	wavmAssert(firstFunctionDefIndex + bodies.size() <= module.functions.defs.size());
+
+	Uptr numCodeBytes = 0;
+	for(const FunctionBodyBytes& body : bodies) { numCodeBytes += body.numBytes; }
+
+	parallelForEach(bodies.size(), numCodeBytes / numCodeBytesPerThread, [&](Uptr bodyIndex) {
+		decodeFunctionBody(bodies[bodyIndex].data,
+						   bodies[bodyIndex].numBytes,
+						   module,
+						   module.functions.defs[firstFunctionDefIndex + bodyIndex]);
+	});
+}
+
+static void serializeCodeSection(InputStream& moduleStream, Module& module)
 {
 	serializeSection(
-		moduleStream, SectionType::functionDefinitions, [&module](Stream& sectionStream) {
-			Uptr numFunctionBodies = module.functions.defs.size();
+		moduleStream, SectionType::functionDefinitions, [&module](InputStream& sectionStream) {
+			Uptr numFunctionBodies = 0;
 			serializeVarUInt32(sectionStream, numFunctionBodies);
-			if(Stream::isInput && numFunctionBodies != module.functions.defs.size())
+			if(numFunctionBodies != module.functions.defs.size())
 			{
 				throw FatalSerializationException(
 					"function and code sections have mismatched function counts");
 			}
-			for(FunctionDef& functionDef : module.functions.defs)
-			{ serializeFunctionBody(sectionStream, module, functionDef); }
+
+			// Find the bytes of each function body, then decode them.
+			std::vector<FunctionBodyBytes> bodies;
+			bodies.reserve(numFunctionBodies);
+			for(Uptr bodyIndex = 0; bodyIndex < numFunctionBodies; ++bodyIndex)
+			{
+				Uptr numBodyBytes = 0;
+				serializeVarUInt32(sectionStream, numBodyBytes);
+				bodies.push_back({sectionStream.advance(numBodyBytes), numBodyBytes});
+			}
+			decodeFunctionBodies(module, 0, bodies);
+		});
+}
+
+static void serializeCodeSection(OutputStream& moduleStream, Module& module)
+{
+	serializeSection(
+		moduleStream, SectionType::functionDefinitions, [&module](OutputStream& sectionStream) {
+			Uptr numFunctionBodies = module.functions.defs.size();
+			serializeVarUInt32(sectionStream, numFunctionBodies);
+
+			// Encode the function bodies in parallel, then write them in order.
+			Uptr numCodeBytes = 0;
+			for(const FunctionDef& functionDef : module.functions.defs)
+			{ numCodeBytes += functionDef.code.size(); }
+
+			std::vector<std::vector<U8>> bodies(numFunctionBodies);
+			parallelForEach(
+				numFunctionBodies, numCodeBytes / numCodeBytesPerThread, [&](Uptr bodyIndex) {
+					bodies[bodyIndex]
+						= encodeFunctionBody(module, module.functions.defs[bodyIndex]);
+				});
+			for(std::vector<U8>& bodyBytes : bodies) { serialize(sectionStream, bodyBytes); }
 		});
 }
 
@@ -848,6 +923,90 @@ static void serializeModule(OutputStream& moduleStream, Module& module)
 	for(auto& userSection : module.userSections) { serialize(moduleStream, userSection); }
 }
 
+// Checks that the known sections of a module are in the correct order.
+static void checkSectionOrder(SectionType sectionType, SectionType& lastKnownSectionType)
+{
+	if(sectionType != SectionType::user)
+	{
+		if(sectionType > lastKnownSectionType) { lastKnownSectionType = sectionType; }
+		else
+		{
+			throw FatalSerializationException("incorrect order for known section");
+		}
+	}
+}
+
+// Deserializes and validates a section, given a stream that starts after the section type.
+static void deserializeSection(InputStream& moduleStream, SectionType sectionType, Module& module)
+{
+	switch(sectionType)
+	{
+	case SectionType::type:
+		serializeTypeSection(moduleStream, module);
+		IR::validateTypes(module);
+		break;
+	case SectionType::import:
+		serializeImportSection(moduleStream, module);
+		IR::validateImports(module);
+		break;
+	case SectionType::functionDeclarations:
+		serializeFunctionSection(moduleStream, module);
+		IR::validateFunctionDeclarations(module);
+		break;
+	case SectionType::table:
+		serializeTableSection(moduleStream, module);
+		IR::validateTableDefs(module);
+		break;
+	case SectionType::memory:
+		serializeMemorySection(moduleStream, module);
+		IR::validateMemoryDefs(module);
+		break;
+	case SectionType::global:
+		serializeGlobalSection(moduleStream, module);
+		IR::validateGlobalDefs(module);
+		break;
+	case SectionType::export_:
+		serializeExportSection(moduleStream, module);
+		IR::validateExports(module);
+		break;
+	case SectionType::start:
+		serializeStartSection(moduleStream, module);
+		IR::validateStartFunction(module);
+		break;
+	case SectionType::elem:
+		serializeElementSection(moduleStream, module);
+		IR::validateElemSegments(module);
+		break;
+	case SectionType::functionDefinitions: serializeCodeSection(moduleStream, module); break;
+	case SectionType::data:
+		serializeDataSection(moduleStream, module);
+		IR::validateDataSegments(module);
+		break;
+	case SectionType::exceptionTypes:
+		serializeExceptionTypeSection(moduleStream, module);
+		IR::validateExceptionTypeDefs(module);
+		break;
+	case SectionType::user:
+	{
+		UserSection& userSection
+			= *module.userSections.insert(module.userSections.end(), UserSection());
+		serialize(moduleStream, userSection);
+		break;
+	}
+	default: throw FatalSerializationException("unknown section ID");
+	};
+}
+
+static void checkHadFunctionDefinitions(const Module& module, bool hadFunctionDefinitions)
+{
+	if(module.functions.defs.size() && !hadFunctionDefinitions)
+	{
+		throw IR::ValidationException(
+			"Serialized module contained function declarations, but no "
+			"corresponding function definition section");
+	}
+}
+
 static void serializeModule(InputStream& moduleStream, Module& module)
 {
 	serializeConstant(moduleStream, "magic number", U32(magicNumber));
@@ -859,83 +1018,214 @@ static void serializeModule(InputStream& moduleStream, Module& module)
 	{
 		SectionType sectionType;
 		serialize(moduleStream, sectionType);
+		checkSectionOrder(sectionType, lastKnownSectionType);
+		deserializeSection(moduleStream, sectionType, module);
+		if(sectionType == SectionType::functionDefinitions) { hadFunctionDefinitions = true; }
+	};
+
+	checkHadFunctionDefinitions(module, hadFunctionDefinitions);
+}
+
+// Decodes a LEB128 U32 from the start of a buffer. Returns false if the buffer ends before the
+// last byte of the encoding.
+static bool tryDecodeVarUInt32(const U8* bytes, Uptr numBytes, Uptr& outValue, Uptr& outNumBytes)
+{
+	// Find the last byte of the encoding. A U32 is encoded in at most 5 bytes, so stop there and
+	// let serializeVarUInt32 report an error if the encoding is too long.
+	Uptr numEncodedBytes = 0;
+	while(true)
+	{
+		if(numEncodedBytes == numBytes) { return false; }
+		if(!(bytes[numEncodedBytes++] & 0x80) || numEncodedBytes == 5) { break; }
+	};
 
-		if(sectionType != SectionType::user)
+	MemoryInputStream stream(bytes, numEncodedBytes);
+	serializeVarUInt32(stream, outValue);
+	outNumBytes = numEncodedBytes;
+	return true;
+}
+
+namespace WASM
+{
+	struct StreamingDecoderImpl
+	{
+		enum class State
+		{
+			header,
+			sectionHeader,
+			codeSectionHeader,
+			functionBody,
+			codeSectionEnd,
+		};
+
+		Module& module;
+		std::function<void(Uptr)> onFunctionDefDecoded;
+
+		// The bytes that have been added, but not decoded yet, start at bufferOffset.
+		std::vector<U8> buffer;
+		Uptr bufferOffset = 0;
+
+		State state                      = State::header;
+		SectionType lastKnownSectionType = SectionType::unknown;
+		bool hadFunctionDefinitions      = false;
+
+		// The state of decoding the code section.
+		Uptr numCodeSectionBytesRemaining = 0;
+		Uptr nextFunctionDefIndex         = 0;
+
+		StreamingDecoderImpl(Module& inModule, std::function<void(Uptr)>&& inOnFunctionDefDecoded)
+		: module(inModule), onFunctionDefDecoded(std::move(inOnFunctionDefDecoded))
 		{
-			if(sectionType > lastKnownSectionType) { lastKnownSectionType = sectionType; }
-			else
-			{
-				throw FatalSerializationException("incorrect order for known section");
-			}
 		}
 
-		switch(sectionType)
+		// Decodes as much of the buffered data as possible.
+		void decode()
 		{
-		case SectionType::type:
-			serializeTypeSection(moduleStream, module);
-			IR::validateTypes(module);
-			break;
-		case SectionType::import:
-			serializeImportSection(moduleStream, module);
-			IR::validateImports(module);
-			break;
-		case SectionType::functionDeclarations:
-			serializeFunctionSection(moduleStream, module);
-			IR::validateFunctionDeclarations(module);
-			break;
-		case SectionType::table:
-			serializeTableSection(moduleStream, module);
-			IR::validateTableDefs(module);
-			break;
-		case SectionType::memory:
-			serializeMemorySection(moduleStream, module);
-			IR::validateMemoryDefs(module);
-			break;
-		case SectionType::global:
-			serializeGlobalSection(moduleStream, module);
-			IR::validateGlobalDefs(module);
-			break;
-		case SectionType::export_:
-			serializeExportSection(moduleStream, module);
-			IR::validateExports(module);
-			break;
-		case SectionType::start:
-			serializeStartSection(moduleStream, module);
-			IR::validateStartFunction(module);
-			break;
-		case SectionType::elem:
-			serializeElementSection(moduleStream, module);
-			IR::validateElemSegments(module);
-			break;
-		case SectionType::functionDefinitions:
-			serializeCodeSection(moduleStream, module);
-			hadFunctionDefinitions = true;
-			break;
-		case SectionType::data:
-			serializeDataSection(moduleStream, module);
-			IR::validateDataSegments(module);
-			break;
-		case SectionType::exceptionTypes:
-			serializeExceptionTypeSection(moduleStream, module);
-			IR::validateExceptionTypeDefs(module);
-			break;
-		case SectionType::user:
+			while(decodeNext()) {};
+		}
+
+	private:
+		void consume(Uptr numBytes)
 		{
-			UserSection& userSection
-				= *module.userSections.insert(module.userSections.end(), UserSection());
-			serialize(moduleStream, userSection);
-			break;
+			wavmAssert(bufferOffset + numBytes <= buffer.size());
+			bufferOffset += numBytes;
 		}
-		default: throw FatalSerializationException("unknown section ID");
-		};
-	};
 
-	if(module.functions.defs.size() && !hadFunctionDefinitions)
-	{
-		throw IR::ValidationException(
-			"Serialized module contained function declarations, but no "
-			"corresponding function definition section");
-	}
+		void consumeCodeSectionBytes(Uptr numBytes)
+		{
+			if(numBytes > numCodeSectionBytesRemaining)
+			{ throw FatalSerializationException("expected data but found end of stream"); }
+			numCodeSectionBytesRemaining -= numBytes;
+			consume(numBytes);
+		}
+
+		// Decodes the next unit of the module: the header, a section, or a function body. Returns
+		// false if more bytes are needed to decode it.
+		bool decodeNext()
+		{
+			const U8* next      = buffer.data() + bufferOffset;
+			const Uptr numBytes = buffer.size() - bufferOffset;
+			switch(state)
+			{
+			case State::header:
+			{
+				if(numBytes < 8) { return false; }
+				MemoryInputStream stream(next, 8);
+				serializeConstant(stream, "magic number", U32(magicNumber));
+				serializeConstant(stream, "version", U32(currentVersion));
+				consume(8);
+				state = State::sectionHeader;
+				return true;
+			}
+			case State::sectionHeader:
+			{
+				Uptr numSectionBytes;
+				Uptr numSizeBytes;
+				if(!numBytes
+				   || !tryDecodeVarUInt32(next + 1, numBytes - 1, numSectionBytes, numSizeBytes))
+				{ return false; }
+
+				MemoryInputStream sectionTypeStream(next, 1);
+				SectionType sectionType;
+				serialize(sectionTypeStream, sectionType);
+
+				if(sectionType == SectionType::functionDefinitions)
+				{
+					// Decode the code section incrementally, as function bodies arrive.
+					checkSectionOrder(sectionType, lastKnownSectionType);
+					consume(1 + numSizeBytes);
+					numCodeSectionBytesRemaining = numSectionBytes;
+					state                        = State::codeSectionHeader;
+				}
+				else
+				{
+					// Wait for the whole section, then decode it with the non-streaming decoder.
+					if(numBytes - 1 - numSizeBytes < numSectionBytes) { return false; }
+					checkSectionOrder(sectionType, lastKnownSectionType);
+					MemoryInputStream sectionStream(next + 1, numSizeBytes + numSectionBytes);
+					deserializeSection(sectionStream, sectionType, module);
+					consume(1 + numSizeBytes + numSectionBytes);
+				}
+				return true;
+			}
+			case State::codeSectionHeader:
+			{
+				Uptr numFunctionBodies;
+				Uptr numCountBytes;
+				if(!tryDecodeVarUInt32(next, numBytes, numFunctionBodies, numCountBytes))
+				{ return false; }
+				if(numFunctionBodies != module.functions.defs.size())
+				{
+					throw FatalSerializationException(
+						"function and code sections have mismatched function counts");
+				}
+				consumeCodeSectionBytes(numCountBytes);
+
+				nextFunctionDefIndex = 0;
+				state = numFunctionBodies ? State::functionBody : State::codeSectionEnd;
+				return true;
+			}
+			case State::functionBody:
+			{
+				// Find as many complete function bodies as are buffered, and decode them together
+				// so they may be decoded in parallel.
+				std::vector<FunctionBodyBytes> bodies;
+				Uptr numScannedBytes = 0;
+				while(nextFunctionDefIndex + bodies.size() < module.functions.defs.size())
+				{
+					Uptr numBodyBytes;
+					Uptr numSizeBytes;
+					try
+					{
+						if(!tryDecodeVarUInt32(next + numScannedBytes,
+											   numBytes - numScannedBytes,
+											   numBodyBytes,
+											   numSizeBytes))
+						{ break; }
+						if(numScannedBytes + numSizeBytes + numBodyBytes
+						   > numCodeSectionBytesRemaining)
+						{
+							throw FatalSerializationException(
+								"expected data but found end of stream");
+						}
+					}
+					catch(FatalSerializationException)
+					{
+						// Decode the preceding bodies first, so their errors take precedence.
+						if(bodies.size()) { break; }
+						throw;
+					}
+					if(numBytes - numScannedBytes < numSizeBytes + numBodyBytes) { break; }
+
+					bodies.push_back({next + numScannedBytes + numSizeBytes, numBodyBytes});
+					numScannedBytes += numSizeBytes + numBodyBytes;
+				};
+				if(!bodies.size()) { return false; }
+
+				decodeFunctionBodies(module, nextFunctionDefIndex, bodies);
+				consumeCodeSectionBytes(numScannedBytes);
+
+				for(Uptr bodyIndex = 0; bodyIndex < bodies.size(); ++bodyIndex)
+				{
+					if(onFunctionDefDecoded) { onFunctionDefDecoded(nextFunctionDefIndex); }
+					++nextFunctionDefIndex;
+				}
+				if(nextFunctionDefIndex == module.functions.defs.size())
+				{ state = State::codeSectionEnd; }
+				return true;
+			}
+			case State::codeSectionEnd:
+			{
+				if(numCodeSectionBytesRemaining)
+				{ throw FatalSerializationException("section contained more data than expected"); }
+				hadFunctionDefinitions = true;
+				state                  = State::sectionHeader;
+				return true;
+			}
+			default: Errors::unreachable();
+			};
+		}
+	};
 }
 
 void WASM::serialize(Serialization::InputStream& stream, Module& module)
@@ -946,3 +1236,36 @@ void WASM::serialize(Serialization::OutputStream& stream, const Module& module)
 {
 	serializeModule(stream, const_cast<Module&>(module));
 }
+
+WASM::StreamingDecoder::StreamingDecoder(Module& outModule,
+										 std::function<void(Uptr)>&& onFunctionDefDecoded)
+: impl(new StreamingDecoderImpl(outModule, std::move(onFunctionDefDecoded)))
+{
+}
+
+WASM::StreamingDecoder::~StreamingDecoder() { delete impl; }
+
+void WASM::StreamingDecoder::addBytes(const U8* bytes, Uptr numBytes)
+{
+	// Discard the bytes that have already been decoded once they are at least half the buffer, so
+	// a large section that arrives in many chunks isn't moved for each chunk.
+	std::vector<U8>& buffer = impl->buffer;
+	if(impl->bufferOffset && impl->bufferOffset >= buffer.size() / 2)
+	{
+		buffer.erase(buffer.begin(), buffer.begin() + impl->bufferOffset);
+		impl->bufferOffset = 0;
+	}
+
+	buffer.insert(buffer.end(), bytes, bytes + numBytes);
+	impl->decode();
+}
+
+void WASM::StreamingDecoder::finish()
+{
+	impl->decode();
+	if(impl->state != StreamingDecoderImpl::State::sectionHeader
+	   || impl->bufferOffset != impl->buffer.size())
+	{ throw FatalSerializationException("expected data but found end of stream"); }
+
+	checkHadFunctionDefinitions(impl->module, impl->hadFunctionDefinitions);
+}
@@ -542,8 +542,7 @@ std::string NFA::Machine::dumpDFAGraphViz() const
 	result += "digraph {\n";
 	HashSet<StateIndex> terminalStates;
 
-	CharSet* classCharSets = (CharSet*)alloca(sizeof(CharSet) * numClasses);
-	memset(classCharSets, 0, sizeof(CharSet) * numClasses);
+	std::vector<CharSet> classCharSets(numClasses);
 	for(Uptr charIndex = 0; charIndex < 256; ++charIndex)
 	{
 		const Uptr classIndex = charToOffsetMap[charIndex] / numStates;
@@ -191,7 +191,8 @@ static void parseImm(CursorState* cursor, BranchTableImm& outImm)
 		outImm.defaultTargetDepth = targetDepths.back();
 		targetDepths.pop_back();
 		outImm.branchTableIndex = (U32)cursor->functionState->functionDef.branchTables.size();
-		cursor->functionState->functionDef.branchTables.push_back(std::move(targetDepths));
+		cursor->functionState->functionDef.branchTables.push_back(
+			cursor->moduleState->module.arena->copyArray(targetDepths));
 	}
 }
 
@@ -779,7 +780,10 @@ FunctionDef WAST::parseFunctionDef(CursorState* cursor, const Token* funcToken)
 			catch(FatalParseException)
 			{
 			}
-			functionDef.code = std::move(functionState.codeByteStream.getBytes());
+			functionDef.code
+				= moduleState->module.arena->copyArray(functionState.codeByteStream.getBytes());
+			functionDef.controlPartOffsets
+				= computeControlPartOffsets(*moduleState->module.arena, functionDef.code);
 			moduleState->disassemblyNames.functions[functionIndex].labels
 				= std::move(functionState.labelDisassemblyNames);
 		});
@@ -11,6 +11,7 @@
 #include "WAST/TestScript.h"
 #include "WAST/WAST.h"
 
+#include <string.h>
 #include <cstdarg>
 #include <cstdio>
 #include <vector>
@@ -25,6 +26,7 @@ struct TestScriptState
 {
 	bool hasInstantiatedModule;
 	GCPointer<ModuleInstance> lastModuleInstance;
+	ExecutionBackend executionBackend;
 	GCPointer<Compartment> compartment;
 	GCPointer<Context> context;
 
@@ -33,8 +35,9 @@ struct TestScriptState
 
 	std::vector<WAST::Error> errors;
 
-	TestScriptState()
+	TestScriptState(ExecutionBackend inExecutionBackend)
 	: hasInstantiatedModule(false)
+	, executionBackend(inExecutionBackend)
 	, compartment(Runtime::createCompartment())
 	, context(Runtime::createContext(compartment))
 	{
@@ -165,7 +168,7 @@ static bool processAction(TestScriptState& state, Action* action, IR::ValueTuple
 
 		// Clear the previous module.
 		state.lastModuleInstance = nullptr;
-		collectGarbage();
+		collectCompartmentGarbage(state.compartment);
 
 		// Link and instantiate the module.
 		TestScriptResolver resolver(state);
@@ -173,10 +176,11 @@ static bool processAction(TestScriptState& state, Action* action, IR::ValueTuple
 		if(linkResult.success)
 		{
 			state.hasInstantiatedModule = true;
-			state.lastModuleInstance    = instantiateModule(state.compartment,
-                                                         *moduleAction->module,
-                                                         std::move(linkResult.resolvedImports),
-                                                         "test module");
+			state.lastModuleInstance    = instantiateModule(
+				state.compartment,
+				compileModule(*moduleAction->module, state.executionBackend),
+				std::move(linkResult.resolvedImports),
+				"test module");
 
 			// Call the module start function, if it has one.
 			FunctionInstance* startFunction = getStartFunction(state.lastModuleInstance);
@@ -487,11 +491,12 @@ static void processCommand(TestScriptState& state, const Command* command)
 							= linkModule(*assertCommand->moduleAction->module, resolver);
 						if(linkResult.success)
 						{
-							auto moduleInstance
-								= instantiateModule(state.compartment,
-													*assertCommand->moduleAction->module,
-													std::move(linkResult.resolvedImports),
-													"test module");
+							auto moduleInstance = instantiateModule(
+								state.compartment,
+								compileModule(*assertCommand->moduleAction->module,
+											  state.executionBackend),
+								std::move(linkResult.resolvedImports),
+								"test module");
 
 							// Call the module start function, if it has one.
 							FunctionInstance* startFunction = getStartFunction(moduleInstance);
@@ -563,12 +568,29 @@ DEFINE_INTRINSIC_MEMORY(spectest,
 
 int main(int argc, char** argv)
 {
-	if(argc != 2)
+	// Parse the command line. --interpret executes the test modules with the interpreter instead
+	// of compiling them to machine code.
+	const char* filename              = nullptr;
+	ExecutionBackend executionBackend = ExecutionBackend::jit;
+	for(int argIndex = 1; argIndex < argc; ++argIndex)
 	{
-		Log::printf(Log::error, "Usage: Test in.wast\n");
+		if(!strcmp(argv[argIndex], "--interpret"))
+		{ executionBackend = ExecutionBackend::interpreter; }
+		else if(!filename)
+		{
+			filename = argv[argIndex];
+		}
+		else
+		{
+			filename = nullptr;
+			break;
+		}
+	}
+	if(!filename)
+	{
+		Log::printf(Log::error, "Usage: Test [--interpret] in.wast\n");
 		return EXIT_FAILURE;
 	}
-	const char* filename = argv[1];
 
 	// Treat any unhandled exception (e.g. in a thread) as a fatal error.
 	Runtime::setUnhandledExceptionHandler([](Runtime::Exception&& exception) {
@@ -586,7 +608,7 @@ int main(int argc, char** argv)
 	testScriptBytes.push_back(0);
 
 	// Process the test script.
-	TestScriptState* testScriptState = new TestScriptState();
+	TestScriptState* testScriptState = new TestScriptState(executionBackend);
 	std::vector<std::unique_ptr<Command>> testCommands;
 
 	// Parse the test script.
@@ -305,10 +305,11 @@ namespace Wavix
 		Platform::File* platformFile = currentProcess->files[fd];
 		if(!platformFile) { throwException(Exception::calledUnimplementedIntrinsicType); }
 
-		U8* buffer = memoryArrayPtr<U8>(memory, bufferAddress, numBytes);
+		MemorySpan<U8> buffer = memorySpan<U8>(memory, U32(bufferAddress), U32(numBytes));
 
 		Uptr numReadBytes = 0;
-		const bool result = Platform::readFile(platformFile, buffer, numBytes, &numReadBytes);
+		const bool result
+			= Platform::readFile(platformFile, buffer.begin(), buffer.size(), &numReadBytes);
 		if(!result) { return -1; }
 
 		return coerce32bitAddress(numReadBytes);
@@ -326,12 +327,6 @@ namespace Wavix
 
 		traceSyscallf("readv", "");
 
-		struct IoVec
-		{
-			U32 address;
-			U32 numBytes;
-		};
-
 		Lock<Platform::Mutex> fileLock(currentProcess->filesMutex);
 
 		if(!validateFD(fd)) { return -1; }
@@ -339,17 +334,18 @@ namespace Wavix
 		Platform::File* platformFile = currentProcess->files[fd];
 		if(!platformFile) { throwException(Exception::calledUnimplementedIntrinsicType); }
 
-		const IoVec* ios  = memoryArrayPtr<const IoVec>(memory, iosAddress, numIos);
+		if(U32(numIos) > maxMemoryIoVecs) { return -1; }
+		std::vector<MemoryIoVec> ios((U32)numIos);
+		getMemoryIoVecs(memory, U32(iosAddress), ios.size(), ios.data());
+
 		Uptr numReadBytes = 0;
-		for(U32 ioIndex = 0; ioIndex < U32(numIos); ++ioIndex)
+		for(const MemoryIoVec& io : ios)
 		{
-			const IoVec io = ios[ioIndex];
 			if(io.numBytes)
 			{
-				U8* ioData          = memoryArrayPtr<U8>(memory, io.address, io.numBytes);
 				Uptr ioNumReadBytes = 0;
 				const bool ioResult
-					= Platform::readFile(platformFile, ioData, io.numBytes, &ioNumReadBytes);
+					= Platform::readFile(platformFile, io.base, io.numBytes, &ioNumReadBytes);
 				numReadBytes += ioNumReadBytes;
 				if(!ioResult || ioNumReadBytes != io.numBytes) { break; }
 			}
@@ -370,12 +366,6 @@ namespace Wavix
 
 		traceSyscallf("writev", "");
 
-		struct IoVec
-		{
-			U32 address;
-			U32 numBytes;
-		};
-
 		Lock<Platform::Mutex> fileLock(currentProcess->filesMutex);
 
 		if(!validateFD(fd)) { return -1; }
@@ -383,17 +373,18 @@ namespace Wavix
 		Platform::File* platformFile = currentProcess->files[fd];
 		if(!platformFile) { throwException(Exception::calledUnimplementedIntrinsicType); }
 
-		const IoVec* ios     = memoryArrayPtr<const IoVec>(memory, iosAddress, numIOs);
+		if(U32(numIOs) > maxMemoryIoVecs) { return -1; }
+		std::vector<MemoryIoVec> ios((U32)numIOs);
+		getMemoryIoVecs(memory, U32(iosAddress), ios.size(), ios.data());
+
 		Uptr numWrittenBytes = 0;
-		for(U32 ioIndex = 0; ioIndex < U32(numIOs); ++ioIndex)
+		for(const MemoryIoVec& io : ios)
 		{
-			const IoVec io = ios[ioIndex];
 			if(io.numBytes)
 			{
-				const U8* ioData       = memoryArrayPtr<U8>(memory, io.address, io.numBytes);
 				Uptr ioNumWrittenBytes = 0;
 				const bool ioResult
-					= Platform::writeFile(platformFile, ioData, io.numBytes, &ioNumWrittenBytes);
+					= Platform::writeFile(platformFile, io.base, io.numBytes, &ioNumWrittenBytes);
 				numWrittenBytes += ioNumWrittenBytes;
 				if(!ioResult || ioNumWrittenBytes != io.numBytes) { break; }
 			}
@@ -129,7 +129,7 @@ namespace Wavix
 						exception.message.c_str());
 			return false;
 		}
-		catch(std::bad_alloc)
+		catch(const std::bad_alloc&)
 		{
 			Log::printf(
 				Log::debug,
@@ -117,10 +117,10 @@ namespace Wavix
 			const Uptr numChars = currentProcess->args[safeArgIndex].size();
 			if(numChars + 1 <= Uptr(numCharsInBuffer))
 			{
-				memcpy(memoryArrayPtr<char>(memory, bufferAddress, numCharsInBuffer),
-					   currentProcess->args[safeArgIndex].c_str(),
-					   numChars);
-				memoryRef<char>(memory, bufferAddress + numChars) = 0;
+				MemorySpan<char> buffer
+					= memorySpan<char>(memory, U32(bufferAddress), numChars + 1);
+				memcpy(buffer.begin(), currentProcess->args[safeArgIndex].c_str(), numChars);
+				buffer[numChars] = 0;
 			}
 			else
 			{
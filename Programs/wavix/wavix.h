@@ -77,17 +77,6 @@ namespace Wavix
 	inline std::string readUserString(Runtime::MemoryInstance* memory, I32 stringAddress)
 	{
 		// Validate the path name and make a local copy of it.
-		std::string pathString;
-		while(true)
-		{
-			const char c = Runtime::memoryRef<char>(memory, stringAddress + pathString.size());
-			if(c == 0) { break; }
-			else
-			{
-				pathString += c;
-			}
-		};
-
-		return pathString;
+		return Runtime::readMemoryString(memory, U32(stringAddress));
 	}
 }
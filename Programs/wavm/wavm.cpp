@@ -73,7 +73,8 @@ struct RootResolver : Resolver
 			Module stubModule;
 			DisassemblyNames stubModuleNames;
 			stubModule.types.push_back(asFunctionType(type));
-			stubModule.functions.defs.push_back({{0}, {}, std::move(codeStream.getBytes()), {}});
+			stubModule.functions.defs.push_back(
+				{{0}, {}, stubModule.arena->copyArray(codeStream.getBytes()), {}});
 			stubModule.exports.push_back({"importStub", IR::ObjectKind::function, 0});
 			stubModuleNames.functions.push_back({"importStub: " + exportName, {}, {}});
 			IR::setDisassemblyNames(stubModule, stubModuleNames);
@@ -110,22 +111,28 @@ struct RootResolver : Resolver
 
 static bool loadModule(const char* filename, IR::Module& outModule)
 {
-	// Read the specified file into an array.
-	std::vector<U8> fileBytes;
-	if(!loadFile(filename, fileBytes)) { return false; }
+	// Map the specified file into memory, or if that isn't possible, read it into an array.
+	SharedBytes fileBytes;
+	if(!mapFile(filename, fileBytes))
+	{
+		std::vector<U8> fileContents;
+		if(!loadFile(filename, fileContents)) { return false; }
+		fileBytes = std::move(fileContents);
+	}
 
 	// If the file starts with the WASM binary magic number, load it as a binary module.
-	if(*(U32*)fileBytes.data() == 0x6d736100)
-	{ return loadBinaryModule(fileBytes.data(), fileBytes.size(), outModule); }
+	if(fileBytes.size() >= 4 && *(U32*)fileBytes.data() == 0x6d736100)
+	{ return loadBinaryModule(fileBytes, outModule); }
 	else
 	{
 		// Make sure the WAST file is null terminated.
-		fileBytes.push_back(0);
+		std::vector<U8> wastBytes(fileBytes.begin(), fileBytes.end());
+		wastBytes.push_back(0);
 
 		// Load it as a text module.
 		std::vector<WAST::Error> parseErrors;
 		if(!WAST::parseModule(
-			   (const char*)fileBytes.data(), fileBytes.size(), outModule, parseErrors))
+			   (const char*)wastBytes.data(), wastBytes.size(), outModule, parseErrors))
 		{
 			reportParseErrors(filename, parseErrors);
 			return false;
@@ -137,12 +144,14 @@ static bool loadModule(const char* filename, IR::Module& outModule)
 
 struct CommandLineOptions
 {
-	const char* filename     = nullptr;
-	const char* functionName = nullptr;
-	char** args              = nullptr;
-	bool onlyCheck           = false;
-	bool enableEmscripten    = true;
-	bool enableThreadTest    = false;
+	const char* filename        = nullptr;
+	const char* functionName    = nullptr;
+	const char* profileFilename = nullptr;
+	char** args                 = nullptr;
+	bool onlyCheck              = false;
+	bool enableEmscripten       = true;
+	bool enableThreadTest       = false;
+	ExecutionBackend backend    = ExecutionBackend::jit;
 };
 
 static int run(const CommandLineOptions& options)
@@ -192,8 +201,10 @@ static int run(const CommandLineOptions& options)
 	}
 
 	// Instantiate the module.
-	ModuleInstance* moduleInstance = instantiateModule(
-		compartment, module, std::move(linkResult.resolvedImports), options.filename);
+	ModuleInstance* moduleInstance = instantiateModule(compartment,
+													   compileModule(module, options.backend),
+													   std::move(linkResult.resolvedImports),
+													   options.filename);
 	if(!moduleInstance) { return EXIT_FAILURE; }
 
 	// Call the module start function, if it has one.
@@ -312,6 +323,8 @@ void showHelp()
 				"  -d|--debug\t\t\tWrite additional debug information to stdout\n"
 				"  --disable-emscripten\t\tDisable Emscripten intrinsics\n"
 				"  --enable-thread-test\t\tEnable ThreadTest intrinsics\n"
+				"  --interpret\t\t\tExecute the module with the interpreter instead of the JIT\n"
+				"  --profile=<file>\t\tWrite a CPU profile in folded stack format to file\n"
 				"  --\t\t\t\tStop parsing arguments\n");
 }
 
@@ -346,6 +359,14 @@ int main(int argc, char** argv)
 		{
 			options.enableThreadTest = true;
 		}
+		else if(!strcmp(*options.args, "--interpret"))
+		{
+			options.backend = ExecutionBackend::interpreter;
+		}
+		else if(!strncmp(*options.args, "--profile=", 10))
+		{
+			options.profileFilename = *options.args + 10;
+		}
 		else if(!strcmp(*options.args, "--"))
 		{
 			++options.args;
@@ -377,5 +398,22 @@ int main(int argc, char** argv)
 		Errors::fatalf("Unhandled runtime exception: %s\n", describeException(exception).c_str());
 	});
 
-	return run(options);
+	// Start profiling if requested.
+	if(options.profileFilename && !startProfiling())
+	{
+		Log::printf(Log::error, "Profiling isn't supported on this platform.\n");
+		return EXIT_FAILURE;
+	}
+
+	const int result = run(options);
+
+	// Write the profile.
+	if(options.profileFilename)
+	{
+		const std::string profile = stopProfiling();
+		if(!saveFile(options.profileFilename, profile.data(), profile.size()))
+		{ return EXIT_FAILURE; }
+	}
+
+	return result;
 }
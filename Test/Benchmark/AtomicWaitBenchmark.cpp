@@ -0,0 +1,134 @@
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Platform/Platform.h"
+#include "Runtime/Runtime.h"
+#include "WAST/WAST.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// Measures the throughput of a contended mutex implemented in WebAssembly with atomic.wait and
+// atomic.wake, on a varying number of threads. Each run is done twice: once with all threads
+// contending for a single mutex, and once with each pair of threads contending for its own mutex.
+
+enum
+{
+	numLockIterationsPerThread = 100000,
+	maxThreads                 = 16,
+};
+
+static const char benchmarkModuleText[] = R"(
+(module
+	(memory 1 1 shared)
+
+	;; A mutex using the classic futex protocol:
+	;; 0 is unlocked, 1 is locked without waiters, 2 is locked with possible waiters.
+	(func $lock (param $address i32)
+		(if (i32.eqz (i32.atomic.rmw.cmpxchg (get_local $address) (i32.const 0) (i32.const 1)))
+			(then (return)))
+		loop $retry
+			(if (i32.eqz (i32.atomic.rmw.xchg (get_local $address) (i32.const 2)))
+				(then (return)))
+			(drop (i32.atomic.wait (get_local $address) (i32.const 2) (f64.const inf)))
+			br $retry
+		end
+	)
+
+	(func $unlock (param $address i32)
+		(if (i32.ne (i32.atomic.rmw.sub (get_local $address) (i32.const 1)) (i32.const 1))
+			(then
+				(i32.atomic.store (get_local $address) (i32.const 0))
+				(drop (atomic.wake (get_local $address) (i32.const 1)))))
+	)
+
+	(func (export "lockLoop") (param $address i32) (param $numIterations i32)
+		loop $iterLoop
+			(call $lock (get_local $address))
+			(i32.store offset=4 (get_local $address)
+				(i32.add (i32.load offset=4 (get_local $address)) (i32.const 1)))
+			(call $unlock (get_local $address))
+			(br_if $iterLoop
+				(tee_local $numIterations (i32.sub (get_local $numIterations) (i32.const 1))))
+		end
+	)
+)
+)";
+
+struct BenchmarkThreadArgs
+{
+	Compartment* compartment;
+	FunctionInstance* lockLoopFunction;
+	U32 mutexAddress;
+};
+
+static I64 benchmarkThreadEntry(void* argsVoid)
+{
+	const BenchmarkThreadArgs& args = *(const BenchmarkThreadArgs*)argsVoid;
+
+	Context* context = createContext(args.compartment);
+	invokeFunctionChecked(context,
+						  args.lockLoopFunction,
+						  {I32(args.mutexAddress), I32(numLockIterationsPerThread)});
+	return 0;
+}
+
+static void runBenchmark(Compartment* compartment,
+						 FunctionInstance* lockLoopFunction,
+						 Uptr numThreads,
+						 Uptr numThreadsPerMutex)
+{
+	Timing::Timer timer;
+
+	std::vector<BenchmarkThreadArgs> threadArgs(numThreads);
+	std::vector<Platform::Thread*> threads;
+	for(Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		// Give each mutex its own cache line.
+		threadArgs[threadIndex].compartment      = compartment;
+		threadArgs[threadIndex].lockLoopFunction = lockLoopFunction;
+		threadArgs[threadIndex].mutexAddress     = U32(threadIndex / numThreadsPerMutex * 64);
+		threads.push_back(
+			Platform::createThread(1024 * 1024, benchmarkThreadEntry, &threadArgs[threadIndex]));
+	}
+	for(Platform::Thread* thread : threads) { Platform::joinThread(thread); }
+
+	const Uptr numLockIterations = numThreads * numLockIterationsPerThread;
+	std::printf("%2" PRIuPTR " threads, %2" PRIuPTR " threads per mutex: %.1f locks/s\n",
+				numThreads,
+				numThreadsPerMutex,
+				numLockIterations / timer.getSeconds());
+}
+
+I32 main(int argc, char** argv)
+{
+	Module module;
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(benchmarkModuleText, sizeof(benchmarkModuleText), module, parseErrors))
+	{
+		Log::printf(Log::error, "Failed to parse benchmark module\n");
+		return EXIT_FAILURE;
+	}
+
+	GCPointer<Compartment> compartment = createCompartment();
+	GCPointer<ModuleInstance> moduleInstance
+		= instantiateModule(compartment, module, {}, "benchmark");
+	FunctionInstance* lockLoopFunction
+		= asFunctionNullable(getInstanceExport(moduleInstance, "lockLoop"));
+	errorUnless(lockLoopFunction);
+
+	for(Uptr numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		runBenchmark(compartment, lockLoopFunction, numThreads, numThreads);
+		if(numThreads > 2) { runBenchmark(compartment, lockLoopFunction, numThreads, 2); }
+	}
+
+	return EXIT_SUCCESS;
+}
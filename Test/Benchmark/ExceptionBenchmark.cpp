@@ -0,0 +1,126 @@
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Runtime.h"
+#include "Runtime/TypedFunction.h"
+#include "WAST/WAST.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// Measures the cost of exceptions thrown and caught within WebAssembly, and of traps caught by the
+// host, with different limits on the number of call stack frames captured for each exception.
+
+enum
+{
+	numThrowsPerRun = 100000,
+	numTrapsPerRun  = 100000,
+};
+
+static const char benchmarkModuleText[] = R"(
+(module
+	(exception_type $a i32)
+
+	(func $throw_a (param i32) (throw $a (get_local 0)))
+
+	(func $recurse_and_throw (param $depth i32) (param $value i32)
+		(if (i32.eqz (get_local $depth))
+			(then (call $throw_a (get_local $value)))
+			(else (call $recurse_and_throw
+					(i32.sub (get_local $depth) (i32.const 1))
+					(get_local $value))))
+	)
+
+	(func (export "throwCatchLoop") (param $numIterations i32) (param $depth i32) (result i32)
+		(local $sum i32)
+		loop $iterLoop
+			(set_local $sum
+				(i32.add (get_local $sum)
+					(try (result i32)
+						(call $recurse_and_throw (get_local $depth) (i32.const 1))
+						(i32.const 0)
+					catch $a
+					end)))
+			(br_if $iterLoop
+				(tee_local $numIterations (i32.sub (get_local $numIterations) (i32.const 1))))
+		end
+		(get_local $sum)
+	)
+
+	(func $trap (export "trap") (param $depth i32)
+		(if (i32.eqz (get_local $depth))
+			(then unreachable)
+			(else (call $trap (i32.sub (get_local $depth) (i32.const 1)))))
+	)
+)
+)";
+
+I32 main(int argc, char** argv)
+{
+	Module module;
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(benchmarkModuleText, sizeof(benchmarkModuleText), module, parseErrors))
+	{
+		Log::printf(Log::error, "Failed to parse benchmark module\n");
+		return EXIT_FAILURE;
+	}
+
+	GCPointer<Compartment> compartment = createCompartment();
+	GCPointer<ModuleInstance> moduleInstance
+		= instantiateModule(compartment, module, {}, "benchmark");
+	GCPointer<Context> context = createContext(compartment);
+
+	const TypedFunction<I32(I32, I32)> throwCatchLoop(
+		asFunctionNullable(getInstanceExport(moduleInstance, "throwCatchLoop")));
+	const TypedFunction<void(I32)> trap(
+		asFunctionNullable(getInstanceExport(moduleInstance, "trap")));
+
+	const Uptr maxFramesPerRun[] = {UINTPTR_MAX, 8, 0};
+	const I32 depthPerRun[]      = {0, 32};
+	for(Uptr maxFrames : maxFramesPerRun)
+	{
+		setExceptionCallStackMaxFrames(maxFrames);
+
+		for(I32 depth : depthPerRun)
+		{
+			const std::string maxFramesDescription
+				= maxFrames == UINTPTR_MAX ? "full" : std::to_string(maxFrames);
+
+			Timing::Timer throwTimer;
+			catchRuntimeExceptions(
+				[&] {
+					const I32 numCaught = throwCatchLoop(context, numThrowsPerRun, depth);
+					errorUnless(numCaught == numThrowsPerRun);
+				},
+				[](Exception&& exception) {
+					Errors::fatalf("Runtime exception: %s", describeException(exception).c_str());
+				});
+			std::printf("max frames %4s, depth %2i: %.2f us/throw+catch in wasm\n",
+						maxFramesDescription.c_str(),
+						depth,
+						throwTimer.getMicroseconds() / F64(numThrowsPerRun));
+
+			Timing::Timer trapTimer;
+			Uptr numTraps = 0;
+			for(Uptr trapIndex = 0; trapIndex < numTrapsPerRun; ++trapIndex)
+			{
+				catchRuntimeExceptions([&] { trap(context, depth); },
+									   [&](Exception&& exception) { ++numTraps; });
+			}
+			errorUnless(numTraps == numTrapsPerRun);
+			std::printf("max frames %4s, depth %2i: %.2f us/trap caught by host\n",
+						maxFramesDescription.c_str(),
+						depth,
+						trapTimer.getMicroseconds() / F64(numTrapsPerRun));
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include "IR/Module.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Platform/Platform.h"
+#include "Runtime/Runtime.h"
+#include "WAST/WAST.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// Measures the throughput of instantiating a module with many function definitions and a table
+// referencing all of them, on a varying number of threads. Each thread instantiates the module into
+// its own compartment, either compiling the module for each instantiation, or instantiating a
+// module that was compiled once up front.
+
+enum
+{
+	numFunctions               = 4096,
+	numInstantiationsPerThread = 16,
+	maxThreads                 = 16,
+};
+
+static std::string generateModuleText()
+{
+	std::string text = "(module\n";
+	text += "  (table " + std::to_string(numFunctions) + " anyfunc)\n";
+	for(Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex)
+	{
+		const std::string indexString = std::to_string(functionIndex);
+		text += "  (func (export \"f" + indexString + "\") (result i32) (i32.const " + indexString
+				+ "))\n";
+	}
+	text += "  (elem (i32.const 0)";
+	for(Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex)
+	{ text += " " + std::to_string(functionIndex); }
+	text += ")\n)\n";
+	return text;
+}
+
+struct BenchmarkModule
+{
+	const Module* module;
+	CompiledModuleRef compiledModule;
+};
+
+static I64 instantiateThreadEntry(void* benchmarkModuleVoid)
+{
+	const BenchmarkModule& benchmarkModule = *(const BenchmarkModule*)benchmarkModuleVoid;
+
+	GCPointer<Compartment> compartment = createCompartment();
+	for(Uptr instantiationIndex = 0; instantiationIndex < numInstantiationsPerThread;
+		++instantiationIndex)
+	{
+		ModuleInstance* moduleInstance
+			= benchmarkModule.compiledModule
+				  ? instantiateModule(compartment, benchmarkModule.compiledModule, {}, "benchmark")
+				  : instantiateModule(compartment, *benchmarkModule.module, {}, "benchmark");
+		errorUnless(moduleInstance);
+		collectCompartmentGarbage(compartment);
+	}
+	return 0;
+}
+
+static void runBenchmark(const char* description, const BenchmarkModule& benchmarkModule)
+{
+	std::printf("%s:\n", description);
+	for(Uptr numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		Timing::Timer timer;
+
+		std::vector<Platform::Thread*> threads;
+		for(Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+		{
+			threads.push_back(Platform::createThread(
+				8 * 1024 * 1024,
+				instantiateThreadEntry,
+				const_cast<BenchmarkModule*>(&benchmarkModule)));
+		}
+		for(Platform::Thread* thread : threads) { Platform::joinThread(thread); }
+
+		const Uptr numInstantiations = numThreads * numInstantiationsPerThread;
+		std::printf("%2" PRIuPTR " threads: %" PRIuPTR " instantiations in %.2fms (%.1f/s)\n",
+					numThreads,
+					numInstantiations,
+					timer.getMilliseconds(),
+					numInstantiations / timer.getSeconds());
+
+		collectGarbage();
+	}
+}
+
+I32 main(int argc, char** argv)
+{
+	const std::string moduleText = generateModuleText();
+	Module module;
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(moduleText.c_str(), moduleText.size() + 1, module, parseErrors))
+	{
+		Log::printf(Log::error, "Failed to parse benchmark module\n");
+		return EXIT_FAILURE;
+	}
+
+	runBenchmark("Compile and instantiate", BenchmarkModule{&module, nullptr});
+
+	Timing::Timer compileTimer;
+	CompiledModuleRef compiledModule = compileModule(module);
+	std::printf("Compiled module in %.2fms\n", compileTimer.getMilliseconds());
+	runBenchmark("Instantiate compiled module", BenchmarkModule{&module, compiledModule});
+
+	return EXIT_SUCCESS;
+}
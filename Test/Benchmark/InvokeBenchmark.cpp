@@ -0,0 +1,117 @@
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Runtime.h"
+#include "Runtime/TypedFunction.h"
+#include "WAST/WAST.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// Measures the overhead of calling a small exported function from the host through
+// invokeFunctionChecked, TypedFunction, and invokeFunctionBatch, and the overhead of calling
+// catchRuntimeExceptions for each invoke.
+
+enum
+{
+	numInvokes = 1000000
+};
+
+static const char benchmarkModuleText[] = R"(
+(module
+	(func (export "add") (param $a i32) (param $b f64) (result i32)
+		(i32.add (get_local $a) (i32.trunc_s/f64 (get_local $b))))
+)
+)";
+
+I32 main(int argc, char** argv)
+{
+	Module module;
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(benchmarkModuleText, sizeof(benchmarkModuleText), module, parseErrors))
+	{
+		Log::printf(Log::error, "Failed to parse benchmark module\n");
+		return EXIT_FAILURE;
+	}
+
+	GCPointer<Compartment> compartment = createCompartment();
+	GCPointer<ModuleInstance> moduleInstance
+		= instantiateModule(compartment, module, {}, "benchmark");
+	FunctionInstance* addFunction = asFunctionNullable(getInstanceExport(moduleInstance, "add"));
+	errorUnless(addFunction);
+	GCPointer<Context> context = createContext(compartment);
+
+	catchRuntimeExceptions(
+		[&] {
+			I32 accumulator = 0;
+			{
+				Timing::Timer timer;
+				for(Uptr invokeIndex = 0; invokeIndex < numInvokes; ++invokeIndex)
+				{
+					accumulator = invokeFunctionChecked(
+									  context, addFunction, {accumulator, F64(invokeIndex & 1)})
+									  .values[0]
+									  .i32;
+				}
+				std::printf("invokeFunctionChecked: %.1f ns/invoke\n",
+							timer.getMicroseconds() * 1000.0 / numInvokes);
+			}
+
+			{
+				const TypedFunction<I32(I32, F64)> typedAddFunction(addFunction);
+				Timing::Timer timer;
+				for(Uptr invokeIndex = 0; invokeIndex < numInvokes; ++invokeIndex)
+				{ accumulator = typedAddFunction(context, accumulator, F64(invokeIndex & 1)); }
+				std::printf("TypedFunction: %.1f ns/invoke\n",
+							timer.getMicroseconds() * 1000.0 / numInvokes);
+			}
+
+			{
+				const TypedFunction<I32(I32, F64)> typedAddFunction(addFunction);
+				Timing::Timer timer;
+				for(Uptr invokeIndex = 0; invokeIndex < numInvokes; ++invokeIndex)
+				{
+					catchRuntimeExceptions(
+						[&] {
+							accumulator
+								= typedAddFunction(context, accumulator, F64(invokeIndex & 1));
+						},
+						[](Exception&& exception) { Errors::unreachable(); });
+				}
+				std::printf("TypedFunction in catchRuntimeExceptions: %.1f ns/invoke\n",
+							timer.getMicroseconds() * 1000.0 / numInvokes);
+			}
+
+			{
+				std::vector<UntaggedValue> arguments(numInvokes * 2);
+				std::vector<UntaggedValue> results(numInvokes);
+				for(Uptr invokeIndex = 0; invokeIndex < numInvokes; ++invokeIndex)
+				{
+					arguments[invokeIndex * 2 + 0].i32 = I32(invokeIndex);
+					arguments[invokeIndex * 2 + 1].f64 = 1.0;
+				}
+
+				Timing::Timer timer;
+				errorUnless(invokeFunctionBatch(
+								context, addFunction, arguments.data(), results.data(), numInvokes)
+							== numInvokes);
+				std::printf("invokeFunctionBatch: %.1f ns/invoke\n",
+							timer.getMicroseconds() * 1000.0 / numInvokes);
+
+				errorUnless(results[numInvokes - 1].i32 == numInvokes);
+			}
+
+			errorUnless(accumulator == numInvokes * 3 / 2);
+		},
+		[](Exception&& exception) {
+			Errors::fatalf("Runtime exception: %s", describeException(exception).c_str());
+		});
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+using namespace Serialization;
+
+// Measures the throughput of decoding LEB128 integers from a buffer, for values with a varying
+// number of significant bits, and checks that the decoded values match the encoded values.
+
+enum
+{
+	numValuesPerRun = 1024 * 1024,
+	numPassesPerRun = 16,
+};
+
+// A simple deterministic random number generator, so each run decodes the same values.
+static U64 nextRandom(U64& state)
+{
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return state >> 11;
+}
+
+template<typename Value, Uptr maxBits>
+static void runBenchmark(const char* typeName, Uptr numSignificantBits)
+{
+	const Value minValue = std::numeric_limits<Value>::min();
+	const Value maxValue = std::numeric_limits<Value>::max();
+
+	// Generate random values with numSignificantBits bits (including the sign bit of signed
+	// values), and encode them.
+	std::vector<Value> values(numValuesPerRun);
+	U64 randomState = numSignificantBits;
+	for(Value& value : values)
+	{
+		if(std::is_signed<Value>::value)
+		{ value = Value(I64(nextRandom(randomState) << 11) >> (64 - numSignificantBits)); }
+		else
+		{
+			value = Value((nextRandom(randomState) << 11) >> (64 - numSignificantBits));
+		}
+	}
+
+	ArrayOutputStream outputStream;
+	for(Value& value : values)
+	{ serializeVarInt<Value, maxBits>(outputStream, value, minValue, maxValue); }
+	const std::vector<U8> bytes = outputStream.getBytes();
+
+	// Decode the values repeatedly.
+	std::vector<Value> decodedValues(numValuesPerRun);
+	Timing::Timer timer;
+	for(Uptr passIndex = 0; passIndex < numPassesPerRun; ++passIndex)
+	{
+		MemoryInputStream inputStream(bytes.data(), bytes.size());
+		for(Value& value : decodedValues)
+		{ serializeVarInt<Value, maxBits>(inputStream, value, minValue, maxValue); }
+	}
+	timer.stop();
+
+	if(decodedValues != values) { Errors::fatalf("Decoded values don't match encoded values"); }
+
+	std::printf("%s, %2" PRIuPTR " bits (%.2f bytes/value): %.1f MB/s, %.1f Mvalues/s\n",
+				typeName,
+				numSignificantBits,
+				F64(bytes.size()) / numValuesPerRun,
+				F64(bytes.size()) * numPassesPerRun / timer.getSeconds() / 1e6,
+				F64(numValuesPerRun) * numPassesPerRun / timer.getSeconds() / 1e6);
+}
+
+I32 main(int argc, char** argv)
+{
+	for(Uptr numSignificantBits : {6, 13, 20, 27, 32})
+	{ runBenchmark<U32, 32>("varuint32", numSignificantBits); }
+	for(Uptr numSignificantBits : {6, 13, 27, 48, 63})
+	{ runBenchmark<I64, 64>("varint64", numSignificantBits); }
+
+	return EXIT_SUCCESS;
+}
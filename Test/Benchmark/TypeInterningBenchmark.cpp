@@ -0,0 +1,109 @@
+#include "IR/Types.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Timing.h"
+#include "Platform/Platform.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace IR;
+
+// Measures the throughput of constructing function types on a varying number of threads, and
+// checks that all threads get the same unique type for each signature. Each run uses signatures
+// that haven't been constructed before, so the threads race to add them to the type tables in the
+// first pass, and only look them up in later passes.
+
+enum
+{
+	numSignaturesPerRun = 16384,
+	numPassesPerThread  = 16,
+	maxThreads          = 16,
+};
+
+static FunctionType getSignatureType(Uptr signatureIndex)
+{
+	static const ValueType valueTypes[4]
+		= {ValueType::i32, ValueType::i64, ValueType::f32, ValueType::f64};
+
+	std::vector<ValueType> params;
+	Uptr bits = signatureIndex;
+	while(bits)
+	{
+		params.push_back(valueTypes[bits & 3]);
+		bits >>= 2;
+	};
+
+	return FunctionType(TypeTuple(valueTypes[signatureIndex % 3]), TypeTuple(params));
+}
+
+struct BenchmarkThreadArgs
+{
+	Uptr firstSignatureIndex;
+	Uptr threadIndex;
+	std::vector<FunctionType> types;
+};
+
+static I64 benchmarkThreadEntry(void* argsVoid)
+{
+	BenchmarkThreadArgs& args = *(BenchmarkThreadArgs*)argsVoid;
+
+	args.types.resize(numSignaturesPerRun);
+	for(Uptr passIndex = 0; passIndex < numPassesPerThread; ++passIndex)
+	{
+		// Start each thread at a different signature, so they add different types concurrently.
+		for(Uptr index = 0; index < numSignaturesPerRun; ++index)
+		{
+			const Uptr signatureIndex
+				= (index + args.threadIndex * numSignaturesPerRun / maxThreads)
+				  % numSignaturesPerRun;
+			const FunctionType type = getSignatureType(args.firstSignatureIndex + signatureIndex);
+			if(passIndex == 0) { args.types[signatureIndex] = type; }
+			else if(type != args.types[signatureIndex])
+			{
+				Errors::fatalf("Signature %" PRIuPTR " has multiple types", signatureIndex);
+			}
+		}
+	}
+	return 0;
+}
+
+static void runBenchmark(Uptr runIndex, Uptr numThreads)
+{
+	Timing::Timer timer;
+
+	std::vector<BenchmarkThreadArgs> threadArgs(numThreads);
+	std::vector<Platform::Thread*> threads;
+	for(Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		threadArgs[threadIndex].firstSignatureIndex = runIndex * numSignaturesPerRun;
+		threadArgs[threadIndex].threadIndex         = threadIndex;
+		threads.push_back(
+			Platform::createThread(1024 * 1024, benchmarkThreadEntry, &threadArgs[threadIndex]));
+	}
+	for(Platform::Thread* thread : threads) { Platform::joinThread(thread); }
+	timer.stop();
+
+	// Check that every thread got the same type for each signature.
+	for(Uptr threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+	{
+		if(threadArgs[threadIndex].types != threadArgs[0].types)
+		{ Errors::fatalf("Threads constructed different types for the same signature"); }
+	}
+
+	const Uptr numTypes = numThreads * numPassesPerThread * numSignaturesPerRun;
+	std::printf("%2" PRIuPTR " threads: %.1f function types/s\n",
+				numThreads,
+				numTypes / timer.getSeconds());
+}
+
+I32 main(int argc, char** argv)
+{
+	Uptr runIndex = 0;
+	for(Uptr numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{ runBenchmark(runIndex++, numThreads); }
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+#include "Inline/ConcurrentInternTable.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Hash.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Platform/Platform.h"
+
+#include <atomic>
+#include <vector>
+
+struct TestValue
+{
+	U64 key;
+};
+
+typedef ConcurrentInternTable<TestValue> TestTable;
+
+// Interns the value with the given key, and counts the number of values that are created.
+static const TestValue* intern(TestTable& table,
+							   U64 key,
+							   Uptr hash,
+							   std::atomic<Uptr>& numCreatedValues)
+{
+	const TestValue* value = table.getOrAdd(
+		hash,
+		[key](const TestValue* value) { return value->key == key; },
+		[key, &numCreatedValues](Arena& arena) {
+			++numCreatedValues;
+			TestValue* value = arena.allocate<TestValue>();
+			value->key       = key;
+			return value;
+		});
+	errorUnless(value->key == key);
+	return value;
+}
+
+static void testIdentity()
+{
+	enum
+	{
+		numKeys = 10000
+	};
+
+	TestTable table;
+	std::atomic<Uptr> numCreatedValues{0};
+
+	// Add enough values that each stripe's table grows several times.
+	std::vector<const TestValue*> values;
+	for(U64 key = 0; key < numKeys; ++key)
+	{ values.push_back(intern(table, key, Hash<U64>()(key), numCreatedValues)); }
+	errorUnless(numCreatedValues == numKeys);
+
+	// Interning a key again returns the same value, without creating a new one.
+	for(U64 key = 0; key < numKeys; ++key)
+	{ errorUnless(intern(table, key, Hash<U64>()(key), numCreatedValues) == values[key]); }
+	errorUnless(numCreatedValues == numKeys);
+}
+
+static void testHashCollisions()
+{
+	enum
+	{
+		numKeys = 100
+	};
+
+	TestTable table;
+	std::atomic<Uptr> numCreatedValues{0};
+
+	// Values with the same hash are in the same stripe, and probe the same buckets, but are still
+	// distinguished by the isEqual function.
+	std::vector<const TestValue*> values;
+	for(U64 key = 0; key < numKeys; ++key)
+	{ values.push_back(intern(table, key, 12345, numCreatedValues)); }
+	for(U64 key = 0; key < numKeys; ++key)
+	{ errorUnless(intern(table, key, 12345, numCreatedValues) == values[key]); }
+	errorUnless(numCreatedValues == numKeys);
+}
+
+enum
+{
+	numThreads          = 8,
+	numConcurrentKeys   = 4096,
+	numKeysPerCollision = 4,
+};
+
+struct ConcurrentTestThread
+{
+	TestTable* table;
+	std::atomic<Uptr>* numCreatedValues;
+	Uptr threadIndex;
+	std::vector<const TestValue*> values;
+};
+
+static I64 concurrentTestThreadEntry(void* threadVoid)
+{
+	ConcurrentTestThread& thread = *(ConcurrentTestThread*)threadVoid;
+	thread.values.resize(numConcurrentKeys);
+
+	// Each thread interns the keys in a different order. Groups of keys share a hash, so lookups
+	// must also probe past values with the same hash that other threads are adding.
+	for(Uptr keyIndex = 0; keyIndex < numConcurrentKeys; ++keyIndex)
+	{
+		const U64 key = (keyIndex + thread.threadIndex * numConcurrentKeys / numThreads)
+						% numConcurrentKeys;
+		thread.values[key] = intern(*thread.table,
+									key,
+									Hash<U64>()(key / numKeysPerCollision),
+									*thread.numCreatedValues);
+	}
+	return 0;
+}
+
+static void testConcurrentIdentity()
+{
+	TestTable table;
+	std::atomic<Uptr> numCreatedValues{0};
+
+	std::vector<ConcurrentTestThread> threads(numThreads);
+	std::vector<Platform::Thread*> platformThreads;
+	for(Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		threads[threadIndex].table            = &table;
+		threads[threadIndex].numCreatedValues = &numCreatedValues;
+		threads[threadIndex].threadIndex      = threadIndex;
+		platformThreads.push_back(
+			Platform::createThread(1024 * 1024, concurrentTestThreadEntry, &threads[threadIndex]));
+	}
+	for(Platform::Thread* platformThread : platformThreads)
+	{ Platform::joinThread(platformThread); }
+
+	// Every thread got the same value for each key, and each value was only created once.
+	errorUnless(numCreatedValues == numConcurrentKeys);
+	for(Uptr key = 0; key < numConcurrentKeys; ++key)
+	{
+		for(const ConcurrentTestThread& thread : threads)
+		{ errorUnless(thread.values[key] == threads[0].values[key]); }
+	}
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testIdentity();
+	testHashCollisions();
+	testConcurrentIdentity();
+	Timing::logTimer("ConcurrentInternTableTest", timer);
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "Inline/IndexAllocator.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Platform/Platform.h"
+
+#include <atomic>
+#include <vector>
+
+// Not a multiple of 64, so the last bitmap word is only partly used.
+enum
+{
+	maxIndex = 200
+};
+
+typedef ConcurrentIndexAllocator<maxIndex> TestAllocator;
+
+static void testAllocAndFree()
+{
+	TestAllocator allocator;
+
+	// Indices are allocated lowest first.
+	for(Uptr expectedIndex = 0; expectedIndex < 100; ++expectedIndex)
+	{
+		Uptr index;
+		errorUnless(allocator.alloc(index));
+		errorUnless(index == expectedIndex);
+	}
+
+	// Freed indices are reused, lowest first.
+	allocator.free(70);
+	allocator.free(5);
+	Uptr index;
+	errorUnless(allocator.alloc(index) && index == 5);
+	errorUnless(allocator.alloc(index) && index == 70);
+	errorUnless(allocator.alloc(index) && index == 100);
+}
+
+static void testExhaustion()
+{
+	TestAllocator allocator;
+
+	Uptr index;
+	for(Uptr expectedIndex = 0; expectedIndex < maxIndex; ++expectedIndex)
+	{ errorUnless(allocator.alloc(index) && index == expectedIndex); }
+
+	// All the indices are allocated, so alloc fails, even though the last bitmap word has free
+	// bits past maxIndex.
+	errorUnless(!allocator.alloc(index));
+	errorUnless(!allocator.alloc(index));
+
+	// Freeing an index in the middle makes it available again, even though it is in a word before
+	// the minimum free word hint.
+	allocator.free(maxIndex - 1);
+	allocator.free(10);
+	errorUnless(allocator.alloc(index) && index == 10);
+	errorUnless(allocator.alloc(index) && index == maxIndex - 1);
+	errorUnless(!allocator.alloc(index));
+}
+
+enum
+{
+	numThreads             = 4,
+	numIndicesPerThread    = maxIndex / numThreads,
+	numIterationsPerThread = 10000,
+};
+
+struct ConcurrentTestState
+{
+	TestAllocator allocator;
+
+	// Whether each index is allocated by a thread, used to check that no index is allocated by
+	// two threads at once.
+	std::atomic<bool> isAllocated[maxIndex];
+
+	ConcurrentTestState()
+	{
+		for(std::atomic<bool>& isIndexAllocated : isAllocated) { isIndexAllocated = false; }
+	}
+};
+
+static I64 concurrentTestThreadEntry(void* stateVoid)
+{
+	ConcurrentTestState& state = *(ConcurrentTestState*)stateVoid;
+	Uptr indices[numIndicesPerThread];
+	for(Uptr iteration = 0; iteration < numIterationsPerThread; ++iteration)
+	{
+		// Each thread allocates at most its share of the indices, so alloc never fails.
+		for(Uptr& index : indices)
+		{
+			errorUnless(state.allocator.alloc(index));
+			errorUnless(index < maxIndex);
+			errorUnless(!state.isAllocated[index].exchange(true));
+		}
+		for(Uptr index : indices)
+		{
+			errorUnless(state.isAllocated[index].exchange(false));
+			state.allocator.free(index);
+		}
+	}
+	return 0;
+}
+
+static void testConcurrentAlloc()
+{
+	ConcurrentTestState* state = new ConcurrentTestState;
+
+	std::vector<Platform::Thread*> threads;
+	for(Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{ threads.push_back(Platform::createThread(1024 * 1024, concurrentTestThreadEntry, state)); }
+	for(Platform::Thread* thread : threads) { Platform::joinThread(thread); }
+
+	// All the indices were freed, so they can all be allocated again.
+	Uptr index;
+	for(Uptr expectedIndex = 0; expectedIndex < maxIndex; ++expectedIndex)
+	{ errorUnless(state->allocator.alloc(index) && index == expectedIndex); }
+	errorUnless(!state->allocator.alloc(index));
+
+	delete state;
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testAllocAndFree();
+	testExhaustion();
+	testConcurrentAlloc();
+	Timing::logTimer("IndexAllocatorTest", timer);
+	return 0;
+}
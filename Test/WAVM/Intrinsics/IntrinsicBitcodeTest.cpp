@@ -0,0 +1,207 @@
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Floats.h"
+#include "Inline/HashMap.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Intrinsics.h"
+#include "Runtime/Runtime.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+DEFINE_INTRINSIC_MODULE(bitcodeTest)
+
+// Counts the calls to the native implementation of addOne, so the test can tell whether a call
+// used the native function or the inlined LLVM body.
+static std::atomic<Uptr> numNativeAddOneCalls{0};
+
+DEFINE_INTRINSIC_FUNCTION(bitcodeTest, "addOne", I32, addOne, I32 value)
+{
+	++numNativeAddOneCalls;
+	return value + 1;
+}
+
+static const char addOneLLVMIR[] = R"(
+define i32 @addOne(i8* %context, i32 %value) {
+  %result = add i32 %value, 1
+  ret i32 %result
+}
+)";
+DEFINE_INTRINSIC_FUNCTION_BITCODE(addOne, addOneLLVMIR)
+
+static const char* moduleText = R"(
+(module
+  (import "bitcodeTest" "addOne" (func $addOne (param i32) (result i32)))
+  (func (export "addTwo") (param i32) (result i32) (call $addOne (call $addOne (get_local 0))))
+)
+)";
+
+// The float rounding operators are compiled to calls to the wavmIntrinsics rounding functions,
+// which have LLVM bodies that the JIT inlines.
+static const char* roundingModuleText = R"(
+(module
+  (func (export "f32.ceil") (param f32) (result f32) (f32.ceil (get_local 0)))
+  (func (export "f32.floor") (param f32) (result f32) (f32.floor (get_local 0)))
+  (func (export "f32.trunc") (param f32) (result f32) (f32.trunc (get_local 0)))
+  (func (export "f32.nearest") (param f32) (result f32) (f32.nearest (get_local 0)))
+  (func (export "f64.ceil") (param f64) (result f64) (f64.ceil (get_local 0)))
+  (func (export "f64.floor") (param f64) (result f64) (f64.floor (get_local 0)))
+  (func (export "f64.trunc") (param f64) (result f64) (f64.trunc (get_local 0)))
+  (func (export "f64.nearest") (param f64) (result f64) (f64.nearest (get_local 0)))
+)
+)";
+
+static void parseModule(const char* text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text, strlen(text) + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+static I32 invokeAddTwo(Compartment* compartment,
+						Context* context,
+						CompiledModuleRef compiledModule,
+						FunctionInstance* addOneInstance,
+						I32 value)
+{
+	ImportBindings imports;
+	imports.functions.push_back(addOneInstance);
+	ModuleInstance* moduleInstance
+		= instantiateModule(compartment, compiledModule, std::move(imports), "bitcodeTest");
+
+	FunctionInstance* addTwo = asFunctionNullable(getInstanceExport(moduleInstance, "addTwo"));
+	errorUnless(addTwo);
+
+	const ValueTuple results = invokeFunctionChecked(context, addTwo, {Value(value)});
+	errorUnless(results.size() == 1 && results[0].type == ValueType::i32);
+	return results[0].i32;
+}
+
+// Checks that calling a rounding operator's export gives the same bits as the native function for
+// each input, including the quiet bit of NaN results.
+template<typename Float>
+static void testRoundingOperator(Context* context,
+								 ModuleInstance* moduleInstance,
+								 const char* exportName,
+								 Float (*nativeFunction)(Float),
+								 const std::vector<Float>& inputs)
+{
+	FunctionInstance* function
+		= asFunctionNullable(getInstanceExport(moduleInstance, exportName));
+	errorUnless(function);
+
+	for(Float input : inputs)
+	{
+		const ValueTuple results = invokeFunctionChecked(context, function, {Value(input)});
+		errorUnless(results.size() == 1 && results[0].type == inferValueType<Float>());
+
+		Float result;
+		memcpy(&result, results[0].bytes, sizeof(Float));
+		const Float expected = nativeFunction(input);
+		if(memcmp(&result, &expected, sizeof(Float)))
+		{
+			Errors::fatalf("%s(%a) returned %a, but expected %a\n",
+						   exportName,
+						   F64(input),
+						   F64(result),
+						   F64(expected));
+		}
+	}
+}
+
+template<typename Float, typename Int> static std::vector<Float> getRoundingInputs()
+{
+	std::vector<Float> inputs;
+	for(F64 value : {0.0, -0.0, 0.5, -0.5, 1.5, -1.5, 2.5, -2.5, 3.7, -3.7, 8388607.5, 1e30, -1e30})
+	{ inputs.push_back(Float(value)); }
+	inputs.push_back(std::numeric_limits<Float>::infinity());
+	inputs.push_back(-std::numeric_limits<Float>::infinity());
+	inputs.push_back(std::numeric_limits<Float>::denorm_min());
+
+	// A quiet NaN, a signaling NaN, and a negative signaling NaN with a non-canonical payload.
+	const Uptr numSignificandBits = Floats::FloatComponents<Float>::numSignificandBits;
+	const Int exponentBits
+		= Int(Floats::FloatComponents<Float>::maxExponentBits) << numSignificandBits;
+	const Int quietBit = Int(1) << (numSignificandBits - 1);
+	for(Int bits : {Int(exponentBits | quietBit),
+					Int(exponentBits | 1),
+					Int((Int(1) << (sizeof(Int) * 8 - 1)) | exponentBits | (quietBit >> 1))})
+	{
+		Float nan;
+		memcpy(&nan, &bits, sizeof(Float));
+		inputs.push_back(nan);
+	}
+	return inputs;
+}
+
+static void testRounding(Compartment* compartment, Context* context)
+{
+	Module module;
+	parseModule(roundingModuleText, module);
+	ModuleInstance* moduleInstance
+		= instantiateModule(compartment, module, ImportBindings(), "rounding");
+
+	const std::vector<F32> f32Inputs = getRoundingInputs<F32, U32>();
+	testRoundingOperator(context, moduleInstance, "f32.ceil", Floats::floatCeil<F32>, f32Inputs);
+	testRoundingOperator(context, moduleInstance, "f32.floor", Floats::floatFloor<F32>, f32Inputs);
+	testRoundingOperator(context, moduleInstance, "f32.trunc", Floats::floatTrunc<F32>, f32Inputs);
+	testRoundingOperator(
+		context, moduleInstance, "f32.nearest", Floats::floatNearest<F32>, f32Inputs);
+
+	const std::vector<F64> f64Inputs = getRoundingInputs<F64, U64>();
+	testRoundingOperator(context, moduleInstance, "f64.ceil", Floats::floatCeil<F64>, f64Inputs);
+	testRoundingOperator(context, moduleInstance, "f64.floor", Floats::floatFloor<F64>, f64Inputs);
+	testRoundingOperator(context, moduleInstance, "f64.trunc", Floats::floatTrunc<F64>, f64Inputs);
+	testRoundingOperator(
+		context, moduleInstance, "f64.nearest", Floats::floatNearest<F64>, f64Inputs);
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+
+	Module module;
+	parseModule(moduleText, module);
+
+	Compartment* compartment = createCompartment();
+	Context* context         = createContext(compartment);
+
+	ModuleInstance* intrinsicInstance = Intrinsics::instantiateModule(
+		compartment, INTRINSIC_MODULE_REF(bitcodeTest), "bitcodeTest");
+	FunctionInstance* addOneInstance
+		= asFunctionNullable(getInstanceExport(intrinsicInstance, "addOne"));
+	errorUnless(addOneInstance);
+
+	// Compiling the module against the intrinsic module inlines the LLVM body of addOne, so the
+	// native function isn't called.
+	const HashMap<std::string, const Intrinsics::Module*> importModules
+		= {{"bitcodeTest", &INTRINSIC_MODULE_REF(bitcodeTest)}};
+	CompiledModuleRef inlinedModule = Intrinsics::compileModule(module, importModules);
+	errorUnless(invokeAddTwo(compartment, context, inlinedModule, addOneInstance, 40) == 42);
+	errorUnless(numNativeAddOneCalls == 0);
+
+	// Compiling the module without the intrinsic module calls the native function.
+	CompiledModuleRef uninlinedModule = compileModule(module);
+	errorUnless(invokeAddTwo(compartment, context, uninlinedModule, addOneInstance, 40) == 42);
+	errorUnless(numNativeAddOneCalls == 2);
+
+	testRounding(compartment, context);
+
+	Timing::logTimer("IntrinsicBitcodeTest", timer);
+	return 0;
+}
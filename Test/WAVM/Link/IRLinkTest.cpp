@@ -0,0 +1,222 @@
+#include "IR/Link.h"
+#include "IR/Module.h"
+#include "IR/Validate.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace IR;
+
+static const char* helperModuleText = R"(
+(module
+  (import "env" "memory" (memory 1))
+  (import "env" "double" (func $double (param i32) (result i32)))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global (export "offset") i32 (i32.const 100))
+
+  (table (export "table") anyfunc (elem $square))
+  (data (i32.const 8) "abc")
+
+  (func $square (export "square") (param i32) (result i32) (i32.mul (get_local 0) (get_local 0)))
+  (func $next (export "next") (result i32)
+    (set_global $counter (i32.add (get_global $counter) (i32.const 1)))
+    (get_global $counter)
+  )
+
+  (func $start (set_global $counter (i32.const 10)))
+  (start $start)
+)
+)";
+
+static const char* mainModuleText = R"(
+(module
+  (import "env" "memory" (memory 1))
+  (import "env" "double" (func $double (param i32) (result i32)))
+  (import "helper" "square" (func $square (param i32) (result i32)))
+  (import "helper" "next" (func $next (result i32)))
+  (import "helper" "offset" (global $offset i32))
+  (import "helper" "table" (table 1 anyfunc))
+
+  (func $run (export "run") (param i32) (result i32)
+    (i32.add (call $square (get_local 0)) (call $double (get_global $offset)))
+  )
+  (func $callTable (export "callTable") (param i32) (result i32)
+    (call_indirect (param i32) (result i32) (get_local 0) (i32.const 0))
+  )
+
+  (func $start (drop (call $next)))
+  (start $start)
+)
+)";
+
+// The expected result of linking the helper and main modules:
+// - The imports from env are merged, and the imports of the helper module's exports are replaced
+//   with the exported definitions.
+// - The definitions of the helper module come before those of the main module, and the name of
+//   the main module's start function is made unique.
+// - The exports are the main module's exports.
+// - The start function calls the start functions of both modules in order.
+static const char* expectedLinkedModuleText = R"(
+(module
+  (type (func (param i32) (result i32)))
+  (type (func (result i32)))
+  (type (func))
+
+  (import "env" "double" (func $double (param i32) (result i32)))
+  (import "env" "memory" (memory 1))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global $offset i32 (i32.const 100))
+
+  (table 1 1 anyfunc)
+  (elem (i32.const 0) $square)
+  (data (i32.const 8) "abc")
+
+  (func $square (param i32) (result i32) (i32.mul (get_local 0) (get_local 0)))
+  (func $next (result i32)
+    (set_global $counter (i32.add (get_global $counter) (i32.const 1)))
+    (get_global $counter)
+  )
+  (func $start (set_global $counter (i32.const 10)))
+
+  (func $run (export "run") (param i32) (result i32)
+    (i32.add (call $square (get_local 0)) (call $double (get_global $offset)))
+  )
+  (func $callTable (export "callTable") (param i32) (result i32)
+    (call_indirect (type 0) (get_local 0) (i32.const 0))
+  )
+  (func $start_0 (drop (call $next)))
+
+  (func (call $start) (call $start_0))
+  (start 7)
+)
+)";
+
+static void parseModule(const char* text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text, strlen(text) + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+static bool isLinkError(const std::vector<LinkableModule>& modules)
+{
+	try
+	{
+		Module linkedModule;
+		linkModules(modules, linkedModule);
+		return false;
+	}
+	catch(const LinkException&)
+	{
+		return true;
+	}
+}
+
+static void testLinkedModule()
+{
+	Module helperModule;
+	Module mainModule;
+	parseModule(helperModuleText, helperModule);
+	parseModule(mainModuleText, mainModule);
+
+	Module linkedModule;
+	linkModules({{"helper", &helperModule}, {"main", &mainModule}}, linkedModule);
+
+	// The linked module must be valid.
+	try
+	{
+		validateDefinitions(linkedModule);
+	}
+	catch(const ValidationException& exception)
+	{
+		Errors::fatalf("linked module is invalid: %s", exception.message.c_str());
+	}
+
+	// Compare the linked module to the expected module by printing both of them, which also
+	// compares the names that were merged from the modules' name sections.
+	Module expectedModule;
+	parseModule(expectedLinkedModuleText, expectedModule);
+	const std::string linkedModuleString   = WAST::print(linkedModule);
+	const std::string expectedModuleString = WAST::print(expectedModule);
+	if(linkedModuleString != expectedModuleString)
+	{
+		Errors::fatalf("linked module:\n%s\ndoesn't match the expected module:\n%s\n",
+					   linkedModuleString.c_str(),
+					   expectedModuleString.c_str());
+	}
+}
+
+static void testLinkErrors()
+{
+	Module helperModule;
+	parseModule(helperModuleText, helperModule);
+
+	// An import of an export that doesn't exist.
+	Module missingExportModule;
+	parseModule("(module (import \"helper\" \"missing\" (func)))", missingExportModule);
+	errorUnless(isLinkError({{"helper", &helperModule}, {"main", &missingExportModule}}));
+
+	// An import of an export with a different type.
+	Module mismatchedTypeModule;
+	parseModule("(module (import \"helper\" \"square\" (func (param i64))))", mismatchedTypeModule);
+	errorUnless(isLinkError({{"helper", &helperModule}, {"main", &mismatchedTypeModule}}));
+
+	// A module that defines a second memory.
+	Module secondMemoryModule;
+	parseModule("(module (memory 1))", secondMemoryModule);
+	errorUnless(isLinkError({{"helper", &helperModule}, {"main", &secondMemoryModule}}));
+
+	// Imports may only be resolved to modules that are linked before the importing module.
+	Module importerModule;
+	parseModule("(module (import \"helper\" \"next\" (func (result i32))))", importerModule);
+	Module linkedModule;
+	linkModules({{"main", &importerModule}, {"helper", &helperModule}}, linkedModule);
+	errorUnless(linkedModule.functions.imports.size() == 2);
+}
+
+static void testLinkedFeatureSpec()
+{
+	FeatureSpec simdFeatureSpec;
+	simdFeatureSpec.atomics                             = false;
+	simdFeatureSpec.requireSharedFlagForAtomicOperators = true;
+	simdFeatureSpec.maxLocals                           = 100;
+	FeatureSpec atomicsFeatureSpec;
+	atomicsFeatureSpec.simd      = false;
+	atomicsFeatureSpec.maxLocals = 200;
+
+	Module simdModule(simdFeatureSpec);
+	Module atomicsModule(atomicsFeatureSpec);
+	parseModule("(module)", simdModule);
+	parseModule("(module)", atomicsModule);
+
+	// The linked module allows the features used by either module, not just the last one.
+	Module linkedModule;
+	linkModules({{"simd", &simdModule}, {"atomics", &atomicsModule}}, linkedModule);
+	errorUnless(linkedModule.featureSpec.simd);
+	errorUnless(linkedModule.featureSpec.atomics);
+	errorUnless(!linkedModule.featureSpec.requireSharedFlagForAtomicOperators);
+	errorUnless(linkedModule.featureSpec.maxLocals == 200);
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testLinkedModule();
+	testLinkErrors();
+	testLinkedFeatureSpec();
+	Timing::logTimer("IRLinkTest", timer);
+	return 0;
+}
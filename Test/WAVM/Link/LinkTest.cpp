@@ -0,0 +1,253 @@
+#include "IR/Link.h"
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Linker.h"
+#include "Runtime/Runtime.h"
+#include "WASM/WASM.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// Provides the imports of the linked module that aren't resolved by the linker.
+static const char* envModuleText = R"(
+(module
+  (memory (export "memory") 1)
+  (global (export "base") i32 (i32.const 100))
+  (func (export "double") (param i32) (result i32) (i32.mul (get_local 0) (i32.const 2)))
+)
+)";
+
+static const char* helperModuleText = R"(
+(module
+  (import "env" "memory" (memory 1))
+  (import "env" "base" (global $base i32))
+  (import "env" "double" (func $double (param i32) (result i32)))
+
+  (type $i32_to_i32 (func (param i32) (result i32)))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global (export "offset") i32 (get_global $base))
+
+  (table (export "table") anyfunc (elem $square))
+  (data (get_global $base) "abc")
+
+  (func $square (export "square") (type $i32_to_i32) (i32.mul (get_local 0) (get_local 0)))
+  (func (export "next") (result i32)
+    (set_global $counter (i32.add (get_global $counter) (i32.const 1)))
+    (get_global $counter)
+  )
+  (func (export "callDouble") (param i32) (result i32) (call $double (get_local 0)))
+
+  (func $start (set_global $counter (i32.const 10)))
+  (start $start)
+)
+)";
+
+static const char* mainModuleText = R"(
+(module
+  (import "env" "memory" (memory 1))
+  (import "env" "double" (func $double (param i32) (result i32)))
+  (import "helper" "square" (func $square (param i32) (result i32)))
+  (import "helper" "next" (func $next (result i32)))
+  (import "helper" "callDouble" (func $callDouble (param i32) (result i32)))
+  (import "helper" "offset" (global $offset i32))
+  (import "helper" "table" (table 1 anyfunc))
+
+  (global $offsetCopy i32 (get_global $offset))
+
+  (func (export "run") (param i32) (result i32)
+    (i32.add (call $square (get_local 0)) (call $callDouble (get_local 0)))
+  )
+  (func (export "next") (result i32) (call $next))
+  (func (export "getOffset") (result i32) (i32.add (get_global $offset) (get_global $offsetCopy)))
+  (func (export "callTable") (param i32) (result i32)
+    (call_indirect (param i32) (result i32) (get_local 0) (i32.const 0))
+  )
+  (func (export "load") (param i32) (result i32) (i32.load8_u (get_local 0)))
+
+  (func $start (drop (call $next)))
+  (start $start)
+)
+)";
+
+static const char* trapHelperModuleText = R"(
+(module
+  (func $trapInHelper (export "trapInHelper") (unreachable))
+)
+)";
+
+static const char* trapMainModuleText = R"(
+(module
+  (import "helper" "trapInHelper" (func $trapInHelper))
+  (func (export "callTrap") (call $trapInHelper))
+)
+)";
+
+static void parseModule(const char* text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text, strlen(text) + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+// Resolves imports from the env module to the exports of its instance.
+struct EnvResolver : Resolver
+{
+	EnvResolver(ModuleInstance* inEnvInstance) : envInstance(inEnvInstance) {}
+	bool resolve(const std::string& moduleName,
+				 const std::string& exportName,
+				 ObjectType type,
+				 Object*& outObject) override
+	{
+		if(moduleName != "env") { return false; }
+		outObject = getInstanceExport(envInstance, exportName);
+		return outObject != nullptr && isA(outObject, type);
+	}
+
+private:
+	ModuleInstance* envInstance;
+};
+
+static I32 invokeI32(Context* context,
+					 ModuleInstance* moduleInstance,
+					 const char* exportName,
+					 const std::vector<Value>& arguments)
+{
+	FunctionInstance* function = asFunctionNullable(getInstanceExport(moduleInstance, exportName));
+	errorUnless(function);
+
+	const ValueTuple results = invokeFunctionChecked(context, function, arguments);
+	errorUnless(results.size() == 1 && results[0].type == ValueType::i32);
+	return results[0].i32;
+}
+
+static void testLinkedModule(ExecutionBackend backend)
+{
+	CompileOptions compileOptions;
+	compileOptions.backend            = backend;
+	compileOptions.inlineFunctionDefs = true;
+
+	Module envModule;
+	Module helperModule;
+	Module mainModule;
+	parseModule(envModuleText, envModule);
+	parseModule(helperModuleText, helperModule);
+	parseModule(mainModuleText, mainModule);
+
+	Module linkedModule;
+	linkModules({{"helper", &helperModule}, {"main", &mainModule}}, linkedModule);
+
+	// Only the imports from env remain, and the memory imports are merged. A function that calls
+	// the start functions of both modules is added.
+	errorUnless(linkedModule.functions.imports.size() == 1);
+	errorUnless(linkedModule.functions.defs.size() == 11);
+	errorUnless(linkedModule.memories.imports.size() == 1);
+	errorUnless(linkedModule.globals.imports.size() == 1);
+	errorUnless(linkedModule.tables.size() == 1);
+	errorUnless(linkedModule.exports.size() == mainModule.exports.size());
+
+	// Check that the linked module is valid by serializing and loading it.
+	Serialization::ArrayOutputStream outputStream;
+	WASM::serialize(outputStream, linkedModule);
+	std::vector<U8> bytes = outputStream.getBytes();
+	Serialization::MemoryInputStream inputStream(bytes.data(), bytes.size());
+	Module loadedModule;
+	WASM::serialize(inputStream, loadedModule);
+
+	Compartment* compartment = createCompartment();
+	Context* context         = createContext(compartment);
+
+	ModuleInstance* envInstance
+		= instantiateModule(compartment, compileModule(envModule, compileOptions), {}, "env");
+	EnvResolver envResolver(envInstance);
+	LinkResult linkResult = linkModule(linkedModule, envResolver);
+	errorUnless(linkResult.success);
+
+	ModuleInstance* linkedInstance = instantiateModule(compartment,
+													   compileModule(linkedModule, compileOptions),
+													   std::move(linkResult.resolvedImports),
+													   "linked");
+
+	// The helper module's start function is called before the main module's start function.
+	FunctionInstance* startFunction = getStartFunction(linkedInstance);
+	errorUnless(startFunction);
+	invokeFunctionChecked(context, startFunction, {});
+	errorUnless(invokeI32(context, linkedInstance, "next", {}) == 12);
+
+	errorUnless(invokeI32(context, linkedInstance, "run", {Value(I32(3))}) == 15);
+	errorUnless(invokeI32(context, linkedInstance, "getOffset", {}) == 200);
+	errorUnless(invokeI32(context, linkedInstance, "callTable", {Value(I32(5))}) == 25);
+	errorUnless(invokeI32(context, linkedInstance, "load", {Value(I32(101))}) == 'b');
+}
+
+// Calls a linked module's export that calls a function that was defined in another module and
+// traps, and returns whether that function is in the trap's call stack.
+static bool isHelperInTrapCallStack(const Module& linkedModule, bool inlineFunctionDefs)
+{
+	CompileOptions compileOptions;
+	compileOptions.inlineFunctionDefs = inlineFunctionDefs;
+
+	Compartment* compartment = createCompartment();
+	Context* context         = createContext(compartment);
+	ModuleInstance* linkedInstance
+		= instantiateModule(compartment, compileModule(linkedModule, compileOptions), {}, "linked");
+	FunctionInstance* function = asFunctionNullable(getInstanceExport(linkedInstance, "callTrap"));
+	errorUnless(function);
+
+	bool trapped             = false;
+	bool isHelperInCallStack = false;
+	catchRuntimeExceptions(
+		[&] { invokeFunctionChecked(context, function, {}); },
+		[&](Exception&& exception) {
+			errorUnless(exception.typeInstance == Exception::reachedUnreachableType);
+			trapped = true;
+			for(const std::string& frameDescription : describeCallStack(exception.callStack))
+			{
+				if(frameDescription.find("!trapInHelper+") != std::string::npos)
+				{ isHelperInCallStack = true; }
+			}
+		});
+	errorUnless(trapped);
+	return isHelperInCallStack;
+}
+
+static void testInlining()
+{
+	Module helperModule;
+	Module mainModule;
+	parseModule(trapHelperModuleText, helperModule);
+	parseModule(trapMainModuleText, mainModule);
+
+	Module linkedModule;
+	linkModules({{"helper", &helperModule}, {"main", &mainModule}}, linkedModule);
+
+	// The call to the function from the helper module is only inlined into its caller if the
+	// linked module is compiled with inlineFunctionDefs.
+	errorUnless(isHelperInTrapCallStack(linkedModule, false));
+	errorUnless(!isHelperInTrapCallStack(linkedModule, true));
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testLinkedModule(ExecutionBackend::jit);
+	testLinkedModule(ExecutionBackend::interpreter);
+	testInlining();
+	Timing::logTimer("LinkTest", timer);
+	return 0;
+}
@@ -0,0 +1,179 @@
+#include "IR/Module.h"
+#include "IR/Optimize.h"
+#include "IR/Validate.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "WASM/WASM.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace IR;
+
+static const char* moduleText = R"(
+(module
+  (type $deadOnly (func (param f64)))
+  (type $binary (func (param i32 i32) (result i32)))
+  (type $unused (func (param i64)))
+  (type $unary (func (param i32) (result i32)))
+  (type $void (func))
+
+  (import "env" "log" (func $log (type $unary)))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global $neverSet (mut i32) (i32.const 7))
+  (global $exported (mut i32) (i32.const 1))
+  (export "exported" (global $exported))
+
+  (table anyfunc (elem $double))
+
+  (func $run (export "run") (param $x i32) (result i32)
+    (set_global $counter (i32.add (get_global $counter) (get_global $neverSet)))
+    (call_indirect (type $unary) (call $helper (get_local $x) (i32.const 1)) (i32.const 0))
+  )
+  (func $helper (param $a i32) (param $b i32) (result i32)
+    (get_local $a)
+    (get_local $b)
+    (block $sum (param i32 i32) (result i32) i32.add)
+  )
+  (func $double (param $y i32) (result i32) (i32.mul (get_local $y) (i32.const 2)))
+
+  (func $dead (param $p i32) (param $q f32) (local $l i64)
+    (loop $forever (call $deadCallee) (br $forever))
+  )
+  (func $deadCallee
+    (call_indirect (type $deadOnly) (f64.const 0) (i32.const 0))
+  )
+)
+)";
+
+// The expected result of optimizing the module:
+// - The unreachable functions' bodies are replaced with unreachable, and the names of their
+//   non-parameter locals and labels are removed.
+// - The types that were only used by the removed code, or not used at all, are removed, and the
+//   other types are renumbered and keep their names.
+// - The mutable global that is never set is made immutable.
+static const char* expectedOptimizedModuleText = R"(
+(module
+  (type $binary (func (param i32 i32) (result i32)))
+  (type $unary (func (param i32) (result i32)))
+  (type $void (func))
+  (type (func (param i32 f32)))
+
+  (import "env" "log" (func $log (type $unary)))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global $neverSet i32 (i32.const 7))
+  (global $exported (mut i32) (i32.const 1))
+  (export "exported" (global $exported))
+
+  (table anyfunc (elem $double))
+
+  (func $run (export "run") (param $x i32) (result i32)
+    (set_global $counter (i32.add (get_global $counter) (get_global $neverSet)))
+    (call_indirect (type $unary) (call $helper (get_local $x) (i32.const 1)) (i32.const 0))
+  )
+  (func $helper (param $a i32) (param $b i32) (result i32)
+    (get_local $a)
+    (get_local $b)
+    (block $sum (param i32 i32) (result i32) i32.add)
+  )
+  (func $double (param $y i32) (result i32) (i32.mul (get_local $y) (i32.const 2)))
+
+  (func $dead (param $p i32) (param $q f32) unreachable)
+  (func $deadCallee unreachable)
+)
+)";
+
+static void parseModule(const char* text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text, strlen(text) + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+static void expectEqualModules(const Module& module, const Module& expectedModule)
+{
+	// Printing the modules also compares the names in their name sections.
+	const std::string moduleString         = WAST::print(module);
+	const std::string expectedModuleString = WAST::print(expectedModule);
+	if(moduleString != expectedModuleString)
+	{
+		Errors::fatalf("module:\n%s\ndoesn't match the expected module:\n%s\n",
+					   moduleString.c_str(),
+					   expectedModuleString.c_str());
+	}
+}
+
+static void testOptimizedModule()
+{
+	Module module;
+	parseModule(moduleText, module);
+	const std::string originalModuleString = WAST::print(module);
+
+	// Optimize a copy of the module, which shares the original module's arena.
+	Module optimizedModule = module;
+	optimizeModule(optimizedModule);
+
+	// The optimized module must be valid.
+	try
+	{
+		validateDefinitions(optimizedModule);
+	}
+	catch(const ValidationException& exception)
+	{
+		Errors::fatalf("optimized module is invalid: %s\n", exception.message.c_str());
+	}
+
+	Module expectedModule;
+	parseModule(expectedOptimizedModuleText, expectedModule);
+	expectEqualModules(optimizedModule, expectedModule);
+
+	// The optimized module, including its rewritten name section, must survive a round trip
+	// through the binary format, which validates it again.
+	Serialization::ArrayOutputStream outputStream;
+	WASM::serialize(outputStream, optimizedModule);
+	const std::vector<U8> bytes = outputStream.getBytes();
+	Module deserializedModule;
+	Serialization::MemoryInputStream inputStream(bytes.data(), bytes.size());
+	WASM::serialize(inputStream, deserializedModule);
+	expectEqualModules(deserializedModule, expectedModule);
+
+	// Optimizing the copy didn't change the original module.
+	errorUnless(WAST::print(module) == originalModuleString);
+}
+
+static void testUnchangedModule()
+{
+	// A module without any unreachable functions or unused types isn't changed.
+	Module module;
+	parseModule(
+		"(module (type $t (func (param i32))) (global $g (mut i32) (i32.const 0))"
+		" (func (export \"set\") (type $t) (set_global $g (get_local 0))))",
+		module);
+
+	Module optimizedModule = module;
+	optimizeModule(optimizedModule);
+	errorUnless(optimizedModule.arena == module.arena);
+	validateDefinitions(optimizedModule);
+	expectEqualModules(optimizedModule, module);
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testOptimizedModule();
+	testUnchangedModule();
+	Timing::logTimer("IROptimizeTest", timer);
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include "IR/IR.h"
+#include "IR/Types.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Runtime.h"
+
+#include <string.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+// An offset that is past the end of the address space reserved for any memory.
+static const Uptr outOfBoundsOffset = Uptr(16) << 30;
+
+// Calls a thunk that is expected to throw a runtime exception of the given type.
+static void expectException(ExceptionTypeInstance* expectedType, const std::function<void()>& thunk)
+{
+	bool threw = false;
+	catchRuntimeExceptions(thunk, [&](Exception&& exception) {
+		if(exception.typeInstance != expectedType)
+		{
+			Errors::fatalf("expected %s, but got %s\n",
+						   describeExceptionType(expectedType).c_str(),
+						   describeException(exception).c_str());
+		}
+		threw = true;
+	});
+	errorUnless(threw);
+}
+
+static void testStringSpan(MemoryInstance* memory)
+{
+	U8* baseAddress     = getMemoryBaseAddress(memory);
+	const Uptr numBytes = getMemoryNumPages(memory) << numBytesPerPageLog2;
+
+	memcpy(baseAddress + 100, "hello", 6);
+	MemorySpan<const char> span = memoryStringSpan(memory, 100);
+	errorUnless(span.begin() == (const char*)baseAddress + 100 && span.size() == 5);
+	errorUnless(readMemoryString(memory, 100) == "hello");
+
+	// An empty string.
+	errorUnless(memoryStringSpan(memory, 200).size() == 0);
+
+	// A string whose NUL is the last byte of the memory.
+	memcpy(baseAddress + numBytes - 4, "abc", 4);
+	errorUnless(readMemoryString(memory, numBytes - 4) == "abc");
+
+	// A string without a NUL before the end of the memory.
+	memset(baseAddress + numBytes - 16, 'x', 16);
+	expectException(Exception::accessViolationType,
+					[&] { memoryStringSpan(memory, numBytes - 16); });
+
+	// A string that starts outside the memory.
+	expectException(Exception::accessViolationType,
+					[&] { memoryStringSpan(memory, outOfBoundsOffset); });
+	expectException(Exception::accessViolationType,
+					[&] { memoryStringSpan(memory, UINTPTR_MAX); });
+}
+
+static void testIoVecs(MemoryInstance* memory)
+{
+	U8* baseAddress = getMemoryBaseAddress(memory);
+
+	const GuestIoVec guestIoVecs[3] = {{2000, 16}, {3000, 0}, {4000, 100}};
+	memcpy(baseAddress + 1000, guestIoVecs, sizeof(guestIoVecs));
+	MemoryIoVec ioVecs[3];
+	errorUnless(getMemoryIoVecs(memory, 1000, 3, ioVecs) == 116);
+	for(Uptr ioVecIndex = 0; ioVecIndex < 3; ++ioVecIndex)
+	{
+		errorUnless(ioVecs[ioVecIndex].base == baseAddress + guestIoVecs[ioVecIndex].address);
+		errorUnless(ioVecs[ioVecIndex].numBytes == guestIoVecs[ioVecIndex].numBytes);
+	}
+	errorUnless(getMemoryIoVecs(memory, 1000, 0, nullptr) == 0);
+
+	// An array of iovecs that isn't in the memory.
+	expectException(Exception::accessViolationType,
+					[&] { getMemoryIoVecs(memory, outOfBoundsOffset, 1, ioVecs); });
+	expectException(Exception::accessViolationType,
+					[&] { getMemoryIoVecs(memory, UINTPTR_MAX - 4, 1, ioVecs); });
+
+	// maxMemoryIoVecs iovecs are allowed, but more are rejected before any are written to the
+	// output array.
+	std::vector<MemoryIoVec> maxIoVecs(maxMemoryIoVecs);
+	errorUnless(getMemoryIoVecs(memory, 8192, maxMemoryIoVecs, maxIoVecs.data()) == 0);
+	expectException(Exception::invalidArgumentType,
+					[&] { getMemoryIoVecs(memory, 8192, maxMemoryIoVecs + 1, nullptr); });
+	expectException(Exception::invalidArgumentType,
+					[&] { getMemoryIoVecs(memory, 8192, UINTPTR_MAX, nullptr); });
+}
+
+static void testSpan(MemoryInstance* memory)
+{
+	U8* baseAddress = getMemoryBaseAddress(memory);
+
+	MemorySpan<U32> span = memorySpan<U32>(memory, 64, 4);
+	errorUnless(span.begin() == (U32*)(baseAddress + 64) && span.size() == 4);
+
+	// A span whose size in bytes overflows.
+	expectException(Exception::accessViolationType,
+					[&] { memorySpan<U64>(memory, 0, UINTPTR_MAX / 4); });
+	expectException(Exception::accessViolationType,
+					[&] { memorySpan<U8>(memory, outOfBoundsOffset, 1); });
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+
+	Compartment* compartment = createCompartment();
+	MemoryInstance* memory   = createMemory(compartment, MemoryType(false, SizeConstraints{1, 1}));
+	errorUnless(memory);
+
+	testStringSpan(memory);
+	testIoVecs(memory);
+	testSpan(memory);
+
+	Timing::logTimer("MemoryAccessTest", timer);
+	return 0;
+}
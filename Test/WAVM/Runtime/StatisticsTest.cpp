@@ -0,0 +1,147 @@
+#include "IR/Module.h"
+#include "IR/TaggedValue.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "Runtime/Runtime.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace IR;
+using namespace Runtime;
+
+static const char* moduleText = R"(
+(module
+  (memory 1 4)
+  (table 2 anyfunc)
+  (func (export "nop"))
+  (func (export "grow") (param i32) (result i32) (memory.grow (get_local 0)))
+  (func (export "unreachable") (unreachable))
+  (func (export "divide") (param i32 i32) (result i32) (i32.div_s (get_local 0) (get_local 1)))
+)
+)";
+
+static void parseModule(const char* text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text, strlen(text) + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+static FunctionInstance* getFunctionExport(ModuleInstance* moduleInstance, const char* name)
+{
+	FunctionInstance* function = asFunctionNullable(getInstanceExport(moduleInstance, name));
+	errorUnless(function);
+	return function;
+}
+
+static U64 getNumTraps(const CompartmentStatistics& statistics, ExceptionTypeInstance* type)
+{
+	const std::string typeName = describeExceptionType(type);
+	for(const auto& pair : statistics.numTrapsByExceptionType)
+	{
+		if(pair.first == typeName) { return pair.second; }
+	}
+	return 0;
+}
+
+// Invokes a function that is expected to trap with the given exception type.
+static void invokeTrappingFunction(Context* context,
+								   FunctionInstance* function,
+								   const std::vector<Value>& arguments,
+								   ExceptionTypeInstance* expectedType)
+{
+	bool trapped = false;
+	catchRuntimeExceptions([&] { invokeFunctionChecked(context, function, arguments); },
+						   [&](Exception&& exception) {
+							   errorUnless(exception.typeInstance == expectedType);
+							   trapped = true;
+						   });
+	errorUnless(trapped);
+}
+
+static void testStatistics(const Module& module, ExecutionBackend backend)
+{
+	Compartment* compartment = createCompartment();
+	Context* context         = createContext(compartment);
+
+	// The compartment already contains the objects it creates for itself, such as the
+	// wavmIntrinsics module instance, so compare the object counts to the counts before the
+	// module is instantiated.
+	const CompartmentStatistics initialStatistics = getStatistics(compartment);
+	errorUnless(initialStatistics.numObjectsByKind[Uptr(Runtime::ObjectKind::context)] == 1);
+
+	ModuleInstance* moduleInstance = instantiateModule(
+		compartment, compileModule(module, backend), ImportBindings(), "statistics");
+
+	CompartmentStatistics statistics = getStatistics(compartment);
+	for(Runtime::ObjectKind kind : {Runtime::ObjectKind::module,
+									Runtime::ObjectKind::memory,
+									Runtime::ObjectKind::table})
+	{
+		errorUnless(statistics.numObjectsByKind[Uptr(kind)]
+					== initialStatistics.numObjectsByKind[Uptr(kind)] + 1);
+	}
+	errorUnless(statistics.numMemoryPages == initialStatistics.numMemoryPages + 1);
+	errorUnless(statistics.numTableElements == initialStatistics.numTableElements + 2);
+	errorUnless(statistics.numInvokes == 0);
+	errorUnless(statistics.numGrowMemoryCalls == 0);
+	errorUnless(statistics.numTrapsByExceptionType.empty());
+
+	// Each invoke is counted.
+	FunctionInstance* nop = getFunctionExport(moduleInstance, "nop");
+	for(Uptr invokeIndex = 0; invokeIndex < 3; ++invokeIndex)
+	{ invokeFunctionChecked(context, nop, {}); }
+	statistics = getStatistics(compartment);
+	errorUnless(statistics.numInvokes == 3);
+
+	// Each memory.grow is counted, even if it fails.
+	FunctionInstance* grow = getFunctionExport(moduleInstance, "grow");
+	errorUnless(invokeFunctionChecked(context, grow, {I32(1)})[0].i32 == 1);
+	errorUnless(invokeFunctionChecked(context, grow, {I32(10)})[0].i32 == -1);
+	statistics = getStatistics(compartment);
+	errorUnless(statistics.numInvokes == 5);
+	errorUnless(statistics.numGrowMemoryCalls == 2);
+	errorUnless(statistics.numMemoryPages == 2);
+
+	// Each trap is counted by its exception type, and the invokes that trapped are counted.
+	FunctionInstance* unreachable = getFunctionExport(moduleInstance, "unreachable");
+	FunctionInstance* divide      = getFunctionExport(moduleInstance, "divide");
+	invokeTrappingFunction(context, unreachable, {}, Exception::reachedUnreachableType);
+	invokeTrappingFunction(context, unreachable, {}, Exception::reachedUnreachableType);
+	invokeTrappingFunction(
+		context, divide, {I32(1), I32(0)}, Exception::integerDivideByZeroOrOverflowType);
+	statistics = getStatistics(compartment);
+	errorUnless(statistics.numInvokes == 8);
+	errorUnless(statistics.numTrapsByExceptionType.size() == 2);
+	errorUnless(getNumTraps(statistics, Exception::reachedUnreachableType) == 2);
+	errorUnless(getNumTraps(statistics, Exception::integerDivideByZeroOrOverflowType) == 1);
+
+	// The counters are per-compartment.
+	const CompartmentStatistics otherStatistics = getStatistics(createCompartment());
+	errorUnless(otherStatistics.numInvokes == 0);
+	errorUnless(otherStatistics.numGrowMemoryCalls == 0);
+	errorUnless(otherStatistics.numTrapsByExceptionType.empty());
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+
+	Module module;
+	parseModule(moduleText, module);
+	testStatistics(module, ExecutionBackend::jit);
+	testStatistics(module, ExecutionBackend::interpreter);
+
+	Timing::logTimer("StatisticsTest", timer);
+	return 0;
+}
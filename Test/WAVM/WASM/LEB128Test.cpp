@@ -0,0 +1,247 @@
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace Serialization;
+
+// The bytes that are added after an encoding. Decoding must give the same result whether or not
+// the encoding is followed by other bytes, which decides whether the decoder can load 8 bytes at
+// once or must decode a byte at a time.
+static const std::vector<std::vector<U8>> paddings = {
+	{},
+	std::vector<U8>(16, 0x00),
+	std::vector<U8>(16, 0xff),
+	std::vector<U8>(3, 0x80),
+};
+
+template<typename Value> struct DecodeResult
+{
+	Value value       = 0;
+	Uptr numBytesRead = 0;
+	std::string error;
+};
+
+template<typename Value, Uptr maxBits>
+static DecodeResult<Value> decode(const std::vector<U8>& encoding,
+								  const std::vector<U8>& padding,
+								  Value minValue,
+								  Value maxValue)
+{
+	std::vector<U8> bytes = encoding;
+	bytes.insert(bytes.end(), padding.begin(), padding.end());
+
+	DecodeResult<Value> result;
+	MemoryInputStream stream(bytes.data(), bytes.size());
+	try
+	{
+		serializeVarInt<Value, maxBits>(stream, result.value, minValue, maxValue);
+		result.numBytesRead = bytes.size() - stream.capacity();
+	}
+	catch(const FatalSerializationException& exception)
+	{
+		result.error = exception.message;
+	}
+	return result;
+}
+
+static std::string formatEncoding(const std::vector<U8>& encoding)
+{
+	std::string string;
+	for(U8 byte : encoding)
+	{
+		static const char hexDigits[] = "0123456789abcdef";
+		if(string.size()) { string += ' '; }
+		string += hexDigits[byte >> 4];
+		string += hexDigits[byte & 15];
+	}
+	return string;
+}
+
+// Checks that the encoding decodes to the expected value, and reads all the encoding's bytes.
+template<typename Value, Uptr maxBits>
+static void expectValue(const std::vector<U8>& encoding,
+						Value expectedValue,
+						Value minValue = std::numeric_limits<Value>::min(),
+						Value maxValue = std::numeric_limits<Value>::max())
+{
+	for(const std::vector<U8>& padding : paddings)
+	{
+		const DecodeResult<Value> result
+			= decode<Value, maxBits>(encoding, padding, minValue, maxValue);
+		if(result.error.size() || result.value != expectedValue
+		   || result.numBytesRead != encoding.size())
+		{
+			Errors::fatalf("decoding {%s} followed by %u padding bytes gave %s after %u bytes, but "
+						   "expected %s\n",
+						   formatEncoding(encoding).c_str(),
+						   U32(padding.size()),
+						   result.error.size() ? result.error.c_str()
+											   : std::to_string(result.value).c_str(),
+						   U32(result.numBytesRead),
+						   std::to_string(expectedValue).c_str());
+		}
+	}
+}
+
+// Checks that the encoding fails to decode, whether or not it is followed by other bytes.
+template<typename Value, Uptr maxBits>
+static void expectError(const std::vector<U8>& encoding,
+						Value minValue = std::numeric_limits<Value>::min(),
+						Value maxValue = std::numeric_limits<Value>::max())
+{
+	for(const std::vector<U8>& padding : paddings)
+	{
+		const DecodeResult<Value> result
+			= decode<Value, maxBits>(encoding, padding, minValue, maxValue);
+		if(result.error.empty())
+		{
+			Errors::fatalf("decoding {%s} followed by %u padding bytes gave %s, but expected an "
+						   "error\n",
+						   formatEncoding(encoding).c_str(),
+						   U32(padding.size()),
+						   std::to_string(result.value).c_str());
+		}
+	}
+}
+
+// Checks that the encoding fails to decode if it is at the end of the input.
+template<typename Value, Uptr maxBits> static void expectEndOfInputError(std::vector<U8> encoding)
+{
+	const DecodeResult<Value> result = decode<Value, maxBits>(
+		encoding, {}, std::numeric_limits<Value>::min(), std::numeric_limits<Value>::max());
+	if(result.error.empty())
+	{
+		Errors::fatalf("decoding {%s} at the end of the input gave %s, but expected an error\n",
+					   formatEncoding(encoding).c_str(),
+					   std::to_string(result.value).c_str());
+	}
+}
+
+static void testUnsigned()
+{
+	expectValue<U32, 32>({0x00}, 0);
+	expectValue<U32, 32>({0x7f}, 127);
+	expectValue<U32, 32>({0x80, 0x01}, 128);
+	expectValue<U32, 32>({0xff, 0xff, 0xff, 0xff, 0x0f}, UINT32_MAX);
+
+	// Encodings may be longer than necessary, up to the maximum length.
+	expectValue<U32, 32>({0x80, 0x80, 0x00}, 0);
+	expectValue<U32, 32>({0x80, 0x80, 0x80, 0x80, 0x00}, 0);
+	expectValue<U32, 32>({0xff, 0x80, 0x80, 0x80, 0x00}, 127);
+	expectError<U32, 32>({0x80, 0x80, 0x80, 0x80, 0x80, 0x00});
+
+	// The unused bits of a maximum length encoding's final byte must be 0.
+	expectError<U32, 32>({0xff, 0xff, 0xff, 0xff, 0x1f});
+	expectError<U32, 32>({0x80, 0x80, 0x80, 0x80, 0x70});
+
+	// The terminator may be the 8th byte, which is the last byte a word-at-a-time decode can see.
+	expectValue<U64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f}, (U64(1) << 56) - 1);
+	expectValue<U64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01}, U64(1) << 56);
+	expectValue<U64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01}, UINT64_MAX);
+	expectValue<U64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00}, 0);
+	expectError<U64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x03});
+	expectError<U64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00});
+
+	// Single byte encodings, which are never decoded a word at a time.
+	expectValue<U8, 7>({0x7f}, 127);
+	expectError<U8, 7>({0x80});
+	expectValue<U8, 1>({0x01}, 1);
+	expectError<U8, 1>({0x02});
+
+	// Values outside the range allowed by the caller.
+	expectValue<U32, 32>({0xe4, 0x00}, 100, 0, 100);
+	expectError<U32, 32>({0xe5, 0x00}, 0, 100);
+}
+
+static void testSigned()
+{
+	expectValue<I32, 32>({0x00}, 0);
+	expectValue<I32, 32>({0x7f}, -1);
+	expectValue<I32, 32>({0x3f}, 63);
+	expectValue<I32, 32>({0x40}, -64);
+	expectValue<I32, 32>({0xc0, 0x00}, 64);
+	expectValue<I32, 32>({0xbf, 0x7f}, -65);
+	expectValue<I32, 32>({0xff, 0xff, 0xff, 0xff, 0x07}, INT32_MAX);
+	expectValue<I32, 32>({0x80, 0x80, 0x80, 0x80, 0x78}, INT32_MIN);
+
+	// Overlong encodings are sign extended from their last byte.
+	expectValue<I32, 32>({0xff, 0x7f}, -1);
+	expectValue<I32, 32>({0xff, 0xff, 0xff, 0xff, 0x7f}, -1);
+	expectValue<I32, 32>({0x80, 0x80, 0x80, 0x80, 0x00}, 0);
+
+	// The unused bits of a maximum length encoding's final byte must match its sign bit.
+	expectError<I32, 32>({0xff, 0xff, 0xff, 0xff, 0x0f});
+	expectError<I32, 32>({0x80, 0x80, 0x80, 0x80, 0x70});
+	expectError<I32, 32>({0xff, 0xff, 0xff, 0xff, 0x77});
+
+	expectValue<I64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f}, (I64(1) << 55) - 1);
+	expectValue<I64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40}, -(I64(1) << 55));
+	expectValue<I64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00}, INT64_MAX);
+	expectValue<I64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7f}, INT64_MIN);
+	expectValue<I64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f}, -1);
+	expectError<I64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01});
+	expectError<I64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7e});
+	expectError<I64, 64>({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f});
+
+	expectValue<I8, 7>({0x40}, -64);
+	expectError<I8, 7>({0x80});
+}
+
+static void testEndOfInput()
+{
+	expectEndOfInputError<U32, 32>({});
+	expectEndOfInputError<U32, 32>({0x80});
+	expectEndOfInputError<U32, 32>({0xff, 0xff, 0xff, 0xff});
+	expectEndOfInputError<I64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80});
+	expectEndOfInputError<I64, 64>({0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80});
+	expectEndOfInputError<U8, 7>({});
+}
+
+// A simple deterministic random number generator, so each run tests the same values.
+static U64 nextRandom(U64& state)
+{
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return state >> 11;
+}
+
+// Encodes random values of random widths, and checks that each decodes to the original value.
+template<typename Value, Uptr maxBits> static void testRoundTrip()
+{
+	U64 randomState = maxBits;
+	for(Uptr iteration = 0; iteration < 100000; ++iteration)
+	{
+		const Uptr numBits = 1 + nextRandom(randomState) % (sizeof(Value) * 8);
+		Value value        = Value((nextRandom(randomState) << 11) ^ nextRandom(randomState));
+		if(numBits < sizeof(Value) * 8)
+		{
+			const Uptr shift = sizeof(Value) * 8 - numBits;
+			value            = Value(value << shift) >> shift;
+		}
+
+		ArrayOutputStream stream;
+		serializeVarInt<Value, maxBits>(
+			stream, value, std::numeric_limits<Value>::min(), std::numeric_limits<Value>::max());
+		expectValue<Value, maxBits>(stream.getBytes(), value);
+	}
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+	testUnsigned();
+	testSigned();
+	testEndOfInput();
+	testRoundTrip<U32, 32>();
+	testRoundTrip<I32, 32>();
+	testRoundTrip<U64, 64>();
+	testRoundTrip<I64, 64>();
+	Timing::logTimer("LEB128Test", timer);
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include "IR/Module.h"
+#include "IR/Validate.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "WASM/WASM.h"
+#include "WAST/WAST.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace IR;
+
+// The module is large enough that the decoder decodes its function bodies in parallel on a host
+// with more than one hardware thread.
+enum
+{
+	numFunctions         = 64,
+	numAddsPerFunction   = 4096,
+	firstInvalidFunction = 20,
+	laterInvalidFunction = 40,
+};
+
+// The types that functions are changed to in order to make them invalid.
+enum : Uptr
+{
+	firstInvalidTypeIndex = 1,
+	laterInvalidTypeIndex = 2,
+};
+
+// Generates a module whose functions all have the type (func (result i32)). The function at
+// shortFunctionIndex has a short body, and the others have long bodies.
+static std::string generateModuleText(Uptr numModuleFunctions, Uptr shortFunctionIndex)
+{
+	std::string longFunctionBody = "(i32.const 0)";
+	for(Uptr addIndex = 0; addIndex < numAddsPerFunction; ++addIndex)
+	{ longFunctionBody += " (i32.const 1) i32.add"; }
+
+	std::string text = "(module\n";
+	text += "  (type (func (result i32)))\n";
+	text += "  (type (func (result i64)))\n";
+	text += "  (type (func (result f32)))\n";
+	for(Uptr functionIndex = 0; functionIndex < numModuleFunctions; ++functionIndex)
+	{
+		text += "  (func (type 0) ";
+		text += functionIndex == shortFunctionIndex ? "(i32.const 0)" : longFunctionBody;
+		text += ")\n";
+	}
+	text += ")\n";
+	return text;
+}
+
+static void parseModule(const std::string& text, Module& outModule)
+{
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(text.c_str(), text.size() + 1, outModule, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+}
+
+static std::vector<U8> serializeModule(const Module& module)
+{
+	Serialization::ArrayOutputStream stream;
+	WASM::serialize(stream, module);
+	return stream.getBytes();
+}
+
+// Decodes a binary module, and returns the message of the exception it throws, or an empty string
+// if it decodes without error.
+static std::string getDecodeError(const std::vector<U8>& bytes)
+{
+	try
+	{
+		Module module;
+		Serialization::MemoryInputStream stream(bytes.data(), bytes.size());
+		WASM::serialize(stream, module);
+		return std::string();
+	}
+	catch(const Serialization::FatalSerializationException& exception)
+	{
+		return "deserialization error: " + exception.message;
+	}
+	catch(const ValidationException& exception)
+	{
+		return "validation error: " + exception.message;
+	}
+}
+
+// Returns the error for decoding a module containing a single function with the given type, which
+// is too small to be decoded in parallel.
+static std::string getSerialDecodeError(Uptr typeIndex)
+{
+	Module module;
+	parseModule(generateModuleText(1, UINTPTR_MAX), module);
+	module.functions.defs[0].type = IndexedFunctionType{typeIndex};
+	return getDecodeError(serializeModule(module));
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+
+	Module module;
+	parseModule(generateModuleText(numFunctions, laterInvalidFunction), module);
+	errorUnless(getDecodeError(serializeModule(module)).empty());
+
+	// Each invalid function body has a different error, and errors don't include the index of the
+	// function, so the error for a module with only the first invalid function is the error that
+	// decoding the function bodies in sequence reports.
+	const std::string firstError = getSerialDecodeError(firstInvalidTypeIndex);
+	const std::string laterError = getSerialDecodeError(laterInvalidTypeIndex);
+	errorUnless(!firstError.empty() && !laterError.empty() && firstError != laterError);
+
+	// Make a function in the middle of the module invalid, and another function after it invalid
+	// with a different error. The later invalid function is short, so another thread is likely to
+	// find its error before the first invalid function has been validated, but the error must
+	// still be the one for the first invalid function.
+	module.functions.defs[firstInvalidFunction].type = IndexedFunctionType{firstInvalidTypeIndex};
+	module.functions.defs[laterInvalidFunction].type = IndexedFunctionType{laterInvalidTypeIndex};
+	const std::vector<U8> invalidModuleBytes = serializeModule(module);
+	for(Uptr iteration = 0; iteration < 10; ++iteration)
+	{
+		const std::string error = getDecodeError(invalidModuleBytes);
+		if(error != firstError)
+		{
+			Errors::fatalf("decoding the module failed with \"%s\", but expected \"%s\"\n",
+						   error.c_str(),
+						   firstError.c_str());
+		}
+	}
+
+	Timing::logTimer("ParallelDecodeTest", timer);
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include "IR/Module.h"
+#include "Inline/Assert.h"
+#include "Inline/BasicTypes.h"
+#include "Inline/Errors.h"
+#include "Inline/Serialization.h"
+#include "Inline/Timing.h"
+#include "Logging/Logging.h"
+#include "WASM/WASM.h"
+#include "WAST/WAST.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace IR;
+
+// A module with every kind of section, including the user section that holds the names.
+static const char* moduleText = R"(
+(module
+  (import "env" "print" (func $print (param i32)))
+  (import "env" "table" (table 1 anyfunc))
+  (import "env" "limit" (global $limit i32))
+
+  (memory 1)
+  (global $counter (mut i32) (i32.const 0))
+  (export "memory" (memory 0))
+  (export "counter" (global $counter))
+
+  (func $increment (export "increment") (result i32)
+    (if (i32.lt_s (get_global $counter) (get_global $limit))
+      (then (set_global $counter (i32.add (get_global $counter) (i32.const 1)))))
+    (get_global $counter)
+  )
+  (func $sum (export "sum") (param $n i32) (result i32) (local $i i32) (local $total i32)
+    (block $done
+      (loop $continue
+        (br_if $done (i32.ge_u (get_local $i) (get_local $n)))
+        (set_local $total (i32.add (get_local $total) (i32.load (get_local $i))))
+        (set_local $i (i32.add (get_local $i) (i32.const 4)))
+        (br $continue)
+      )
+    )
+    (get_local $total)
+  )
+  (func $start (call $print (call $increment)))
+  (start $start)
+
+  (elem (i32.const 0) $increment)
+  (data (i32.const 0) "\01\00\00\00\02\00\00\00\03\00\00\00")
+)
+)";
+
+static std::vector<U8> serializeModule(const Module& module)
+{
+	Serialization::ArrayOutputStream stream;
+	WASM::serialize(stream, module);
+	return stream.getBytes();
+}
+
+// Decodes a binary module with a StreamingDecoder, adding the bytes in chunks of the given sizes,
+// and checks that reserializing the decoded module gives the same bytes.
+static void testChunks(const std::vector<U8>& moduleBytes, const std::vector<Uptr>& chunkSizes)
+{
+	Module module;
+	std::vector<Uptr> decodedFunctionDefIndices;
+	{
+		WASM::StreamingDecoder decoder(module, [&](Uptr functionDefIndex) {
+			decodedFunctionDefIndices.push_back(functionDefIndex);
+		});
+
+		Uptr numAddedBytes = 0;
+		for(Uptr chunkSize : chunkSizes)
+		{
+			decoder.addBytes(moduleBytes.data() + numAddedBytes, chunkSize);
+			numAddedBytes += chunkSize;
+		}
+		errorUnless(numAddedBytes == moduleBytes.size());
+		decoder.finish();
+	}
+
+	// Each function definition is reported once, in order.
+	errorUnless(decodedFunctionDefIndices.size() == module.functions.defs.size());
+	for(Uptr index = 0; index < decodedFunctionDefIndices.size(); ++index)
+	{ errorUnless(decodedFunctionDefIndices[index] == index); }
+
+	if(serializeModule(module) != moduleBytes)
+	{ Errors::fatal("the module decoded by the streaming decoder doesn't match the original"); }
+}
+
+static std::vector<Uptr> getRandomChunkSizes(Uptr numBytes, Uptr maxChunkSize)
+{
+	std::vector<Uptr> chunkSizes;
+	while(numBytes)
+	{
+		// Include some empty chunks.
+		const Uptr chunkSize = std::min(numBytes, Uptr(rand()) % (maxChunkSize + 1));
+		chunkSizes.push_back(chunkSize);
+		numBytes -= chunkSize;
+	}
+	return chunkSizes;
+}
+
+// Checks that finishing a module that is missing its last bytes throws.
+static void testTruncatedModule(const std::vector<U8>& moduleBytes)
+{
+	Module module;
+	WASM::StreamingDecoder decoder(module);
+	decoder.addBytes(moduleBytes.data(), moduleBytes.size() - 1);
+	try
+	{
+		decoder.finish();
+		Errors::fatal("finishing a truncated module didn't throw");
+	}
+	catch(const Serialization::FatalSerializationException&)
+	{
+	}
+}
+
+I32 main()
+{
+	Timing::Timer timer;
+
+	Module module;
+	std::vector<WAST::Error> parseErrors;
+	if(!WAST::parseModule(moduleText, strlen(moduleText) + 1, module, parseErrors))
+	{
+		for(const WAST::Error& error : parseErrors)
+		{ Log::printf(Log::error, "%s\n", error.message.c_str()); }
+		Errors::fatal("failed to parse module");
+	}
+	const std::vector<U8> moduleBytes = serializeModule(module);
+
+	// All the bytes at once.
+	testChunks(moduleBytes, {moduleBytes.size()});
+
+	// One byte at a time.
+	testChunks(moduleBytes, std::vector<Uptr>(moduleBytes.size(), 1));
+
+	// Random chunk sizes.
+	srand(0);
+	for(Uptr iteration = 0; iteration < 100; ++iteration)
+	{ testChunks(moduleBytes, getRandomChunkSizes(moduleBytes.size(), 32)); }
+
+	testTruncatedModule(moduleBytes);
+
+	Timing::logTimer("StreamingDecoderTest", timer);
+	return 0;
+}
@@ -0,0 +1,58 @@
+;; Test that removing unreachable function bodies, making unwritten globals immutable, and removing
+;; unused types when a module is compiled doesn't change its behavior.
+
+(module $M
+  (type $unused (func (param i64 i64) (result i64)))
+  (type $i32_to_i32 (func (param i32) (result i32)))
+
+  (global $counter (mut i32) (i32.const 0))
+  (global $unwritten (mut i32) (i32.const 42))
+  (global $writtenByUnreachable (mut i32) (i32.const 7))
+  (global $exported (export "exported") (mut i32) (i32.const 3))
+
+  (table anyfunc (elem $onlyInTable))
+
+  (func $unreachable (param i32) (result i32)
+    (set_global $writtenByUnreachable (i32.const 0))
+    (call $onlyCalledByUnreachable (get_local 0))
+  )
+  (func $onlyCalledByUnreachable (param i32) (result i32)
+    (local i64 f64)
+    (block (br_table 0 0 (get_local 0)))
+    (get_local 0)
+  )
+
+  (func $onlyInTable (type $i32_to_i32) (i32.add (get_local 0) (i32.const 1)))
+  (func $onlyCalled (param i32) (result i32) (i32.mul (get_local 0) (i32.const 2)))
+
+  (func (export "callIndirect") (param i32) (result i32)
+    (call_indirect (type $i32_to_i32) (call $onlyCalled (get_local 0)) (i32.const 0))
+  )
+  (func (export "increment") (result i32)
+    (set_global $counter (i32.add (get_global $counter) (i32.const 1)))
+    (get_global $counter)
+  )
+  (func (export "getUnwritten") (result i32) (get_global $unwritten))
+  (func (export "getWrittenByUnreachable") (result i32) (get_global $writtenByUnreachable))
+  (func (export "getExported") (result i32) (get_global $exported))
+
+  (func $start (set_global $counter (i32.const 10)))
+  (start $start)
+)
+
+(assert_return (invoke "increment") (i32.const 11))
+(assert_return (invoke "callIndirect" (i32.const 2)) (i32.const 5))
+(assert_return (invoke "getUnwritten") (i32.const 42))
+(assert_return (invoke "getWrittenByUnreachable") (i32.const 7))
+
+;; An exported global that isn't set by its module may be set by another module.
+
+(register "M" $M)
+
+(module
+  (import "M" "exported" (global $exported (mut i32)))
+  (func (export "setExported") (param i32) (set_global $exported (get_local 0)))
+)
+
+(invoke "setExported" (i32.const 9))
+(assert_return (invoke $M "getExported") (i32.const 9))
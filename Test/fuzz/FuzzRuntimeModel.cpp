@@ -279,7 +279,8 @@ static void generateFunction(RandomStream& random, Module& module)
 
 	codeStream.finishValidation();
 
-	functionDef.code = codeByteStream.getBytes();
+	functionDef.code               = module.arena->copyArray(codeByteStream.getBytes());
+	functionDef.controlPartOffsets = computeControlPartOffsets(*module.arena, functionDef.code);
 
 	module.functions.defs.push_back(std::move(functionDef));
 };
@@ -298,11 +299,12 @@ void generateValidModule(Module& module, const U8* inputBytes, Uptr numBytes)
 	module.types.push_back(FunctionType(TypeTuple{}, TypeTuple{ValueType::f64}));
 	module.types.push_back(FunctionType(TypeTuple{}, TypeTuple{ValueType::v128}));
 
-	module.functions.defs.push_back({{1}, {}, {U8(Opcode::end), 0}, {}});
-	module.functions.defs.push_back({{2}, {}, {U8(Opcode::end), 0}, {}});
-	module.functions.defs.push_back({{3}, {}, {U8(Opcode::end), 0}, {}});
-	module.functions.defs.push_back({{4}, {}, {U8(Opcode::end), 0}, {}});
-	module.functions.defs.push_back({{5}, {}, {U8(Opcode::end), 0}, {}});
+	const ArenaArray<U8> emptyFunctionCode = module.arena->copyArray<U8>({U8(Opcode::end), 0});
+	module.functions.defs.push_back({{1}, {}, emptyFunctionCode, {}});
+	module.functions.defs.push_back({{2}, {}, emptyFunctionCode, {}});
+	module.functions.defs.push_back({{3}, {}, emptyFunctionCode, {}});
+	module.functions.defs.push_back({{4}, {}, emptyFunctionCode, {}});
+	module.functions.defs.push_back({{5}, {}, emptyFunctionCode, {}});
 
 	module.memories.imports.push_back(
 		{MemoryType{true, SizeConstraints{1024, IR::maxMemoryPages}}});
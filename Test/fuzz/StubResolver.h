@@ -51,7 +51,8 @@ struct StubResolver : Runtime::Resolver
 			IR::Module stubModule;
 			IR::DisassemblyNames stubModuleNames;
 			stubModule.types.push_back(asFunctionType(type));
-			stubModule.functions.defs.push_back({{0}, {}, std::move(codeStream.getBytes()), {}});
+			stubModule.functions.defs.push_back(
+				{{0}, {}, stubModule.arena->copyArray(codeStream.getBytes()), {}});
 			stubModule.exports.push_back({"importStub", IR::ObjectKind::function, 0});
 			stubModuleNames.functions.push_back({"importStub: " + exportName, {}, {}});
 			IR::setDisassemblyNames(stubModule, stubModuleNames);
@@ -462,8 +462,13 @@ private:
   bool getInfoFromDwarfSection(pint_t pc, const UnwindInfoSections &sects,
                                             uint32_t fdeSectionOffsetHint=0);
   int stepWithDwarfFDE() {
-    return DwarfInstructions<A, R>::stepWithDwarf(_addressSpace,
-                                              (pint_t)this->getReg(UNW_REG_IP),
+    // The IP of a frame interrupted by a signal is the next instruction to
+    // execute rather than a return address, so the row that starts at it
+    // applies.
+    pint_t pc = (pint_t)this->getReg(UNW_REG_IP);
+    if (_isInterruptedFrame)
+      ++pc;
+    return DwarfInstructions<A, R>::stepWithDwarf(_addressSpace, pc,
                                               (pint_t)_info.unwind_info,
                                               _registers);
   }
@@ -657,13 +662,14 @@ private:
   unw_proc_info_t  _info;
   bool             _unwindInfoMissing;
   bool             _isSignalFrame;
+  bool             _isInterruptedFrame;
 };
 
 
 template <typename A, typename R>
 UnwindCursor<A, R>::UnwindCursor(unw_context_t *context, A &as)
     : _addressSpace(as), _registers(context), _unwindInfoMissing(false),
-      _isSignalFrame(false) {
+      _isSignalFrame(false), _isInterruptedFrame(false) {
   static_assert((check_fit<UnwindCursor<A, R>, unw_cursor_t>::does_fit),
                 "UnwindCursor<> does not fit in unw_cursor_t");
   memset(&_info, 0, sizeof(_info));
@@ -671,7 +677,8 @@ UnwindCursor<A, R>::UnwindCursor(unw_context_t *context, A &as)
 
 template <typename A, typename R>
 UnwindCursor<A, R>::UnwindCursor(A &as, void *)
-    : _addressSpace(as), _unwindInfoMissing(false), _isSignalFrame(false) {
+    : _addressSpace(as), _unwindInfoMissing(false), _isSignalFrame(false),
+      _isInterruptedFrame(false) {
   memset(&_info, 0, sizeof(_info));
   // FIXME
   // fill in _registers from thread arg
@@ -985,6 +992,7 @@ bool UnwindCursor<A, R>::getInfoFromDwarfSection(pint_t pc,
       _info.unwind_info       = fdeInfo.fdeStart;
       _info.unwind_info_size  = (uint32_t)fdeInfo.fdeLength;
       _info.extra             = (unw_word_t) sects.dso_base;
+      _isSignalFrame          = cieInfo.isSignalFrame;
 
       // Add to cache (to make next lookup faster) if we had no hint
       // and there was no index.
@@ -1264,6 +1272,8 @@ bool UnwindCursor<A, R>::getInfoFromCompactEncodingSection(pint_t pc,
 template <typename A, typename R>
 void UnwindCursor<A, R>::setInfoBasedOnIPRegister(bool isReturnAddress) {
   pint_t pc = (pint_t)this->getReg(UNW_REG_IP);
+  _isSignalFrame = false;
+  _isInterruptedFrame = false;
 #if defined(_LIBUNWIND_ARM_EHABI)
   // Remove the thumb bit so the IP represents the actual instruction address.
   // This matches the behaviour of _Unwind_GetIP on arm.
@@ -1392,6 +1402,10 @@ int UnwindCursor<A, R>::step() {
   if (_unwindInfoMissing)
     return UNW_STEP_END;
 
+  // If this is a signal trampoline frame, the caller's IP is the address of
+  // the instruction that was interrupted by the signal, not a return address.
+  const bool callerIPIsReturnAddress = !_isSignalFrame;
+
   // Use unwinding info to modify register set as if function returned.
   int result;
 #if defined(_LIBUNWIND_SUPPORT_COMPACT_UNWIND)
@@ -1408,7 +1422,8 @@ int UnwindCursor<A, R>::step() {
 
   // update info based on new PC
   if (result == UNW_STEP_SUCCESS) {
-    this->setInfoBasedOnIPRegister(true);
+    this->setInfoBasedOnIPRegister(callerIPIsReturnAddress);
+    _isInterruptedFrame = !callerIPIsReturnAddress;
     if (_unwindInfoMissing)
       return UNW_STEP_END;
     if (_info.gp)